@@ -29,7 +29,9 @@
 // 挂载点 (SPIFFS/SD)
 #define MOUNT_POINT "/sdcard"
 
-// 播放列表分类目录
+// 播放列表分类目录（SD 卡上没有 MODE_MANIFEST_PATH 时的默认模式，按此顺序编号）
+#define MODE_MANIFEST_PATH    "/modes.ini"
+#define MODE_MANIFEST_MAX_SIZE 16384
 #define PLAYLIST_DIR_CHILDREN "/儿歌"
 #define PLAYLIST_DIR_MUSIC    "/音乐"
 #define PLAYLIST_DIR_POEM     "/古诗"
@@ -47,3 +49,57 @@
 #define DISPLAY_WIDTH   240
 #define DISPLAY_HEIGHT  240
 #define DISPLAY_SPI_MODE 3
+
+// ---- 功耗管理 -----
+#define POWER_BACKLIGHT_DIM_MS    30000          // 无操作 30 秒后背光变暗
+#define POWER_BACKLIGHT_OFF_MS    120000         // 无操作 2 分钟后关闭背光
+#define POWER_BACKLIGHT_DIM_LEVEL 24
+#define POWER_DEEP_SLEEP_MS       (10 * 60000)   // 暂停 10 分钟后深度睡眠，模式键唤醒
+
+// ---- 播放列表 -----
+#define PLAYLIST_MEMORY_CAP       (2 * 1024 * 1024) // 常驻模式索引的内存上限，超出时淘汰最久未用的模式
+#define PLAYLIST_NO_REPEAT        16             // 重新打乱时，最近播放的 N 首不会出现在新一轮的前 N 首
+#define PLAYLIST_RAW_SCAN         1              // 缓存未命中时直接读 FAT32 目录扇区扫描（非 FAT32 卡自动退回 VFS），0 为只用 VFS
+#define PLAYLIST_PRELOAD_DELAY_MS 5000           // 开机只建当前模式，其余模式开播后延迟逐个预建
+
+// ---- 旁路缓存 -----
+#define SIDECAR_DIR_MAX_FILES     512            // /.seek、/.wave 各自的文件数上限，超出时删掉最早的 1/8
+
+// ---- 音频任务 -----
+#define AUDIO_TASK_CORE           1              // 与 loop() 同核，高优先级抢占；扫描 / 校验任务在核心 0
+#define AUDIO_TASK_PRIORITY       3              // 高于 loop()、LED 与校验任务（均为 1）
+#define AUDIO_TASK_STACK          12288          // AAC / FLAC 解码器栈需求较大
+#define AUDIO_TASK_DEADLINE_MS    50             // 两次 audio.loop() 最大间隔；DMA 约 185ms，超过即告警
+#define AUDIO_TASK_IDLE_MS        20             // 暂停时阻塞等待命令的超时
+#define AUDIO_TASK_REPORT_MS      60000          // 截止期与栈高水位报告周期
+
+// ---- 事件追踪 -----
+#define TRACE_CAPACITY            8192           // 环形缓冲记录数（16 字节 / 条，放在 PSRAM）
+#define TRACE_FILE                "/.trace.bin"
+#define TRACE_FILE_PREV           "/.trace.1.bin" // 上一次落盘的追踪
+#define TRACE_UNDERRUN_FLUSH_MS   5000           // 断流后延迟落盘，记录事后的恢复过程
+#define TRACE_FLUSH_MIN_INTERVAL_MS 60000        // 断流触发的落盘最小间隔
+
+// ---- 曲目浏览 -----
+#define BROWSER_FRAME_MS          33             // 浏览器刷新间隔（约 30fps）
+#define BROWSER_IDLE_MS           15000          // 无操作自动关闭浏览器
+
+// ---- 拍手口令 -----
+#define MIC_ENABLE                0              // 1 为常开麦克风监听拍手（占用 I2S_NUM_1）；设备上的 CPU 开销尚未实测，默认关闭
+#define MIC_SAMPLE_RATE           16000          // 须与 ClapDetector 的帧长（160 采样 = 10ms）一致
+#define MIC_GAIN_SHIFT            14             // 32 位槽内 24 位数据右移到 16 位，数值越小灵敏度越高
+#define MIC_TASK_CORE             0              // 与音频任务（核心 1）分开
+#define MIC_TASK_PRIORITY         2
+#define MIC_CPU_BUDGET_US         500            // 每 10ms 帧的处理预算（核心 0 的 5%），超出计数并报告
+
+// ---- 网络电台 -----
+#define STREAM_BUFFER_SIZE        (512 * 1024)   // 抖动缓冲（PSRAM），128kbps 约 32 秒
+#define STREAM_TASK_CORE          0              // 网络收发与 WiFi 协议栈同核，不占音频核心
+#define STREAM_TASK_PRIORITY      2
+#define STREAM_TASK_STACK         4096
+#define STREAM_DECODER_LEAD       16384          // 解码器输入缓冲最多预取的字节，其余留在抖动缓冲中计入深度
+#define STREAM_START_MS           400            // 快速起播：缓冲达到此深度即打开解码器
+#define STREAM_MIN_TARGET_MS      1000           // 自适应目标深度的上下限
+#define STREAM_MAX_TARGET_MS      10000
+#define STREAM_GROW_SPEED         0.96f          // 深度低于目标时的播放速度（经 TimeStretch），补足后恢复原速
+#define STREAM_REPORT_MS          10000          // 串口健康报告周期
@@ -0,0 +1,181 @@
+#include "AudioTask.h"
+#include <SD.h>
+#include "config.h"
+#include "diag/TraceRecorder.h"
+
+AudioTask::AudioTask()
+    : _audio(nullptr), _stretch(nullptr), _task(nullptr), _queue(nullptr), _done(nullptr), _result(false), _fs(&SD),
+      _lastLoopUs(0), _missed(0), _maxGapUs(0), _maxWorkUs(0), _maxCommandUs(0), _lastReportMs(0), _watchCount(0) {
+    _path[0] = '\0';
+}
+
+void AudioTask::begin(Audio &audio, TimeStretch &stretch) {
+    _audio = &audio;
+    _stretch = &stretch;
+    _queue = xQueueCreate(8, sizeof(Command));
+    _done = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(taskEntry, "audio", AUDIO_TASK_STACK, this, AUDIO_TASK_PRIORITY, &_task, AUDIO_TASK_CORE);
+    watchStack("audio", _task);
+    _lastReportMs = millis();
+}
+
+void AudioTask::taskEntry(void *arg) {
+    ((AudioTask *)arg)->run();
+}
+
+void AudioTask::run() {
+    Command cmd;
+    while (true) {
+        while (xQueueReceive(_queue, &cmd, 0) == pdTRUE) {
+            execute(cmd);
+        }
+
+        uint32_t start = micros();
+        if (_lastLoopUs != 0) {
+            uint32_t gap = start - _lastLoopUs;
+            if (gap > _maxGapUs) _maxGapUs = gap;
+            if (gap > AUDIO_TASK_DEADLINE_MS * 1000UL) {
+                _missed++;
+                trace(TRACE_DEADLINE, 0, 0, gap);
+            }
+        }
+
+        if (_beginHook) _beginHook();
+        _audio->loop();
+        bool running = _audio->isRunning();
+        if (_endHook) _endHook(running);
+
+        uint32_t end = micros();
+        if (end - start > _maxWorkUs) _maxWorkUs = end - start;
+        _lastLoopUs = running ? end : 0;
+
+        if (running) {
+            vTaskDelay(1); // 让出同核心的 loop()，DMA 余量远大于 1 tick
+        } else {
+            // 暂停 / 播完：阻塞到有新命令（超时仍跑一轮 loop，交给库收尾）
+            xQueuePeek(_queue, &cmd, pdMS_TO_TICKS(AUDIO_TASK_IDLE_MS));
+        }
+    }
+}
+
+void AudioTask::execute(const Command &cmd) {
+    uint32_t latency = micros() - cmd.postedUs;
+    if (latency > _maxCommandUs) _maxCommandUs = latency;
+
+    switch (cmd.type) {
+        case CMD_CONNECT:
+        case CMD_CONNECT_PAUSED:
+            _stretch->reset();
+            _result = _audio->connecttoFS(*_fs, _path, cmd.arg);
+            // 打开与暂停之间没有 audio.loop()，不会解码出第一块
+            if (_result && cmd.type == CMD_CONNECT_PAUSED) _audio->pauseResume();
+            _lastLoopUs = 0; // 打开文件本身耗时，不计入截止期
+            break;
+        case CMD_PAUSE_RESUME:
+            _audio->pauseResume();
+            _result = _audio->isRunning();
+            _lastLoopUs = 0;
+            break;
+        case CMD_VOLUME:
+            _audio->setVolume(cmd.arg);
+            break;
+        case CMD_SEEK_FILE_POS:
+            _stretch->reset();
+            _audio->setFilePos(cmd.arg);
+            break;
+        case CMD_SEEK_SECONDS:
+            _stretch->reset();
+            _audio->setAudioPlayPosition(cmd.arg);
+            break;
+        case CMD_SPEED:
+            _stretch->setSpeed(cmd.speed);
+            break;
+        case CMD_STOP:
+            _audio->stopSong();
+            break;
+    }
+    if (cmd.sync) xSemaphoreGive(_done);
+}
+
+// 任务启动前（setup 早期）直接执行，保持原有调用顺序
+bool AudioTask::call(Command cmd) {
+    cmd.sync = true;
+    cmd.postedUs = micros();
+    if (!_task) {
+        cmd.sync = false;
+        execute(cmd);
+        return _result;
+    }
+    xQueueSend(_queue, &cmd, portMAX_DELAY);
+    xSemaphoreTake(_done, portMAX_DELAY);
+    return _result;
+}
+
+void AudioTask::post(Command cmd) {
+    cmd.sync = false;
+    cmd.postedUs = micros();
+    if (!_task) {
+        execute(cmd);
+        return;
+    }
+    xQueueSend(_queue, &cmd, portMAX_DELAY);
+}
+
+bool AudioTask::connect(const char *path, uint32_t resumeFilePos, bool paused) {
+    return connect(SD, path, resumeFilePos, paused);
+}
+
+bool AudioTask::connect(fs::FS &fs, const char *path, uint32_t resumeFilePos, bool paused) {
+    _fs = &fs;
+    strncpy(_path, path, kPathMax - 1);
+    _path[kPathMax - 1] = '\0';
+    return call({ paused ? CMD_CONNECT_PAUSED : CMD_CONNECT, true, resumeFilePos, 0, 0 });
+}
+
+void AudioTask::stop() {
+    call({ CMD_STOP, true, 0, 0, 0 });
+}
+
+bool AudioTask::pauseResume() {
+    return call({ CMD_PAUSE_RESUME, true, 0, 0, 0 });
+}
+
+void AudioTask::setVolume(uint8_t volume) {
+    post({ CMD_VOLUME, false, volume, 0, 0 });
+}
+
+void AudioTask::seekFilePos(uint32_t pos) {
+    call({ CMD_SEEK_FILE_POS, true, pos, 0, 0 });
+}
+
+void AudioTask::seekSeconds(uint16_t second) {
+    call({ CMD_SEEK_SECONDS, true, second, 0, 0 });
+}
+
+void AudioTask::setSpeed(float speed) {
+    call({ CMD_SPEED, true, 0, speed, 0 });
+}
+
+void AudioTask::watchStack(const char *name, TaskHandle_t task) {
+    if (!task || _watchCount >= kMaxWatch) return;
+    _watchNames[_watchCount] = name;
+    _watchTasks[_watchCount] = task;
+    _watchCount++;
+}
+
+void AudioTask::report() {
+    uint32_t now = millis();
+    if (now - _lastReportMs < AUDIO_TASK_REPORT_MS) return;
+    _lastReportMs = now;
+
+    Serial.printf("Audio task: missed %u (> %u ms), max gap %u ms, max decode %u us, max cmd latency %u us\n",
+                  (unsigned)_missed, (unsigned)AUDIO_TASK_DEADLINE_MS, (unsigned)(_maxGapUs / 1000),
+                  (unsigned)_maxWorkUs, (unsigned)_maxCommandUs);
+    for (int i = 0; i < _watchCount; i++) {
+        Serial.printf("  stack free %-6s %u bytes\n", _watchNames[i], (unsigned)uxTaskGetStackHighWaterMark(_watchTasks[i]));
+    }
+    // 峰值按报告窗口统计，错过次数累计
+    _maxGapUs = 0;
+    _maxWorkUs = 0;
+    _maxCommandUs = 0;
+}
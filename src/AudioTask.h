@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "Audio.h"
+#include "dsp/TimeStretch.h"
+
+// 独立音频任务：解码与 I2S 送数从 loop() 中移出，跑在固定核心的高优先级任务里，
+// 屏幕刷新、SD 扫描、模式切换再慢也不会让 DMA 饿死。
+//
+// 调度约定：
+//   - 只有本任务调用 audio 的修改类接口（connect / stop / pauseResume / seek / setVolume）与
+//     timeStretch.setSpeed / reset；其他任务一律通过命令队列提交。
+//   - 命令只有一个发起方（主循环）。需要结果或顺序保证的命令同步等待任务执行完毕；
+//     音量为异步命令，连续按键不阻塞主循环。
+//   - isRunning() / 当前时间 / 码率等只读接口可在任意任务直接读取（快照，允许旧一帧）。
+//   - 库的 EOF 回调在本任务中执行，只能设置标志，由主循环处理换曲。
+//   - 播放中每轮循环至少让出 1 tick；暂停时阻塞在队列上，不占 CPU。
+// 主机上的调度模拟见 test/audio_task_test.cpp。
+class AudioTask {
+public:
+    using Hook = std::function<void()>;
+    using EndHook = std::function<void(bool running)>;
+
+    AudioTask();
+    void begin(Audio &audio, TimeStretch &stretch);
+
+    // 每次 audio.loop() 前后回调，在音频任务中执行（主机测试据此观察调度）
+    void onLoopBegin(Hook cb) { _beginHook = cb; }
+    void onLoopEnd(EndHook cb) { _endHook = cb; }
+
+    // ---- 命令（主循环调用） ----
+    // 同步，返回是否打开成功（SD 卡）。paused：打开后立即暂停，同一命令内完成，中间不解码、不出声
+    bool connect(const char *path, uint32_t resumeFilePos, bool paused = false);
+    bool connect(fs::FS &fs, const char *path, uint32_t resumeFilePos, bool paused = false); // 同步，任意文件系统（网络电台的虚拟文件）
+    void stop();                                            // 同步，关闭当前文件
+    bool pauseResume();                                     // 同步，返回执行后是否在播放
+    void setVolume(uint8_t volume);                         // 异步
+    void seekFilePos(uint32_t pos);                         // 同步
+    void seekSeconds(uint16_t second);                      // 同步
+    void setSpeed(float speed);                             // 同步
+
+    // ---- 诊断 ----
+    void watchStack(const char *name, TaskHandle_t task); // 纳入栈高水位报告（最多 kMaxWatch 个）
+    void report();                                         // 主循环周期调用，按 AUDIO_TASK_REPORT_MS 输出
+    uint32_t getMissedDeadlines() const { return _missed; }
+
+private:
+    enum CommandType : uint8_t {
+        CMD_CONNECT,
+        CMD_CONNECT_PAUSED,
+        CMD_PAUSE_RESUME,
+        CMD_VOLUME,
+        CMD_SEEK_FILE_POS,
+        CMD_SEEK_SECONDS,
+        CMD_SPEED,
+        CMD_STOP,
+    };
+
+    struct Command {
+        CommandType type;
+        bool sync;
+        uint32_t arg;
+        float speed;
+        uint32_t postedUs; // 入队时间，统计命令延迟
+    };
+
+    static const int kMaxWatch = 5;
+    static const size_t kPathMax = 256;
+
+    static void taskEntry(void *arg);
+    void run();
+    void execute(const Command &cmd);
+    bool call(Command cmd);
+    void post(Command cmd);
+
+    Audio *_audio;
+    TimeStretch *_stretch;
+    TaskHandle_t _task;
+    QueueHandle_t _queue;
+    SemaphoreHandle_t _done; // 同步命令完成信号
+    volatile bool _result;
+    char _path[kPathMax];    // CMD_CONNECT(_PAUSED) 的路径与文件系统：同步命令，执行完成前发起方不会改写
+    fs::FS *_fs;
+
+    Hook _beginHook;
+    EndHook _endHook;
+
+    // 截止期统计：两次 audio.loop() 的间隔超过 AUDIO_TASK_DEADLINE_MS 即记为一次错过
+    uint32_t _lastLoopUs;
+    volatile uint32_t _missed;
+    volatile uint32_t _maxGapUs;
+    volatile uint32_t _maxWorkUs;
+    volatile uint32_t _maxCommandUs;
+    uint32_t _lastReportMs;
+
+    const char *_watchNames[kMaxWatch];
+    TaskHandle_t _watchTasks[kMaxWatch];
+    int _watchCount;
+};
@@ -0,0 +1,155 @@
+#include "BookmarkStore.h"
+#include "util/Crc32.h"
+
+// 过期记录超过 (有效条目 + 此值) 时压缩
+#define BOOKMARK_COMPACT_SLACK 128
+
+BookmarkStore::BookmarkStore() : _fs(nullptr), _logRecords(0), _tornTail(false) {}
+
+uint32_t BookmarkStore::recordCrc(const Record &r) {
+    return crc32(&r, offsetof(Record, crc));
+}
+
+bool BookmarkStore::begin(fs::FS &fs, const char *path) {
+    _fs = &fs;
+    _path = path;
+    _tmpPath = _path + ".tmp";
+    _bakPath = _path + ".bak";
+    _entries.clear();
+    _logRecords = 0;
+    _tornTail = false;
+
+    // 压缩提交过程中断电：日志缺失时 .tmp 即为新版本（旧日志只在 .tmp 写完并核对后才挪成 .bak；
+    // 此前没有日志时 .tmp 可能不完整，逐条 CRC 会截掉坏尾），没有 .tmp 则退回 .bak。
+    // 日志存在时残留的 .tmp / .bak 都已无用
+    if (!_fs->exists(_path.c_str())) {
+        if (_fs->exists(_tmpPath.c_str())) {
+            _fs->rename(_tmpPath.c_str(), _path.c_str());
+        } else if (_fs->exists(_bakPath.c_str())) {
+            _fs->rename(_bakPath.c_str(), _path.c_str());
+        }
+    }
+    if (_fs->exists(_tmpPath.c_str())) _fs->remove(_tmpPath.c_str());
+    if (_fs->exists(_bakPath.c_str())) _fs->remove(_bakPath.c_str());
+
+    File f = _fs->open(_path.c_str());
+    if (!f) return true; // 尚无日志
+
+    size_t fileSize = f.size();
+    size_t validBytes = 0;
+    Record r;
+    while (f.read((uint8_t *)&r, sizeof(r)) == sizeof(r)) {
+        if (r.crc != recordCrc(r)) break;
+        if (r.value == 0) {
+            _entries.erase(r.key);
+        } else {
+            _entries[r.key] = r.value;
+        }
+        _logRecords++;
+        validBytes += sizeof(r);
+    }
+    f.close();
+
+    Serial.printf("Bookmarks: %u entries, %u log records\n", (unsigned)_entries.size(), (unsigned)_logRecords);
+
+    // 尾部不完整（写入时断电），重写以丢弃坏尾；此时失败（如卡满）则在下次追加前重试，
+    // 否则新记录会接在坏尾之后而无法读回
+    if (validBytes != fileSize) {
+        Serial.printf("Bookmarks: dropping %u bytes of torn log tail\n", (unsigned)(fileSize - validBytes));
+        _tornTail = true;
+        compact();
+    }
+    return true;
+}
+
+bool BookmarkStore::get(uint64_t key, uint64_t &value) const {
+    auto it = _entries.find(key);
+    if (it == _entries.end()) return false;
+    value = it->second;
+    return true;
+}
+
+void BookmarkStore::put(uint64_t key, uint64_t value) {
+    auto it = _entries.find(key);
+    if (value == 0) {
+        if (it == _entries.end()) return;
+        _entries.erase(it);
+    } else {
+        if (it != _entries.end() && it->second == value) return;
+        _entries[key] = value;
+    }
+
+    Record r = { key, value, 0 };
+    r.crc = recordCrc(r);
+    append(r);
+
+    if (_logRecords > _entries.size() + BOOKMARK_COMPACT_SLACK) {
+        compact();
+    }
+}
+
+bool BookmarkStore::append(const Record &r) {
+    if (!_fs) return false;
+    if (_tornTail) return compact(); // 重写的内容已包含这次修改
+    File f = _fs->open(_path.c_str(), FILE_APPEND);
+    if (!f) {
+        Serial.println("Bookmarks: append failed");
+        return false;
+    }
+    bool ok = f.write((const uint8_t *)&r, sizeof(r)) == sizeof(r);
+    f.close();
+    _logRecords++;
+    if (!ok) {
+        // 短写（卡满）留下坏尾：下次追加前先整体重写
+        Serial.println("Bookmarks: append failed");
+        _tornTail = true;
+    }
+    return ok;
+}
+
+bool BookmarkStore::compact() {
+    if (!_fs) return false;
+
+    // 先完整写入临时文件并核对长度：短写（卡满）或断电都不会动到现有日志
+    File f = _fs->open(_tmpPath.c_str(), FILE_WRITE);
+    if (!f) {
+        Serial.println("Bookmarks: compaction failed");
+        return false;
+    }
+    bool ok = true;
+    for (const auto &e : _entries) {
+        Record r = { e.first, e.second, 0 };
+        r.crc = recordCrc(r);
+        if (f.write((const uint8_t *)&r, sizeof(r)) != sizeof(r)) {
+            ok = false;
+            break;
+        }
+    }
+    ok = ok && f.size() == _entries.size() * sizeof(Record);
+    f.close();
+    if (!ok) {
+        Serial.println("Bookmarks: compaction failed, keeping the old log");
+        _fs->remove(_tmpPath.c_str());
+        return false;
+    }
+
+    // 提交：FAT 的 rename 不能覆盖已有文件，先把旧日志挪成 .bak，新日志就位后再删除
+    if (_fs->exists(_path.c_str())) {
+        _fs->remove(_bakPath.c_str());
+        if (!_fs->rename(_path.c_str(), _bakPath.c_str())) {
+            Serial.println("Bookmarks: compaction failed, keeping the old log");
+            _fs->remove(_tmpPath.c_str());
+            return false;
+        }
+    }
+    if (!_fs->rename(_tmpPath.c_str(), _path.c_str())) {
+        Serial.println("Bookmarks: failed to commit compaction");
+        _fs->rename(_bakPath.c_str(), _path.c_str());
+        return false;
+    }
+    _fs->remove(_bakPath.c_str());
+    _logRecords = _entries.size();
+    _tornTail = false;
+    Serial.printf("Bookmarks: compacted to %u records\n", (unsigned)_logRecords);
+    return true;
+}
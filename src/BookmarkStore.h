@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <unordered_map>
+#include "util/CountingAllocator.h"
+
+// 书签库：key/value 均为 64 位，持久化为 SD 卡上的追加日志
+// 每次更新只追加一条 20 字节记录（带 CRC），断电最多丢失最后一条；
+// 加载时遇到截断或校验失败的记录即停止，并通过压缩重写去掉坏尾。
+// 日志中的过期记录超过阈值后压缩：完整写入 .tmp 并核对长度 → 旧日志挪成 .bak → .tmp 改名 → 删除 .bak；
+// 写入失败（卡满）时保留旧日志，提交中途断电则在加载时按残留文件恢复。
+class BookmarkStore {
+public:
+    BookmarkStore();
+
+    bool begin(fs::FS &fs, const char *path = "/.bookmarks.log");
+    bool get(uint64_t key, uint64_t &value) const;
+    void put(uint64_t key, uint64_t value); // value 为 0 表示删除
+    void remove(uint64_t key) { put(key, 0); }
+    bool compact();
+    size_t size() const { return _entries.size(); }
+
+private:
+    struct Record {
+        uint64_t key;
+        uint64_t value;
+        uint32_t crc;
+    } __attribute__((packed));
+
+    static uint32_t recordCrc(const Record &r);
+    bool append(const Record &r);
+
+    fs::FS *_fs;
+    String _path;
+    String _tmpPath;
+    String _bakPath;
+    std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                       CountingAllocator<std::pair<const uint64_t, uint64_t>, MEM_CACHE>> _entries;
+    size_t _logRecords; // 日志中的记录条数（含过期记录）
+    bool _tornTail;     // 日志尾部有坏记录且尚未重写
+};
@@ -1,66 +1,84 @@
 #include "InputManager.h"
 #include "config.h"
+#include "diag/TraceRecorder.h"
+#include "input/EdgeRing.h"
+#include <driver/gpio.h>
+#include <esp_timer.h>
 
-InputManager::InputManager() {
-    btnMode = new OneButton(MODEL_BUTTON_GPIO, true, true);
-    btnVolUp = new OneButton(VOLUME_UP_BUTTON_GPIO, true, true);
-    btnVolDown = new OneButton(VOLUME_DOWN_BUTTON_GPIO, true, true);
+#define EDGE_QUEUE_SIZE 32
+static const gpio_num_t kButtonPins[] = { MODEL_BUTTON_GPIO, VOLUME_UP_BUTTON_GPIO, VOLUME_DOWN_BUTTON_GPIO };
+static EdgeRing<EDGE_QUEUE_SIZE> s_edges;
+
+void IRAM_ATTR InputManager::onEdgeIsr(void *arg) {
+    uint8_t button = (uint8_t)(uintptr_t)arg;
+    s_edges.push(button, gpio_get_level(kButtonPins[button]) == 0, // 低电平有效
+                 (uint32_t)(esp_timer_get_time() / 1000));
 }
 
-void InputManager::begin() {
-    // Mode Button
-    btnMode->attachClick([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_playPauseCb) self->_playPauseCb();
-    }, this);
+InputManager::InputManager() {}
 
-    btnMode->attachDoubleClick([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_modeDoubleCb) self->_modeDoubleCb();
-    }, this);
+void InputManager::begin() {
+    for (uint8_t i = 0; i < BTN_COUNT; i++) {
+        pinMode(kButtonPins[i], INPUT_PULLUP);
+        attachInterruptArg(kButtonPins[i], onEdgeIsr, (void *)(uintptr_t)i, CHANGE);
+    }
+}
 
-    btnMode->attachLongPressStart([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_funcLongPressCb) self->_funcLongPressCb();
-    }, this);
+void InputManager::loop() {
+    // 按时间顺序回放边沿，判定只依赖中断时间戳
+    ButtonEdge e;
+    while (s_edges.pop(e)) {
+        _recognizer.onEdge(e.button, e.pressed, e.timeMs);
+    }
 
-    // Volume Up
-    btnVolUp->attachClick([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_volUpCb) self->_volUpCb();
-    }, this);
-    
-    btnVolUp->attachDoubleClick([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_nextSongCb) self->_nextSongCb();
-    }, this);
+    // 去抖到期时以实际电平复核（队列溢出丢掉的边沿由此补回）
+    bool levels[GestureRecognizer::kMaxButtons] = {};
+    for (uint8_t i = 0; i < BTN_COUNT; i++) levels[i] = gpio_get_level(kButtonPins[i]) == 0;
+    _recognizer.tick((uint32_t)(esp_timer_get_time() / 1000), levels);
 
-    btnVolUp->attachLongPressStart([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_nextModeCb) self->_nextModeCb();
-    }, this);
+    Gesture g;
+    while (_recognizer.poll(g)) {
+        dispatch(g);
+    }
+}
 
-    // Volume Down
-    btnVolDown->attachClick([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_volDownCb) self->_volDownCb();
-    }, this);
-    
-    btnVolDown->attachDoubleClick([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_prevSongCb) self->_prevSongCb();
-    }, this);
+void InputManager::dispatch(const Gesture &g) {
+    trace(TRACE_BUTTON, g.type, g.button | (g.buttons << 8), g.clicks);
+    if (_activityCb) _activityCb();
 
-    btnVolDown->attachLongPressStart([](void *scope) {
-        InputManager *self = (InputManager *)scope;
-        if (self->_prevModeCb) self->_prevModeCb();
-    }, this);
-}
+    if (g.type == GESTURE_CHORD) {
+        // Vol+ & Vol-
+        if (g.buttons == ((1 << BTN_VOL_UP) | (1 << BTN_VOL_DOWN)) && _volChordCb) _volChordCb();
+        // Mode & Vol-
+        if (g.buttons == ((1 << BTN_MODE) | (1 << BTN_VOL_DOWN)) && _sleepTimerCb) _sleepTimerCb();
+        // Mode & Vol+
+        if (g.buttons == ((1 << BTN_MODE) | (1 << BTN_VOL_UP)) && _browseCb) _browseCb();
+        return;
+    }
 
-void InputManager::loop() {
-    btnMode->tick();
-    btnVolUp->tick();
-    btnVolDown->tick();
+    Callback *cb = nullptr;
+    switch (g.button) {
+        case BTN_MODE:
+            if (g.type == GESTURE_LONG_PRESS) cb = &_funcLongPressCb;
+            else if (g.clicks == 1) cb = &_playPauseCb;
+            else if (g.clicks == 2) cb = &_modeDoubleCb;
+            else if (g.clicks == 3) cb = &_speedCb;
+            else if (g.clicks == 4) cb = &_abRepeatCb;
+            break;
+        case BTN_VOL_UP:
+            if (g.type == GESTURE_LONG_PRESS) cb = &_nextModeCb;
+            else if (g.clicks == 1) cb = &_volUpCb;
+            else if (g.clicks == 2) cb = &_nextSongCb;
+            else if (g.clicks == 3) cb = &_seekFwdCb;
+            break;
+        case BTN_VOL_DOWN:
+            if (g.type == GESTURE_LONG_PRESS) cb = &_prevModeCb;
+            else if (g.clicks == 1) cb = &_volDownCb;
+            else if (g.clicks == 2) cb = &_prevSongCb;
+            else if (g.clicks == 3) cb = &_seekBackCb;
+            break;
+    }
+    if (cb && *cb) (*cb)();
 }
 
 void InputManager::onPlayPause(Callback cb) { _playPauseCb = cb; }
@@ -72,3 +90,11 @@ void InputManager::onNextSong(Callback cb) { _nextSongCb = cb; }
 void InputManager::onPrevSong(Callback cb) { _prevSongCb = cb; }
 void InputManager::onNextMode(Callback cb) { _nextModeCb = cb; }
 void InputManager::onPrevMode(Callback cb) { _prevModeCb = cb; }
+void InputManager::onSpeedCycle(Callback cb) { _speedCb = cb; }
+void InputManager::onABRepeat(Callback cb) { _abRepeatCb = cb; }
+void InputManager::onSeekForward(Callback cb) { _seekFwdCb = cb; }
+void InputManager::onSeekBackward(Callback cb) { _seekBackCb = cb; }
+void InputManager::onVolumeChord(Callback cb) { _volChordCb = cb; }
+void InputManager::onSleepTimer(Callback cb) { _sleepTimerCb = cb; }
+void InputManager::onBrowse(Callback cb) { _browseCb = cb; }
+void InputManager::onActivity(Callback cb) { _activityCb = cb; }
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <Arduino.h>
-#include <OneButton.h>
 #include <functional>
+#include "input/GestureRecognizer.h"
 
 class InputManager {
 public:
     using Callback = std::function<void()>;
+    enum ButtonId : uint8_t { BTN_MODE, BTN_VOL_UP, BTN_VOL_DOWN, BTN_COUNT };
 
     InputManager();
     void begin();
@@ -21,11 +22,23 @@ public:
     void onPrevSong(Callback cb); // Double Click
     void onNextMode(Callback cb); // Long Press
     void onPrevMode(Callback cb); // Long Press
+    void onSpeedCycle(Callback cb); // Triple Click Mode
+    void onABRepeat(Callback cb); // 4x Click Mode
+    void onSeekForward(Callback cb); // Triple Click Vol+
+    void onSeekBackward(Callback cb); // Triple Click Vol-
+    void onVolumeChord(Callback cb); // Vol+ & Vol- together
+    void onSleepTimer(Callback cb); // Mode & Vol- together
+    void onBrowse(Callback cb); // Mode & Vol+ together
+    void onActivity(Callback cb); // Any gesture (before dispatch)
+
+    // 按键当前是否按住（长按后持续滚动用，以已分发的边沿为准）
+    bool isHeld(uint8_t button) const { return _recognizer.isPressed(button); }
 
 private:
-    OneButton *btnMode;
-    OneButton *btnVolUp;
-    OneButton *btnVolDown;
+    static void IRAM_ATTR onEdgeIsr(void *arg);
+    void dispatch(const Gesture &g);
+
+    GestureRecognizer _recognizer;
 
     Callback _playPauseCb;
     Callback _modeDoubleCb;
@@ -36,4 +49,12 @@ private:
     Callback _prevSongCb;
     Callback _nextModeCb;
     Callback _prevModeCb;
+    Callback _speedCb;
+    Callback _abRepeatCb;
+    Callback _seekFwdCb;
+    Callback _seekBackCb;
+    Callback _volChordCb;
+    Callback _sleepTimerCb;
+    Callback _browseCb;
+    Callback _activityCb;
 };
@@ -0,0 +1,95 @@
+#include "LedEngine.h"
+#include <string.h>
+
+static uint8_t lerp8(uint8_t a, uint8_t b, uint32_t t) { // t: 0..256
+    return (uint8_t)(((uint32_t)a * (256 - t) + (uint32_t)b * t) >> 8);
+}
+
+LedEngine::LedEngine() {
+    memset(_layers, 0, sizeof(_layers));
+}
+
+void LedEngine::play(LedLayer layer, const LedKeyframe *frames, size_t count, uint16_t repeat, uint32_t nowMs) {
+    Timeline &t = _layers[layer];
+    if (count > kMaxKeyframes) count = kMaxKeyframes;
+    if (count == 0) {
+        t.active = false;
+        return;
+    }
+    memcpy(t.frames, frames, count * sizeof(LedKeyframe));
+    t.count = count;
+    t.repeat = repeat;
+    t.start = nowMs;
+    t.active = true;
+}
+
+void LedEngine::blink(LedLayer layer, int times, LedColor color, uint32_t nowMs, uint16_t onMs, uint16_t offMs) {
+    const LedColor off = { 0, 0, 0 };
+    LedKeyframe frames[3] = {
+        { 0, color, 255, LED_EASE_STEP },
+        { onMs, off, 255, LED_EASE_STEP },
+        { (uint32_t)onMs + offMs, off, 255, LED_EASE_STEP },
+    };
+    play(layer, frames, 3, times > 0 ? times : 1, nowMs);
+}
+
+void LedEngine::stop(LedLayer layer) {
+    _layers[layer].active = false;
+}
+
+bool LedEngine::sample(Timeline &t, uint32_t nowMs, LedColor &color, uint8_t &alpha) {
+    if (!t.active) return false;
+
+    int32_t delta = (int32_t)(nowMs - t.start);
+    uint32_t elapsed = delta > 0 ? delta : 0; // 尚未开始的时间轴停在首帧
+    uint32_t duration = t.frames[t.count - 1].timeMs;
+    if (duration == 0 || t.count == 1) {
+        color = t.frames[0].color;
+        alpha = t.frames[0].alpha;
+        return true;
+    }
+
+    if (t.repeat && elapsed / duration >= t.repeat) {
+        t.active = false;
+        return false;
+    }
+    uint32_t pos = elapsed % duration;
+
+    size_t k = 0;
+    while (k + 2 < t.count && t.frames[k + 1].timeMs <= pos) k++;
+    const LedKeyframe &a = t.frames[k];
+    const LedKeyframe &b = t.frames[k + 1];
+
+    uint32_t span = b.timeMs - a.timeMs;
+    uint32_t x = span ? ((pos - a.timeMs) << 8) / span : 256; // 0..256
+    switch (b.easing) {
+        case LED_EASE_STEP:
+            x = 0;
+            break;
+        case LED_EASE_IN_OUT:
+            x = (x * x * (3 * 256 - 2 * x)) >> 16; // smoothstep
+            break;
+        case LED_EASE_LINEAR:
+            break;
+    }
+
+    color.r = lerp8(a.color.r, b.color.r, x);
+    color.g = lerp8(a.color.g, b.color.g, x);
+    color.b = lerp8(a.color.b, b.color.b, x);
+    alpha = lerp8(a.alpha, b.alpha, x);
+    return true;
+}
+
+LedColor LedEngine::render(uint32_t nowMs) {
+    LedColor out = { 0, 0, 0 };
+    for (int i = 0; i < LED_LAYER_COUNT; i++) {
+        LedColor c;
+        uint8_t alpha;
+        if (!sample(_layers[i], nowMs, c, alpha)) continue;
+        uint32_t t = alpha + (alpha >> 7); // 0..255 → 0..256
+        out.r = lerp8(out.r, c.r, t);
+        out.g = lerp8(out.g, c.g, t);
+        out.b = lerp8(out.b, c.b, t);
+    }
+    return out;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 时间轴 LED 灯效引擎（纯 C++，不依赖 Arduino）
+// 每个图层播放一组关键帧，按图层优先级从低到高做 alpha 混合：
+// 通知闪烁 (NOTIFY) 叠加在彩虹底色 (BASE) 之上，结束后自动露出底色。
+// render() 只做插值计算，不阻塞，由定时任务按固定帧率调用。
+
+struct LedColor {
+    uint8_t r, g, b;
+    bool operator==(const LedColor &o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const LedColor &o) const { return !(*this == o); }
+};
+
+enum LedEasing : uint8_t {
+    LED_EASE_STEP,   // 保持上一帧颜色直到本帧
+    LED_EASE_LINEAR,
+    LED_EASE_IN_OUT, // smoothstep
+};
+
+// easing 描述从上一帧过渡到本帧的方式
+struct LedKeyframe {
+    uint32_t timeMs;
+    LedColor color;
+    uint8_t alpha;
+    LedEasing easing;
+};
+
+enum LedLayer {
+    LED_LAYER_BASE,   // 播放状态底色
+    LED_LAYER_NOTIFY, // 操作反馈
+    LED_LAYER_COUNT
+};
+
+class LedEngine {
+public:
+    static const size_t kMaxKeyframes = 16;
+
+    LedEngine();
+
+    // repeat 为 0 表示无限循环
+    void play(LedLayer layer, const LedKeyframe *frames, size_t count, uint16_t repeat, uint32_t nowMs);
+    void blink(LedLayer layer, int times, LedColor color, uint32_t nowMs, uint16_t onMs = 100, uint16_t offMs = 100);
+    void stop(LedLayer layer);
+    bool isActive(LedLayer layer) const { return _layers[layer].active; }
+
+    LedColor render(uint32_t nowMs);
+
+private:
+    struct Timeline {
+        LedKeyframe frames[kMaxKeyframes];
+        size_t count;
+        uint16_t repeat;
+        uint32_t start;
+        bool active;
+    };
+
+    bool sample(Timeline &t, uint32_t nowMs, LedColor &color, uint8_t &alpha);
+
+    Timeline _layers[LED_LAYER_COUNT];
+};
@@ -0,0 +1,184 @@
+#include "ModeManifest.h"
+#include <stdlib.h>
+#include <strings.h>
+#include "util/PathHash.h"
+
+static std::string trim(const std::string &s) {
+    size_t b = 0, e = s.size();
+    while (b < e && (s[b] == ' ' || s[b] == '\t' || s[b] == '\r')) b++;
+    while (e > b && (s[e - 1] == ' ' || s[e - 1] == '\t' || s[e - 1] == '\r')) e--;
+    return s.substr(b, e - b);
+}
+
+// 去掉行尾注释（# 或 ;），双引号内的不算
+static void stripComment(std::string &line) {
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        if (line[i] == '"') quoted = !quoted;
+        else if (!quoted && (line[i] == '#' || line[i] == ';')) {
+            line.erase(i);
+            return;
+        }
+    }
+}
+
+static std::string unquote(const std::string &s) {
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"') return s.substr(1, s.size() - 2);
+    return s;
+}
+
+void ModeManifest::error(int line, const std::string &msg) {
+    _errors.push_back("line " + std::to_string(line) + ": " + msg);
+}
+
+bool ModeManifest::setKey(ModeConfig &mode, const std::string &key, const std::string &value) {
+    if (key == "path") {
+        mode.path = value;
+    } else if (key == "shuffle") {
+        if (value == "random") mode.shuffle = SHUFFLE_RANDOM;
+        else if (value == "sequential") mode.shuffle = SHUFFLE_SEQUENTIAL;
+        else if (value == "album") mode.shuffle = SHUFFLE_ALBUM;
+        else if (value == "weighted") mode.shuffle = SHUFFLE_WEIGHTED;
+        else return false;
+    } else if (key == "dsp") {
+        if (value == "normal") mode.speed = 1.0f;
+        else if (value == "slow") mode.speed = 0.8f;
+        else if (value == "fast") mode.speed = 1.25f;
+        else {
+            char *end = nullptr;
+            float v = strtof(value.c_str(), &end);
+            if (end == value.c_str() || *end || v < 0.5f || v > 2.0f) return false;
+            mode.speed = v;
+        }
+    } else if (key == "stream") {
+        // 只支持明文 HTTP（Icecast / SHOUTcast），https 需要 TLS，内存与 CPU 都不够从容
+        if (value.size() <= 7 || strncasecmp(value.c_str(), "http://", 7) != 0) return false;
+        mode.streams.push_back(value);
+    } else if (key == "depth") {
+        char *end = nullptr;
+        long v = strtol(value.c_str(), &end, 10);
+        if (end == value.c_str() || *end || v < 0 || v > kMaxDepth) return false;
+        mode.depth = (uint8_t)v;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ModeManifest::setGlobal(const std::string &key, const std::string &value) {
+    if (key == "wifi_ssid") _wifiSsid = value;
+    else if (key == "wifi_password") _wifiPassword = value;
+    else return false;
+    return true;
+}
+
+bool ModeManifest::hasStreams() const {
+    for (const ModeConfig &mode : _modes) {
+        if (mode.isStream()) return true;
+    }
+    return false;
+}
+
+bool ModeManifest::validate(ModeConfig &mode, int line) {
+    if (mode.isStream()) {
+        // 电台模式不扫描 SD 卡，没有目录
+        if (!mode.path.empty()) {
+            error(line, "stream mode cannot have a path: " + mode.name);
+            return false;
+        }
+        if (_modes.size() >= kMaxModes) {
+            error(line, "too many modes");
+            return false;
+        }
+        return true;
+    }
+    if (mode.path.empty()) mode.path = "/" + mode.name;
+    if (mode.path[0] != '/') {
+        error(line, "path must start with '/': " + mode.path);
+        return false;
+    }
+    while (mode.path.size() > 1 && mode.path.back() == '/') mode.path.pop_back();
+    for (const ModeConfig &other : _modes) {
+        if (other.path == mode.path) {
+            error(line, "duplicate path: " + mode.path);
+            return false;
+        }
+    }
+    if (_modes.size() >= kMaxModes) {
+        error(line, "too many modes");
+        return false;
+    }
+    return true;
+}
+
+bool ModeManifest::parse(const char *text, size_t len) {
+    _modes.clear();
+    _errors.clear();
+    _wifiSsid.clear();
+    _wifiPassword.clear();
+    _hash = pathHash(text, len);
+
+    ModeConfig mode;
+    bool inMode = false;
+    int modeLine = 0;
+    int lineNo = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        size_t end = pos;
+        while (end < len && text[end] != '\n') end++;
+        std::string line(text + pos, end - pos);
+        pos = end + 1;
+        lineNo++;
+
+        // 去掉 UTF-8 BOM 与注释（# 或 ;）
+        if (lineNo == 1 && line.compare(0, 3, "\xEF\xBB\xBF") == 0) line.erase(0, 3);
+        stripComment(line);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        if (line[0] == '[') {
+            if (inMode && validate(mode, modeLine)) _modes.push_back(mode);
+            modeLine = lineNo;
+            if (line.back() != ']' || line.size() < 3) {
+                error(lineNo, "bad section header");
+                inMode = false;
+                continue;
+            }
+            mode = ModeConfig();
+            mode.name = trim(line.substr(1, line.size() - 2));
+            // 空名称的缺省路径是 "/"，会扫描整张卡
+            inMode = !mode.name.empty();
+            if (!inMode) error(lineNo, "empty mode name");
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            error(lineNo, "expected [mode] or key = value");
+            continue;
+        }
+        std::string key = trim(line.substr(0, eq));
+        std::string value = unquote(trim(line.substr(eq + 1)));
+        if (!inMode) {
+            // 第一个段之前只能是全局键
+            if (modeLine == 0 && setGlobal(key, value)) continue;
+            error(lineNo, modeLine == 0 ? "unknown global key: " + key : "expected [mode] or key = value");
+            continue;
+        }
+        if (!setKey(mode, key, value)) error(lineNo, "invalid " + key + ": " + value);
+    }
+    if (inMode && validate(mode, modeLine)) _modes.push_back(mode);
+
+    return !_modes.empty();
+}
+
+void ModeManifest::loadDefaults(const std::vector<std::string> &paths) {
+    _modes.clear();
+    _hash = 0;
+    for (const std::string &p : paths) {
+        ModeConfig mode;
+        mode.path = p;
+        mode.name = p.size() > 1 && p[0] == '/' ? p.substr(1) : p;
+        _modes.push_back(mode);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// 模式清单：SD 卡根目录 /modes.ini 定义任意数量的播放模式，固件与 tools/generate_playlist.py 共用。
+// 纯 C++，不依赖 Arduino，便于在主机上测试解析与校验。
+//
+//   # 注释；每个 [名称] 段是一个模式，按出现顺序编号，名称不能为空
+//   [故事]
+//   path    = /故事       ; 缺省为 "/" + 名称；含 # 或 ; 的路径必须加双引号，如 "/C# 入门"
+//   shuffle = random      ; random | sequential | album | weighted
+//   dsp     = slow        ; normal | slow | fast，或直接写倍速如 0.8
+//   depth   = 2           ; 子目录扫描深度 0-8
+//
+//   # 网络电台模式：一行一个 stream（仅 http://），没有 path / depth，不扫描 SD 卡
+//   wifi_ssid     = "my-wifi"   ; 全局键写在第一个段之前；带引号的值可以包含 # 和 ;
+//   wifi_password = "secret"
+//   [电台]
+//   stream = http://example.com:8000/live.mp3
+//   stream = http://example.com:8000/news.aac
+//
+// # 与 ; 在引号外一律开始注释，因此不加引号的值（包括路径）里不能出现这两个字符。
+// 清单原始字节的 FNV-1a 哈希写入每个播放列表缓存，清单变化后旧缓存自动失效。
+
+enum ShufflePolicy : uint8_t {
+    SHUFFLE_RANDOM,     // 全部打乱
+    SHUFFLE_SEQUENTIAL, // 按路径自然排序（章节、集数）
+    SHUFFLE_ALBUM,      // 目录之间打乱，目录内顺序播放
+    SHUFFLE_WEIGHTED,   // 越久没播放的越优先
+};
+
+struct ModeConfig {
+    std::string name;
+    std::string path;
+    ShufflePolicy shuffle = SHUFFLE_RANDOM;
+    float speed = 1.0f; // DSP 预设：该模式的默认播放速度
+    uint8_t depth = 2;
+    std::vector<std::string> streams; // 网络电台地址，非空即为电台模式
+
+    bool isStream() const { return !streams.empty(); }
+};
+
+class ModeManifest {
+public:
+    static const size_t kMaxModes = 16;
+    static const uint8_t kMaxDepth = 8;
+
+    // 解析成功（至少一个有效模式）返回 true；无法识别的行/键记入 errors() 但不致命
+    bool parse(const char *text, size_t len);
+    void loadDefaults(const std::vector<std::string> &paths); // 无清单时使用
+
+    const std::vector<ModeConfig> &modes() const { return _modes; }
+    const std::vector<std::string> &errors() const { return _errors; }
+    uint64_t hash() const { return _hash; } // 无清单时为 0
+    const std::string &wifiSsid() const { return _wifiSsid; }
+    const std::string &wifiPassword() const { return _wifiPassword; }
+    bool hasStreams() const;
+
+private:
+    bool setKey(ModeConfig &mode, const std::string &key, const std::string &value);
+    bool setGlobal(const std::string &key, const std::string &value);
+    bool validate(ModeConfig &mode, int line);
+    void error(int line, const std::string &msg);
+
+    std::vector<ModeConfig> _modes;
+    std::vector<std::string> _errors;
+    uint64_t _hash = 0;
+    std::string _wifiSsid;
+    std::string _wifiPassword;
+};
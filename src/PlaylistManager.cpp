@@ -3,11 +3,42 @@
 #include <algorithm>
 #include <random>
 #include <SD.h> // Ensure SD access
+#include <string.h>
+#include "util/PathHash.h"
+#include "util/Crc32.h"
+#include "diag/TraceRecorder.h"
+#include "playlist/CacheStore.h"
+#include "playlist/FatScanner.h"
+#include "playlist/DirGroups.h"
 
-PlaylistManager::PlaylistManager() : _currentModeIndex(-1), _currentSongIndex(-1) {}
+PlaylistManager::ModeData::ModeData()
+    : order(ArenaAllocator<uint32_t>(&arena)), orderPos(ArenaAllocator<uint32_t>(&arena)),
+      currentSongIndex(-1), validated(false), policy(&OrderPolicy::forType(SHUFFLE_RANDOM)),
+      cacheCrc(0), playsSinceSave(0), historyDirty(false), orderSeed(0), orderAge(0), lastUsed(0) {}
+
+PlaylistManager::PlaylistManager()
+    : _browseGeneration(0), _cur(nullptr), _pending(PathIndex::kNotFound), _lock(nullptr), _validateTask(nullptr),
+      _generation(0), _useClock(0), _modes(), _manifestHash(0), _currentModeIndex(-1) {}
+
+PlaylistManager::~PlaylistManager() {
+    for (ModeData *m : _slots) delete m;
+}
 
 void PlaylistManager::addMode(String path) {
-    _modes.push_back(path);
+    ModeConfig config;
+    config.path = path.c_str();
+    config.name = path.startsWith("/") ? path.substring(1).c_str() : path.c_str();
+    addMode(config);
+}
+
+void PlaylistManager::addMode(const ModeConfig &config) {
+    _modes.push_back(config);
+    _slots.push_back(nullptr);
+}
+
+const ModeConfig *PlaylistManager::getCurrentModeConfig() const {
+    if (_currentModeIndex < 0 || _currentModeIndex >= (int)_modes.size()) return nullptr;
+    return &_modes[_currentModeIndex];
 }
 
 void PlaylistManager::setMode(int index) {
@@ -26,33 +57,157 @@ void PlaylistManager::setMode(int index) {
         _prefs.end();
     }
     
-    // Clear playlist
-    _playlist.clear();
+    if (!_lock) _lock = xSemaphoreCreateMutex();
+    // 离开的模式先落盘播放历史与统计
+    if (_cur) {
+        for (int i = 0; i < (int)_slots.size(); i++) {
+            if (_slots[i] == _cur) savePlayed(*_cur, i, true);
+        }
+    }
+    _pending = PathIndex::kNotFound;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _generation++;
+
+    Serial.printf("Switching to mode: %s\n", _modes[index].name.c_str());
+    unsigned long start = micros();
+    bool resident = _slots[index] != nullptr;
+    if (!resident) {
+        _slots[index] = build(index);
+    } else {
+        trace(TRACE_CACHE, TRACE_CACHE_RESIDENT, index, _slots[index]->count());
+    }
+    // 常驻模式直接交换指针，保留它自己的打乱顺序和播放位置
+    _cur = _slots[index];
+    _cur->lastUsed = ++_useClock;
+    evict(index);
+    xSemaphoreGive(_lock);
+
+    unsigned long elapsed = micros() - start;
+    trace(TRACE_SECTION, TRACE_SEC_MODE_SWITCH, index, elapsed);
+    Serial.printf("Mode switch (%s) in %luus\n", resident ? "resident" : "built", elapsed);
+    printList();
+    if (!_cur->validated) startValidation();
+}
+
+bool PlaylistManager::preloadStep() {
+    if (!_lock) _lock = xSemaphoreCreateMutex();
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    int i = 0;
+    while (i < (int)_modes.size() && _slots[i]) i++;
+    bool full = residentBytes() >= memoryCap;
+    bool built = false;
+    if (i < (int)_modes.size() && !full) {
+        Serial.printf("Preloading mode: %s\n", _modes[i].name.c_str());
+        _slots[i] = build(i);
+        _slots[i]->lastUsed = ++_useClock;
+        full = residentBytes() >= memoryCap;
+        built = true;
+    }
+    xSemaphoreGive(_lock);
+    if (full) {
+        Serial.println("Playlist memory cap reached, remaining modes load on demand");
+        return false;
+    }
+    return built;
+}
+
+bool PlaylistManager::isModeResident(int index) const {
+    if (_modes.empty()) return false;
+    if (index < 0) index = _modes.size() - 1;
+    if (index >= (int)_modes.size()) index = 0;
+    return _slots[index] != nullptr;
+}
+
+PlaylistManager::ModeData *PlaylistManager::build(int index) {
+    TraceScope section(TRACE_SEC_MODE_BUILD, index);
+    const ModeConfig &config = _modes[index];
+    ModeData *m = new ModeData();
+    m->policy = &OrderPolicy::forType(config.shuffle);
+    if (m->policy->usesStats()) loadStats(*m, index);
+    loadHistory(*m, index);
+    // 电台模式：列表就是清单中的地址，不读缓存、不扫描、不校验
+    if (config.isStream()) {
+        for (const std::string &url : config.streams) addTrack(*m, String(url.c_str()));
+        if (m->exhausted || !m->buildIndex()) m->discard();
+        buildSearch(*m, index);
+        m->validated = true;
+        shuffle(*m);
+        return m;
+    }
+
     // Pre-reserve for large dirs
-    _playlist.reserve(1000);
-    
-    Serial.printf("Switching to mode: %s\n", _modes[_currentModeIndex].c_str());
-    
+    if (m->arena.reserve(1000 * sizeof(const char *))) m->playlist.reserve(1000);
+
     // Try to load cache first
-    if (!loadCache(_currentModeIndex)) {
+    if (!loadCache(*m, index)) {
         Serial.println("Cache miss, full scanning SD...");
         
         // Full scan
         // Use stored path (now includes slash from config.h)
-        scan(SD, _modes[_currentModeIndex].c_str(), 2);
+        {
+            TraceScope scanSection(TRACE_SEC_SCAN, index);
+            unsigned long start = millis();
+            bool raw = false;
+#if PLAYLIST_RAW_SCAN
+            raw = rawScan(*m, config.path.c_str(), config.depth);
+#endif
+            if (!raw) scan(*m, SD, config.path.c_str(), config.depth);
+            Serial.printf("Scan (%s): %u tracks in %lums\n", raw ? "raw FAT32" : "VFS", (unsigned)m->playlist.size(),
+                          millis() - start);
+        }
+        // 内存不足时丢弃部分结果：模式按空处理，也不把不完整的列表写进缓存
+        if (m->exhausted || !m->buildIndex()) {
+            m->discard();
+            Serial.printf("Mode %s: out of playlist memory, not loaded\n", config.name.c_str());
+            return m;
+        }
+        trace(TRACE_CACHE, TRACE_CACHE_MISS, index, m->count());
         
         // Save cache immediately
-        saveCache(_currentModeIndex);
+        saveCache(*m, index);
     } else {
         Serial.println("Cache hit!");
+        if (!m->buildIndex()) {
+            Serial.printf("Mode %s: out of playlist memory, not loaded\n", config.name.c_str());
+            return m;
+        }
+        trace(TRACE_CACHE, TRACE_CACHE_HIT, index, m->count());
+    }
+
+    // 检索索引：与缓存匹配时直接加载，否则重建并落盘
+    if (!loadSearch(*m, index)) {
+        buildSearch(*m, index);
+        saveSearch(*m, index);
     }
     
     // Shuffle
-    shuffle();
-    printList();
+    shuffle(*m);
+    return m;
 }
 
+size_t PlaylistManager::residentBytes() const {
+    size_t total = 0;
+    for (const ModeData *m : _slots) {
+        if (m) total += m->arena.capacity() + m->search.bytes();
+    }
+    return total;
+}
 
+void PlaylistManager::evict(int keep) {
+    while (residentBytes() > memoryCap) {
+        int victim = -1;
+        for (int i = 0; i < (int)_slots.size(); i++) {
+            if (i == keep || !_slots[i]) continue;
+            if (victim < 0 || _slots[i]->lastUsed < _slots[victim]->lastUsed) victim = i;
+        }
+        if (victim < 0) return; // 只剩当前模式，即使超限也保留
+        Serial.printf("Evicting mode: %s\n", _modes[victim].name.c_str());
+        savePlayed(*_slots[victim], victim, true);
+        delete _slots[victim];
+        _slots[victim] = nullptr;
+    }
+}
 
 void PlaylistManager::loadMode() {
     _prefs.begin("playlist", true); // Read-only
@@ -63,6 +218,11 @@ void PlaylistManager::loadMode() {
     setMode(savedIndex);
 }
 
+void PlaylistManager::deferMode(int index) {
+    if (index < 0 || index >= (int)_modes.size()) return;
+    _currentModeIndex = index;
+}
+
 void PlaylistManager::nextMode() {
     setMode(_currentModeIndex + 1);
 }
@@ -72,70 +232,46 @@ void PlaylistManager::prevMode() {
 }
 
 String PlaylistManager::getCurrentModeName() {
-    if (_currentModeIndex >= 0 && _currentModeIndex < (int)_modes.size()) {
-        String name = _modes[_currentModeIndex];
-        if (name.startsWith("/")) {
-            return name.substring(1);
-        }
-        return name;
+    const ModeConfig *config = getCurrentModeConfig();
+    if (config) {
+        return String(config->name.c_str());
     }
     return "Unknown";
 }
 
 void PlaylistManager::saveCache(int modeIndex) {
-    if (_playlist.empty()) return;
-    
-    String cacheFile = "/.playlist_cache_" + String(modeIndex) + ".txt";
-    File f = SD.open(cacheFile.c_str(), FILE_WRITE);
-    if (!f) {
-        Serial.println("Failed to save cache");
-        return;
-    }
-    
-    for (const auto& song : _playlist) {
-        f.println(song);
-    }
-    f.close();
-    Serial.println("Cache saved.");
+    if (modeIndex < 0 || modeIndex >= (int)_slots.size() || !_slots[modeIndex]) return;
+    saveCache(*_slots[modeIndex], modeIndex);
 }
 
-bool PlaylistManager::loadCache(int modeIndex) {
-    String cacheFile = "/.playlist_cache_" + String(modeIndex) + ".txt";
-    if (!SD.exists(cacheFile.c_str())) return false;
-    
-    File f = SD.open(cacheFile.c_str());
-    if (!f) return false;
-    
-    while (f.available()) {
-        String line = f.readStringUntil('\n');
-        line.trim();
-        if (line.length() > 0) {
-            _playlist.push_back(line);
-        }
-    }
-    f.close();
-    
-    if (_playlist.empty()) return false;
+void PlaylistManager::saveCache(ModeData &m, int modeIndex) {
+    if (m.playlist.empty()) return;
+    uint32_t crc;
+    if (!CacheStore(SD, _manifestHash).save(m, modeIndex, crc)) return;
+    m.cacheCrc = m.removedCount == 0 ? crc : 0; // 有墓碑时缓存顺序与曲目 ID 不再一致
+}
+
+bool PlaylistManager::loadCache(ModeData &m, int modeIndex) {
+    uint32_t crc;
+    if (!CacheStore(SD, _manifestHash).load(m, modeIndex, crc)) return false;
+    m.cacheCrc = crc;
     return true;
 }
 
 void PlaylistManager::clearCache() {
     // Helper to delete all cache files
     for (int i = 0; i < (int)_modes.size(); i++) {
-        String cacheFile = "/.playlist_cache_" + String(i) + ".txt";
-        if (SD.exists(cacheFile.c_str())) {
-            SD.remove(cacheFile.c_str());
+        for (const char *ext : { "txt", "tmp", "bak", "idx", "idx.tmp" }) {
+            String cacheFile = CacheStore::path(i, ext);
+            if (SD.exists(cacheFile.c_str())) {
+                SD.remove(cacheFile.c_str());
+            }
         }
     }
     Serial.println("Cache cleared!");
 }
 
-void PlaylistManager::scan(fs::FS &fs, const char *dirname, uint8_t levels) {
-    // Reserve memory to avoid reallocations
-    if (_playlist.capacity() < 1000) {
-        _playlist.reserve(1000);
-    }
-
+void PlaylistManager::scan(ModeData &m, fs::FS &fs, const char *dirname, uint8_t levels) {
     File root = fs.open(dirname);
     if (!root) {
         Serial.println("Failed to open directory");
@@ -150,7 +286,8 @@ void PlaylistManager::scan(fs::FS &fs, const char *dirname, uint8_t levels) {
     while (file) {
         if (file.isDirectory()) {
             if (levels) {
-                scan(fs, file.path(), levels - 1);
+                scan(m, fs, file.path(), levels - 1);
+                if (m.exhausted) return;
             }
         } else {
             String filename = String(file.name());
@@ -166,7 +303,7 @@ void PlaylistManager::scan(fs::FS &fs, const char *dirname, uint8_t levels) {
             String path = String(file.path());
             
             if (isAudioFile(path)) {
-                _playlist.push_back(path);
+                if (!addTrack(m, path)) return; // 内存不足，由 build() 放弃该模式
                 // Serial.printf("Found: %s\n", path.c_str());
             }
         }
@@ -177,84 +314,527 @@ void PlaylistManager::scan(fs::FS &fs, const char *dirname, uint8_t levels) {
     }
 }
 
+bool PlaylistManager::addTrack(ModeData &m, const String &path) {
+    return m.add(path.c_str(), path.length());
+}
+
+static const char *const kAudioExtensions[] = { ".mp3", ".aac", ".m4a", ".flac", ".ogg", ".wav" };
+static const size_t kAudioExtensionCount = sizeof(kAudioExtensions) / sizeof(kAudioExtensions[0]);
+
 bool PlaylistManager::isAudioFile(String filename) {
     filename.toLowerCase();
-    return filename.endsWith(".mp3") || 
-           filename.endsWith(".aac") || 
-           filename.endsWith(".m4a") || 
-           filename.endsWith(".flac") || 
-           filename.endsWith(".ogg") ||
-           filename.endsWith(".wav");
+    for (size_t i = 0; i < kAudioExtensionCount; i++) {
+        if (filename.endsWith(kAudioExtensions[i])) return true;
+    }
+    return false;
+}
+
+#if PLAYLIST_RAW_SCAN
+// SD 卡原始扇区读取（SPI 模式下 readRAW 每次一个扇区，但地址连续）
+class SdBlockDevice : public BlockDevice {
+public:
+    bool read(uint32_t sector, uint8_t *buf, uint32_t count) override {
+        for (uint32_t i = 0; i < count; i++) {
+            if (!SD.readRAW(buf + i * FatScanner::kSectorSize, sector + i)) return false;
+        }
+        return true;
+    }
+};
+
+// 直接读取 FAT32 目录扇区；卡不是 FAT32 或中途读失败时返回 false，由调用方走 VFS 扫描
+bool PlaylistManager::rawScan(ModeData &m, const char *dirname, uint8_t levels) {
+    SdBlockDevice dev;
+    FatScanner fat(dev, kAudioExtensions, kAudioExtensionCount);
+    if (!fat.mount()) {
+        Serial.println("Raw scan: not a FAT32 card, using VFS");
+        return false;
+    }
+    bool ok = fat.scan(dirname, levels, [&m](const char *path, size_t len) {
+        m.add(path, len);
+    });
+    if (!ok) {
+        Serial.printf("Raw scan of %s failed, using VFS\n", dirname);
+        // 丢弃已读入的部分结果
+        m.discard();
+        return false;
+    }
+    Serial.printf("Raw scan: %u entries, %u sectors\n", (unsigned)fat.entriesSeen(), (unsigned)fat.sectorsRead());
+    return true;
 }
+#endif
 
 void PlaylistManager::shuffle() {
-    if (_playlist.empty()) return;
+    if (_cur) shuffle(*_cur);
+}
+
+void PlaylistManager::shuffle(ModeData &m) {
+    // 随机种子来自 ESP32 硬件随机数发生器
+    shuffle(m, esp_random(), 0);
+}
+
+void PlaylistManager::shuffle(ModeData &m, uint32_t seed, uint16_t skipRecent) {
+    if (m.count() == 0) return;
+
+    m.order.clear();
+    // order / orderPos 首次分配时先预留：内存不足则没有播放顺序，next() 返回空
+    bool grow = m.order.capacity() < m.count() || m.orderPos.capacity() < m.playlist.size();
+    if (grow && !m.arena.reserve((m.count() + m.playlist.size()) * sizeof(uint32_t) + 8)) {
+        arenaRelease(m.orderPos);
+        m.currentSongIndex = -1;
+        Serial.println("Playlist order: out of memory");
+        return;
+    }
+    m.order.reserve(m.count());
+    for (uint32_t id = 0; id < m.playlist.size(); id++) {
+        if (m.isPlayable(id)) m.order.push_back(id);
+    }
     
-    // Use ESP32 hardware random number generator
-    std::random_device rd;
-    std::mt19937 g(esp_random());
-    std::shuffle(_playlist.begin(), _playlist.end(), g);
+    // 策略就地重排，相同种子结果相同
+    OrderContext ctx = { m.playlist.data(), &m.stats, seed };
+    m.policy->build(m.order.data(), m.order.size(), ctx);
+    m.orderSeed = seed;
+    m.orderAge = skipRecent;
+
+    // 不重复约束：最近播放的 PLAYLIST_NO_REPEAT 首不排在新一轮开头
+    uint32_t recent[PLAYLIST_NO_REPEAT];
+    size_t k = 0;
+    for (size_t b = skipRecent; b < m.history.size() && k < PLAYLIST_NO_REPEAT; b++) {
+        uint32_t id = m.index.find(m.history.at(b));
+        if (id != PathIndex::kNotFound) recent[k++] = id;
+    }
+    if (k) m.policy->avoidRecent(m.order.data(), m.order.size(), recent, k, ctx);
+
+    m.orderPos.assign(m.playlist.size(), (uint32_t)PathIndex::kNotFound);
+    for (uint32_t i = 0; i < m.order.size(); i++) {
+        m.orderPos[m.order[i]] = i;
+    }
     
-    _currentSongIndex = -1;
+    m.currentSongIndex = -1;
     Serial.println("Playlist shuffled");
 }
 
 String PlaylistManager::next() {
-    if (_playlist.empty()) return "";
-    
-    _currentSongIndex++;
-    if (_currentSongIndex >= (int)_playlist.size()) {
-        // Option 1: Loop back to 0 without shuffle
-        // _currentSongIndex = 0;
-        
-        // Option 2: Reshuffle and start from 0
-        shuffle(); 
-        _currentSongIndex = 0; 
+    _pending = PathIndex::kNotFound;
+    if (count() == 0) return "";
+
+    // 之前用 prev() 回看过历史：先沿历史向前重放
+    uint64_t hash;
+    while (_cur->history.forward(hash)) {
+        uint32_t id = _cur->index.find(hash);
+        if (id != PathIndex::kNotFound && _cur->isPlayable(id)) return _cur->playlist[id];
     }
     
-    return _playlist[_currentSongIndex];
+    // 跳过被移除（墓碑）或校验为缺失的曲目
+    for (size_t n = 0; n <= _cur->order.size(); n++) {
+        _cur->currentSongIndex++;
+        if (_cur->currentSongIndex >= _cur->order.size()) {
+            // 顺序播放直接回到开头，其余策略重新生成一轮
+            if (_cur->policy->reshuffleOnWrap()) shuffle(*_cur);
+            _cur->currentSongIndex = 0; 
+            if (_cur->order.empty()) return "";
+        }
+        uint32_t id = _cur->order[_cur->currentSongIndex];
+        if (_cur->isPlayable(id)) {
+            _pending = id; // 打开成功后由 commitPlayed() 记入历史
+            return _cur->playlist[id];
+        }
+    }
+    return "";
 }
 
 String PlaylistManager::prev() {
-    if (_playlist.empty()) return "";
-    
-    if (_currentSongIndex == 0) {
-        _currentSongIndex = _playlist.size() - 1;
-    } else {
-        _currentSongIndex--;
+    _pending = PathIndex::kNotFound;
+    if (count() == 0) return "";
+
+    // 沿真实播放历史回退（跨越重新打乱也有效）
+    uint64_t hash;
+    while (_cur->history.back(hash)) {
+        uint32_t id = _cur->index.find(hash);
+        if (id != PathIndex::kNotFound && _cur->isPlayable(id)) return _cur->playlist[id];
     }
     
-    return _playlist[_currentSongIndex];
+    // 已回到最早一条历史：停在这里重播它。不再沿播放顺序往回走——那样会重复已播过的曲目，
+    // 且这些移动不进历史，之后的 next() 无法重放
+    if (_cur->history.size() == 0) return "";
+    uint32_t id = _cur->index.find(_cur->history.at(_cur->history.cursor()));
+    if (id != PathIndex::kNotFound && _cur->isPlayable(id)) return _cur->playlist[id];
+    return "";
+}
+
+bool PlaylistManager::commitPlayed(uint64_t trackId) {
+    uint32_t id = _pending;
+    _pending = PathIndex::kNotFound;
+    if (!_cur || id == PathIndex::kNotFound || _cur->index.find(trackId) != id) return false;
+
+    // 只改内存，落盘由 savePlayed() 在播放路径之外批量进行
+    if (_cur->history.push(trackId)) {
+        if (_cur->orderAge < UINT16_MAX) _cur->orderAge++;
+        _cur->historyDirty = true;
+    }
+    if (_cur->policy->usesStats()) {
+        _cur->stats.notePlayed(trackId);
+        if (_cur->playsSinceSave < UINT8_MAX) _cur->playsSinceSave++;
+    }
+    return true;
+}
+
+void PlaylistManager::savePlayed(bool all) {
+    if (!_cur) return;
+    for (int i = 0; i < (int)_slots.size(); i++) {
+        if (_slots[i] == _cur) savePlayed(*_cur, i, all);
+    }
+}
+
+void PlaylistManager::savePlayed(ModeData &m, int modeIndex, bool all) {
+    if (m.historyDirty) saveHistory(m, modeIndex);
+    // 统计每 16 首落盘一次，断电最多丢失十几首
+    if (m.stats.isDirty() && (all || m.playsSinceSave >= 16)) saveStats(m, modeIndex);
+}
+
+// 每个模式的附属文件按模式路径哈希命名，清单调整顺序后仍能对应
+String PlaylistManager::modeFilePath(const char *prefix, int modeIndex) const {
+    char name[40];
+    uint64_t h = pathHash(_modes[modeIndex].path.c_str());
+    snprintf(name, sizeof(name), "/.%s_%08x.bin", prefix, (unsigned)(h ^ (h >> 32)));
+    return String(name);
+}
+
+// 历史文件：magic "HIST" + head (u16) + count (u16) + 64 个槽位 (u64)
+void PlaylistManager::loadHistory(ModeData &m, int modeIndex) {
+    String path = modeFilePath("history", modeIndex);
+    File f = SD.open(path.c_str());
+    if (!f) return;
+
+    uint8_t header[8];
+    uint64_t slots[PlayHistory::kCapacity];
+    if (f.read(header, sizeof(header)) == sizeof(header) && memcmp(header, "HIST", 4) == 0 &&
+        f.read((uint8_t *)slots, sizeof(slots)) == sizeof(slots)) {
+        uint16_t head, count;
+        memcpy(&head, header + 4, 2);
+        memcpy(&count, header + 6, 2);
+        m.history.restore(slots, head, count);
+    }
+    f.close();
+}
+
+void PlaylistManager::saveHistory(ModeData &m, int modeIndex) {
+    uint8_t image[8 + PlayHistory::kCapacity * 8];
+    uint16_t head = m.history.head();
+    uint16_t count = m.history.count();
+    memcpy(image, "HIST", 4);
+    memcpy(image + 4, &head, 2);
+    memcpy(image + 6, &count, 2);
+    for (uint16_t i = 0; i < PlayHistory::kCapacity; i++) {
+        uint64_t slot = m.history.slot(i);
+        memcpy(image + 8 + i * 8, &slot, 8);
+    }
+
+    // 文件大小固定：已存在时原地改写，不截断
+    String path = modeFilePath("history", modeIndex);
+    File f = SD.open(path.c_str(), "r+");
+    if (!f || f.size() != sizeof(image)) {
+        if (f) f.close();
+        f = SD.open(path.c_str(), FILE_WRITE); // 首次或文件损坏
+        if (!f) return;
+    }
+    bool ok = f.write(image, sizeof(image)) == sizeof(image);
+    f.close();
+    if (ok) m.historyDirty = false;
+}
+
+// 格式：magic "PLY2" + PlayCountTable 原始字节 + CRC32
+static bool loadStatsFile(PlayCountTable &stats, const String &path) {
+    File f = SD.open(path.c_str());
+    if (!f) return false;
+    size_t size = f.size();
+    bool ok = false;
+    if (size >= 8) {
+        std::vector<uint8_t> buf(size);
+        if (f.read(buf.data(), size) == size) {
+            uint32_t crc;
+            memcpy(&crc, buf.data() + size - 4, 4);
+            ok = memcmp(buf.data(), "PLY2", 4) == 0 && crc == crc32(buf.data() + 4, size - 8) &&
+                 stats.deserialize(buf.data() + 4, size - 8);
+        }
+    }
+    f.close();
+    return ok;
+}
+
+void PlaylistManager::loadStats(ModeData &m, int modeIndex) {
+    String path = modeFilePath("plays", modeIndex);
+    String bakPath = path + ".bak";
+    bool ok = loadStatsFile(m.stats, path);
+    // 当前版本缺失或损坏（提交中途断电）：回退到上一代
+    if (!ok && loadStatsFile(m.stats, bakPath)) {
+        ok = true;
+        path = bakPath;
+    }
+    if (SD.exists(path.c_str())) {
+        Serial.printf("Play stats %s: %s (%u tracks)\n", path.c_str(), ok ? "loaded" : "invalid", (unsigned)m.stats.size());
+    }
+}
+
+void PlaylistManager::saveStats(ModeData &m, int modeIndex) {
+    std::vector<uint8_t> buf(4 + m.stats.serializedSize() + 4);
+    memcpy(buf.data(), "PLY2", 4);
+    m.stats.serialize(buf.data() + 4);
+    uint32_t crc = crc32(buf.data() + 4, buf.size() - 8);
+    memcpy(buf.data() + buf.size() - 4, &crc, 4);
+
+    // 与缓存相同的提交方式：完整写入 .tmp，旧版本挪成 .bak，再把 .tmp 改名为正式文件
+    String path = modeFilePath("plays", modeIndex);
+    String tmpPath = path + ".tmp";
+    String bakPath = path + ".bak";
+    File f = SD.open(tmpPath.c_str(), FILE_WRITE);
+    if (!f) return;
+    bool ok = f.write(buf.data(), buf.size()) == buf.size();
+    f.close();
+    if (!ok) {
+        SD.remove(tmpPath.c_str());
+        return;
+    }
+    if (SD.exists(path.c_str())) {
+        SD.remove(bakPath.c_str());
+        SD.rename(path.c_str(), bakPath.c_str());
+    }
+    if (!SD.rename(tmpPath.c_str(), path.c_str())) return;
+    m.stats.markClean();
+    m.playsSinceSave = 0;
+}
+
+void PlaylistManager::buildSearch(ModeData &m, int modeIndex) {
+    unsigned long start = millis();
+    const String &root = _modes[modeIndex].path;
+    size_t rootLen = root.length();
+    while (rootLen > 1 && root[rootLen - 1] == '/') rootLen--;
+
+    m.search.clear();
+    for (uint32_t id = 0; id < m.playlist.size(); id++) {
+        if (!m.isRemoved(id)) m.search.add(id, m.playlist[id], rootLen);
+    }
+    m.search.finalize();
+    Serial.printf("Search index built: %u keys, %u bytes in %lums\n", (unsigned)m.search.entryCount(),
+                  (unsigned)m.search.bytes(), millis() - start);
+}
+
+// 检索索引文件：magic "SID2" + SearchIndex 原始字节 + CRC32，与缓存文件同名（扩展名 .idx）。
+// 索引中的曲目 ID 即缓存中的行号，头部记录缓存的 CRC，缓存重写后旧索引自动失效
+bool PlaylistManager::loadSearch(ModeData &m, int modeIndex) {
+    if (m.cacheCrc == 0) return false;
+    String path = CacheStore::path(modeIndex, "idx");
+    File f = SD.open(path.c_str());
+    if (!f) return false;
+
+    size_t size = f.size();
+    bool ok = false;
+    if (size >= 8) {
+        std::vector<uint8_t> buf(size);
+        if (f.read(buf.data(), size) == size) {
+            uint32_t crc;
+            memcpy(&crc, buf.data() + size - 4, 4);
+            ok = memcmp(buf.data(), "SID2", 4) == 0 && crc == crc32(buf.data() + 4, size - 8) &&
+                 m.search.deserialize(buf.data() + 4, size - 8, m.cacheCrc);
+        }
+    }
+    f.close();
+    if (ok) Serial.printf("Search index loaded: %u keys\n", (unsigned)m.search.entryCount());
+    return ok;
+}
+
+void PlaylistManager::saveSearch(ModeData &m, int modeIndex) {
+    String path = CacheStore::path(modeIndex, "idx");
+    if (m.cacheCrc == 0) {
+        SD.remove(path.c_str()); // 与当前缓存不对应，下次加载缓存后重建
+        return;
+    }
+    std::vector<uint8_t> buf(4 + m.search.serializedSize() + 4);
+    memcpy(buf.data(), "SID2", 4);
+    m.search.serialize(buf.data() + 4, m.cacheCrc);
+    uint32_t crc = crc32(buf.data() + 4, buf.size() - 8);
+    memcpy(buf.data() + buf.size() - 4, &crc, 4);
+
+    // 完整写入 .tmp 再改名：索引可随时重建，不留 .bak；卡满或断电时正式文件要么是旧版本，要么缺失
+    String tmpPath = path + ".tmp";
+    File f = SD.open(tmpPath.c_str(), FILE_WRITE);
+    if (!f) return;
+    bool ok = f.write(buf.data(), buf.size()) == buf.size();
+    f.close();
+    if (!ok) {
+        SD.remove(tmpPath.c_str());
+        Serial.printf("Search index %s: write failed\n", path.c_str());
+        return;
+    }
+    SD.remove(path.c_str()); // FAT 的 rename 不能覆盖
+    SD.rename(tmpPath.c_str(), path.c_str());
+}
+
+size_t PlaylistManager::search(const char *prefix, const char **paths, size_t max) const {
+    if (!_cur || max == 0) return 0;
+    // 多取一些，过滤掉校验发现缺失的曲目后仍能填满
+    uint32_t ids[32];
+    size_t n = _cur->search.query(prefix, ids, sizeof(ids) / sizeof(ids[0]));
+    size_t found = 0;
+    for (size_t i = 0; i < n && found < max; i++) {
+        if (_cur->isPlayable(ids[i])) paths[found++] = _cur->playlist[ids[i]];
+    }
+    return found;
 }
 
 void PlaylistManager::remove(String path) {
-    for (size_t i = 0; i < _playlist.size(); i++) {
-        if (_playlist[i] == path) {
-            _playlist.erase(_playlist.begin() + i);
-            
-            // Adjust index if we removed an element before the current index
-            if (i < _currentSongIndex) {
-                _currentSongIndex--;
-            }
-            // If we removed the element AT the current index, the next element shifts down.
-            // The index stays the same, but now points to the new element.
-            // We only need to clamp if we are now out of bounds (which happens if we removed the last element)
-            if (_currentSongIndex >= _playlist.size() && _currentSongIndex > 0) {
-                 _currentSongIndex = 0; // Wrap around or reset
+    // O(1)：哈希定位后仅打墓碑，不移动数组，播放顺序中的位置保持不变
+    // 墓碑位与 removedCount 由校验任务在 _lock 下读取，写入同样持锁
+    if (!_cur) return;
+    uint32_t id = _cur->index.find(pathHash(path.c_str()));
+    if (id == PathIndex::kNotFound || path != _cur->playlist[id]) return;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool removed = !_cur->isRemoved(id);
+    _cur->markRemoved(id);
+    xSemaphoreGive(_lock);
+    if (removed) Serial.printf("Removed missing file from playlist: %s\n", path.c_str());
+}
+
+bool PlaylistManager::selectTrack(uint64_t trackId) {
+    if (!_cur) return false;
+    uint32_t id = _cur->index.find(trackId);
+    if (id == PathIndex::kNotFound || !_cur->isPlayable(id) || id >= _cur->orderPos.size()) return false;
+    if (_cur->orderPos[id] == PathIndex::kNotFound) return false;
+
+    // next() 先自增再取值，-1 回绕为 0；放弃回看中的历史，否则 next() 会先重放历史
+    _cur->currentSongIndex = (size_t)_cur->orderPos[id] - 1;
+    _cur->history.toHead();
+    return true;
+}
+
+bool PlaylistManager::restoreOrder(uint32_t seed, uint16_t historySkip, uint64_t trackId) {
+    if (!_cur) return false;
+    shuffle(*_cur, seed, historySkip);
+    uint32_t id = _cur->index.find(trackId);
+    if (id == PathIndex::kNotFound || id >= _cur->orderPos.size() || _cur->orderPos[id] == PathIndex::kNotFound) {
+        return false;
+    }
+    _cur->currentSongIndex = _cur->orderPos[id];
+    _cur->history.toHead();
+    return true;
+}
+
+size_t PlaylistManager::buildBrowseList(uint64_t currentHash, size_t &currentPos) {
+    _browse.clear();
+    currentPos = 0;
+    if (!_cur) return 0;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    uint32_t current = _cur->index.find(currentHash);
+    _browse.reserve(_cur->count());
+    for (uint32_t id = 0; id < _cur->playlist.size(); id++) {
+        if (!_cur->isPlayable(id)) continue;
+        if (id == current) currentPos = _browse.size();
+        _browse.push_back(id);
+    }
+    _browseGeneration = _generation;
+    xSemaphoreGive(_lock);
+    return _browse.size();
+}
+
+const char *PlaylistManager::browsePath(size_t pos) const {
+    // 路径常驻在模式 arena 中，切换或重建前一直有效
+    if (pos >= _browse.size() || _browseGeneration != _generation || !_cur) return nullptr;
+    return _cur->playlist[_browse[pos]];
+}
+
+bool PlaylistManager::browsePosition(uint64_t trackId, size_t &pos) const {
+    if (!_cur || _browseGeneration != _generation) return false;
+    uint32_t id = _cur->index.find(trackId);
+    // 快照按曲目 ID 递增
+    auto it = std::lower_bound(_browse.begin(), _browse.end(), id);
+    if (id == PathIndex::kNotFound || it == _browse.end() || *it != id) return false;
+    pos = it - _browse.begin();
+    return true;
+}
+
+void PlaylistManager::clearBrowseList() {
+    _browse.clear();
+    _browse.shrink_to_fit();
+}
+
+void PlaylistManager::startValidation() {
+    if (!_cur || _cur->playlist.empty()) return;
+    if (!_validateTask) {
+        // 低优先级，跑在非音频核心
+        xTaskCreatePinnedToCore(validateTask, "plValidate", 6144, this, 1, &_validateTask, 0);
+    }
+    xTaskNotifyGive(_validateTask);
+}
+
+void PlaylistManager::validateTask(void *arg) {
+    PlaylistManager *self = (PlaylistManager *)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->validate();
+    }
+}
+
+void PlaylistManager::validate() {
+    // 快照：按目录分组的曲目 ID，每个目录恰好一组，只列举一次
+    // _cur 只在持有 _lock 且代数未变时访问：切换或淘汰模式都会递增 _generation
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    uint32_t gen = _generation;
+    const ModeData &m = *_cur;
+    std::vector<uint32_t> ids;
+    ids.reserve(m.playlist.size());
+    for (uint32_t id = 0; id < m.playlist.size(); id++) {
+        if (!m.isRemoved(id)) ids.push_back(id);
+    }
+    sortByDir(ids.data(), ids.size(), m.playlist.data());
+    const char *const *paths = m.playlist.data(); // 指向模式 arena，代数不变时一直有效
+    xSemaphoreGive(_lock);
+
+    unsigned long start = millis();
+    DirValidation v;
+    v.enter = [this, gen]() {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        if (gen == _generation) return true;
+        xSemaphoreGive(_lock); // 播放列表已切换，放弃
+        return false;
+    };
+    v.leave = [this]() { xSemaphoreGive(_lock); };
+    // getNextFileName 返回完整路径，不构造 File 对象
+    v.list = [](const char *dir, const std::function<void(const char *)> &entry) {
+        File root = SD.open(dir[0] ? dir : "/");
+        if (root && root.isDirectory()) {
+            String name = root.getNextFileName();
+            while (name.length() > 0) {
+                entry(name.c_str());
+                name = root.getNextFileName();
             }
-            
-            Serial.printf("Removed missing file from playlist: %s\n", path.c_str());
-            return; // Found and removed, exit
         }
+        if (root) root.close();
+    };
+    v.markMissing = [this](uint32_t id) { __atomic_fetch_or(&_cur->missing[id / 32], 1u << (id % 32), __ATOMIC_RELAXED); };
+    v.pause = []() { vTaskDelay(1); }; // 让出 SD 总线给解码
+    if (!v.run(ids.data(), ids.size(), paths)) return;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool current = gen == _generation;
+    if (current) _cur->validated = true;
+    xSemaphoreGive(_lock);
+    if (current) {
+        Serial.printf("Validation: %u missing, %u tracks, %u dirs listed in %lums\n",
+                      (unsigned)v.missing, (unsigned)ids.size(), (unsigned)v.dirs, millis() - start);
     }
 }
 
 size_t PlaylistManager::count() const {
-    return _playlist.size();
+    return _cur ? _cur->count() : 0;
 }
 
 void PlaylistManager::printList() {
-    Serial.printf("Total songs: %d\n", _playlist.size());
+    Serial.printf("Total songs: %u (duplicates skipped: %u)\n", (unsigned)count(), (unsigned)getDuplicateCount());
+    if (_cur) {
+        Serial.printf("Playlist arena: %u / %u bytes, resident total %u / %u\n", (unsigned)_cur->arena.used(),
+                      (unsigned)_cur->arena.capacity(), (unsigned)residentBytes(), (unsigned)memoryCap);
+    }
     // for (const auto& song : _playlist) {
     //     Serial.println(song);
     // }
@@ -5,41 +5,141 @@
 #include <FS.h>
 #include <SD.h>
 #include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "util/PathIndex.h"
+#include "util/Arena.h"
+#include "util/CountingAllocator.h"
+#include "config.h"
+#include "ModeManifest.h"
+#include "playlist/OrderPolicy.h"
+#include "playlist/PlayCountTable.h"
+#include "playlist/PlayHistory.h"
+#include "playlist/SearchIndex.h"
+#include "playlist/TrackTable.h"
 
 class PlaylistManager {
 public:
     PlaylistManager();
+    ~PlaylistManager();
     
     // Add directory to scan
     void addMode(String path);
+    void addMode(const ModeConfig &config);
+    void setManifestHash(uint64_t hash) { _manifestHash = hash; } // 写入缓存头，不匹配的缓存视为过期
+    uint64_t getManifestHash() const { return _manifestHash; }
+    const ModeConfig *getCurrentModeConfig() const;
     void setMode(int index);
     void loadMode(); // Load from NVS
+    void deferMode(int index); // 只记下当前模式编号、不构建索引：交接快速启动先开播，随后 setMode() 构建
     void nextMode();
     void prevMode();
     String getCurrentModeName();
+    int getCurrentModeIndex() const { return _currentModeIndex; }
+
+    // 常驻索引：开机只建当前模式，其余模式开播后逐个预建；切换时只交换指针并恢复该模式自己的播放位置。
+    // 总占用超过 memoryCap 时淘汰最久未使用的模式，再次切回时重新加载。
+    bool preloadStep(); // 预建下一个未常驻的模式，全部完成或达到上限时返回 false（开机后在主循环中逐个进行）
+    bool isModeResident(int index) const;
+    size_t residentBytes() const; // 全部常驻模式的 arena 与检索索引
+    size_t memoryCap = PLAYLIST_MEMORY_CAP;
     
     // Cache Management
-    void saveCache(int modeIndex);
-    bool loadCache(int modeIndex);
+    void saveCache(int modeIndex); // 仅对常驻模式有效
     void clearCache(); // Force rescan helper
 
     // Playback
     void shuffle();
+    // next() / prev() 只选曲不落盘；next() 从播放顺序选出的曲目打开成功后调用 commitPlayed() 记入历史与统计
     String next();
     String prev(); // Add previous song support
+    bool commitPlayed(uint64_t trackId); // trackId 不是上一次 next() 选出的曲目时忽略
+    // 把内存中的历史与统计写到卡上（在播放路径之外调用）；统计按每 16 首的节奏，all 为 true 时全部写出
+    void savePlayed(bool all = false);
     void remove(String path);
-    size_t count() const;
-    size_t getCurrentIndex() const { return _currentSongIndex; }
+    bool selectTrack(uint64_t trackId); // 下一次 next() 返回该曲目
+    // 当前一轮播放顺序的种子，以及此后新增的历史条数；restoreOrder() 据此重建同一顺序，
+    // 并定位到 trackId（视为正在播放，下一次 next() 返回其后一首）。曲目集合与播放统计未变时顺序完全一致
+    uint32_t getOrderSeed() const { return _cur ? _cur->orderSeed : 0; }
+    uint16_t getOrderAge() const { return _cur ? _cur->orderAge : 0; }
+    bool restoreOrder(uint32_t seed, uint16_t historySkip, uint64_t trackId);
+    // 曲目浏览：当前模式全部可播放曲目的 ID（扫描顺序）快照，名称按行从 arena 直接取，不复制字符串
+    size_t buildBrowseList(uint64_t currentHash, size_t &currentPos);
+    const char *browsePath(size_t pos) const; // 模式已切换或越界返回 nullptr
+    void clearBrowseList();
+    bool browsePosition(uint64_t trackId, size_t &pos) const; // 曲目在浏览快照中的位置
+    // 前缀检索当前模式（文件名 / 目录名，汉字按拼音首字母），返回可播放曲目的路径，模式切换前有效
+    size_t search(const char *prefix, const char **paths, size_t max) const;
+    size_t count() const; // 有效曲目数（不含已移除/重复）
+    size_t getCurrentIndex() const { return _cur ? _cur->currentSongIndex : 0; }
+    size_t getDuplicateCount() const { return _cur ? _cur->duplicateCount : 0; }
     size_t getModeCount() const { return _modes.size(); }
+    bool isValidated() const { return _cur && _cur->validated; }
     void printList();
 
 private:
-    void scan(fs::FS &fs, const char *dirname, uint8_t levels);
+    // 单个模式的全部数据（路径字符串、顺序、索引）都分配在自己的 arena 中，
+    // 淘汰或重建时整体丢弃，不再逐个释放上千个 String。曲目存储本身见 TrackTable
+    struct ModeData : TrackTable {
+        ModeData();
+
+        ArenaVector<uint32_t> order;        // 播放顺序（曲目 ID 的排列）
+        ArenaVector<uint32_t> orderPos;     // 曲目 ID → 在 order 中的位置
+        size_t currentSongIndex;
+        bool validated;
+        const OrderPolicy *policy;          // 播放顺序策略（来自清单的 shuffle）
+        PlayCountTable stats;               // 加权随机用的播放统计
+        PlayHistory history;                // 真实播放历史，prev() 沿它回退
+        SearchIndex search;                 // 前缀检索（与缓存一同落盘）
+        uint32_t cacheCrc;                  // 与 playlist 顺序一致的缓存文件 CRC，0 表示未知
+        uint8_t playsSinceSave;
+        bool historyDirty;                  // 历史有尚未落盘的条目
+        uint32_t orderSeed;                 // 本轮顺序的随机种子
+        uint16_t orderAge;                  // 本轮生成之后新增的历史条数
+        uint32_t lastUsed;                  // LRU 时间戳（切换计数）
+    };
+
+    ModeData *build(int index); // 从缓存或扫描构建，调用方持有 _lock
+    void evict(int keep);       // 按 LRU 淘汰，直到总占用不超过 memoryCap；未落盘的历史与统计先写出
+
+    void scan(ModeData &m, fs::FS &fs, const char *dirname, uint8_t levels);
+#if PLAYLIST_RAW_SCAN
+    bool rawScan(ModeData &m, const char *dirname, uint8_t levels); // 直接解析 FAT32 目录扇区
+#endif
     bool isAudioFile(String filename);
+    bool addTrack(ModeData &m, const String &path); // 内存不足返回 false
+    bool loadCache(ModeData &m, int modeIndex);     // 当前版本损坏时回退到 .bak（见 CacheStore）
+    void saveCache(ModeData &m, int modeIndex);
+    void buildSearch(ModeData &m, int modeIndex);
+    bool loadSearch(ModeData &m, int modeIndex);
+    void saveSearch(ModeData &m, int modeIndex);
+    void shuffle(ModeData &m);
+    void shuffle(ModeData &m, uint32_t seed, uint16_t skipRecent); // skipRecent：不重复约束跳过最新的几条历史
+    void savePlayed(ModeData &m, int modeIndex, bool all);
+    void loadStats(ModeData &m, int modeIndex);
+    void saveStats(ModeData &m, int modeIndex);
+    void loadHistory(ModeData &m, int modeIndex);
+    void saveHistory(ModeData &m, int modeIndex);
+    String modeFilePath(const char *prefix, int modeIndex) const;
+
+    // 后台校验：按目录批量列举，标记缺失文件，播放路径无需再逐首 SD.exists()
+    void startValidation();
+    void validate();
+    static void validateTask(void *arg);
+
+    TaggedVector<uint32_t, MEM_UI> _browse; // 浏览快照（曲目 ID）
+    uint32_t _browseGeneration;             // 快照对应的 _generation，切换 / 重建后失效
+
+    std::vector<ModeData *> _slots; // 每个模式一个槽位，nullptr 表示未常驻
+    ModeData *_cur;                 // 当前模式
+    uint32_t _pending;              // 上一次 next() 从播放顺序选出、尚未确认播放的曲目 ID
 
-    std::vector<String> _playlist;
-    std::vector<String> _modes; // Paths like "/music", "/story"
+    SemaphoreHandle_t _lock;         // 保护播放列表结构，供校验任务与 setMode 互斥
+    TaskHandle_t _validateTask;
+    volatile uint32_t _generation;   // 每次切换 / 重建递增，校验任务据此放弃过期结果
+    uint32_t _useClock;
+    std::vector<ModeConfig> _modes; // 来自 /modes.ini，或默认的 "/儿歌" 等目录
+    uint64_t _manifestHash;
     int _currentModeIndex;
-    size_t _currentSongIndex;
     Preferences _prefs;
 };
@@ -0,0 +1,264 @@
+#include "SeekIndex.h"
+#include "SidecarDir.h"
+#include "config.h"
+#include "util/PathHash.h"
+
+static const uint32_t SEEK_INDEX_MAGIC = 0x58494B53; // "SKIX"
+static const uint8_t SEEK_INDEX_VERSION = 1;
+static const size_t kHeaderSize = 13; // magic + version + 源文件大小 + 条目数
+
+static SidecarDir &seekDir() {
+    static SidecarDir dir(SD, "/.seek", SIDECAR_DIR_MAX_FILES);
+    return dir;
+}
+
+// MPEG 帧头表 (kbps / Hz)
+static const uint16_t kMp3BitrateV1L3[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+static const uint16_t kMp3BitrateV1L2[16] = { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 };
+static const uint16_t kMp3BitrateV2[16]   = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+static const uint32_t kMp3SampleRate[3]   = { 44100, 48000, 32000 };
+
+// 解析 4 字节帧头，返回帧长（0 表示无效），输出该帧采样数与采样率
+static uint32_t parseMp3Header(const uint8_t *h, uint32_t &samples, uint32_t &sampleRate) {
+    if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) return 0;
+    uint8_t version = (h[1] >> 3) & 0x03; // 0: 2.5, 2: 2, 3: 1
+    uint8_t layer = (h[1] >> 1) & 0x03;   // 1: III, 2: II
+    uint8_t brIdx = (h[2] >> 4) & 0x0F;
+    uint8_t srIdx = (h[2] >> 2) & 0x03;
+    uint8_t pad = (h[2] >> 1) & 0x01;
+    if (version == 1 || (layer != 1 && layer != 2) || srIdx == 3) return 0;
+
+    bool v1 = version == 3;
+    uint32_t kbps = v1 ? (layer == 1 ? kMp3BitrateV1L3[brIdx] : kMp3BitrateV1L2[brIdx]) : kMp3BitrateV2[brIdx];
+    if (kbps == 0) return 0;
+
+    sampleRate = kMp3SampleRate[srIdx] >> (v1 ? 0 : (version == 2 ? 1 : 2));
+    samples = (layer == 1 && !v1) ? 576 : 1152;
+    return (samples / 8) * kbps * 1000 / sampleRate + pad;
+}
+
+SeekIndex::SeekIndex()
+    : _trackId(0), _fileSize(0), _format(FORMAT_UNKNOWN), _complete(false),
+      _scanPos(0), _samples(0), _sampleRate(0) {}
+
+void SeekIndex::open(const String &path) {
+    close();
+    _path = path;
+    _trackId = pathHash(path.c_str());
+
+    String lower = path;
+    lower.toLowerCase();
+    if (lower.endsWith(".mp3")) _format = FORMAT_MP3;
+    else if (lower.endsWith(".flac")) _format = FORMAT_FLAC;
+    else return; // 其他格式交给解码库自身的跳转
+
+    File f = SD.open(path.c_str());
+    if (!f) return;
+    _fileSize = f.size();
+
+    if (loadCache()) {
+        f.close();
+        return;
+    }
+
+    if (_format == FORMAT_FLAC) {
+        if (parseFlac(f)) finish();
+        f.close();
+        return;
+    }
+
+    _scanPos = skipId3(f);
+    _file = f;
+    Serial.printf("SeekIndex: building for %s\n", path.c_str());
+}
+
+void SeekIndex::close() {
+    if (_file) _file.close();
+    _offsets.clear();
+    _complete = false;
+    _format = FORMAT_UNKNOWN;
+    _scanPos = 0;
+    _samples = 0;
+    _sampleRate = 0;
+}
+
+bool SeekIndex::lookup(uint32_t second, uint32_t &offset) const {
+    if (second >= _offsets.size()) return false;
+    offset = _offsets[second];
+    return true;
+}
+
+bool SeekIndex::buildStep(size_t maxBytes) {
+    if (_complete || _format != FORMAT_MP3 || !_file) return false;
+    if (!scanMp3(maxBytes)) {
+        _file.close();
+        finish();
+        return false;
+    }
+    return true;
+}
+
+uint32_t SeekIndex::skipId3(File &f) {
+    uint8_t h[10];
+    f.seek(0);
+    if (f.read(h, 10) != 10) return 0;
+    if (h[0] != 'I' || h[1] != 'D' || h[2] != '3') return 0;
+    // syncsafe 整数
+    uint32_t size = ((uint32_t)(h[6] & 0x7F) << 21) | ((uint32_t)(h[7] & 0x7F) << 14) |
+                    ((uint32_t)(h[8] & 0x7F) << 7) | (h[9] & 0x7F);
+    return 10 + size + ((h[5] & 0x10) ? 10 : 0);
+}
+
+bool SeekIndex::scanMp3(size_t maxBytes) {
+    size_t budget = maxBytes;
+    while (budget > 0 && _scanPos + 4 <= _fileSize) {
+        _file.seek(_scanPos);
+        size_t n = _file.read(_buf, sizeof(_buf));
+        if (n < 4) return false;
+        budget = budget > n ? budget - n : 0;
+
+        size_t i = 0;
+        while (i + 4 <= n) {
+            uint32_t frameSamples, sampleRate;
+            uint32_t len = parseMp3Header(&_buf[i], frameSamples, sampleRate);
+            uint32_t nextSamples, nextRate;
+            // 下一帧头也必须有效，避免把音频数据误判为同步字
+            if (len == 0 || (i + len + 4 <= n && parseMp3Header(&_buf[i + len], nextSamples, nextRate) == 0)) {
+                i++; // 重新同步
+                continue;
+            }
+            if (_sampleRate == 0) _sampleRate = sampleRate;
+
+            // 当前帧覆盖到新的一秒时记录其起点
+            uint32_t second = _samples / _sampleRate;
+            while (_offsets.size() <= second) _offsets.push_back(_scanPos + i);
+
+            _samples += frameSamples;
+            i += len;
+        }
+        _scanPos += i; // i 可能超出 n：最后一帧跨越缓冲区末尾
+        if (n < sizeof(_buf)) return false;
+        yield();
+    }
+    return _scanPos + 4 <= _fileSize;
+}
+
+bool SeekIndex::parseFlac(File &f) {
+    uint8_t h[4];
+    f.seek(0);
+    uint32_t pos = skipId3(f);
+    f.seek(pos);
+    if (f.read(h, 4) != 4 || memcmp(h, "fLaC", 4) != 0) return false;
+    pos += 4;
+
+    uint32_t sampleRate = 0;
+    uint32_t firstFrame = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> points; // (sample, offset)
+
+    bool last = false;
+    while (!last) {
+        f.seek(pos);
+        if (f.read(h, 4) != 4) return false;
+        last = h[0] & 0x80;
+        uint8_t type = h[0] & 0x7F;
+        uint32_t len = ((uint32_t)h[1] << 16) | ((uint32_t)h[2] << 8) | h[3];
+
+        if (type == 0) { // STREAMINFO
+            uint8_t si[18];
+            if (f.read(si, 18) != 18) return false;
+            sampleRate = ((uint32_t)si[10] << 12) | ((uint32_t)si[11] << 4) | (si[12] >> 4);
+        } else if (type == 3) { // SEEKTABLE: 每点 18 字节
+            uint8_t p[18];
+            for (uint32_t k = 0; k < len / 18; k++) {
+                if (f.read(p, 18) != 18) return false;
+                uint64_t sample = 0, offset = 0;
+                for (int b = 0; b < 8; b++) sample = (sample << 8) | p[b];
+                for (int b = 8; b < 16; b++) offset = (offset << 8) | p[b];
+                if (sample != 0xFFFFFFFFFFFFFFFFULL) points.push_back(std::make_pair(sample, offset));
+            }
+        }
+        pos += 4 + len;
+    }
+    firstFrame = pos;
+
+    if (sampleRate == 0 || points.empty()) return false;
+
+    // 每秒取不晚于该时刻的最近 seek point
+    uint32_t seconds = points.back().first / sampleRate + 1;
+    _offsets.reserve(seconds);
+    size_t k = 0;
+    for (uint32_t s = 0; s < seconds; s++) {
+        uint64_t target = (uint64_t)s * sampleRate;
+        while (k + 1 < points.size() && points[k + 1].first <= target) k++;
+        _offsets.push_back(firstFrame + (uint32_t)points[k].second);
+    }
+    return true;
+}
+
+void SeekIndex::finish() {
+    _complete = true;
+    Serial.printf("SeekIndex: %u seconds indexed\n", (unsigned)_offsets.size());
+    saveCache();
+}
+
+String SeekIndex::cachePath() const {
+    char name[40];
+    snprintf(name, sizeof(name), "/.seek/%016llx.idx", (unsigned long long)_trackId);
+    return String(name);
+}
+
+bool SeekIndex::loadCache() {
+    String path = cachePath();
+    if (!SD.exists(path.c_str())) return false;
+
+    File f = SD.open(path.c_str());
+    if (!f) return false;
+
+    uint32_t magic = 0, fileSize = 0, count = 0;
+    uint8_t version = 0;
+    bool ok = f.read((uint8_t *)&magic, 4) == 4 && f.read(&version, 1) == 1 &&
+              f.read((uint8_t *)&fileSize, 4) == 4 && f.read((uint8_t *)&count, 4) == 4;
+    // 文件被替换（大小变化）则视为失效；条目数不得超过索引文件实际能容纳的数量，损坏的计数不会触发巨量分配
+    if (!ok || magic != SEEK_INDEX_MAGIC || version != SEEK_INDEX_VERSION || fileSize != _fileSize ||
+        count == 0 || count > (f.size() - kHeaderSize) / sizeof(uint32_t)) {
+        f.close();
+        return false;
+    }
+
+    _offsets.resize(count);
+    size_t bytes = count * sizeof(uint32_t);
+    ok = f.read((uint8_t *)_offsets.data(), bytes) == bytes;
+    f.close();
+
+    if (!ok) {
+        _offsets.clear();
+        return false;
+    }
+    _complete = true;
+    return true;
+}
+
+void SeekIndex::saveCache() {
+    if (_offsets.empty()) return;
+    if (!seekDir().prepare()) return;
+
+    // 先写临时文件再改名：断电只会留下不完整的 .tmp，不会留下截断的索引
+    String path = cachePath();
+    String tmpPath = path + ".tmp";
+    File f = SD.open(tmpPath.c_str(), FILE_WRITE);
+    if (!f) {
+        Serial.println("SeekIndex: failed to save cache");
+        return;
+    }
+    uint32_t count = _offsets.size();
+    size_t bytes = count * sizeof(uint32_t);
+    bool ok = f.write((const uint8_t *)&SEEK_INDEX_MAGIC, 4) == 4 && f.write(&SEEK_INDEX_VERSION, 1) == 1 &&
+              f.write((const uint8_t *)&_fileSize, 4) == 4 && f.write((const uint8_t *)&count, 4) == 4 &&
+              f.write((const uint8_t *)_offsets.data(), bytes) == bytes;
+    f.close();
+    // 索引可随时重建，不保留上一代
+    if (!ok || !seekDir().commit(tmpPath.c_str(), path.c_str())) {
+        Serial.println("SeekIndex: failed to save cache");
+        SD.remove(tmpPath.c_str());
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include <FS.h>
+#include <SD.h>
+#include "util/CountingAllocator.h"
+
+// 每文件的秒级跳转索引：_offsets[s] = 第 s 秒所在帧的字节偏移
+// MP3 通过逐帧扫描帧头增量构建（播放时在 loop 中分批进行），FLAC 直接读取 SEEKTABLE。
+// 构建完成后缓存到 SD 卡 /.seek/<路径哈希>.idx（文件数上限见 SidecarDir），之后的跳转为 O(1) 查表。
+class SeekIndex {
+public:
+    SeekIndex();
+
+    void open(const String &path); // 换曲时调用：命中缓存则直接可用，否则准备增量构建
+    void close();
+    bool buildStep(size_t maxBytes); // 增量扫描 maxBytes，返回 true 表示仍需继续
+    bool lookup(uint32_t second, uint32_t &offset) const;
+    bool isComplete() const { return _complete; }
+    uint32_t getIndexedSeconds() const { return _offsets.size(); }
+
+private:
+    enum Format { FORMAT_UNKNOWN, FORMAT_MP3, FORMAT_FLAC };
+
+    String cachePath() const;
+    bool loadCache();
+    void saveCache();
+    void finish();
+
+    uint32_t skipId3(File &f);
+    bool parseFlac(File &f);
+    bool scanMp3(size_t maxBytes);
+
+    String _path;
+    uint64_t _trackId;
+    uint32_t _fileSize;
+    Format _format;
+    bool _complete;
+    TaggedVector<uint32_t, MEM_CACHE> _offsets;
+
+    // MP3 扫描状态
+    File _file;
+    uint32_t _scanPos;
+    uint64_t _samples;
+    uint32_t _sampleRate;
+    uint8_t _buf[4096];
+};
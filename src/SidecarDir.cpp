@@ -0,0 +1,57 @@
+#include "SidecarDir.h"
+#include <string.h>
+#include <vector>
+
+SidecarDir::SidecarDir(fs::FS &fs, const char *dir, size_t maxFiles)
+    : _fs(fs), _dir(dir), _maxFiles(maxFiles), _count(-1) {}
+
+bool SidecarDir::prepare() {
+    return _fs.exists(_dir) || _fs.mkdir(_dir);
+}
+
+bool SidecarDir::commit(const char *tmpPath, const char *path) {
+    bool existed = _fs.exists(path);
+    if (existed && !_fs.remove(path)) return false;
+    if (!_fs.rename(tmpPath, path)) {
+        if (existed && _count > 0) _count--;
+        return false;
+    }
+    if (existed) return true;
+
+    if (_count < 0) countFiles(); // 统计时已包含刚提交的文件
+    else _count++;
+    if ((size_t)_count > _maxFiles) prune(path);
+    return true;
+}
+
+void SidecarDir::countFiles() {
+    _count = 0;
+    File dir = _fs.open(_dir);
+    if (dir && dir.isDirectory()) {
+        for (String name = dir.getNextFileName(); name.length() > 0; name = dir.getNextFileName()) _count++;
+    }
+    if (dir) dir.close();
+}
+
+void SidecarDir::prune(const char *keep) {
+    size_t target = _maxFiles - _maxFiles / 8;
+    size_t excess = (size_t)_count - target;
+
+    // 先收集再删除，不在遍历目录的同时修改它
+    std::vector<String> victims;
+    File dir = _fs.open(_dir);
+    if (dir && dir.isDirectory()) {
+        for (String name = dir.getNextFileName(); name.length() > 0 && victims.size() < excess;
+             name = dir.getNextFileName()) {
+            if (strcmp(name.c_str(), keep) != 0) victims.push_back(name);
+        }
+    }
+    if (dir) dir.close();
+
+    size_t removed = 0;
+    for (const String &name : victims) {
+        if (_fs.remove(name.c_str())) removed++;
+    }
+    _count -= removed;
+    Serial.printf("Sidecar %s: removed %u oldest files, %u left\n", _dir, (unsigned)removed, (unsigned)_count);
+}
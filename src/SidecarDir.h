@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+// 每文件旁路缓存目录（/.seek、/.wave）：文件数不超过 maxFiles。
+// 新增文件使数量超限时按目录顺序（FAT 上大致是创建顺序）删掉最早的一批，降到上限的 7/8，
+// 每批只列一次目录。缓存都可随时重建，被删的曲目下次播放时重新生成。
+// 文件数在第一次新增文件时列目录统计，之后在内存中累计。只在主循环中使用。
+class SidecarDir {
+public:
+    SidecarDir(fs::FS &fs, const char *dir, size_t maxFiles);
+
+    bool prepare(); // 目录不存在时创建
+    // 把已完整写入的 tmpPath 提交为 path（FAT 的 rename 不能覆盖，先删旧文件）。
+    // 失败返回 false，tmpPath 由调用方删除
+    bool commit(const char *tmpPath, const char *path);
+
+private:
+    void countFiles();
+    void prune(const char *keep);
+
+    fs::FS &_fs;
+    const char *_dir;
+    size_t _maxFiles;
+    long _count; // -1：尚未统计
+};
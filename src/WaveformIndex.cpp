@@ -0,0 +1,157 @@
+#include "WaveformIndex.h"
+#include <FS.h>
+#include <SD.h>
+#include "SidecarDir.h"
+#include "config.h"
+#include "util/PathHash.h"
+#include "util/Crc32.h"
+
+static const uint32_t WAVEFORM_MAGIC = 0x4B504657; // "WFPK"
+static const uint8_t WAVEFORM_VERSION = 1;
+
+static SidecarDir &waveDir() {
+    static SidecarDir dir(SD, "/.wave", SIDECAR_DIR_MAX_FILES);
+    return dir;
+}
+
+WaveformIndex::WaveformIndex()
+    : _feedGeneration(0), _feedSampleRate(0), _mux(portMUX_INITIALIZER_UNLOCKED),
+      _generation(0), _reducing(false), _published(false), _trackId(0), _fileSize(0), _ready(false) {}
+
+void WaveformIndex::open(const String &path) {
+    close();
+    _trackId = pathHash(path.c_str());
+
+    File f = SD.open(path.c_str());
+    if (!f) return;
+    _fileSize = f.size();
+    f.close();
+
+    _ready = loadCache();
+    portENTER_CRITICAL(&_mux);
+    _reducing = !_ready;
+    portEXIT_CRITICAL(&_mux);
+    if (!_ready) Serial.printf("Waveform: reducing %s during playback\n", path.c_str());
+}
+
+void WaveformIndex::close() {
+    portENTER_CRITICAL(&_mux);
+    _generation++;
+    _reducing = false;
+    _published = false;
+    portEXIT_CRITICAL(&_mux);
+    _ready = false;
+    _fileSize = 0;
+}
+
+void WaveformIndex::feed(const int16_t *pcm, size_t frames, uint8_t channels, uint32_t sampleRate,
+                         uint32_t durationSec, uint32_t currentSec) {
+    portENTER_CRITICAL(&_mux);
+    bool reducing = _reducing;
+    uint32_t generation = _generation;
+    portEXIT_CRITICAL(&_mux);
+    if (!reducing) return;
+
+    if (generation != _feedGeneration) {
+        _feedGeneration = generation;
+        _reducer.reset(0);
+    }
+    // 时长要等解码库解析完文件头才知道
+    if (sampleRate == 0 || durationSec == 0 || channels == 0) return;
+    if (!_reducer.started()) {
+        _reducer.reset((uint64_t)durationSec * sampleRate);
+        _feedSampleRate = sampleRate;
+    }
+    if (sampleRate != _feedSampleRate) return;
+
+    // 续播、跳转后解码位置与已累加的帧数不再一致，按播放时间重新对齐
+    uint64_t expected = (uint64_t)currentSec * sampleRate;
+    uint64_t pos = _reducer.position();
+    if ((pos > expected ? pos - expected : expected - pos) > 2ull * sampleRate) _reducer.seek(expected);
+
+    _reducer.put(pcm, frames, channels);
+    if (!_reducer.complete()) return;
+
+    portENTER_CRITICAL(&_mux);
+    if (_generation == generation && _reducing) {
+        memcpy(_pending, _reducer.columns(), sizeof(_pending));
+        _published = true;
+        _reducing = false;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool WaveformIndex::update() {
+    if (_ready) return false;
+    bool published = false;
+    portENTER_CRITICAL(&_mux);
+    if (_published) {
+        memcpy(_columns, _pending, sizeof(_columns));
+        _published = false;
+        published = true;
+    }
+    portEXIT_CRITICAL(&_mux);
+    if (!published) return false;
+
+    _ready = true;
+    Serial.println("Waveform: complete");
+    saveCache();
+    return true;
+}
+
+int32_t WaveformIndex::gapTarget(uint32_t currentSec, uint32_t durationSec, int dir) const {
+    if (!_ready || durationSec == 0) return -1;
+    int column = (uint64_t)currentSec * PeakReducer::kColumns / durationSec;
+    if (column >= PeakReducer::kColumns) column = PeakReducer::kColumns - 1;
+    int target = PeakReducer::findGap(_columns, PeakReducer::kColumns, column, dir);
+    if (target < 0) return -1;
+    return (uint64_t)target * durationSec / PeakReducer::kColumns;
+}
+
+String WaveformIndex::cachePath() const {
+    char name[40];
+    snprintf(name, sizeof(name), "/.wave/%016llx.pk", (unsigned long long)_trackId);
+    return String(name);
+}
+
+bool WaveformIndex::loadCache() {
+    String path = cachePath();
+    if (!SD.exists(path.c_str())) return false;
+
+    File f = SD.open(path.c_str());
+    if (!f) return false;
+
+    uint32_t magic = 0, fileSize = 0, crc = 0;
+    uint8_t version = 0;
+    bool ok = f.read((uint8_t *)&magic, 4) == 4 && f.read(&version, 1) == 1 &&
+              f.read((uint8_t *)&fileSize, 4) == 4 &&
+              f.read((uint8_t *)_columns, sizeof(_columns)) == sizeof(_columns) &&
+              f.read((uint8_t *)&crc, 4) == 4;
+    f.close();
+    // 文件被替换（大小变化）或内容损坏则视为失效
+    return ok && magic == WAVEFORM_MAGIC && version == WAVEFORM_VERSION && fileSize == _fileSize &&
+           crc == crc32(_columns, sizeof(_columns));
+}
+
+void WaveformIndex::saveCache() {
+    if (!waveDir().prepare()) return;
+
+    // 与 SeekIndex 相同：先写临时文件再改名，卡满或断电不会留下截断的波形
+    String path = cachePath();
+    String tmpPath = path + ".tmp";
+    File f = SD.open(tmpPath.c_str(), FILE_WRITE);
+    if (!f) {
+        Serial.println("Waveform: failed to save cache");
+        return;
+    }
+    uint32_t crc = crc32(_columns, sizeof(_columns));
+    bool ok = f.write((const uint8_t *)&WAVEFORM_MAGIC, 4) == 4 && f.write(&WAVEFORM_VERSION, 1) == 1 &&
+              f.write((const uint8_t *)&_fileSize, 4) == 4 &&
+              f.write((const uint8_t *)_columns, sizeof(_columns)) == sizeof(_columns) &&
+              f.write((const uint8_t *)&crc, 4) == 4;
+    f.close();
+    if (!ok || !waveDir().commit(tmpPath.c_str(), path.c_str())) {
+        Serial.println("Waveform: failed to save cache");
+        SD.remove(tmpPath.c_str());
+    }
+}
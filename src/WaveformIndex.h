@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include "dsp/PeakReducer.h"
+
+// 每文件的波形概览：PeakReducer::kColumns 列峰值 / RMS，与进度条逐像素对应。
+// 首次播放时在音频任务的 PCM 钩子里归约（feed），各列覆盖后由主循环写入 SD 卡
+// /.wave/<路径哈希>.pk（文件数上限见 SidecarDir），之后换曲直接加载；也可以用 tools/gen_waveforms.py 离线生成。
+// 归约器只由音频任务访问；与主循环之间只交换代号、开关和完成的结果，临界区内不做计算。
+class WaveformIndex {
+public:
+    WaveformIndex();
+
+    void open(const String &path); // 换曲时调用：命中缓存则直接可用，否则在播放中归约
+    void close();
+    // 音频任务：送入解码后的 PCM（变速之前）。currentSec 用于发现跳转并对齐归约位置
+    void feed(const int16_t *pcm, size_t frames, uint8_t channels, uint32_t sampleRate,
+              uint32_t durationSec, uint32_t currentSec);
+    bool update(); // 主循环：归约完成时保存缓存，返回 true 表示波形刚刚可用
+
+    bool isReady() const { return _ready; }
+    const WaveColumn *columns() const { return _ready ? _columns : nullptr; }
+    // 跳转目标（秒）：当前位置之后 / 之前最近的停顿结束处，没有波形或找不到停顿时返回 -1
+    int32_t gapTarget(uint32_t currentSec, uint32_t durationSec, int dir) const;
+
+private:
+    String cachePath() const;
+    bool loadCache();
+    void saveCache();
+
+    // 音频任务私有
+    PeakReducer _reducer;
+    uint32_t _feedGeneration;
+    uint32_t _feedSampleRate;
+
+    // 两侧共享，持锁访问：换曲时代号加一，音频任务据此重置归约器并丢弃上一首的结果
+    portMUX_TYPE _mux;
+    uint32_t _generation;
+    bool _reducing;
+    bool _published;
+    WaveColumn _pending[PeakReducer::kColumns];
+
+    // 主循环私有
+    uint64_t _trackId;
+    uint32_t _fileSize;
+    bool _ready;
+    WaveColumn _columns[PeakReducer::kColumns];
+};
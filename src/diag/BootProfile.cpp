@@ -0,0 +1,32 @@
+#include "BootProfile.h"
+#include "TraceRecorder.h"
+
+static const char *const kPhaseNames[BOOT_PHASE_COUNT] = {
+    "runtime", "display", "storage", "modes", "playlist", "audio", "input", "track",
+};
+
+BootProfile::BootProfile() : _us{}, _last(0), _firstAudio(0), _handoff(false) {}
+
+void BootProfile::mark(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT) return;
+    uint32_t now = (uint32_t)TraceRecorder::nowUs();
+    _us[phase] += now - _last;
+    _last = now;
+    if (phase == BOOT_PHASE_TRACK && _firstAudio == 0) _firstAudio = now;
+}
+
+void BootProfile::report(bool handoff) {
+    _handoff = handoff;
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        if (_us[i]) trace(TRACE_SECTION, TRACE_SEC_BOOT, i, _us[i]);
+    }
+    print();
+}
+
+void BootProfile::print() const {
+    Serial.printf("Boot (%s): %.1f ms total, first audio at %.1f ms\n", _handoff ? "handoff" : "cold",
+                  _last / 1000.0f, _firstAudio / 1000.0f);
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        if (_us[i]) Serial.printf("  %-9s %8.1f ms\n", kPhaseNames[i], _us[i] / 1000.0f);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+// 开机耗时分解：setup() 在每个阶段结束时 mark()，记入与上一次标记的间隔。
+// 计时零点为 esp_timer 启动（app_main 之前），第一个阶段包含 setup() 之前的运行时初始化。
+// 交接快速启动的阶段顺序不同（先开播、后建索引），同一阶段可多次标记，耗时累加。
+// report() 输出分解表，并写入事件追踪（TRACE_SECTION / TRACE_SEC_BOOT，a = 阶段）。
+// 以下枚举值写入追踪文件，只能追加（tools/trace_tool.py 中有同样的表）
+enum BootPhase : uint8_t {
+    BOOT_PHASE_RUNTIME,  // 进入 setup() 之前
+    BOOT_PHASE_DISPLAY,  // 屏幕初始化
+    BOOT_PHASE_STORAGE,  // PSRAM / 追踪缓冲 / SPI / SD 挂载
+    BOOT_PHASE_MODES,    // 模式清单与书签
+    BOOT_PHASE_PLAYLIST, // 索引构建（缓存加载或扫描）
+    BOOT_PHASE_AUDIO,    // 设置、变速、音频任务
+    BOOT_PHASE_INPUT,    // 按键、麦克风、功耗管理
+    BOOT_PHASE_TRACK,    // 打开首曲，此后开始出声
+    BOOT_PHASE_COUNT
+};
+
+class BootProfile {
+public:
+    BootProfile();
+
+    void mark(BootPhase phase);
+    void report(bool handoff); // setup() 结束时调用：写入追踪并输出
+    void print() const;        // 串口命令 "boot"
+    uint32_t firstAudioUs() const { return _firstAudio; }
+
+private:
+
+    uint32_t _us[BOOT_PHASE_COUNT];
+    uint32_t _last;
+    uint32_t _firstAudio; // 首曲打开完成的时刻，0 表示尚未开播
+    bool _handoff;
+};
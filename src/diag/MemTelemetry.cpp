@@ -0,0 +1,70 @@
+#include "MemTelemetry.h"
+#include <esp_heap_caps.h>
+
+MemTelemetry::MemTelemetry() : _internal{ 0, 0 }, _psram{ 0, 0 }, _lowInternal{ 0, 0 }, _lowPsram{ 0, 0 },
+                               _external{}, _probeFree(0), _window(0), _primed(false) {}
+
+MemTelemetry::HeapStats MemTelemetry::read(uint32_t caps) {
+    HeapStats s;
+    s.freeBytes = heap_caps_get_free_size(caps);
+    s.largestBlock = heap_caps_get_largest_free_block(caps);
+    return s;
+}
+
+static void lowerTo(MemTelemetry::HeapStats &low, const MemTelemetry::HeapStats &now) {
+    if (now.freeBytes < low.freeBytes) low.freeBytes = now.freeBytes;
+    if (now.largestBlock < low.largestBlock) low.largestBlock = now.largestBlock;
+}
+
+void MemTelemetry::sample() {
+    _internal = read(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    _psram = read(MALLOC_CAP_SPIRAM);
+    if (!_primed) {
+        _lowInternal = _internal;
+        _lowPsram = _psram;
+        _primed = true;
+    }
+    lowerTo(_lowInternal, _internal);
+    lowerTo(_lowPsram, _psram);
+}
+
+void MemTelemetry::beginProbe() {
+    _probeFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
+void MemTelemetry::endProbe(MemTag tag) {
+    if (tag >= MEM_TAG_COUNT) return;
+    int32_t used = (int32_t)_probeFree - (int32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    // 期间若先释放了旧的解码器状态，差值可能为负，按 0 计
+    _external[tag] = used > 0 ? used : 0;
+}
+
+void MemTelemetry::printHeap(const char *name, const HeapStats &now, const HeapStats &low) {
+    uint32_t frag = now.freeBytes ? 100 - (uint64_t)now.largestBlock * 100 / now.freeBytes : 0;
+    Serial.printf("  %-8s free %7u (low %7u)  largest %7u (low %7u)  frag %u%%\n",
+                  name, now.freeBytes, low.freeBytes, now.largestBlock, low.largestBlock, frag);
+}
+
+void MemTelemetry::report(const char *reason) {
+    sample();
+    Serial.printf("Mem [%s] window %u\n", reason, _window);
+    printHeap("internal", _internal, _lowInternal);
+    if (_psram.freeBytes) printHeap("psram", _psram, _lowPsram);
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        MemTag tag = (MemTag)i;
+        Serial.printf("  %-8s %7d (peak %7d)", memTagName(tag), memCurrent(tag), memPeak(tag));
+        if (_external[i]) Serial.printf("  + lib ~%d", _external[i]);
+        Serial.println();
+    }
+}
+
+void MemTelemetry::onTrackChange(const char *nextTrack) {
+    report("track change");
+    Serial.printf("  next: %s\n", nextTrack);
+
+    // 新窗口：低水位从当前值开始，计数器峰值重置为当前用量
+    _window++;
+    _lowInternal = _internal;
+    _lowPsram = _psram;
+    memResetPeaks();
+}
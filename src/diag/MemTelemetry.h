@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../util/CountingAllocator.h"
+
+// 内存遥测：采样内部 RAM 与 PSRAM 的空闲量和最大连续块（碎片程度），
+// 汇总各子系统的计数分配器用量，并按曲目统计低水位 / 峰值，切歌时通过串口输出。
+// 第三方库（LovyanGFX、音频解码器）的分配无法挂计数器，用前后空闲量之差近似归属。
+class MemTelemetry {
+public:
+    struct HeapStats {
+        uint32_t freeBytes;
+        uint32_t largestBlock;
+    };
+
+    MemTelemetry();
+
+    void sample(); // 周期调用（约 1 秒），更新本窗口低水位
+    void onTrackChange(const char *nextTrack); // 输出上一首期间的统计并开启新窗口
+    void report(const char *reason);
+
+    // 第三方库分配归属：beginProbe() → 调用库 → endProbe(tag)
+    void beginProbe();
+    void endProbe(MemTag tag);
+
+    HeapStats internal() const { return _internal; }
+    HeapStats psram() const { return _psram; }
+
+private:
+    static HeapStats read(uint32_t caps);
+    static void printHeap(const char *name, const HeapStats &now, const HeapStats &low);
+
+    HeapStats _internal;
+    HeapStats _psram;
+    HeapStats _lowInternal; // 本窗口最小空闲 / 最小最大块
+    HeapStats _lowPsram;
+
+    int32_t _external[MEM_TAG_COUNT]; // 近似归属给各标签的库内存
+    uint32_t _probeFree;
+    uint32_t _window;
+    bool _primed;
+};
@@ -0,0 +1,94 @@
+#include "TraceRecorder.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../util/Crc32.h"
+#include "../util/CountingAllocator.h"
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+TraceRecorder &traceRecorder() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder() : _ring(nullptr), _capacity(0), _head(0) {}
+
+TraceRecorder::~TraceRecorder() {
+    if (_ring) {
+        memCount(MEM_CACHE, -(int32_t)(_capacity * sizeof(TraceRecord)));
+        free(_ring);
+    }
+}
+
+uint64_t TraceRecorder::nowUs() {
+#ifdef ESP_PLATFORM
+    return (uint64_t)esp_timer_get_time();
+#else
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+bool TraceRecorder::begin(size_t capacity) {
+    if (_ring || capacity == 0) return _ring != nullptr;
+    size_t bytes = capacity * sizeof(TraceRecord);
+    void *p = nullptr;
+#ifdef ESP_PLATFORM
+    p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (!p) p = malloc(bytes); // 无 PSRAM 时退回内部 RAM
+    if (!p) return false;
+
+    memset(p, 0, bytes);
+    memCount(MEM_CACHE, (int32_t)bytes);
+    _capacity = capacity;
+    _ring = (TraceRecord *)p; // 最后发布：未初始化前 record() 直接丢弃
+    return true;
+}
+
+void TraceRecorder::record(TraceType type, uint8_t code, uint16_t a, uint32_t b) {
+    TraceRecord *ring = _ring;
+    if (!ring) return;
+    uint32_t slot = _head.fetch_add(1, std::memory_order_relaxed);
+    TraceRecord &r = ring[slot % _capacity];
+    r.timeUs = nowUs();
+    r.type = type;
+    r.code = code;
+    r.a = a;
+    r.b = b;
+}
+
+bool TraceRecorder::flush(const Writer &write) const {
+    if (!_ring) return false;
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t count = head < _capacity ? head : (uint32_t)_capacity;
+    uint32_t dropped = head - count;
+
+    uint8_t header[16];
+    memcpy(header, "TRC1", 4);
+    uint16_t version = kVersion;
+    uint16_t recordSize = sizeof(TraceRecord);
+    memcpy(header + 4, &version, 2);
+    memcpy(header + 6, &recordSize, 2);
+    memcpy(header + 8, &count, 4);
+    memcpy(header + 12, &dropped, 4);
+    uint32_t crc = crc32(header, sizeof(header));
+    if (!write(header, sizeof(header))) return false;
+
+    // 分块拷出再写，避免写卡期间直接引用正在被覆盖的槽位
+    TraceRecord chunk[32];
+    uint32_t first = head - count;
+    for (uint32_t done = 0; done < count;) {
+        uint32_t n = count - done;
+        if (n > 32) n = 32;
+        for (uint32_t i = 0; i < n; i++) chunk[i] = _ring[(first + done + i) % _capacity];
+        crc = crc32(chunk, n * sizeof(TraceRecord), crc);
+        if (!write(chunk, n * sizeof(TraceRecord))) return false;
+        done += n;
+    }
+    return write(&crc, sizeof(crc));
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <functional>
+
+// 二进制事件追踪：按键、命令、打开曲目、缓存命中、断流和分段耗时写入 PSRAM 环形缓冲，
+// 需要时整体落盘（见 main.cpp 的 flushTrace），主机端用 tools/trace_tool.py 解码 / 统计 / 重放。
+// 纯 C++，任意任务都可直接调用 trace()：槽位由原子计数器分配，不加锁。
+//
+// 文件格式（小端）：
+//   头 16 字节：magic "TRC1" | u16 版本 | u16 记录长度 | u32 记录数 | u32 被覆盖的记录数
+//   记录数 × TraceRecord（按时间从旧到新）
+//   u32 CRC32（覆盖头与全部记录）
+
+// 以下枚举值写入文件，只能追加，不能重排（tools/trace_tool.py 中有同样的表）
+enum TraceType : uint8_t {
+    TRACE_MARK,       // code = TraceMark
+    TRACE_BUTTON,     // code = GestureType，a = 按键编号 | 组合键位掩码 << 8，b = 连击次数
+    TRACE_COMMAND,    // code = TraceCommand，主循环实际执行的操作（可重放）
+    TRACE_TRACK_OPEN, // code = 是否成功，a = 模式编号，b = 路径哈希低 32 位
+    TRACE_CACHE,      // code = TraceCache，a = 模式编号，b = 曲目数
+    TRACE_UNDERRUN,   // 已停用（断流统一记为 TRACE_DEADLINE），保留编号
+    TRACE_DEADLINE,   // b = 错过截止期的间隔 (us)
+    TRACE_SECTION,    // code = TraceSection，a = 参数，b = 耗时 (us)
+    TRACE_STREAM,     // code = TraceStream，a = 重连次数，b 见各项
+};
+
+enum TraceCommand : uint8_t {
+    TRACE_CMD_PLAY_PAUSE,
+    TRACE_CMD_NEXT_SONG,
+    TRACE_CMD_PREV_SONG,
+    TRACE_CMD_NEXT_MODE,
+    TRACE_CMD_PREV_MODE,
+    TRACE_CMD_SPEED,
+    TRACE_CMD_SEEK_FORWARD,
+    TRACE_CMD_SEEK_BACKWARD,
+    TRACE_CMD_AB_REPEAT,
+    TRACE_CMD_SLEEP_TIMER,
+    TRACE_CMD_VOLUME_UP,
+    TRACE_CMD_VOLUME_DOWN,
+    TRACE_CMD_MUTE,
+    TRACE_CMD_LED_TOGGLE,
+    TRACE_CMD_TRACK_END,
+    TRACE_CMD_COUNT
+};
+
+enum TraceCache : uint8_t {
+    TRACE_CACHE_HIT,
+    TRACE_CACHE_MISS,     // 无缓存或已过期，重新扫描
+    TRACE_CACHE_RESIDENT, // 模式常驻内存，只交换指针
+};
+
+enum TraceSection : uint8_t {
+    TRACE_SEC_MODE_SWITCH,
+    TRACE_SEC_MODE_BUILD,
+    TRACE_SEC_SCAN,
+    TRACE_SEC_TRACK_OPEN,
+    TRACE_SEC_UI_FRAME,
+    TRACE_SEC_TRACE_FLUSH,
+    TRACE_SEC_BOOT,        // a = BootPhase
+};
+
+enum TraceStream : uint8_t {
+    TRACE_STREAM_CONNECT,   // b = 连续失败次数
+    TRACE_STREAM_START,     // 响应头有效，开始接收（b = HTTP 状态码）
+    TRACE_STREAM_STALL,     // 超时无数据，重连（b = 距上次收到数据的 ms）
+    TRACE_STREAM_CLOSED,    // 服务器关闭连接，重连（b 同上）
+    TRACE_STREAM_BACKOFF,   // b = 退避等待 ms
+    TRACE_STREAM_FAILED,    // 不再重试（b = HTTP 状态码，0 为其他原因）
+    TRACE_STREAM_UNDERRUN,  // 抖动缓冲读空（b = 目标深度 ms）
+    TRACE_STREAM_SPLICE,    // 重连后接上新内容（b = 累计丢弃的重复帧）
+};
+
+enum TraceMark : uint8_t {
+    TRACE_MARK_BOOT,  // a = 1 表示交接快速启动
+    TRACE_MARK_FLUSH, // 落盘（a = TraceFlushReason）
+};
+
+enum TraceFlushReason : uint8_t {
+    TRACE_FLUSH_SERIAL,   // 串口命令 "trace"
+    TRACE_FLUSH_UNDERRUN, // 断流后延迟落盘，包含事后的几秒
+    TRACE_FLUSH_SLEEP,    // 深度睡眠前
+};
+
+struct TraceRecord {
+    uint64_t timeUs; // 自启动起的微秒数
+    uint8_t type;
+    uint8_t code;
+    uint16_t a;
+    uint32_t b;
+};
+static_assert(sizeof(TraceRecord) == 16, "trace file format depends on the record size");
+
+class TraceRecorder {
+public:
+    static const uint16_t kVersion = 1;
+    using Writer = std::function<bool(const void *data, size_t len)>;
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    bool begin(size_t capacity); // 缓冲区优先放在 PSRAM；capacity 为记录条数
+    void record(TraceType type, uint8_t code, uint16_t a, uint32_t b);
+
+    // 按文件格式输出当前缓冲（从旧到新）。录制不暂停：落盘期间被覆盖的最旧记录可能不一致
+    bool flush(const Writer &write) const;
+
+    size_t capacity() const { return _capacity; }
+    uint32_t recorded() const { return _head.load(std::memory_order_relaxed); }
+
+    static uint64_t nowUs();
+
+private:
+    TraceRecord *_ring;
+    size_t _capacity;
+    std::atomic<uint32_t> _head; // 已分配的槽位总数（单调递增）
+};
+
+TraceRecorder &traceRecorder(); // 全局实例
+
+inline void trace(TraceType type, uint8_t code = 0, uint16_t a = 0, uint32_t b = 0) {
+    traceRecorder().record(type, code, a, b);
+}
+
+// 作用域计时：析构时记录 TRACE_SECTION；耗时低于 minUs 的不记录（用于高频路径）
+class TraceScope {
+public:
+    explicit TraceScope(TraceSection section, uint16_t arg = 0, uint32_t minUs = 0)
+        : _section(section), _arg(arg), _minUs(minUs), _start(TraceRecorder::nowUs()) {}
+    ~TraceScope() {
+        uint32_t us = (uint32_t)(TraceRecorder::nowUs() - _start);
+        if (us >= _minUs) trace(TRACE_SECTION, _section, _arg, us);
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    TraceSection _section;
+    uint16_t _arg;
+    uint32_t _minUs;
+    uint64_t _start;
+};
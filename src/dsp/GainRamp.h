@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 立体声 PCM 乘 Q8 增益（256 为原音量），块内从 from 线性过渡到 to，块与块之间不出现台阶。纯 C++。
+inline void applyGainRamp(int16_t *buff, size_t frames, uint16_t from, uint16_t to) {
+    if (frames == 0 || (from == 256 && to == 256)) return;
+    int32_t g = (int32_t)from << 16;
+    int32_t step = (((int32_t)to - (int32_t)from) << 16) / (int32_t)frames;
+    for (size_t i = 0; i < frames; i++, g += step) {
+        int32_t k = g >> 16;
+        buff[i * 2] = (int16_t)((buff[i * 2] * k) >> 8);
+        buff[i * 2 + 1] = (int16_t)((buff[i * 2 + 1] * k) >> 8);
+    }
+}
@@ -0,0 +1,117 @@
+#include "PeakReducer.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+// 第 c 列起始帧：floor(c * total / kColumns)，列宽相差至多 1 帧
+static inline uint64_t columnStart(int c, uint64_t total) {
+    return (uint64_t)c * total / PeakReducer::kColumns;
+}
+
+void PeakReducer::reset(uint64_t totalFrames) {
+    _total = totalFrames;
+    _pos = 0;
+    _channels = 2;
+    _completed = 0;
+    memset(_sumSq, 0, sizeof(_sumSq));
+    memset(_frames, 0, sizeof(_frames));
+    memset(_peak, 0, sizeof(_peak));
+    memset(_done, 0, sizeof(_done));
+    memset(_out, 0, sizeof(_out));
+    if (_total == 0) return;
+    // 极短的曲目会出现零宽列，直接视为完成
+    for (int c = 0; c < kColumns; c++) {
+        if (columnStart(c + 1, _total) == columnStart(c, _total)) finishColumn(c);
+    }
+}
+
+void PeakReducer::seek(uint64_t frame) {
+    _pos = frame < _total ? frame : _total;
+}
+
+void PeakReducer::put(const int16_t *pcm, size_t frames, uint8_t channels) {
+    if (_total == 0 || channels == 0) return;
+    _channels = channels;
+
+    while (frames > 0 && _pos < _total) {
+        // 当前帧所在列：满足 columnStart(c) <= pos 的最大 c
+        int c = (int)(((_pos + 1) * kColumns - 1) / _total);
+        uint64_t start = columnStart(c, _total);
+        uint64_t end = columnStart(c + 1, _total);
+        size_t n = end - _pos < frames ? (size_t)(end - _pos) : frames;
+
+        if (!_done[c]) {
+            // 内层循环只有取绝对值、比较和乘加
+            uint32_t peak = _peak[c];
+            uint64_t sum = 0;
+            size_t samples = n * channels;
+            for (size_t k = 0; k < samples; k++) {
+                int32_t v = pcm[k];
+                uint32_t a = v < 0 ? -v : v;
+                if (a > peak) peak = a;
+                sum += (uint32_t)(v * v);
+            }
+            _peak[c] = peak;
+            _sumSq[c] += sum;
+            _frames[c] += n;
+            if (_frames[c] >= (end - start) * kCoverage / 100) finishColumn(c);
+        }
+
+        pcm += n * channels;
+        frames -= n;
+        _pos += n;
+    }
+}
+
+void PeakReducer::finishColumn(int i) {
+    uint64_t samples = (uint64_t)_frames[i] * _channels;
+    float rms = samples ? sqrtf((float)_sumSq[i] / samples) : 0.0f;
+    _out[i].peak = quantize(_peak[i]);
+    _out[i].rms = quantize(rms);
+    _done[i] = true;
+    _completed++;
+}
+
+uint8_t PeakReducer::quantize(float amplitude) {
+    if (amplitude < 1.0f) return 0;
+    // 255 对应 0dBFS，0 对应 -60dBFS
+    float q = 255.0f + 255.0f * 20.0f * log10f(amplitude / 32768.0f) / 60.0f;
+    if (q <= 0.0f) return 0;
+    if (q >= 255.0f) return 255;
+    return (uint8_t)(q + 0.5f);
+}
+
+int PeakReducer::findGap(const WaveColumn *cols, int count, int column, int dir, uint8_t dropDb, int minRun) {
+    if (!cols || count <= 0 || count > kColumns || minRun < 1) return -1;
+
+    uint8_t levels[kColumns];
+    for (int i = 0; i < count; i++) levels[i] = cols[i].rms;
+    std::nth_element(levels, levels + count / 2, levels + count);
+    int limit = (int)levels[count / 2] - dropDb * 255 / 60;
+    if (limit <= 0) return -1; // 整体很安静，没有可区分的停顿
+
+    auto quiet = [cols, limit](int i) { return cols[i].rms < limit; };
+
+    if (dir > 0) {
+        int run = 0;
+        for (int i = column + 1; i < count; i++) {
+            if (quiet(i)) {
+                run++;
+            } else {
+                if (run >= minRun) return i;
+                run = 0;
+            }
+        }
+        return -1;
+    }
+
+    // 向后：找前面 minRun 列都安静的有声列。从 column - 2 开始，
+    // 刚跳到段首时再按一次会回到上一段，而不是停在原地
+    for (int i = std::min(column - 2, count - 1); i >= minRun; i--) {
+        if (quiet(i)) continue;
+        int k = 1;
+        while (k <= minRun && quiet(i - k)) k++;
+        if (k > minRun) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 波形概览的一列：峰值与 RMS，按 dBFS 对数量化到 0..255（0 = -60dB 及以下，255 = 满幅）
+struct WaveColumn {
+    uint8_t peak;
+    uint8_t rms;
+};
+
+// 流式峰值归约：把整首曲目的 PCM 归约为 kColumns 列（与进度条宽度相同）。
+// 按块输入交织的 16 位 PCM，每列只保存峰值 / 平方和 / 帧数三个累加器，内层循环不做除法。
+// 位置可以跳变（用户跳转）：seek() 后从新位置继续累加，每列累计够 kCoverage 比例的帧才算完成，
+// 全部列完成即 complete()。纯 C++，不分配内存。
+class PeakReducer {
+public:
+    static const int kColumns = 218;
+    static const uint8_t kCoverage = 90; // 百分比
+
+    PeakReducer() { reset(0); }
+
+    void reset(uint64_t totalFrames); // 新曲目；totalFrames 为 0 表示未开始
+    void seek(uint64_t frame);
+    void put(const int16_t *pcm, size_t frames, uint8_t channels);
+
+    bool started() const { return _total > 0; }
+    uint64_t position() const { return _pos; }
+    bool complete() const { return _completed == kColumns; }
+    int completedColumns() const { return _completed; }
+    bool columnReady(int i) const { return _done[i]; }
+    const WaveColumn *columns() const { return _out; }
+
+    // 线性幅度（0..32768）→ 0..255，离线工具 tools/gen_waveforms.py 使用同一公式
+    static uint8_t quantize(float amplitude);
+
+    // 跳转目标：从 column 沿 dir（+1 / -1）寻找安静区（RMS 比全曲中位数低 dropDb 以上、至少 minRun 列），
+    // 返回其后第一列有声音的列号；向后找时跳过紧邻的当前段首。找不到返回 -1。用于在朗诵之间的停顿处跳转
+    static int findGap(const WaveColumn *cols, int count, int column, int dir, uint8_t dropDb = 12, int minRun = 2);
+
+private:
+    void finishColumn(int i);
+
+    uint64_t _total;
+    uint64_t _pos;
+    uint8_t _channels;
+    uint64_t _sumSq[kColumns];
+    uint32_t _frames[kColumns];
+    uint16_t _peak[kColumns];
+    bool _done[kColumns];
+    WaveColumn _out[kColumns];
+    int _completed;
+};
@@ -0,0 +1,157 @@
+#include "TimeStretch.h"
+#include <math.h>
+#include <string.h>
+
+TimeStretch::TimeStretch()
+    : _channels(2), _speed(1.0f), _stepQ16(kSegment << 16), _inFrames(0), _nominalQ16(0),
+      _haveTail(false), _outRead(0), _outFrames(0) {}
+
+void TimeStretch::begin(uint8_t channels) {
+    _channels = channels ? channels : 1;
+
+    // 输入需容纳: 搜索窗 + 两段 + 一次 put 的余量
+    _in.assign((kSegment * 4 + kTolerance * 2 + 2048) * _channels, 0);
+    _tail.assign(kSegment * _channels, 0);
+    _tailMono.assign(kSegment / kDecimate, 0);
+    _out.assign(kSegment * 4 * _channels, 0);
+
+    _fade.resize(kSegment);
+    for (size_t i = 0; i < kSegment; i++) {
+        float w = 0.5f - 0.5f * cosf((float)M_PI * (i + 0.5f) / kSegment);
+        _fade[i] = (int16_t)(w * 32767.0f);
+    }
+    reset();
+}
+
+void TimeStretch::setSpeed(float speed) {
+    if (speed < 0.5f) speed = 0.5f;
+    if (speed > 2.0f) speed = 2.0f;
+    if (speed == _speed) return;
+    _speed = speed;
+    _stepQ16 = (uint32_t)(kSegment * speed * 65536.0f);
+    reset();
+}
+
+void TimeStretch::reset() {
+    _inFrames = 0;
+    _nominalQ16 = 0;
+    _haveTail = false;
+    _outRead = 0;
+    _outFrames = 0;
+}
+
+void TimeStretch::put(const int16_t *samples, size_t frames) {
+    if (_in.empty()) return;
+    const size_t capFrames = _in.size() / _channels;
+
+    while (frames > 0) {
+        size_t room = capFrames - _inFrames;
+        if (room == 0) {
+            // 输出 FIFO 满导致无法消费时，丢弃最旧数据保证实时性
+            if (!processSegment()) {
+                size_t drop = kSegment;
+                memmove(&_in[0], &_in[drop * _channels], (_inFrames - drop) * _channels * sizeof(int16_t));
+                _inFrames -= drop;
+                _nominalQ16 = _nominalQ16 > ((uint64_t)drop << 16) ? _nominalQ16 - ((uint64_t)drop << 16) : 0;
+            }
+            continue;
+        }
+        size_t n = frames < room ? frames : room;
+        memcpy(&_in[_inFrames * _channels], samples, n * _channels * sizeof(int16_t));
+        _inFrames += n;
+        samples += n * _channels;
+        frames -= n;
+
+        while (processSegment()) {}
+    }
+}
+
+size_t TimeStretch::receive(int16_t *out, size_t maxFrames) {
+    const size_t capFrames = _out.size() / _channels;
+    size_t n = _outFrames < maxFrames ? _outFrames : maxFrames;
+    for (size_t i = 0; i < n; i++) {
+        memcpy(&out[i * _channels], &_out[_outRead * _channels], _channels * sizeof(int16_t));
+        _outRead = (_outRead + 1) % capFrames;
+    }
+    _outFrames -= n;
+    return n;
+}
+
+int16_t TimeStretch::monoAt(size_t frame) const {
+    if (_channels == 1) return _in[frame];
+    return (int16_t)(((int32_t)_in[frame * _channels] + _in[frame * _channels + 1]) >> 1);
+}
+
+int64_t TimeStretch::correlate(size_t candidate) const {
+    int64_t acc = 0;
+    for (size_t i = 0; i < kSegment / kDecimate; i++) {
+        acc += (int32_t)_tailMono[i] * monoAt(candidate + i * kDecimate);
+    }
+    return acc;
+}
+
+size_t TimeStretch::findBestOffset(size_t nominal) {
+    size_t lo = nominal > kTolerance ? nominal - kTolerance : 0;
+    size_t hi = nominal + kTolerance;
+
+    // 粗搜索：候选点步长 = 抽取步长
+    size_t best = nominal;
+    int64_t bestScore = INT64_MIN;
+    for (size_t c = lo; c <= hi; c += kDecimate) {
+        int64_t s = correlate(c);
+        if (s > bestScore) { bestScore = s; best = c; }
+    }
+
+    // 细搜索：在粗结果附近逐帧
+    size_t fineLo = best > lo + kDecimate ? best - kDecimate + 1 : lo;
+    size_t fineHi = best + kDecimate - 1 < hi ? best + kDecimate - 1 : hi;
+    for (size_t c = fineLo; c <= fineHi; c++) {
+        int64_t s = correlate(c);
+        if (s > bestScore) { bestScore = s; best = c; }
+    }
+    return best;
+}
+
+bool TimeStretch::processSegment() {
+    const size_t capOut = _out.size() / _channels;
+    if (capOut - _outFrames < kSegment) return false;
+
+    size_t nominal = (size_t)(_nominalQ16 >> 16);
+    // 需要的输入: 搜索上界 + 交叉淡化段 + 新 tail
+    if (nominal + kTolerance + kSegment * 2 > _inFrames) return false;
+
+    size_t best = _haveTail ? findBestOffset(nominal) : nominal;
+
+    // 交叉淡化输出 kSegment 帧
+    size_t w = (_outRead + _outFrames) % capOut;
+    for (size_t i = 0; i < kSegment; i++) {
+        int32_t fadeIn = _fade[i];
+        int32_t fadeOut = 32767 - fadeIn;
+        for (uint8_t ch = 0; ch < _channels; ch++) {
+            int32_t cur = _in[(best + i) * _channels + ch];
+            int32_t v = _haveTail ? (_tail[i * _channels + ch] * fadeOut + cur * fadeIn) >> 15 : cur;
+            _out[w * _channels + ch] = (int16_t)v;
+        }
+        w = (w + 1) % capOut;
+    }
+    _outFrames += kSegment;
+
+    // 新 tail = 所选片段之后的 kSegment 帧
+    memcpy(&_tail[0], &_in[(best + kSegment) * _channels], kSegment * _channels * sizeof(int16_t));
+    for (size_t i = 0; i < kSegment / kDecimate; i++) {
+        size_t f = best + kSegment + i * kDecimate;
+        _tailMono[i] = _channels == 1 ? _in[f] : (int16_t)(((int32_t)_in[f * _channels] + _in[f * _channels + 1]) >> 1);
+    }
+    _haveTail = true;
+    _nominalQ16 += _stepQ16;
+
+    // 丢弃已不可能再被搜索到的输入
+    nominal = (size_t)(_nominalQ16 >> 16);
+    size_t keepFrom = nominal > kTolerance ? nominal - kTolerance : 0;
+    if (keepFrom > 0) {
+        memmove(&_in[0], &_in[keepFrom * _channels], (_inFrames - keepFrom) * _channels * sizeof(int16_t));
+        _inFrames -= keepFrom;
+        _nominalQ16 -= (uint64_t)keepFrom << 16;
+    }
+    return true;
+}
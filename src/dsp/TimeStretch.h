@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "../util/CountingAllocator.h"
+
+// WSOLA 变速不变调 (Waveform Similarity Overlap-Add)
+// 纯 C++ 实现，不依赖 Arduino，输入/输出均为 16bit 交织 PCM。
+//
+// 每一跳输出 kSegment 帧：上一段的"自然延续"(tail) 与输入中最相似的片段做交叉淡化，
+// 输入读指针按 kSegment * speed 前进，因此时长改变而音高不变。
+// 相似度搜索在 4 倍抽取的单声道信号上进行，44.1kHz 下每帧约 40 次乘加，单核余量充足。
+class TimeStretch {
+public:
+    static const size_t kSegment = 512;   // 交叉淡化长度 (帧)，44.1kHz 下约 11.6ms
+    static const size_t kTolerance = 256; // 相似度搜索范围 ±帧
+    static const size_t kDecimate = 4;    // 相关计算的抽取步长
+
+    TimeStretch();
+
+    void begin(uint8_t channels = 2);
+    void setSpeed(float speed);   // 0.5 ~ 2.0，1.0 为直通
+    float getSpeed() const { return _speed; }
+    bool isActive() const { return _speed != 1.0f; }
+    void reset();                 // 换曲/跳转后调用，丢弃内部缓存
+
+    // 写入 frames 帧交织 PCM
+    void put(const int16_t *samples, size_t frames);
+    // 取出最多 maxFrames 帧，返回实际帧数
+    size_t receive(int16_t *out, size_t maxFrames);
+
+private:
+    bool processSegment();
+    size_t findBestOffset(size_t nominal);
+    int64_t correlate(size_t candidate) const;
+    int16_t monoAt(size_t frame) const;
+
+    uint8_t _channels;
+    float _speed;
+    uint32_t _stepQ16;        // 每跳输入前进量 (Q16 帧)
+
+    TaggedVector<int16_t, MEM_DECODER> _in; // 输入 FIFO (交织)
+    size_t _inFrames;
+    uint64_t _nominalQ16;     // 下一段的名义起点，相对 _in[0]
+
+    TaggedVector<int16_t, MEM_DECODER> _tail;     // 上一段之后的自然延续 kSegment 帧
+    TaggedVector<int16_t, MEM_DECODER> _tailMono; // tail 的抽取单声道，用于相关
+    bool _haveTail;
+
+    TaggedVector<int16_t, MEM_DECODER> _out; // 输出 FIFO (交织)
+    size_t _outRead;
+    size_t _outFrames;
+
+    TaggedVector<int16_t, MEM_DECODER> _fade; // Q15 升余弦淡入表
+};
@@ -0,0 +1,162 @@
+#include "ClapDetector.h"
+
+ClapDetector::ClapDetector() {
+    reset();
+}
+
+void ClapDetector::reset() {
+    _state = STATE_IDLE;
+    _last = 0;
+    _prevLevel = 0;
+    _floor = 0;
+    _peak = 0;
+    _candFrames = 0;
+    _outNow = kSilent;
+    for (int i = 0; i < kMaxLag; i++) {
+        _outRing[i] = kSilent;
+        _lagMean[i] = 0;
+        _lagDev[i] = 0;
+    }
+    _outPos = 0;
+    _bestLag = 0;
+    _echoFrames = 0;
+    _frame = 0;
+    _lastClap = 0;
+    _lastOnset = 0;
+    _count = 0;
+    _rejected = 0;
+}
+
+int16_t ClapDetector::log2Q8(uint64_t value) {
+    if (value == 0) return 0;
+    int msb = 63 - __builtin_clzll(value);
+    // 尾数取最高位之后的 8 位，线性近似 log2(1+x)，误差 < 0.1（约 0.3dB）
+    uint32_t frac = msb >= 8 ? (uint32_t)(value >> (msb - 8)) & 0xFF : (uint32_t)(value << (8 - msb)) & 0xFF;
+    return (int16_t)(msb * 256 + frac);
+}
+
+int16_t ClapDetector::outputLevel(const int16_t *pcm, size_t samples, size_t stride) {
+    if (samples == 0 || stride == 0) return kSilent;
+    // 与麦克风相同的一阶差分，耦合估计才与频谱无关（低音鼓输出很响，但到麦克风的差分能量很小）
+    uint64_t sum = 0;
+    size_t n = 0;
+    for (size_t i = stride; i < samples; i += stride, n++) {
+        int32_t d = pcm[i] - pcm[i - stride];
+        sum += (uint32_t)d * (uint32_t)d;
+    }
+    if (n == 0) return kSilent;
+    // 均方值，与块长无关
+    return log2Q8(sum) - log2Q8(n);
+}
+
+int16_t ClapDetector::echoFloor() const {
+    // 输出块（约 26ms）与麦克风帧不对齐，取最佳延迟前后各一帧的最大值
+    int16_t out = kSilent;
+    for (int k = _bestLag - 1; k <= _bestLag + 1; k++) {
+        if (k >= 0 && k < kMaxLag && outputAt(k) > out) out = outputAt(k);
+    }
+    if (out == kSilent) return kSilent;
+    if (_echoFrames < kMaxLag * 4) return 32767; // 尚未学到耦合：播放开始的一小段时间内不检测
+    int32_t echo = out + _lagMean[_bestLag] + 2 * _lagDev[_bestLag];
+    return echo > 32767 ? 32767 : echo < -32767 ? -32767 : (int16_t)echo;
+}
+
+void ClapDetector::learnEcho(int16_t level) {
+    int32_t best = INT32_MAX;
+    for (int k = 0; k < kMaxLag; k++) {
+        int16_t out = outputAt(k);
+        if (out == kSilent) continue;
+        int32_t diff = level - out - _lagMean[k];
+        _lagMean[k] += diff >> 5;
+        _lagDev[k] += ((diff < 0 ? -diff : diff) - _lagDev[k]) >> 5;
+        if (_lagDev[k] < best) {
+            best = _lagDev[k];
+            _bestLag = k;
+        }
+    }
+    if (_echoFrames < UINT16_MAX) _echoFrames++;
+}
+
+uint8_t ClapDetector::processFrame(const int16_t *frame) {
+    // 一阶差分后的帧能量：|d| <= 65535，d² 在 uint32 内
+    uint64_t energy = 0;
+    int32_t prev = _last;
+    for (size_t i = 0; i < kFrame; i++) {
+        int32_t d = frame[i] - prev;
+        prev = frame[i];
+        energy += (uint32_t)d * (uint32_t)d;
+    }
+    _last = prev;
+    int16_t level = log2Q8(energy);
+
+    _outRing[_outPos] = _outNow;
+    _outPos = (_outPos + 1) % kMaxLag;
+    int16_t echo = echoFloor();
+    // 起音须同时高出环境底噪 onsetDb、高出回声预测 echoMarginDb
+    int32_t margin = level - _floor - onsetDb * kDbQ8;
+    if (echo != kSilent && level - echo - echoMarginDb * kDbQ8 < margin) margin = level - echo - echoMarginDb * kDbQ8;
+
+    // 底噪：下降快、上升慢，开头 0.5 秒快速收敛；起音候选期间不更新
+    if (_state != STATE_CANDIDATE) {
+        int32_t diff = level - _floor;
+        _floor += diff < 0 || _frame < 50 ? diff >> 2 : diff >> 7;
+    }
+
+    switch (_state) {
+        case STATE_IDLE:
+            if (margin >= 0 && level - _prevLevel >= attackDb * kDbQ8) {
+                _state = STATE_CANDIDATE;
+                _peak = level;
+                _candFrames = 0;
+                _lastOnset = _frame;
+            }
+            break;
+        case STATE_CANDIDATE:
+            _candFrames++;
+            if (level > _peak) {
+                // 起音后两帧内仍可上升（起音落在帧尾），之后还在变响就是持续的声音
+                if (_candFrames > 2) {
+                    _state = STATE_SUSTAIN;
+                    _rejected++;
+                } else {
+                    _peak = level;
+                }
+            } else if (_peak - level >= decayDb * kDbQ8) {
+                _state = STATE_IDLE;
+                onClap();
+            } else if (_candFrames >= decayFrames) {
+                _state = STATE_SUSTAIN;
+                _rejected++;
+            }
+            break;
+        case STATE_SUSTAIN:
+            if (margin < -(int32_t)onsetDb * kDbQ8 / 2) _state = STATE_IDLE;
+            break;
+    }
+
+    // 只用回声明显高于环境底噪的帧学习耦合；起音候选（可能是拍手）及其后的余音不参与
+    if (_state == STATE_IDLE && _outNow != kSilent && _frame - _lastOnset > 2u * decayFrames &&
+        level - _floor > 6 * kDbQ8) {
+        learnEcho(level);
+    }
+
+    uint8_t claps = 0;
+    if (_count > 0 && _state != STATE_CANDIDATE && _frame - _lastClap >= endGapFrames) {
+        if (_count >= minClaps && _count <= maxClaps) claps = _count;
+        else _rejected++;
+        _count = 0;
+    }
+    _prevLevel = level;
+    _frame++;
+    return claps;
+}
+
+void ClapDetector::onClap() {
+    if (_count > 0) {
+        uint32_t gap = _lastOnset - _lastClap;
+        if (gap < minGapFrames) return;   // 同一次拍手的反射
+        if (gap > maxGapFrames) _count = 0; // 节奏断开，重新计数
+    }
+    _count++;
+    _lastClap = _lastOnset;
+}
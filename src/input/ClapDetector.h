@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 拍手口令识别（纯 C++，定点运算，不依赖 Arduino）
+// 输入为 16kHz 单声道 PCM，每次一帧 kFrame 个采样（10ms），输出连续拍手的次数。
+//
+// 前端：一阶差分（突出拍手的宽带高频）后求帧能量，取 log2（Q8，约 85 单位 / dB）。
+// 拍手 = 起音：比环境底噪高 onsetDb 且比上一帧陡增 attackDb；之后 decayFrames 帧内回落 decayDb。
+// 说话、音乐的音节起音较缓、持续较长，在这一步被排除。
+// 播放时起音还须比"回声预测"高 echoMarginDb。回声预测 = 若干帧之前的播放输出电平 + 扬声器→麦克风耦合：
+// 对 0..kMaxLag 帧的每个延迟跟踪 (麦克风电平 - 输出电平) 的均值与平均偏差，偏差最小的即为实际延迟
+// （I2S DMA 与声学路径），耦合取该延迟的均值加两倍偏差。音量越大、播放越响，门限越高，不会被自己的声音触发。
+// 节奏：相邻两拍间隔 minGap..maxGap，最后一拍后 endGap 内无新拍手即结束，次数在 minClaps..maxClaps 内才输出。
+class ClapDetector {
+public:
+    static const size_t kFrame = 160;      // 16kHz 下 10ms
+    static const int kDbQ8 = 85;           // 1dB 能量对应的 log2 Q8 单位
+    static const int16_t kSilent = -32768; // 无播放输出
+    static const int kMaxLag = 32;         // 回声延迟搜索范围（320ms，覆盖 I2S DMA 延迟）
+
+    // 阈值（dB）与节奏（帧）
+    uint8_t onsetDb = 15;
+    uint8_t attackDb = 9;
+    uint8_t decayDb = 10;
+    uint8_t decayFrames = 8;   // 80ms 内须回落
+    uint8_t echoMarginDb = 6;  // 播放时须高出回声预测的余量
+    uint8_t minGapFrames = 12; // 120ms
+    uint8_t maxGapFrames = 70; // 700ms
+    uint8_t endGapFrames = 80; // 800ms
+    uint8_t minClaps = 2;      // 单次拍手误触发率太高，不作为口令
+    uint8_t maxClaps = 5;
+
+    ClapDetector();
+    void reset();
+
+    // 处理一帧，返回本帧结束的拍手序列次数（0 表示没有）
+    uint8_t processFrame(const int16_t *frame);
+    // 当前播放输出电平（outputLevel 的返回值），不播放时为 kSilent。每帧调用前设置
+    void setOutputLevel(int16_t level) { _outNow = level; }
+
+    // 播放输出的电平（一阶差分后的均方值，log2 Q8）；stride 为同一声道相邻采样的间隔（交织立体声取 2）
+    static int16_t outputLevel(const int16_t *pcm, size_t samples, size_t stride);
+    static int16_t log2Q8(uint64_t value);
+
+    // 诊断
+    int16_t level() const { return _prevLevel; }
+    int16_t noiseFloor() const { return _floor; }
+    int16_t echoFloor() const; // 回声预测电平，不播放时为 kSilent
+    uint32_t rejected() const { return _rejected; }
+
+private:
+    enum State : uint8_t {
+        STATE_IDLE,
+        STATE_CANDIDATE, // 检测到起音，等待回落
+        STATE_SUSTAIN,   // 持续的响声（说话 / 音乐），回到底噪附近前不再检测
+    };
+
+    void onClap();
+    int16_t outputAt(int lag) const { return _outRing[(_outPos + kMaxLag - 1 - lag) % kMaxLag]; }
+    void learnEcho(int16_t level);
+
+    State _state;
+    int16_t _last;      // 上一帧最后一个采样（差分用）
+    int16_t _prevLevel;
+    int16_t _floor;
+    int16_t _peak;
+    uint8_t _candFrames;
+    int16_t _outNow;
+    int16_t _outRing[kMaxLag]; // 最近 kMaxLag 帧的输出电平
+    uint8_t _outPos;
+    int32_t _lagMean[kMaxLag]; // 各延迟下 麦克风电平 - 输出电平 的均值与平均偏差
+    int32_t _lagDev[kMaxLag];
+    uint8_t _bestLag;
+    uint16_t _echoFrames;      // 已学习的帧数，不足时播放中不检测
+
+    uint32_t _frame;
+    uint32_t _lastClap;
+    uint32_t _lastOnset;
+    uint8_t _count;
+    uint32_t _rejected;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// GPIO 中断记录的按键边沿
+struct ButtonEdge {
+    uint8_t button;
+    uint8_t pressed;
+    uint32_t timeMs;
+};
+
+// 单生产者（ISR）单消费者（主循环）环形队列，满时覆盖最旧的边沿：
+// 最新的边沿决定按键当前状态，丢掉它会让按键卡在按下；丢掉旧的只会漏掉一次早先的点击。
+// 生产者在写槽位前后各递增一个计数（_started / _written），都只由生产者修改；
+// 消费者自己记录读位置，读完一条后复查 _started，若这期间该槽位已开始被覆盖则丢弃读到的内容。纯 C++。
+template <size_t N>
+class EdgeRing {
+public:
+    EdgeRing() : _started(0), _written(0), _read(0), _dropped(0) {}
+
+    inline __attribute__((always_inline)) void push(uint8_t button, bool pressed, uint32_t timeMs) {
+        uint32_t w = _written;
+        __atomic_store_n(&_started, w + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST); // 先公布 _started，再写槽位
+        ButtonEdge &e = _slots[w % N];
+        e.button = button;
+        e.pressed = pressed;
+        e.timeMs = timeMs;
+        __atomic_store_n(&_written, w + 1, __ATOMIC_RELEASE);
+    }
+
+    bool pop(ButtonEdge &out) {
+        while (true) {
+            uint32_t w = __atomic_load_n(&_written, __ATOMIC_ACQUIRE);
+            if (w - _read > N) { // 已被覆盖的条目
+                _dropped += w - _read - N;
+                _read = w - N;
+            }
+            if (_read == w) return false;
+
+            out = _slots[_read % N];
+            __atomic_thread_fence(__ATOMIC_SEQ_CST); // 先读完槽位，再复查 _started
+            // 生产者开始写第 _read + N 条即覆盖本槽位
+            bool overwritten = __atomic_load_n(&_started, __ATOMIC_ACQUIRE) - _read > N;
+            _read++;
+            if (!overwritten) return true;
+            _dropped++;
+        }
+    }
+
+    uint32_t dropped() const { return _dropped; }
+
+private:
+    ButtonEdge _slots[N];
+    uint32_t _started;
+    uint32_t _written;
+    uint32_t _read;
+    uint32_t _dropped;
+};
@@ -0,0 +1,139 @@
+#include "GestureRecognizer.h"
+#include <string.h>
+
+GestureRecognizer::GestureRecognizer() : _head(0), _count(0) {
+    memset(_buttons, 0, sizeof(_buttons));
+}
+
+void GestureRecognizer::emit(GestureType type, uint8_t button, uint8_t buttons, uint8_t clicks) {
+    if (_count == kQueueSize) return; // 队列满则丢弃
+    Gesture &g = _queue[(_head + _count) % kQueueSize];
+    g.type = type;
+    g.button = button;
+    g.buttons = buttons;
+    g.clicks = clicks;
+    _count++;
+}
+
+bool GestureRecognizer::poll(Gesture &out) {
+    if (_count == 0) return false;
+    out = _queue[_head];
+    _head = (_head + 1) % kQueueSize;
+    _count--;
+    return true;
+}
+
+void GestureRecognizer::onEdge(uint8_t button, bool pressed, uint32_t timeMs) {
+    if (button >= kMaxButtons) return;
+    // 到此边沿为止已稳定满窗口的电平先生效（其间没有别的边沿，电平必然未变），并推进超时
+    settle(timeMs, nullptr);
+
+    Button &b = _buttons[button];
+    b.raw = pressed;
+    b.rawTime = timeMs;
+    b.pending = pressed != b.level; // 抖回原电平则取消
+}
+
+void GestureRecognizer::settle(uint32_t nowMs, const bool *levels) {
+    while (true) {
+        int next = -1;
+        for (uint8_t i = 0; i < kMaxButtons; i++) {
+            const Button &b = _buttons[i];
+            if (!b.pending || nowMs - b.rawTime < debounceMs) continue;
+            if (next < 0 || (int32_t)(b.rawTime - _buttons[next].rawTime) < 0) next = i;
+        }
+        if (next < 0) break;
+
+        Button &b = _buttons[next];
+        b.pending = false;
+        if (levels && levels[next] != b.raw) {
+            b.raw = levels[next]; // 复核不符：此后的边沿丢失了，实际电平仍是去抖后的电平
+            b.rawTime = nowMs;
+            continue;
+        }
+        tickAll(b.rawTime);
+        apply(next, b.raw, b.rawTime);
+    }
+    tickAll(nowMs);
+}
+
+void GestureRecognizer::apply(uint8_t button, bool pressed, uint32_t timeMs) {
+    Button &b = _buttons[button];
+    b.level = pressed;
+
+    if (pressed) {
+        // 组合键：另一键刚按下不久且尚未形成长按
+        for (uint8_t o = 0; o < kMaxButtons; o++) {
+            Button &other = _buttons[o];
+            if (o == button || other.state != STATE_DOWN) continue;
+            if (timeMs - other.pressTime > chordMs) continue;
+
+            emit(GESTURE_CHORD, button, (1 << button) | (1 << o), 0);
+            other.state = STATE_HELD;
+            other.clicks = 0;
+            b.state = STATE_HELD;
+            b.clicks = 0;
+            b.pressTime = timeMs;
+            return;
+        }
+
+        if (b.state == STATE_IDLE) b.clicks = 0;
+        b.state = STATE_DOWN;
+        b.pressTime = timeMs;
+    } else {
+        if (b.state == STATE_DOWN) {
+            b.clicks++;
+            b.state = STATE_UP;
+            b.releaseTime = timeMs;
+        } else if (b.state == STATE_HELD) {
+            b.state = STATE_IDLE;
+            b.clicks = 0;
+        }
+    }
+}
+
+void GestureRecognizer::tickButton(uint8_t button, uint32_t nowMs) {
+    Button &b = _buttons[button];
+    if (b.pending) return; // 电平变化待定（可能已松开），到期生效时再按其时间结算
+    switch (b.state) {
+        case STATE_DOWN:
+            if ((int32_t)(nowMs - b.pressTime) >= (int32_t)longPressMs) { // 有符号：迟到的边沿可能早于已生效的按下
+                // 长按前若已有连击，先结算
+                if (b.clicks > 0) emit(GESTURE_CLICK, button, 1 << button, b.clicks);
+                emit(GESTURE_LONG_PRESS, button, 1 << button, 0);
+                b.state = STATE_HELD;
+                b.clicks = 0;
+            }
+            break;
+        case STATE_UP:
+            if ((int32_t)(nowMs - b.releaseTime) > (int32_t)clickMs) {
+                emit(GESTURE_CLICK, button, 1 << button, b.clicks);
+                b.state = STATE_IDLE;
+                b.clicks = 0;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void GestureRecognizer::tick(uint32_t nowMs, const bool *levels) {
+    if (levels) {
+        for (uint8_t i = 0; i < kMaxButtons; i++) {
+            Button &b = _buttons[i];
+            // 实际电平与去抖后的电平不同却没有待定边沿：边沿丢失，从现在开始重新去抖
+            if (!b.pending && levels[i] != b.level) {
+                b.raw = levels[i];
+                b.rawTime = nowMs;
+                b.pending = true;
+            }
+        }
+    }
+    settle(nowMs, levels);
+}
+
+void GestureRecognizer::tickAll(uint32_t nowMs) {
+    for (uint8_t i = 0; i < kMaxButtons; i++) {
+        tickButton(i, nowMs);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 按键手势识别（纯 C++，不依赖 Arduino）
+// 输入为带时间戳的按下/松开边沿（由 GPIO 中断记录），输出单击/多击、长按和组合键。
+// 判定只依赖边沿自身的时间戳：处理每个边沿前先用该时间推进超时，
+// 因此主循环延迟只会推迟事件的分发，不会把双击误判成两次单击。
+// 去抖按电平：任何边沿都重新计时，电平保持 debounceMs 不变才生效，生效时刻取该电平开始的边沿时间。
+// tick() 可带入各键当前的实际电平，到期时据此复核，边沿丢失（队列溢出）也不会卡在按下状态。
+
+enum GestureType : uint8_t {
+    GESTURE_CLICK,      // clicks = 连击次数
+    GESTURE_LONG_PRESS,
+    GESTURE_CHORD,      // buttons = 同时按下的按键位掩码
+};
+
+struct Gesture {
+    GestureType type;
+    uint8_t button;  // 单键手势的按键编号
+    uint8_t buttons; // 组合键位掩码
+    uint8_t clicks;
+};
+
+class GestureRecognizer {
+public:
+    static const uint8_t kMaxButtons = 4;
+    static const size_t kQueueSize = 8;
+
+    // 默认值与 OneButton 保持一致
+    uint16_t debounceMs = 50;
+    uint16_t clickMs = 400;     // 连击间隔上限
+    uint16_t longPressMs = 800;
+    uint16_t chordMs = 150;     // 组合键两次按下的最大间隔
+
+    GestureRecognizer();
+
+    void onEdge(uint8_t button, bool pressed, uint32_t timeMs);
+    // levels：各键此刻的电平（按下为 true），为空则以最后一个边沿为准
+    void tick(uint32_t nowMs, const bool *levels = nullptr);
+    bool poll(Gesture &out);
+    bool isPressed(uint8_t button) const { return _buttons[button].state == STATE_DOWN || _buttons[button].state == STATE_HELD; }
+
+private:
+    enum State : uint8_t {
+        STATE_IDLE,
+        STATE_DOWN,  // 按下中，尚未达到长按
+        STATE_UP,    // 已松开，等待下一次连击
+        STATE_HELD,  // 已触发长按或组合键，松开前不再产生手势
+    };
+
+    struct Button {
+        State state;
+        uint8_t clicks;
+        uint32_t pressTime;
+        uint32_t releaseTime;
+        uint32_t rawTime; // 最后一个边沿的时间
+        bool raw;         // 最后一个边沿的电平
+        bool level;       // 去抖后的电平
+        bool pending;     // raw 与 level 不同，等待去抖窗口到期
+    };
+
+    void settle(uint32_t nowMs, const bool *levels); // 按时间顺序接受已稳定满去抖窗口的电平
+    void apply(uint8_t button, bool pressed, uint32_t timeMs);
+    void tickAll(uint32_t nowMs);
+    void tickButton(uint8_t button, uint32_t nowMs);
+    void emit(GestureType type, uint8_t button, uint8_t buttons, uint8_t clicks);
+
+    Button _buttons[kMaxButtons];
+    Gesture _queue[kQueueSize];
+    size_t _head;
+    size_t _count;
+};
@@ -0,0 +1,102 @@
+#include "MicListener.h"
+#include <driver/i2s.h>
+#include "config.h"
+
+#define MIC_I2S_PORT I2S_NUM_1
+
+MicListener::MicListener()
+    : _task(nullptr), _running(false), _output((uint32_t)(uint16_t)ClapDetector::kSilent << 16),
+      _frames(0), _busyUs(0), _maxUs(0), _overBudget(0), _events(0), _lastReportMs(0) {}
+
+bool MicListener::begin() {
+    // INMP441 一类的 I2S 数字麦克风：24 位数据放在 32 位槽内，L/R 接地为左声道
+    i2s_config_t cfg = {};
+    cfg.mode = I2S_MODE_MASTER | I2S_MODE_RX;
+    cfg.sample_rate = MIC_SAMPLE_RATE;
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+    cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    cfg.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    cfg.dma_buf_count = 4;
+    cfg.dma_buf_len = ClapDetector::kFrame;
+    cfg.use_apll = false;
+
+    i2s_pin_config_t pins = {};
+    pins.mck_io_num = I2S_PIN_NO_CHANGE;
+    pins.bck_io_num = AUDIO_I2S_MIC_GPIO_SCK;
+    pins.ws_io_num = AUDIO_I2S_MIC_GPIO_WS;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = AUDIO_I2S_MIC_GPIO_DIN;
+
+    if (i2s_driver_install(MIC_I2S_PORT, &cfg, 0, NULL) != ESP_OK || i2s_set_pin(MIC_I2S_PORT, &pins) != ESP_OK) {
+        Serial.println("Mic: I2S init failed");
+        return false;
+    }
+    _running = true;
+    xTaskCreatePinnedToCore(taskEntry, "mic", 3072, this, MIC_TASK_PRIORITY, &_task, MIC_TASK_CORE);
+    _lastReportMs = millis();
+    Serial.println("Mic: clap commands enabled");
+    return true;
+}
+
+void MicListener::stop() {
+    if (!_running) return;
+    _running = false; // 任务读完当前帧后退出并卸载驱动
+}
+
+void MicListener::setOutputLevel(int16_t level) {
+    _output = ((uint32_t)(uint16_t)level << 16) | (millis() & 0xFFFF);
+}
+
+void MicListener::taskEntry(void *arg) {
+    ((MicListener *)arg)->run();
+}
+
+void MicListener::run() {
+    static int32_t raw[ClapDetector::kFrame];
+    static int16_t frame[ClapDetector::kFrame];
+
+    while (_running) {
+        size_t bytes = 0;
+        if (i2s_read(MIC_I2S_PORT, raw, sizeof(raw), &bytes, portMAX_DELAY) != ESP_OK || bytes != sizeof(raw)) continue;
+
+        uint32_t start = micros();
+        for (size_t i = 0; i < ClapDetector::kFrame; i++) {
+            int32_t v = raw[i] >> MIC_GAIN_SHIFT;
+            frame[i] = v > 32767 ? 32767 : v < -32768 ? -32768 : v;
+        }
+        uint32_t output = _output;
+        bool playing = ((millis() - output) & 0xFFFF) < 100;
+        _detector.setOutputLevel(playing ? (int16_t)(output >> 16) : ClapDetector::kSilent);
+        uint8_t claps = _detector.processFrame(frame);
+
+        uint32_t us = micros() - start;
+        _frames++;
+        _busyUs += us;
+        if (us > _maxUs) _maxUs = us;
+        if (us > MIC_CPU_BUDGET_US) _overBudget++;
+
+        if (claps) {
+            _events++;
+            Serial.printf("Mic: %u claps\n", claps);
+            if (_clapCb) _clapCb(claps);
+        }
+    }
+    i2s_driver_uninstall(MIC_I2S_PORT);
+    _task = nullptr;
+    vTaskDelete(NULL);
+}
+
+void MicListener::report() {
+    uint32_t now = millis();
+    if (!_task || now - _lastReportMs < AUDIO_TASK_REPORT_MS) return;
+    _lastReportMs = now;
+
+    uint32_t frames = _frames;
+    Serial.printf("Mic: %u frames, avg %u us, max %u us, over budget (%u us) %u, events %u, rejected %u\n",
+                  (unsigned)frames, (unsigned)(frames ? _busyUs / frames : 0), (unsigned)_maxUs,
+                  (unsigned)MIC_CPU_BUDGET_US, (unsigned)_overBudget, (unsigned)_events, (unsigned)_detector.rejected());
+    _frames = 0;
+    _busyUs = 0;
+    _maxUs = 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "ClapDetector.h"
+
+// 拍手口令：板载 I2S 麦克风（I2S_NUM_1，config.h 中的 AUDIO_I2S_MIC_GPIO_*）常开监听。
+// 独立任务固定在核心 0（音频任务在核心 1），阻塞在 i2s_read 上，每 10ms 一帧交给 ClapDetector，
+// 不读卡、不分配内存。每帧耗时按 MIC_CPU_BUDGET_US 统计，超出的帧计数并随报告输出。
+// 播放输出电平由音频任务经 setOutputLevel 提供（单个 32 位字，无需加锁），100ms 未更新即视为没有播放。
+class MicListener {
+public:
+    using ClapCallback = std::function<void(uint8_t claps)>;
+
+    MicListener();
+    bool begin();
+    void stop(); // 深度睡眠前关闭麦克风
+
+    // 在监听任务中回调，只能设置标志，由主循环执行
+    void onClaps(ClapCallback cb) { _clapCb = cb; }
+    // 音频任务：最近一块播放输出的电平（ClapDetector::outputLevel，已计入音量）
+    void setOutputLevel(int16_t level);
+
+    void report(); // 主循环周期调用，按 AUDIO_TASK_REPORT_MS 输出
+    TaskHandle_t task() const { return _task; }
+
+private:
+    static void taskEntry(void *arg);
+    void run();
+
+    ClapDetector _detector;
+    ClapCallback _clapCb;
+    TaskHandle_t _task;
+    volatile bool _running;
+    volatile uint32_t _output; // 高 16 位电平，低 16 位 millis()
+
+    // CPU 预算统计（报告窗口内）
+    volatile uint32_t _frames;
+    volatile uint32_t _busyUs;
+    volatile uint32_t _maxUs;
+    volatile uint32_t _overBudget;
+    volatile uint32_t _events;
+    uint32_t _lastReportMs;
+};
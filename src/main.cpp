@@ -7,16 +7,48 @@
 #include "Audio.h"
 #include "config.h"
 #include "PlaylistManager.h"
+#include "ModeManifest.h"
 #include "InputManager.h"
+#include "input/MicListener.h"
+#include "AudioTask.h"
+#include "SeekIndex.h"
+#include "WaveformIndex.h"
+#include "BookmarkStore.h"
+#include "LedEngine.h"
+#include "power/PowerManager.h"
+#include "power/SleepTimer.h"
+#include "power/HandoffStore.h"
+#include "util/PathHash.h"
+#include "diag/MemTelemetry.h"
+#include "diag/BootProfile.h"
+#include "diag/TraceRecorder.h"
 #include "esp_ota_ops.h"
 #include "esp_partition.h"
+#include <driver/i2s.h>
 #include "ui/UIManager.h"
+#include "ui/TrackBrowser.h"
+#include "dsp/TimeStretch.h"
+#include "dsp/GainRamp.h"
+#include "stream/StreamPlayer.h"
 
 // Globals
 Audio audio;
 PlaylistManager playlist;
 InputManager input;
 Preferences prefs;
+TimeStretch timeStretch;
+SeekIndex seekIndex;
+WaveformIndex waveform;
+BookmarkStore bookmarks;
+LedEngine led;
+PowerManager power;
+SleepTimer sleepTimer;
+MemTelemetry memTelemetry;
+BootProfile bootProfile;
+HandoffStore handoffStore;
+AudioTask audioTask; // 解码与 I2S 送数；audio 的修改类接口只经它调用
+MicListener mic;     // 拍手口令，任务在核心 0
+StreamPlayer stream; // 网络电台，网络任务在核心 0
 
 // Async flags (set in button callbacks, processed in loop to avoid blocking in ISR/callback context)
 static volatile bool g_pauseResumeRequest = false;
@@ -24,52 +56,99 @@ static volatile bool g_nextSongRequest = false;
 static volatile bool g_prevSongRequest = false;
 static volatile bool g_nextModeRequest = false;
 static volatile bool g_prevModeRequest = false;
+static volatile bool g_speedCycleRequest = false;
+static volatile bool g_seekForwardRequest = false;
+static volatile bool g_seekBackwardRequest = false;
+static volatile bool g_abRepeatRequest = false;
+static volatile bool g_sleepTimerRequest = false;
+static volatile bool g_trackEndRequest = false; // 音频任务中的 EOF 回调设置
+static volatile uint8_t g_clapRequest = 0;      // 麦克风任务设置：拍手次数
+
+// 从另一个应用分区切回时的播放状态（见 switch_to_other_app），有效时开机跳过加载界面直接续播
+static HandoffState g_handoff;
+static bool g_handoffBoot = false;
+static bool g_preloadPending = false; // 开机只建当前模式，其余模式开播后延迟预建
+static bool g_streamConnectPending = false; // 电台：缓冲达到起播深度后打开解码器
+static bool g_streamFailShown = false;
 
 // Volume state
 int currentVolume = 5; // Default 5
+bool isMuted = false;
 bool isLedEnabled = true;
-uint8_t ledHue = 0;
-unsigned long lastLedUpdate = 0;
 
-// Helper for RGB LED
-void blinkLED(int times, uint8_t r, uint8_t g, uint8_t b) {
-    if (!isLedEnabled) return;
-    for (int i = 0; i < times; i++) {
-        neopixelWrite(BUILTIN_LED_GPIO, r, g, b);
-        delay(100);
-        neopixelWrite(BUILTIN_LED_GPIO, 0, 0, 0);
-        delay(100);
+// LED 灯效由独立任务按帧推进；led 的状态同时被主循环修改，用自旋锁保护
+#define LED_FRAME_MS 30
+static portMUX_TYPE g_ledMux = portMUX_INITIALIZER_UNLOCKED;
+static bool g_rainbowOn = false;
+
+// 彩虹：红 → 绿 → 蓝 → 红 线性过渡，一圈约 12.8 秒
+static const LedKeyframe kRainbowFrames[] = {
+    { 0,     { 255, 0, 0 }, 255, LED_EASE_LINEAR },
+    { 4250,  { 0, 255, 0 }, 255, LED_EASE_LINEAR },
+    { 8500,  { 0, 0, 255 }, 255, LED_EASE_LINEAR },
+    { 12750, { 255, 0, 0 }, 255, LED_EASE_LINEAR },
+};
+
+// 播放速度档位（每个模式独立记忆）
+static const float kSpeedSteps[] = { 1.0f, 0.8f, 1.25f };
+static const int kSpeedStepCount = sizeof(kSpeedSteps) / sizeof(kSpeedSteps[0]);
+static int16_t g_stretchOut[TimeStretch::kSegment * 2];
+
+// 跳转 / A-B 复读
+#define SEEK_STEP_SECONDS 30
+#define SEEK_GAP_MAX_SECONDS 120 // 波形中的停顿超过此距离时退回固定步长（音乐曲目的长间隔）
+enum ABState { AB_OFF, AB_A_SET, AB_LOOPING };
+ABState abState = AB_OFF;
+uint32_t abStartSec = 0;
+uint32_t abEndSec = 0;
+
+// 断点续播：仅为长音频保存位置，模式记录其最后播放的曲目
+#define BOOKMARK_MIN_SECONDS 300
+#define BOOKMARK_INTERVAL_MS 15000
+String currentTrack;
+
+// LED 任务：只在颜色变化时写 RMT（高频调用 neopixelWrite 可能阻塞）
+void ledTask(void *arg) {
+    LedColor last = { 1, 1, 1 }; // 强制首帧输出
+    while (true) {
+        portENTER_CRITICAL(&g_ledMux);
+        LedColor c = led.render(millis());
+        portEXIT_CRITICAL(&g_ledMux);
+
+        if (!isLedEnabled) c = { 0, 0, 0 };
+        if (c != last) {
+            neopixelWrite(BUILTIN_LED_GPIO, c.r, c.g, c.b);
+            last = c;
+        }
+        vTaskDelay(pdMS_TO_TICKS(LED_FRAME_MS));
     }
 }
 
-// Simple HSV to RGB (Hue 0-255, Sat 255, Val 255)
-void setRainbowColor(uint8_t wheelPos) {
-    wheelPos = 255 - wheelPos;
-    if (wheelPos < 85) {
-        neopixelWrite(BUILTIN_LED_GPIO, 255 - wheelPos * 3, 0, wheelPos * 3);
-    } else if (wheelPos < 170) {
-        wheelPos -= 85;
-        neopixelWrite(BUILTIN_LED_GPIO, 0, wheelPos * 3, 255 - wheelPos * 3);
-    } else {
-        wheelPos -= 170;
-        neopixelWrite(BUILTIN_LED_GPIO, wheelPos * 3, 255 - wheelPos * 3, 0);
-    }
+// Helper for RGB LED（非阻塞：叠加在底色之上的通知层）
+void blinkLED(int times, uint8_t r, uint8_t g, uint8_t b) {
+    if (!isLedEnabled) return;
+    portENTER_CRITICAL(&g_ledMux);
+    led.blink(LED_LAYER_NOTIFY, times, { r, g, b }, millis());
+    portEXIT_CRITICAL(&g_ledMux);
 }
 
+// 播放中显示彩虹底色，暂停/关闭时熄灭
 void updateLED() {
-    // 所有 neopixelWrite 调用都必须限频，ESP32-S3 的 RMT 外设在高频调用时可能阻塞
-    unsigned long now = millis();
-    if (now - lastLedUpdate < 50) return; // 全局 50ms 节流
-    lastLedUpdate = now;
+    bool want = isLedEnabled && audio.isRunning();
+    if (want == g_rainbowOn) return;
+    g_rainbowOn = want;
 
-    if (!isLedEnabled || !audio.isRunning()) {
-        neopixelWrite(BUILTIN_LED_GPIO, 0, 0, 0);
+    portENTER_CRITICAL(&g_ledMux);
+    if (want) {
+        led.play(LED_LAYER_BASE, kRainbowFrames, sizeof(kRainbowFrames) / sizeof(kRainbowFrames[0]), 0, millis());
     } else {
-        setRainbowColor(ledHue++);
+        led.stop(LED_LAYER_BASE);
     }
+    portEXIT_CRITICAL(&g_ledMux);
 }
 
 void toggleLed() {
+    trace(TRACE_COMMAND, TRACE_CMD_LED_TOGGLE);
     isLedEnabled = !isLedEnabled;
     Serial.printf("LED Enabled: %d\n", isLedEnabled);
     
@@ -81,10 +160,229 @@ void toggleLed() {
         blinkLED(1, 0, 255, 0); // Blink Green once
     } else {
         blinkLED(1, 255, 0, 0); // Blink Red once
-        neopixelWrite(BUILTIN_LED_GPIO, 0, 0, 0); // Force off
     }
 }
 
+void changeVolume(int delta) {
+    trace(TRACE_COMMAND, delta > 0 ? TRACE_CMD_VOLUME_UP : TRACE_CMD_VOLUME_DOWN);
+    isMuted = false;
+    int volume = currentVolume + delta;
+    if (volume < 0 || volume > 21) return;
+    currentVolume = volume;
+    audioTask.setVolume(currentVolume);
+    Serial.printf("Volume: %d\n", currentVolume);
+
+    prefs.begin("settings", false);
+    prefs.putInt("volume", currentVolume);
+    prefs.end();
+
+    #ifdef ENABLE_DISPLAY
+    ui.updateVolume(currentVolume);
+    #endif
+}
+
+void toggleMute() {
+    trace(TRACE_COMMAND, TRACE_CMD_MUTE);
+    isMuted = !isMuted;
+    audioTask.setVolume(isMuted ? 0 : currentVolume);
+    Serial.printf("Mute: %d\n", isMuted);
+    #ifdef ENABLE_DISPLAY
+    ui.updateVolume(isMuted ? 0 : currentVolume);
+    #endif
+}
+
+bool isStreamPath(const String &path) {
+    return strncasecmp(path.c_str(), "http://", 7) == 0;
+}
+
+bool isStreamMode() {
+    const ModeConfig *config = playlist.getCurrentModeConfig();
+    return config && config->isStream();
+}
+
+void loadModeSpeed() {
+    // 电台固定原速：变速只用于补足抖动缓冲（见 updateStream）
+    if (isStreamMode()) {
+        audioTask.setSpeed(1.0f);
+        return;
+    }
+    // 未手动调过速度时使用清单中的 dsp 预设
+    const ModeConfig *config = playlist.getCurrentModeConfig();
+    String key = "speed" + String(playlist.getCurrentModeIndex());
+    prefs.begin("settings", true);
+    float speed = prefs.getFloat(key.c_str(), config ? config->speed : 1.0f);
+    prefs.end();
+
+    audioTask.setSpeed(speed);
+    Serial.printf("Speed: %.2fx\n", timeStretch.getSpeed());
+}
+
+void cycleSpeed() {
+    if (isStreamMode()) return;
+    int next = 0;
+    for (int i = 0; i < kSpeedStepCount; i++) {
+        if (kSpeedSteps[i] == timeStretch.getSpeed()) {
+            next = (i + 1) % kSpeedStepCount;
+            break;
+        }
+    }
+    audioTask.setSpeed(kSpeedSteps[next]);
+    Serial.printf("Speed: %.2fx\n", timeStretch.getSpeed());
+
+    String key = "speed" + String(playlist.getCurrentModeIndex());
+    prefs.begin("settings", false);
+    prefs.putFloat(key.c_str(), timeStretch.getSpeed());
+    prefs.end();
+
+    blinkLED(next + 1, 16, 0, 16); // 紫色闪烁次数 = 档位
+}
+
+void seekTo(int32_t second) {
+    if (!audio.isRunning() || stream.isActive()) return; // 电台不能跳转
+    int32_t duration = audio.getAudioFileDuration();
+    if (second < 0) second = 0;
+    if (duration > 0 && second >= duration) second = duration - 1;
+
+    uint32_t offset;
+    if (seekIndex.lookup(second, offset)) {
+        audioTask.seekFilePos(offset);
+    } else {
+        // 索引尚未覆盖该位置，交给解码库按码率估算
+        audioTask.seekSeconds(second);
+    }
+    Serial.printf("Seek -> %ds\n", second);
+}
+
+void seekRelative(int32_t delta) {
+    seekTo((int32_t)audio.getAudioCurrentTime() + delta);
+}
+
+// 快进 / 快退手势：有波形时跳到下一段 / 本段开头（朗诵之间的停顿），否则按固定步长
+void seekGesture(int dir) {
+    int32_t now = audio.getAudioCurrentTime();
+    int32_t target = waveform.gapTarget(now, audio.getAudioFileDuration(), dir);
+    if (target >= 0 && abs(target - now) <= SEEK_GAP_MAX_SECONDS) {
+        Serial.printf("Seek to gap: %ds\n", target);
+        seekTo(target);
+    } else {
+        seekRelative(dir * SEEK_STEP_SECONDS);
+    }
+}
+
+void cycleABRepeat() {
+    if (stream.isActive()) return;
+    uint32_t now = audio.getAudioCurrentTime();
+    switch (abState) {
+        case AB_OFF:
+            abStartSec = now;
+            abState = AB_A_SET;
+            Serial.printf("A-B: A = %us\n", abStartSec);
+            blinkLED(1, 16, 16, 0);
+            break;
+        case AB_A_SET:
+            if (now <= abStartSec) return;
+            abEndSec = now;
+            abState = AB_LOOPING;
+            Serial.printf("A-B: B = %us, looping\n", abEndSec);
+            seekTo(abStartSec);
+            blinkLED(2, 16, 16, 0);
+            break;
+        case AB_LOOPING:
+            abState = AB_OFF;
+            Serial.println("A-B: off");
+            blinkLED(1, 16, 0, 0);
+            break;
+    }
+}
+
+uint64_t modeKey() {
+    return pathHash(("mode:" + playlist.getCurrentModeName()).c_str());
+}
+
+// 书签值：高 32 位为秒数，低 32 位为文件字节偏移
+void saveBookmark() {
+    if (currentTrack.length() == 0 || isStreamPath(currentTrack)) return;
+    if (audio.getAudioFileDuration() < BOOKMARK_MIN_SECONDS) return;
+
+    uint32_t sec = audio.getAudioCurrentTime();
+    uint32_t pos = audio.getFilePos();
+    if (sec < 5 || pos == 0) return;
+    bookmarks.put(pathHash(currentTrack.c_str()), ((uint64_t)sec << 32) | pos);
+}
+
+// 切回模式时从该模式最后播放的曲目继续
+void resumeMode() {
+    uint64_t trackId;
+    if (bookmarks.get(modeKey(), trackId) && playlist.selectTrack(trackId)) {
+        Serial.println("Resuming last track of mode");
+    }
+}
+
+// 电台：先停下解码器再让网络任务重置缓冲，达到起播深度后由 updateStream() 打开解码器
+bool startStream(const String &path) {
+    uint64_t trackId = pathHash(path.c_str());
+    audioTask.stop();
+    stream.start(path.c_str());
+    g_streamConnectPending = true;
+    g_streamFailShown = false;
+    trace(TRACE_TRACK_OPEN, 1, playlist.getCurrentModeIndex(), (uint32_t)trackId);
+    seekIndex.close();
+    waveform.close();
+    #ifdef ENABLE_DISPLAY
+    ui.setWaveform(nullptr);
+    #endif
+    abState = AB_OFF;
+
+    currentTrack = path;
+    playlist.commitPlayed(trackId);
+    bookmarks.put(modeKey(), trackId); // 切回该模式时继续收听同一电台
+    return true;
+}
+
+// resumePos 为 0 时从书签继续
+// paused：打开后停在该位置不出声（交接前处于暂停）；电台没有位置可停，忽略
+bool startTrack(const String &path, uint32_t resumePos = 0, bool paused = false) {
+    saveBookmark();
+    if (isStreamPath(path)) return startStream(path);
+    if (stream.isActive()) {
+        audioTask.stop(); // 解码器不再读取后才能释放缓冲
+        stream.stop();
+        g_streamConnectPending = false;
+    }
+
+    uint64_t trackId = pathHash(path.c_str());
+    uint64_t mark = 0;
+    if (resumePos == 0 && bookmarks.get(trackId, mark)) {
+        resumePos = (uint32_t)mark;
+        Serial.printf("Resume at %us\n", (uint32_t)(mark >> 32));
+    }
+
+    // 输出上一首期间的内存低水位，解码器分配按打开前后的空闲差近似归属
+    memTelemetry.onTrackChange(path.c_str());
+    memTelemetry.beginProbe();
+    bool ok;
+    {
+        TraceScope section(TRACE_SEC_TRACK_OPEN, playlist.getCurrentModeIndex());
+        power.onResume(); // 暂停中切歌：暂停时停掉的 I2S 要在开播前恢复
+        ok = audioTask.connect(path.c_str(), resumePos, paused); // 同步：音频任务打开文件后返回
+    }
+    if (ok && paused) power.onPause();
+    memTelemetry.endProbe(MEM_DECODER);
+    trace(TRACE_TRACK_OPEN, ok, playlist.getCurrentModeIndex(), (uint32_t)trackId);
+    if (!ok) return false;
+    playlist.commitPlayed(trackId); // 只改内存：历史与统计由主循环定期落盘
+    seekIndex.open(path);
+    waveform.open(path);
+    #ifdef ENABLE_DISPLAY
+    ui.setWaveform(waveform.columns());
+    #endif
+    abState = AB_OFF;
+
+    currentTrack = path;
+    bookmarks.put(modeKey(), trackId);
+    return true;
+}
+
 void playNext() {
     // Safety check to prevent infinite loop if all files are missing
     static int skipCount = 0;
@@ -96,7 +394,8 @@ void playNext() {
 
     String nextFile = playlist.next();
     if (nextFile.length() > 0) {
-        if (SD.exists(nextFile)) {
+        // 缺失文件已由后台校验标记并在 next() 中跳过，这里直接打开，失败再移除
+        if (startTrack(nextFile)) {
             Serial.printf("Playing: %s\n", nextFile.c_str());
             
             #ifdef ENABLE_DISPLAY
@@ -104,7 +403,6 @@ void playNext() {
             ui.updateStatus(playlist.getCurrentModeName(), currentVolume, true);
             #endif
             
-            audio.connecttoFS(SD, nextFile.c_str());
             skipCount = 0; // Reset counter on success
         } else {
             Serial.printf("File missing: %s, removing from playlist...\n", nextFile.c_str());
@@ -119,6 +417,8 @@ void playNext() {
         if (emptyModeCount < (int)playlist.getModeCount()) {
             emptyModeCount++;
             playlist.nextMode();
+            loadModeSpeed();
+            resumeMode();
             skipCount = 0;
             playNext();
         } else {
@@ -144,7 +444,7 @@ void playPrev() {
 
     String prevFile = playlist.prev();
     if (prevFile.length() > 0) {
-        if (SD.exists(prevFile)) {
+        if (startTrack(prevFile)) {
             Serial.printf("Playing: %s\n", prevFile.c_str());
             
             #ifdef ENABLE_DISPLAY
@@ -152,7 +452,6 @@ void playPrev() {
             ui.updateStatus(playlist.getCurrentModeName(), currentVolume, true);
             #endif
             
-            audio.connecttoFS(SD, prevFile.c_str());
             skipCount = 0;
         } else {
             Serial.printf("File missing: %s, removing from playlist...\n", prevFile.c_str());
@@ -160,32 +459,467 @@ void playPrev() {
             skipCount++;
             playPrev();
         }
-    } else {
+    } else if (playlist.count() == 0) {
         #ifdef ENABLE_DISPLAY
         ui.updateSongInfo("No Music Found", 0, 0);
         #endif
     }
 }
 
+// 正常播放结束：清除断点，下次从头开始
+void trackFinished() {
+    if (currentTrack.length() > 0) {
+        bookmarks.remove(pathHash(currentTrack.c_str()));
+        currentTrack = "";
+    }
+    // 睡眠定时器为"播完本曲"：不再续播，由 loop() 中的到期处理进入睡眠
+    if (sleepTimer.onTrackEnd()) return;
+    playNext();
+}
+
+// 睡眠定时器：淡出期间按增益系数缩放，到期后保存断点并深度睡眠。
+// 增益在 PCM 钩子中逐样本施加（Q8，256 为原音量），与音量档位无关都有 256 级；
+// 低音量时若改音量档位只剩几级，淡出会一顿一顿的
+static volatile uint16_t g_sleepGain = 256;
+
+void applySleepGain(uint16_t gain) {
+    g_sleepGain = gain;
+}
+
+void cycleSleepTimer() {
+    SleepTimerMode mode = sleepTimer.cycle(millis());
+    applySleepGain(256);
+    Serial.printf("Sleep timer mode: %d\n", mode);
+    if (mode == SLEEP_OFF) blinkLED(1, 16, 0, 0);
+    else blinkLED(mode, 8, 0, 16); // 紫色，次数即档位
+}
+
+void updateSleepTimer() {
+    uint32_t remainingMs = 0;
+    uint32_t duration = audio.getAudioFileDuration();
+    uint32_t current = audio.getAudioCurrentTime();
+    if (duration > current) remainingMs = (duration - current) * 1000;
+
+    SleepTimerState st = sleepTimer.update(millis(), remainingMs);
+    #ifdef ENABLE_DISPLAY
+    ui.updateSleepTimer(st.minutesLeft);
+    #endif
+    if (!st.expired) {
+        applySleepGain(st.gain);
+        return;
+    }
+
+    Serial.println("Sleep timer expired");
+    sleepTimer.cancel();
+    if (audio.isRunning()) {
+        audioTask.pauseResume();
+        power.onPause();
+    }
+    applySleepGain(256); // 醒来后恢复原音量
+    power.enterDeepSleep(); // 回调中保存断点
+}
+
+// 曲目浏览器（Mode + Vol+ 打开 / 关闭）。浏览中按键改为导航：
+//   Vol+ / Vol- 单击：上 / 下一行；双击：翻页；长按：加速滚动，松开即停
+//   Mode 单击：播放选中曲目；Mode 双击：关闭；Mode 三击：字母选择器
+//   其余单键手势（Mode 长按切换应用、Mode 四击、Vol± 三击跳转）浏览中不生效，
+//   翻页时多按一下不会误触，误长按 Mode 也不会重启到另一个应用
+enum BrowserKey { BROWSE_UP, BROWSE_DOWN, BROWSE_PAGE_UP, BROWSE_PAGE_DOWN, BROWSE_HOLD_UP, BROWSE_HOLD_DOWN,
+                  BROWSE_SELECT, BROWSE_CLOSE, BROWSE_PICKER, BROWSE_IGNORED };
+
+#ifdef ENABLE_DISPLAY
+TrackBrowser browser;
+static uint8_t g_browseHoldButton = 0;
+static uint32_t g_browseActivityMs = 0;
+static volatile bool g_browseToggleRequest = false;
+static volatile bool g_browseSelectRequest = false;
+
+// 字母选择器：Vol± 单击选字母，Mode 单击追加并跳到首个匹配，Vol± 双击在匹配间切换，
+// Mode 双击删除一个字母（已空时退出），Mode 三击退出，光标停在匹配处，再单击 Mode 播放
+#define PICKER_MAX_HITS 16
+static const char kPickerLetters[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+struct LetterPicker {
+    bool active = false;
+    char query[16] = "";
+    size_t len = 0;
+    uint8_t letter = 0;
+    size_t hits[PICKER_MAX_HITS]; // 匹配曲目在浏览快照中的位置
+    size_t hitCount = 0;
+    size_t hit = 0;
+};
+static LetterPicker g_picker;
+
+void showPicker() {
+    ui.showBrowserQuery(g_picker.active ? g_picker.query : nullptr, kPickerLetters[g_picker.letter]);
+}
+
+// 返回是否有匹配；有则光标跳到第一个
+bool pickerSearch() {
+    const char *paths[PICKER_MAX_HITS];
+    size_t n = playlist.search(g_picker.query, paths, PICKER_MAX_HITS);
+    g_picker.hitCount = 0;
+    g_picker.hit = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t pos;
+        if (playlist.browsePosition(pathHash(paths[i]), pos)) g_picker.hits[g_picker.hitCount++] = pos;
+    }
+    if (g_picker.hitCount) browser.jumpTo(g_picker.hits[0]);
+    return g_picker.hitCount > 0;
+}
+
+void pickerInput(BrowserKey key) {
+    const int letterCount = sizeof(kPickerLetters) - 1;
+    switch (key) {
+        case BROWSE_UP:
+            g_picker.letter = (g_picker.letter + letterCount - 1) % letterCount;
+            break;
+        case BROWSE_DOWN:
+            g_picker.letter = (g_picker.letter + 1) % letterCount;
+            break;
+        case BROWSE_PAGE_UP:
+        case BROWSE_PAGE_DOWN:
+            if (g_picker.hitCount == 0) break;
+            g_picker.hit = (g_picker.hit + (key == BROWSE_PAGE_DOWN ? 1 : g_picker.hitCount - 1)) % g_picker.hitCount;
+            browser.jumpTo(g_picker.hits[g_picker.hit]);
+            break;
+        case BROWSE_SELECT:
+            if (g_picker.len + 1 >= sizeof(g_picker.query)) break;
+            g_picker.query[g_picker.len++] = kPickerLetters[g_picker.letter];
+            g_picker.query[g_picker.len] = '\0';
+            if (!pickerSearch()) {
+                // 没有匹配：撤销这个字母
+                g_picker.query[--g_picker.len] = '\0';
+                pickerSearch();
+                blinkLED(1, 16, 0, 0);
+            }
+            break;
+        case BROWSE_CLOSE:
+            if (g_picker.len == 0) {
+                g_picker.active = false;
+                break;
+            }
+            g_picker.query[--g_picker.len] = '\0';
+            if (g_picker.len) pickerSearch();
+            break;
+        case BROWSE_PICKER:
+            g_picker.active = false;
+            break;
+        default:
+            break; // 长按及其余手势不使用
+    }
+    showPicker();
+}
+
+void closeBrowser() {
+    if (!browser.isOpen()) return;
+    g_picker.active = false;
+    browser.close();
+    playlist.clearBrowseList();
+    ui.closeBrowser();
+}
+
+void openBrowser() {
+    size_t current = 0;
+    size_t n = playlist.buildBrowseList(pathHash(currentTrack.c_str()), current);
+    if (n == 0) return;
+    browser.open(n, current);
+    g_browseActivityMs = millis();
+    ui.openBrowser();
+    Serial.printf("Browser: %u tracks\n", (unsigned)n);
+}
+
+// 在按键回调中调用；返回 true 表示按键已被浏览器消费
+bool browserInput(BrowserKey key) {
+    if (!browser.isOpen()) return false;
+    if (g_picker.active) {
+        pickerInput(key);
+        return true;
+    }
+    switch (key) {
+        case BROWSE_UP:        browser.step(-1); break;
+        case BROWSE_DOWN:      browser.step(1); break;
+        case BROWSE_PAGE_UP:   browser.step(-TrackBrowser::kRows); break;
+        case BROWSE_PAGE_DOWN: browser.step(TrackBrowser::kRows); break;
+        case BROWSE_HOLD_UP:
+            g_browseHoldButton = InputManager::BTN_VOL_UP;
+            browser.startHold(-1, millis());
+            break;
+        case BROWSE_HOLD_DOWN:
+            g_browseHoldButton = InputManager::BTN_VOL_DOWN;
+            browser.startHold(1, millis());
+            break;
+        case BROWSE_SELECT:    g_browseSelectRequest = true; break; // 打开曲目需要读卡，交给主循环
+        case BROWSE_CLOSE:     g_browseToggleRequest = true; break;
+        case BROWSE_PICKER:
+            g_picker = LetterPicker();
+            g_picker.active = true;
+            showPicker();
+            break;
+        case BROWSE_IGNORED:   break;
+    }
+    return true;
+}
+
+void selectBrowsedTrack() {
+    const char *path = playlist.browsePath(browser.cursor());
+    uint64_t trackId = path ? pathHash(path) : 0;
+    closeBrowser();
+    if (path && playlist.selectTrack(trackId)) playNext();
+}
+
+// 每帧只推进长按滚动并重绘变化的可见行，单帧开销与曲目数无关
+void updateBrowser() {
+    if (!browser.isOpen()) return;
+    uint32_t now = millis();
+    if (browser.holdDirection() != 0) {
+        if (input.isHeld(g_browseHoldButton)) {
+            browser.tick(now);
+            g_browseActivityMs = now;
+        } else {
+            browser.stopHold();
+        }
+    }
+    // 模式已切换（快照失效）或长时间无操作：关闭
+    if (!playlist.browsePath(0) || now - g_browseActivityMs > BROWSER_IDLE_MS) {
+        closeBrowser();
+        return;
+    }
+
+    static uint32_t lastFrame = 0;
+    if (now - lastFrame < BROWSER_FRAME_MS) return;
+    lastFrame = now;
+    TraceScope section(TRACE_SEC_UI_FRAME, 1, 5000);
+    ui.drawBrowser(browser, [](size_t i) { return playlist.browsePath(i); });
+}
+#else
+void closeBrowser() {}
+bool browserInput(BrowserKey) { return false; }
+#endif
+
 void nextMode() {
-    // 不在此处 blinkLED（含 delay），避免阻塞 input.loop()
     #ifdef ENABLE_DISPLAY
-    ui.showLoading("Loading...");
+    // 常驻模式切换只是指针交换，无需加载提示
+    if (!playlist.isModeResident(playlist.getCurrentModeIndex() + 1)) ui.showLoading("Loading...");
     #endif
+    closeBrowser();
+    saveBookmark();
     playlist.nextMode();
+    loadModeSpeed();
+    resumeMode();
     playNext();
-    blinkLED(2, 0, 0, 16); // 切换完成后再闪灯
+    blinkLED(2, 0, 0, 16);
 }
 
 void prevMode() {
     #ifdef ENABLE_DISPLAY
-    ui.showLoading("Loading...");
+    // 常驻模式切换只是指针交换，无需加载提示
+    if (!playlist.isModeResident(playlist.getCurrentModeIndex() - 1)) ui.showLoading("Loading...");
     #endif
+    closeBrowser();
+    saveBookmark();
     playlist.prevMode();
+    loadModeSpeed();
+    resumeMode();
     playNext();
     blinkLED(2, 0, 0, 16);
 }
 
+// 追踪落盘：保留上一份，便于对比"卡顿前后"
+void flushTrace(TraceFlushReason reason) {
+    trace(TRACE_MARK, TRACE_MARK_FLUSH, reason);
+    TraceScope section(TRACE_SEC_TRACE_FLUSH, reason);
+    if (SD.exists(TRACE_FILE)) {
+        SD.remove(TRACE_FILE_PREV);
+        SD.rename(TRACE_FILE, TRACE_FILE_PREV);
+    }
+    File f = SD.open(TRACE_FILE, FILE_WRITE);
+    if (!f) return;
+    bool ok = traceRecorder().flush([&f](const void *data, size_t len) {
+        return f.write((const uint8_t *)data, len) == len;
+    });
+    f.close();
+    Serial.printf("Trace %s: %u events -> %s\n", ok ? "saved" : "write failed",
+                  (unsigned)traceRecorder().recorded(), TRACE_FILE);
+}
+
+// 断流后延迟落盘，使追踪同时包含卡顿之前与之后的事件
+void checkUnderrunTrace() {
+    static uint32_t lastUnderruns = 0;
+    static unsigned long flushAt = 0;
+    static unsigned long lastFlush = 0;
+    static bool flushed = false;
+
+    uint32_t underruns = audioTask.getMissedDeadlines();
+    if (underruns != lastUnderruns) {
+        lastUnderruns = underruns;
+        if (!flushAt && (!flushed || millis() - lastFlush > TRACE_FLUSH_MIN_INTERVAL_MS)) {
+            flushAt = millis() + TRACE_UNDERRUN_FLUSH_MS;
+        }
+    }
+    if (flushAt && (long)(millis() - flushAt) >= 0) {
+        flushAt = 0;
+        lastFlush = millis();
+        flushed = true;
+        flushTrace(TRACE_FLUSH_UNDERRUN);
+    }
+}
+
+// 网络电台：缓冲达到起播深度后打开解码器；深度低于目标时略微放慢播放，补足后恢复原速
+void updateStream() {
+    if (!stream.isActive()) return;
+    stream.report();
+
+    if (stream.link() == LINK_FAILED) {
+        if (!g_streamFailShown) {
+            g_streamFailShown = true;
+            g_streamConnectPending = false;
+            Serial.printf("Stream failed: %s (%s)\n", stream.error(), stream.url());
+            #ifdef ENABLE_DISPLAY
+            ui.showLoading(String("Stream: ") + stream.error());
+            #endif
+            blinkLED(3, 16, 0, 0);
+        }
+        return;
+    }
+
+    if (g_streamConnectPending && stream.canStart()) {
+        g_streamConnectPending = false;
+        power.onResume();
+        bool ok = audioTask.connect(stream.fs(), stream.decoderPath(), 0);
+        Serial.printf("Stream decoder %s: %s\n", ok ? "started" : "failed", stream.decoderPath());
+    }
+
+    float speed = stream.rateAdjust() < 0 ? STREAM_GROW_SPEED : 1.0f;
+    if (speed != timeStretch.getSpeed()) audioTask.setSpeed(speed);
+}
+
+// 串口检索：列出匹配当前模式的曲目，"play <n>" 播放其中一首
+#define SERIAL_FIND_MAX 10
+static uint64_t g_findResults[SERIAL_FIND_MAX];
+static size_t g_findCount = 0;
+
+void serialFind(const char *prefix) {
+    const char *paths[SERIAL_FIND_MAX];
+    unsigned long start = micros();
+    g_findCount = playlist.search(prefix, paths, SERIAL_FIND_MAX);
+    unsigned long elapsed = micros() - start;
+    for (size_t i = 0; i < g_findCount; i++) {
+        g_findResults[i] = pathHash(paths[i]);
+        Serial.printf("  %u: %s\n", (unsigned)i, paths[i]);
+    }
+    Serial.printf("find \"%s\": %u results in %luus\n", prefix, (unsigned)g_findCount, elapsed);
+}
+
+void serialPlay(size_t n) {
+    if (n >= g_findCount || !playlist.selectTrack(g_findResults[n])) {
+        Serial.println("No such result (run find first)");
+        return;
+    }
+    closeBrowser();
+    playNext();
+}
+
+// 串口命令：
+//   trace        追踪落盘
+//   cmd <n>      执行一条 TraceCommand（tools/trace_tool.py replay 用它重放会话）
+//   find <前缀>  检索当前模式（拼音首字母 / 文件名 / 目录名）
+//   play <n>     播放上一次 find 的第 n 个结果
+//   stream [地址] 输出电台缓冲健康度；带地址时直接收听（需在清单中配置 wifi_ssid）
+void handleSerial() {
+    static char line[StreamPlayer::kUrlMax];
+    static size_t len = 0;
+    while (Serial.available()) {
+        char c = Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (len < sizeof(line) - 1) line[len++] = c;
+            continue;
+        }
+        if (len == 0) continue;
+        line[len] = '\0';
+        len = 0;
+
+        if (strcmp(line, "trace") == 0) {
+            flushTrace(TRACE_FLUSH_SERIAL);
+        } else if (strcmp(line, "boot") == 0) {
+            bootProfile.print();
+        } else if (strncmp(line, "find ", 5) == 0) {
+            serialFind(line + 5);
+        } else if (strncmp(line, "play ", 5) == 0) {
+            serialPlay(atoi(line + 5));
+        } else if (strncmp(line, "stream ", 7) == 0) {
+            if (!stream.task()) Serial.println("Stream: set wifi_ssid in " MODE_MANIFEST_PATH);
+            else if (!isStreamPath(line + 7)) Serial.println("Stream: only http:// is supported");
+            else startTrack(line + 7);
+        } else if (strcmp(line, "stream") == 0) {
+            StreamHealth h;
+            stream.health(h);
+            Serial.printf("Stream %s: depth %u / target %u ms, jitter %u (peak %u) ms, underruns %u (%u ms), "
+                          "reconnects %u %s\n",
+                          stream.isActive() ? stream.url() : "(off)", (unsigned)h.depthMs, (unsigned)h.targetMs,
+                          (unsigned)h.jitterMs, (unsigned)h.peakMs, h.underruns, (unsigned)h.stallMs, h.reconnects,
+                          stream.error());
+        } else if (strncmp(line, "cmd ", 4) == 0) {
+            switch (atoi(line + 4)) {
+                case TRACE_CMD_PLAY_PAUSE:    g_pauseResumeRequest = true; break;
+                case TRACE_CMD_NEXT_SONG:     g_nextSongRequest = true; break;
+                case TRACE_CMD_PREV_SONG:     g_prevSongRequest = true; break;
+                case TRACE_CMD_NEXT_MODE:     g_nextModeRequest = true; break;
+                case TRACE_CMD_PREV_MODE:     g_prevModeRequest = true; break;
+                case TRACE_CMD_SPEED:         g_speedCycleRequest = true; break;
+                case TRACE_CMD_SEEK_FORWARD:  g_seekForwardRequest = true; break;
+                case TRACE_CMD_SEEK_BACKWARD: g_seekBackwardRequest = true; break;
+                case TRACE_CMD_AB_REPEAT:     g_abRepeatRequest = true; break;
+                case TRACE_CMD_SLEEP_TIMER:   g_sleepTimerRequest = true; break;
+                case TRACE_CMD_VOLUME_UP:     changeVolume(1); break;
+                case TRACE_CMD_VOLUME_DOWN:   changeVolume(-1); break;
+                case TRACE_CMD_MUTE:          toggleMute(); break;
+                case TRACE_CMD_LED_TOGGLE:    toggleLed(); break;
+                case TRACE_CMD_TRACK_END:     g_trackEndRequest = true; break;
+                default: Serial.printf("Unknown command: %s\n", line); break;
+            }
+        } else {
+            Serial.printf("Unknown command: %s\n", line);
+        }
+    }
+}
+
+// 切换应用前保存播放状态；没有正在播放的曲目时不保存，回来后正常启动
+void saveHandoff() {
+    saveBookmark();
+    playlist.savePlayed(true);
+    if (currentTrack.length() == 0) return;
+
+    HandoffState s;
+    s.mode = playlist.getCurrentModeIndex();
+    s.volume = currentVolume;
+    s.flags = (isMuted ? HandoffState::FLAG_MUTED : 0) | (audio.isRunning() ? 0 : HandoffState::FLAG_PAUSED);
+    s.manifestHash = playlist.getManifestHash();
+    s.trackId = pathHash(currentTrack.c_str());
+    s.filePos = isStreamPath(currentTrack) ? 0 : audio.getFilePos();
+    s.seconds = audio.getAudioCurrentTime();
+    s.shuffleSeed = playlist.getOrderSeed();
+    s.historySkip = playlist.getOrderAge();
+    s.setPath(currentTrack.c_str());
+    handoffStore.save(s);
+}
+
+// 交接快速启动：按保存的路径直接开播，再建当前模式的索引并恢复同一播放顺序。返回是否已开播
+bool resumeHandoff() {
+    // 切换前处于暂停的，回来后同样停在原处：在音频任务的同一命令中打开并暂停，开机时不会先响一下
+    bool paused = g_handoff.flags & HandoffState::FLAG_PAUSED;
+    bool started = g_handoff.path[0] && startTrack(g_handoff.path, g_handoff.filePos, paused);
+    if (started) {
+        bootProfile.mark(BOOT_PHASE_TRACK);
+        Serial.printf("Handoff resume: %s at %us%s\n", g_handoff.path, g_handoff.seconds, audio.isRunning() ? "" : " (paused)");
+    }
+    playlist.setMode(g_handoff.mode);
+    if (!playlist.restoreOrder(g_handoff.shuffleSeed, g_handoff.historySkip, g_handoff.trackId)) {
+        Serial.println("Handoff track not in playlist, order reshuffled");
+    }
+    bootProfile.mark(BOOT_PHASE_PLAYLIST);
+    return started;
+}
+
 void switch_to_other_app() {
     const esp_partition_t *running = esp_ota_get_running_partition();
     const esp_partition_t *target = NULL;
@@ -214,6 +948,7 @@ void switch_to_other_app() {
 
         esp_err_t err = esp_ota_set_boot_partition(target);
         if (err == ESP_OK) {
+            saveHandoff();
             Serial.println("Partition switch success, restarting...");
             delay(1000);
             ESP.restart();
@@ -225,13 +960,78 @@ void switch_to_other_app() {
     }
 }
 
+// 读取 SD 卡上的模式清单；不存在或没有有效模式时使用 config.h 中的默认目录
+void loadModes() {
+    ModeManifest manifest;
+    bool ok = false;
+    File f = SD.open(MODE_MANIFEST_PATH);
+    if (f && f.size() <= MODE_MANIFEST_MAX_SIZE) {
+        std::string text(f.size(), '\0');
+        size_t n = f.read((uint8_t *)&text[0], text.size());
+        ok = manifest.parse(text.data(), n);
+        for (const std::string &e : manifest.errors()) {
+            Serial.printf("%s %s\n", MODE_MANIFEST_PATH, e.c_str());
+        }
+    }
+    if (f) f.close();
+
+    if (!ok) {
+        Serial.println("No valid mode manifest, using default modes");
+        manifest.loadDefaults({ PLAYLIST_DIR_CHILDREN, PLAYLIST_DIR_MUSIC, PLAYLIST_DIR_POEM, PLAYLIST_DIR_STORY });
+    }
+    static const char *const kShuffleNames[] = { "random", "sequential", "album", "weighted" };
+    for (const ModeConfig &mode : manifest.modes()) {
+        if (mode.isStream()) {
+            Serial.printf("Mode %s: %u streams %s\n", mode.name.c_str(), (unsigned)mode.streams.size(),
+                          kShuffleNames[mode.shuffle]);
+            playlist.addMode(mode);
+            continue;
+        }
+        Serial.printf("Mode %s: %s depth %u %s %.2fx\n", mode.name.c_str(), mode.path.c_str(), mode.depth,
+                      kShuffleNames[mode.shuffle], mode.speed);
+        playlist.addMode(mode);
+    }
+    playlist.setManifestHash(manifest.hash());
+
+    // 有电台模式（或配置了 WiFi，便于串口 stream 命令试听）时才分配缓冲、创建网络任务
+    if (manifest.hasStreams() || !manifest.wifiSsid().empty()) {
+        if (stream.begin(audio, manifest.wifiSsid().c_str(), manifest.wifiPassword().c_str())) {
+            audioTask.watchStack("stream", stream.task());
+        }
+    }
+}
+
+#ifdef ENABLE_DISPLAY
+void beginDisplay() {
+    memTelemetry.beginProbe();
+    ui.begin();
+    memTelemetry.endProbe(MEM_UI);
+    bootProfile.mark(BOOT_PHASE_DISPLAY);
+}
+#endif
+
 void setup() {
     Serial.begin(115200);
+    bootProfile.mark(BOOT_PHASE_RUNTIME);
+
+    // 从另一个应用切回：状态读出后立即清除，即使这次启动中途复位，下次也按正常流程启动
+    g_handoffBoot = handoffStore.load(g_handoff);
+    if (g_handoffBoot) handoffStore.clear();
+
+    // LED 任务最先启动，开机过程中的闪烁不再阻塞
+    TaskHandle_t ledHandle = NULL;
+    xTaskCreatePinnedToCore(ledTask, "led", 2048, NULL, 1, &ledHandle, 1);
+    audioTask.watchStack("loop", xTaskGetCurrentTaskHandle());
+    audioTask.watchStack("led", ledHandle);
     
+    memTelemetry.sample();
+
     #ifdef ENABLE_DISPLAY
-    // Init UI first to show boot status
-    ui.begin();
-    ui.updateStatus("Booting...", 0, false);
+    // Init UI first to show boot status（交接快速启动推迟到开播之后）
+    if (!g_handoffBoot) {
+        beginDisplay();
+        ui.updateStatus("Booting...", 0, false);
+    }
     #endif
     
     // PSRAM Check
@@ -242,28 +1042,51 @@ void setup() {
     } else {
         Serial.println("PSRAM init failed!");
     }
+    traceRecorder().begin(TRACE_CAPACITY);
+    trace(TRACE_MARK, TRACE_MARK_BOOT, g_handoffBoot);
 
     // SPI & SD Setup
     SPI.begin(SD_CLK_PIN, SD_MISO_PIN, SD_MOSI_PIN, SD_CS_PIN);
     // Increase SPI frequency to 20MHz for faster scanning and reading
     bool sdSuccess = SD.begin(SD_CS_PIN, SPI, 20000000);
+    bootProfile.mark(BOOT_PHASE_STORAGE);
+    if (sdSuccess) {
+        bookmarks.begin(SD);
+
+        // Setup Modes
+        loadModes();
+        bootProfile.mark(BOOT_PHASE_MODES);
+    }
+
+    // 换了 SD 卡或清单有变（模式编号可能错位）时不沿用交接状态
+    if (g_handoffBoot && !(sdSuccess && g_handoff.manifestHash == playlist.getManifestHash() &&
+                           g_handoff.mode >= 0 && g_handoff.mode < (int)playlist.getModeCount())) {
+        Serial.println("Handoff state does not match the SD card, cold boot");
+        g_handoffBoot = false;
+        #ifdef ENABLE_DISPLAY
+        beginDisplay();
+        ui.updateStatus("Booting...", 0, false);
+        #endif
+    }
+
     if (!sdSuccess) {
         Serial.println("SD Mount Failed");
         #ifdef ENABLE_DISPLAY
         ui.showLoading("请插入SD卡");
         #endif
+    } else if (g_handoffBoot) {
+        // 先开播，索引在音频任务启动后再建（见 resumeHandoff）
+        playlist.deferMode(g_handoff.mode);
     } else {
-        // Setup Modes
-        playlist.addMode(PLAYLIST_DIR_CHILDREN);
-        playlist.addMode(PLAYLIST_DIR_MUSIC);
-        playlist.addMode(PLAYLIST_DIR_POEM);
-        playlist.addMode(PLAYLIST_DIR_STORY);
-        
         // Load last mode
         #ifdef ENABLE_DISPLAY
         ui.showLoading("Loading...");
         #endif
+        // 开机只建当前模式；其余模式开播后在主循环中逐个预建（受 PLAYLIST_MEMORY_CAP 限制），
+        // 之后切换模式无需读卡。模式多或缓存未命中时不再推迟开播
         playlist.loadMode();
+        resumeMode();
+        bootProfile.mark(BOOT_PHASE_PLAYLIST);
     }
 
     // Load Volume & LED
@@ -271,67 +1094,140 @@ void setup() {
     currentVolume = prefs.getInt("volume", 10);
     isLedEnabled = prefs.getBool("led", true);
     prefs.end();
+    if (g_handoffBoot) {
+        currentVolume = g_handoff.volume <= 21 ? g_handoff.volume : currentVolume;
+        isMuted = g_handoff.flags & HandoffState::FLAG_MUTED;
+    }
     
     // Audio Setup
     audio.setPinout(AUDIO_I2S_SPK_GPIO_BCLK, AUDIO_I2S_SPK_GPIO_LRCK, AUDIO_I2S_SPK_GPIO_DOUT);
-    audio.setVolume(currentVolume);
+    audio.setVolume(isMuted ? 0 : currentVolume);
+
+    timeStretch.begin(2);
+    if (sdSuccess) {
+        loadModeSpeed();
+    }
+
+    // 此后 audio 的修改类接口只在音频任务中执行；断流由音频任务按截止期统计
+    audioTask.begin(audio, timeStretch);
+    bootProfile.mark(BOOT_PHASE_AUDIO);
+
+    // 交接快速启动：按键、麦克风等其余初始化之前先开播，随后再初始化屏幕
+    bool handoffStarted = g_handoffBoot && resumeHandoff();
+    #ifdef ENABLE_DISPLAY
+    if (g_handoffBoot) {
+        beginDisplay();
+        ui.setWaveform(waveform.columns());
+    }
+    #endif
 
     // Input Setup
     // 使用标志位异步触发，避免在回调中直接调用 audio API 导致 I2S/DMA 阻塞
-    input.onPlayPause([]() { g_pauseResumeRequest = true; });
+    // 曲目浏览器打开时，单击 / 双击 / 长按先交给浏览器
+    input.onPlayPause([]() {
+        if (!browserInput(BROWSE_SELECT)) g_pauseResumeRequest = true;
+    });
 
     input.onVolumeUp([]() {
-        if (currentVolume < 21) {
-            currentVolume++;
-            audio.setVolume(currentVolume);
-            Serial.printf("Volume: %d\n", currentVolume);
-            
-            prefs.begin("settings", false);
-            prefs.putInt("volume", currentVolume);
-            prefs.end();
-            
-            #ifdef ENABLE_DISPLAY
-            ui.updateVolume(currentVolume);
-            #endif
-        }
+        if (!browserInput(BROWSE_UP)) changeVolume(1);
     });
-
     input.onVolumeDown([]() {
-        if (currentVolume > 0) {
-            currentVolume--;
-            audio.setVolume(currentVolume);
-            Serial.printf("Volume: %d\n", currentVolume);
-            
-            prefs.begin("settings", false);
-            prefs.putInt("volume", currentVolume);
-            prefs.end();
-            
-            #ifdef ENABLE_DISPLAY
-            ui.updateVolume(currentVolume);
-            #endif
-        }
+        if (!browserInput(BROWSE_DOWN)) changeVolume(-1);
     });
 
     // 全部使用标志位异步触发，避免在回调中阻塞 input.loop()
-    input.onNextSong([]() { g_nextSongRequest = true; });
-    input.onPrevSong([]() { g_prevSongRequest = true; });
-    input.onNextMode([]() { g_nextModeRequest = true; });
-    input.onPrevMode([]() { g_prevModeRequest = true; });
+    input.onNextSong([]() {
+        if (!browserInput(BROWSE_PAGE_UP)) g_nextSongRequest = true;
+    });
+    input.onPrevSong([]() {
+        if (!browserInput(BROWSE_PAGE_DOWN)) g_prevSongRequest = true;
+    });
+    input.onNextMode([]() {
+        if (!browserInput(BROWSE_HOLD_UP)) g_nextModeRequest = true;
+    });
+    input.onPrevMode([]() {
+        if (!browserInput(BROWSE_HOLD_DOWN)) g_prevModeRequest = true;
+    });
+    input.onSpeedCycle([]() {
+        if (!browserInput(BROWSE_PICKER)) g_speedCycleRequest = true;
+    });
+    input.onSeekForward([]() {
+        if (!browserInput(BROWSE_IGNORED)) g_seekForwardRequest = true;
+    });
+    input.onSeekBackward([]() {
+        if (!browserInput(BROWSE_IGNORED)) g_seekBackwardRequest = true;
+    });
+    input.onABRepeat([]() {
+        if (!browserInput(BROWSE_IGNORED)) g_abRepeatRequest = true;
+    });
+    input.onSleepTimer([]() { g_sleepTimerRequest = true; });
+
+    // Vol+ 与 Vol- 同时按下：静音开关
+    input.onVolumeChord(toggleMute);
     
-    input.onModeDoubleClick(toggleLed);
-    input.onFunctionLongPress(switch_to_other_app);
+    input.onModeDoubleClick([]() {
+        if (!browserInput(BROWSE_CLOSE)) toggleLed();
+    });
+    #ifdef ENABLE_DISPLAY
+    input.onBrowse([]() { g_browseToggleRequest = true; });
+    #endif
+    input.onFunctionLongPress([]() {
+        if (!browserInput(BROWSE_IGNORED)) switch_to_other_app();
+    });
 
+    input.onActivity([]() {
+        power.noteActivity();
+        #ifdef ENABLE_DISPLAY
+        g_browseActivityMs = millis();
+        #endif
+        // 淡出期间任意按键：取消定时器并恢复音量
+        if (g_sleepGain < 256) {
+            sleepTimer.cancel();
+            applySleepGain(256);
+            Serial.println("Sleep timer cancelled");
+        }
+    });
     input.begin();
 
+    #if MIC_ENABLE
+    mic.onClaps([](uint8_t claps) { g_clapRequest = claps; });
+    if (mic.begin()) audioTask.watchStack("mic", mic.task());
+    #endif
+
+    #ifdef ENABLE_DISPLAY
+    power.onBacklight([](uint8_t level) { ui.setBacklight(level); });
+    #endif
+    power.onBeforeDeepSleep([]() {
+        mic.stop();
+        saveBookmark();
+        playlist.savePlayed(true);
+        flushTrace(TRACE_FLUSH_SLEEP);
+        isLedEnabled = false; // LED 任务随即熄灭
+        neopixelWrite(BUILTIN_LED_GPIO, 0, 0, 0);
+    });
+    power.begin();
+    bootProfile.mark(BOOT_PHASE_INPUT);
+
+    memTelemetry.report("boot");
+
     // Start Playback only if SD is OK
-    if (sdSuccess) {
+    if (handoffStarted) {
+        #ifdef ENABLE_DISPLAY
+        ui.updateSongInfo(currentTrack, playlist.getCurrentIndex() + 1, playlist.count());
+        ui.updateStatus(playlist.getCurrentModeName(), currentVolume, audio.isRunning());
+        if (isMuted) ui.updateVolume(0);
+        #endif
+    } else if (sdSuccess) {
         blinkLED(3, 0, 16, 0); // Blink Green (Success)
         
         #ifdef ENABLE_DISPLAY
         ui.updateStatus(playlist.getCurrentModeName(), currentVolume, true);
         #endif
         
+        // 交接状态中的曲目打不开：从该曲目（或该模式最后播放的曲目）的书签继续
+        if (g_handoffBoot && !playlist.selectTrack(g_handoff.trackId)) resumeMode();
         playNext();
+        bootProfile.mark(BOOT_PHASE_TRACK);
     } else {
         blinkLED(3, 16, 0, 0); // Blink Red (Failure)
         
@@ -340,86 +1236,249 @@ void setup() {
         ui.showLoading("请插入SD卡");
         #endif
     }
+
+    bootProfile.report(g_handoffBoot);
+    g_preloadPending = sdSuccess;
+}
+
+// 拍手口令：2 下暂停 / 继续，3 下下一首，4 下音量 +，5 下音量 -
+void handleClaps() {
+    uint8_t claps = g_clapRequest;
+    if (claps == 0) return;
+    g_clapRequest = 0;
+    trace(TRACE_BUTTON, GESTURE_CLICK, InputManager::BTN_COUNT, claps); // 按键编号 BTN_COUNT 表示麦克风
+    power.noteActivity();
+    switch (claps) {
+        case 2: g_pauseResumeRequest = true; break;
+        case 3: g_nextSongRequest = true; break;
+        case 4: changeVolume(1); break;
+        case 5: changeVolume(-1); break;
+    }
 }
 
 void loop() {
-    // input.loop() 必须最优先，保证 OneButton 时序不受 audio.loop() 耗时影响
+    // 按键边沿由中断打时间戳，这里只负责分发手势，耗时不影响识别
     input.loop();
+    handleSerial();
+    handleClaps();
 
     // 异步处理所有耗时操作（audio API / SD 读写不能在回调中直接调用）
     if (g_pauseResumeRequest) {
         g_pauseResumeRequest = false;
-        audio.pauseResume();
-        Serial.printf("Pause/Resume -> running: %d\n", audio.isRunning());
+        trace(TRACE_COMMAND, TRACE_CMD_PLAY_PAUSE);
+        saveBookmark();
+        playlist.savePlayed();
+        bool running;
+        if (audio.isRunning()) {
+            running = audioTask.pauseResume();
+            power.onPause();
+        } else {
+            power.onResume();
+            running = audioTask.pauseResume();
+        }
+        Serial.printf("Pause/Resume -> running: %d\n", running);
         #ifdef ENABLE_DISPLAY
-        ui.updateStatus(playlist.getCurrentModeName(), currentVolume, audio.isRunning());
+        ui.updateStatus(playlist.getCurrentModeName(), currentVolume, running);
         #endif
     }
     if (g_nextSongRequest) {
         g_nextSongRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_NEXT_SONG);
         playNext();
     }
     if (g_prevSongRequest) {
         g_prevSongRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_PREV_SONG);
         playPrev();
     }
     if (g_nextModeRequest) {
         g_nextModeRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_NEXT_MODE);
         nextMode();
     }
     if (g_prevModeRequest) {
         g_prevModeRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_PREV_MODE);
         prevMode();
     }
+    if (g_speedCycleRequest) {
+        g_speedCycleRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_SPEED);
+        cycleSpeed();
+    }
+    if (g_seekForwardRequest) {
+        g_seekForwardRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_SEEK_FORWARD);
+        seekGesture(1);
+    }
+    if (g_seekBackwardRequest) {
+        g_seekBackwardRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_SEEK_BACKWARD);
+        seekGesture(-1);
+    }
+    if (g_abRepeatRequest) {
+        g_abRepeatRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_AB_REPEAT);
+        cycleABRepeat();
+    }
+    if (g_sleepTimerRequest) {
+        g_sleepTimerRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_SLEEP_TIMER);
+        cycleSleepTimer();
+    }
+
+    if (g_trackEndRequest) {
+        g_trackEndRequest = false;
+        trace(TRACE_COMMAND, TRACE_CMD_TRACK_END);
+        // 电台没有结尾：库在缓冲读空时会当作文件结束，重新缓冲后再打开解码器
+        if (stream.isActive()) g_streamConnectPending = true;
+        else trackFinished();
+    }
+
+    #ifdef ENABLE_DISPLAY
+    if (g_browseToggleRequest) {
+        g_browseToggleRequest = false;
+        if (browser.isOpen()) closeBrowser();
+        else openBrowser();
+    }
+    if (g_browseSelectRequest) {
+        g_browseSelectRequest = false;
+        selectBrowsedTrack();
+    }
+    #endif
 
-    audio.loop();
+    static unsigned long lastBookmark = 0;
+    if (audio.isRunning() && millis() - lastBookmark > BOOKMARK_INTERVAL_MS) {
+        lastBookmark = millis();
+        saveBookmark();
+        playlist.savePlayed();
+    }
 
-    // 暂停时 audio.loop() 瞬间返回，主循环跑满 CPU，需要主动让出时间片
-    if (!audio.isRunning()) {
-        delay(1);
+    if (abState == AB_LOOPING && audio.getAudioCurrentTime() >= abEndSec) {
+        seekTo(abStartSec);
+    }
+
+    // 播放中分批构建跳转索引，每 20ms 最多读 8KB，避免挤占解码的 SD 带宽
+    static unsigned long lastIndexStep = 0;
+    if (audio.isRunning() && millis() - lastIndexStep > 20) {
+        lastIndexStep = millis();
+        seekIndex.buildStep(8192);
+    }
+    if (waveform.update()) {
+        #ifdef ENABLE_DISPLAY
+        ui.setWaveform(waveform.columns());
+        #endif
+    }
+    // 开机只建了当前模式：开播数秒后每次循环预建一个，单次阻塞约为一次缓存加载（未命中时为一次扫描）
+    if (g_preloadPending && millis() > PLAYLIST_PRELOAD_DELAY_MS) {
+        g_preloadPending = playlist.preloadStep();
     }
 
+    updateSleepTimer();
     updateLED();
 
+    static unsigned long lastMemSample = 0;
+    if (millis() - lastMemSample > 1000) {
+        lastMemSample = millis();
+        memTelemetry.sample();
+    }
+    updateStream();
+    audioTask.report();
+    mic.report();
+    checkUnderrunTrace();
+
     #ifdef ENABLE_DISPLAY
-    ui.updateVisualizer();
+    // 背光关闭时跳过频谱动画
+    if (ui.isScreenOn()) {
+        TraceScope section(TRACE_SEC_UI_FRAME, 0, 5000); // 只记录超过 5ms 的帧
+        ui.updateVisualizer();
+    }
+    updateBrowser();
     static unsigned long lastUIUpdate = 0;
     if (millis() - lastUIUpdate > 500) {
         lastUIUpdate = millis();
-        if (audio.isRunning()) {
+        if (stream.isActive()) {
+            // 电台没有进度：进度条位置显示缓冲深度与目标
+            StreamHealth h;
+            stream.health(h);
+            ui.updateStreamHealth(h);
+            if (audio.isRunning()) ui.updateBitrate(audio.getBitRate());
+        } else if (audio.isRunning()) {
             ui.updateProgress(audio.getAudioCurrentTime(), audio.getAudioFileDuration());
             ui.updateBitrate(audio.getBitRate());
         }
     }
     #endif
 
-    // Check if song finished (requires Audio library callback or polling)
-    // The Audio library handles EOF by calling audio_eof_mp3 or generic eof.
-    // We can use the callback mechanism.
+    // 功耗调度：调频、背光、长时间暂停后深度睡眠；解码在音频任务中，主循环休眠不影响送数。电台的 WiFi 收发按重负载处理
+    bool heavyDecode = timeStretch.isActive() || currentTrack.endsWith(".flac") || currentTrack.endsWith(".FLAC") ||
+                       stream.isActive();
+    power.update(audio.isRunning(), heavyDecode);
+}
+
+// Audio Library Callbacks（均在音频任务中执行）
+
+// PCM 输出钩子：库在写入 I2S 前回调（len 为立体声帧数）
+// 变速时接管输出：经 WSOLA 处理后自行写 I2S，continueI2S=false 让库跳过本块
+void audio_process_extern(int16_t *buff, uint16_t len, bool *continueI2S) {
+    // 首次播放时归约波形概览（变速前的原始 PCM，与文件时间轴一致）
+    waveform.feed(buff, len, 2, audio.getSampleRate(), audio.getAudioFileDuration(), audio.getAudioCurrentTime());
+    // 睡眠淡出：块内从上一块的增益线性过渡到当前增益
+    static uint16_t s_gainApplied = 256;
+    uint16_t gain = g_sleepGain;
+    applyGainRamp(buff, len, s_gainApplied, gain);
+    s_gainApplied = gain;
+
+    #if MIC_ENABLE
+    // 拍手检测的回声参考：淡出之后的输出电平（扬声器实际的声音）加上音量增益（音量按线性增益近似）
+    mic.setOutputLevel(isMuted || currentVolume == 0 || gain == 0
+                           ? ClapDetector::kSilent
+                           : ClapDetector::outputLevel(buff, len * 2, 2) + ClapDetector::log2Q8(currentVolume * currentVolume));
+    #endif
+
+    if (!timeStretch.isActive()) {
+        *continueI2S = true;
+        return;
+    }
+    *continueI2S = false;
+
+    // 分块送入，保证输出 FIFO 不溢出
+    size_t offset = 0;
+    while (offset < len) {
+        size_t chunk = len - offset;
+        if (chunk > TimeStretch::kSegment) chunk = TimeStretch::kSegment;
+        timeStretch.put(buff + offset * 2, chunk);
+        offset += chunk;
+
+        size_t frames;
+        while ((frames = timeStretch.receive(g_stretchOut, TimeStretch::kSegment)) > 0) {
+            size_t written = 0;
+            i2s_write(I2S_NUM_0, g_stretchOut, frames * 2 * sizeof(int16_t), &written, portMAX_DELAY);
+        }
+    }
 }
 
-// Audio Library Callbacks
 void audio_eof_mp3(const char *info) {
     Serial.print("EOF: "); Serial.println(info);
-    playNext();
+    g_trackEndRequest = true; // 换曲需要读卡、更新 UI，交给主循环
 }
 
 void audio_eof_aac(const char *info) {
     Serial.print("EOF: "); Serial.println(info);
-    playNext();
+    g_trackEndRequest = true; // 换曲需要读卡、更新 UI，交给主循环
 }
 
 void audio_eof_stream(const char *info) {
     Serial.print("EOF: "); Serial.println(info);
-    playNext();
+    g_trackEndRequest = true; // 换曲需要读卡、更新 UI，交给主循环
 }
 
 void audio_eof_flac(const char *info) {
     Serial.print("EOF: "); Serial.println(info);
-    playNext();
+    g_trackEndRequest = true; // 换曲需要读卡、更新 UI，交给主循环
 }
 
 void audio_eof_speech(const char *info) {
     Serial.print("EOF: "); Serial.println(info);
-    playNext();
+    g_trackEndRequest = true; // 换曲需要读卡、更新 UI，交给主循环
 }
@@ -0,0 +1,66 @@
+#include "CacheFile.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../util/Crc32.h"
+
+CacheFile::CacheFile(uint64_t manifestHash) : _manifestHash(manifestHash), _crc(0), _count(0), _state(STATE_HEADER) {}
+
+void CacheFile::accumulate(const char *line, size_t len) {
+    _crc = crc32(line, len, _crc);
+    _crc = crc32("\n", 1, _crc);
+}
+
+size_t CacheFile::header(char *buf, size_t size) {
+    int n = snprintf(buf, size, "#manifest %016llx", (unsigned long long)_manifestHash);
+    if (n < 0 || (size_t)n + 1 >= size) return 0;
+    accumulate(buf, n);
+    buf[n++] = '\n';
+    buf[n] = '\0';
+    _state = STATE_BODY;
+    return n;
+}
+
+void CacheFile::track(const char *path, size_t len) {
+    accumulate(path, len);
+    _count++;
+}
+
+size_t CacheFile::trailer(char *buf, size_t size) const {
+    int n = snprintf(buf, size, "#end %u %08x\n", (unsigned)_count, (unsigned)_crc);
+    return (n < 0 || (size_t)n >= size) ? 0 : n;
+}
+
+CacheFile::LineKind CacheFile::feed(const char *line, size_t len) {
+    switch (_state) {
+        case STATE_HEADER: {
+            char expected[kLineMax];
+            int n = snprintf(expected, sizeof(expected), "#manifest %016llx", (unsigned long long)_manifestHash);
+            if ((size_t)n != len || memcmp(line, expected, len) != 0) break;
+            accumulate(line, len);
+            _state = STATE_BODY;
+            return LINE_HEADER;
+        }
+        case STATE_BODY: {
+            if (len >= 5 && memcmp(line, "#end ", 5) == 0) {
+                // 尾行自身不参与 CRC；逐字段严格比对，截断的尾行不会碰巧通过
+                char expected[kLineMax];
+                int n = snprintf(expected, sizeof(expected), "#end %u %08x", (unsigned)_count, (unsigned)_crc);
+                if ((size_t)n != len || memcmp(line, expected, len) != 0) break;
+                _state = STATE_DONE;
+                return LINE_END;
+            }
+            accumulate(line, len);
+            if (len == 0) return LINE_SKIP;
+            _count++;
+            return LINE_TRACK;
+        }
+        case STATE_DONE:
+            if (len == 0) return LINE_SKIP;
+            break;
+        case STATE_BAD:
+            break;
+    }
+    _state = STATE_BAD;
+    return LINE_BAD;
+}
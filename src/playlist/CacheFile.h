@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 播放列表缓存的文本格式（tools/generate_playlist.py 写出同样的格式）：
+//   #manifest <清单哈希，16 位十六进制>
+//   <路径>                                   每行一首，换行只用 '\n'
+//   #end <曲目数> <CRC32，8 位十六进制>        CRC 覆盖此前的全部字节（含换行）
+// 没有尾行、尾行不符或尾行后还有内容的文件视为写入中断，整体丢弃。
+// 纯 C++，写入与读取共用同一个累加器，文件 I/O 由调用方负责。
+class CacheFile {
+public:
+    enum LineKind : uint8_t {
+        LINE_HEADER,
+        LINE_TRACK,
+        LINE_SKIP,  // 空行
+        LINE_END,   // 尾行且校验通过
+        LINE_BAD,   // 头不匹配、校验失败或尾行后还有内容；之后的输入一律为 LINE_BAD
+    };
+
+    static const size_t kLineMax = 40; // 头行 / 尾行（含换行与结尾 0）的最大长度
+
+    explicit CacheFile(uint64_t manifestHash);
+
+    // ---- 写：header() → 每首 track() → trailer() ----
+    size_t header(char *buf, size_t size);  // 返回写入 buf 的字节数（含换行）
+    void track(const char *path, size_t len); // 累加一行（调用方负责写出 path 与 '\n'）
+    size_t trailer(char *buf, size_t size) const;
+
+    // ---- 读：逐行输入（不含 '\n'） ----
+    LineKind feed(const char *line, size_t len);
+    bool valid() const { return _state == STATE_DONE; }
+    uint32_t count() const { return _count; }
+    uint32_t crc() const { return _crc; } // 已累加内容的 CRC（完成后即尾行中的值）
+
+private:
+    enum State : uint8_t { STATE_HEADER, STATE_BODY, STATE_DONE, STATE_BAD };
+
+    void accumulate(const char *line, size_t len);
+
+    uint64_t _manifestHash;
+    uint32_t _crc;
+    uint32_t _count;
+    State _state;
+};
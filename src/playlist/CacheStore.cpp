@@ -0,0 +1,100 @@
+#include "CacheStore.h"
+#include <string.h>
+
+String CacheStore::path(int modeIndex, const char *ext) {
+    return "/.playlist_cache_" + String(modeIndex) + "." + ext;
+}
+
+bool CacheStore::save(const TrackTable &tracks, int modeIndex, uint32_t &crc) {
+    String cacheFile = path(modeIndex, "txt");
+    String tmpFile = path(modeIndex, "tmp");
+    String bakFile = path(modeIndex, "bak");
+
+    // 先完整写入临时文件：断电只会留下不完整的 .tmp，现有缓存不受影响
+    File f = _fs.open(tmpFile.c_str(), FILE_WRITE);
+    if (!f) {
+        Serial.println("Failed to save cache");
+        return false;
+    }
+
+    // 首行记录清单哈希，清单修改后旧缓存不再被采用；尾行为曲目数与 CRC
+    CacheFile cache(_manifestHash);
+    char line[CacheFile::kLineMax];
+    size_t n = cache.header(line, sizeof(line));
+    bool ok = f.write((const uint8_t *)line, n) == n;
+
+    for (uint32_t id = 0; id < tracks.playlist.size() && ok; id++) {
+        if (tracks.isRemoved(id)) continue;
+        const char *p = tracks.playlist[id];
+        size_t len = strlen(p);
+        cache.track(p, len);
+        ok = f.write((const uint8_t *)p, len) == len && f.write('\n') == 1;
+    }
+    n = cache.trailer(line, sizeof(line));
+    ok = ok && f.write((const uint8_t *)line, n) == n;
+    f.close();
+    if (!ok) {
+        Serial.println("Failed to save cache");
+        _fs.remove(tmpFile.c_str());
+        return false;
+    }
+
+    // 提交：FAT 的 rename 不能覆盖已有文件，先把当前版本挪成 .bak（也是加载失败时的回退）
+    if (_fs.exists(cacheFile.c_str())) {
+        _fs.remove(bakFile.c_str());
+        _fs.rename(cacheFile.c_str(), bakFile.c_str());
+    }
+    if (!_fs.rename(tmpFile.c_str(), cacheFile.c_str())) {
+        Serial.println("Failed to commit cache");
+        return false;
+    }
+    crc = cache.crc();
+    Serial.printf("Cache saved (%u tracks).\n", (unsigned)cache.count());
+    return true;
+}
+
+bool CacheStore::loadFile(TrackTable &tracks, const String &file, uint32_t &crc) {
+    File f = _fs.open(file.c_str());
+    if (!f) return false;
+
+    CacheFile cache(_manifestHash);
+    bool header = true;
+    while (f.available()) {
+        String line = f.readStringUntil('\n');
+        CacheFile::LineKind kind = cache.feed(line.c_str(), line.length());
+        if (kind == CacheFile::LINE_TRACK) {
+            if (!tracks.add(line.c_str(), line.length())) break;
+        } else if (kind == CacheFile::LINE_BAD) {
+            if (header) Serial.printf("Stale cache %s (%s), rescanning\n", file.c_str(), line.c_str());
+            break;
+        }
+        header = false;
+    }
+    f.close();
+
+    if (cache.valid() && !tracks.playlist.empty()) {
+        crc = cache.crc();
+        return true;
+    }
+    if (tracks.exhausted) {
+        Serial.printf("Out of playlist memory loading %s (%u tracks read)\n", file.c_str(), (unsigned)tracks.playlist.size());
+    } else if (!header) Serial.printf("Corrupt cache %s (%u tracks read), discarded\n", file.c_str(), (unsigned)cache.count());
+
+    // 已读入的曲目作废，整体回收 arena
+    tracks.discard();
+    return false;
+}
+
+bool CacheStore::load(TrackTable &tracks, int modeIndex, uint32_t &crc) {
+    String cacheFile = path(modeIndex, "txt");
+    if (_fs.exists(cacheFile.c_str()) && loadFile(tracks, cacheFile, crc)) return true;
+
+    // 当前版本缺失或损坏（写入 / 提交中途断电）：回退到上一代
+    String bakFile = path(modeIndex, "bak");
+    if (tracks.exhausted) return false; // 不是缓存的问题，上一代也装不下
+    if (!_fs.exists(bakFile.c_str()) || !loadFile(tracks, bakFile, crc)) return false;
+    Serial.printf("Recovered previous cache generation %s\n", bakFile.c_str());
+    _fs.remove(cacheFile.c_str());
+    _fs.rename(bakFile.c_str(), cacheFile.c_str());
+    return true;
+}
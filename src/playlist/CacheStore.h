@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include "CacheFile.h"
+#include "TrackTable.h"
+
+// 播放列表缓存在卡上的读写与提交，文件格式见 CacheFile.h。
+// 文件名与生成脚本约定：/.playlist_cache_<模式编号>.txt，提交过程中另有 .tmp / .bak，检索索引为 .idx（写入中为 .idx.tmp）。
+// 提交顺序：完整写入 .tmp → 当前 .txt 挪成 .bak（FAT 的 rename 不能覆盖）→ .tmp 改名为 .txt；
+// 任一步断电，加载时 .txt 缺失或校验失败就回退到 .bak 并把它提升为当前版本。
+class CacheStore {
+public:
+    CacheStore(fs::FS &fs, uint64_t manifestHash) : _fs(fs), _manifestHash(manifestHash) {}
+
+    static String path(int modeIndex, const char *ext);
+
+    // 写出未被墓碑标记的曲目；成功时 crc 为新缓存的 CRC
+    bool save(const TrackTable &tracks, int modeIndex, uint32_t &crc);
+    // 逐条 add() 到空的 tracks；失败时已读入的曲目作废（discard），crc 为与 tracks 顺序一致的缓存 CRC
+    bool load(TrackTable &tracks, int modeIndex, uint32_t &crc);
+
+private:
+    bool loadFile(TrackTable &tracks, const String &file, uint32_t &crc);
+
+    fs::FS &_fs;
+    uint64_t _manifestHash;
+};
@@ -0,0 +1,71 @@
+#include "DirGroups.h"
+#include "util/PathHash.h"
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+size_t dirLength(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? slash - path : 0;
+}
+
+bool sameDir(const char *a, const char *b) {
+    size_t len = dirLength(a);
+    return dirLength(b) == len && strncmp(a, b, len) == 0;
+}
+
+int compareByDir(const char *a, const char *b) {
+    size_t la = dirLength(a), lb = dirLength(b);
+    int c = memcmp(a, b, la < lb ? la : lb);
+    if (c) return c;
+    if (la != lb) return la < lb ? -1 : 1;
+    return strcmp(a + la, b + lb);
+}
+
+void sortByDir(uint32_t *ids, size_t n, const char *const *paths) {
+    std::sort(ids, ids + n, [paths](uint32_t x, uint32_t y) {
+        int c = compareByDir(paths[x], paths[y]);
+        return c ? c < 0 : x < y;
+    });
+}
+
+size_t dirGroupEnd(const uint32_t *ids, size_t n, size_t begin, const char *const *paths) {
+    size_t end = begin + 1;
+    while (end < n && sameDir(paths[ids[end]], paths[ids[begin]])) end++;
+    return end;
+}
+
+bool DirValidation::run(const uint32_t *ids, size_t n, const char *const *paths) {
+    std::vector<uint64_t> hashes;
+    std::unordered_set<uint64_t> present;
+    size_t i = 0;
+    while (i < n) {
+        // 取出同一目录的一组曲目
+        if (!enter()) return false;
+        const char *first = paths[ids[i]];
+        std::string dir(first, dirLength(first));
+        size_t groupEnd = dirGroupEnd(ids, n, i, paths);
+        hashes.clear();
+        for (size_t k = i; k < groupEnd; k++) hashes.push_back(pathHash(paths[ids[k]]));
+        leave();
+
+        // 每个目录只列举一次
+        present.clear();
+        list(dir.c_str(), [&present](const char *path) { present.insert(pathHash(path)); });
+        dirs++;
+
+        if (!enter()) return false;
+        for (size_t k = 0; k < hashes.size(); k++) {
+            if (present.count(hashes[k])) continue;
+            markMissing(ids[i + k]);
+            missing++;
+        }
+        leave();
+
+        i = groupEnd;
+        if (pause) pause();
+    }
+    return true;
+}
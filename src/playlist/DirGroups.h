@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+
+// 按目录分组曲目 ID：排序后同一目录的曲目连续，且每个目录恰好一组。纯 C++。
+// 直接按完整路径排序做不到：'.'、' ' 等字符小于 '/'，
+// "/a/b.mp3" < "/a/b/c.mp3" < "/a/c.mp3" 会把 /a 拆成两段。
+
+size_t dirLength(const char *path); // 最后一个 '/' 之前的长度，没有 '/' 为 0
+bool sameDir(const char *a, const char *b);
+
+// 先按目录部分（逐字节）比较，目录相同再比较完整路径
+int compareByDir(const char *a, const char *b);
+void sortByDir(uint32_t *ids, size_t n, const char *const *paths);
+
+// ids 已按目录分组时，返回从 begin 开始的这一组的结束位置
+size_t dirGroupEnd(const uint32_t *ids, size_t n, size_t begin, const char *const *paths);
+
+// 后台校验的一遍：ids 已按目录分组。每组在临界区内取出目录名与路径哈希，离开临界区后列举该目录一次，
+// 再回到临界区标记未列出的曲目。paths 只在临界区内访问。
+struct DirValidation {
+    // 列举目录 dir（"" 为根目录），对每个条目的完整路径调用 entry
+    using Lister = std::function<void(const char *dir, const std::function<void(const char *path)> &entry)>;
+
+    std::function<bool()> enter;                 // 进入临界区；返回 false 表示 paths 已失效（此时不持有锁）
+    std::function<void()> leave;
+    Lister list;
+    std::function<void(uint32_t id)> markMissing; // 在临界区内调用
+    std::function<void()> pause;                 // 每个目录之后调用（可为空），让出 SD 总线
+
+    size_t dirs = 0;    // 已列举的目录数
+    size_t missing = 0; // 已标记的曲目数
+
+    // 全部目录校验完返回 true；enter() 失败时放弃并返回 false
+    bool run(const uint32_t *ids, size_t n, const char *const *paths);
+};
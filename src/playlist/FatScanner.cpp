@@ -0,0 +1,301 @@
+#include "FatScanner.h"
+#include <string.h>
+
+static inline uint16_t le16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static inline uint32_t le32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static const uint8_t kAttrDir = 0x10;
+static const uint8_t kAttrVolume = 0x08;
+static const uint8_t kAttrLfn = 0x0F;
+static const uint32_t kEndOfChain = 0x0FFFFFF8;
+static const uint32_t kMaxDirEntries = 65536;
+
+// LFN 条目中 13 个 UTF-16 字符的字节偏移
+static const uint8_t kLfnOffsets[13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+
+static bool isBootSector(const uint8_t *b) {
+    return b[510] == 0x55 && b[511] == 0xAA && (b[0] == 0xEB || b[0] == 0xE9) && le16(b + 11) == FatScanner::kSectorSize;
+}
+
+static uint8_t shortChecksum(const uint8_t *e) {
+    uint8_t sum = 0;
+    for (int i = 0; i < 11; i++) sum = ((sum & 1) << 7) + (sum >> 1) + e[i];
+    return sum;
+}
+
+static inline uint16_t lowerAscii(uint16_t c) {
+    return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+}
+
+FatScanner::FatScanner(BlockDevice &dev, const char *const *extensions, size_t extensionCount)
+    : _dev(dev), _extensions(extensions), _extensionCount(extensionCount), _fatStart(0), _dataStart(0),
+      _sectorsPerCluster(0), _clusterCount(0), _rootCluster(0), _fatSector(UINT32_MAX), _sectorsRead(0),
+      _entriesSeen(0) {}
+
+bool FatScanner::readSectors(uint32_t sector, uint8_t *buf, uint32_t count) {
+    _sectorsRead += count;
+    return _dev.read(sector, buf, count);
+}
+
+bool FatScanner::mount() {
+    uint8_t b[kSectorSize];
+    if (!readSectors(0, b, 1)) return false;
+
+    uint32_t base = 0;
+    if (!isBootSector(b)) {
+        // MBR：取第一个 FAT32 分区（0x0B CHS / 0x0C LBA）
+        if (b[510] != 0x55 || b[511] != 0xAA) return false;
+        bool found = false;
+        for (int i = 0; i < 4 && !found; i++) {
+            const uint8_t *p = b + 0x1BE + i * 16;
+            if (p[4] == 0x0B || p[4] == 0x0C) {
+                base = le32(p + 8);
+                found = true;
+            }
+        }
+        if (!found || !readSectors(base, b, 1) || !isBootSector(b)) return false;
+    }
+
+    uint8_t spc = b[13];
+    uint16_t reserved = le16(b + 14);
+    uint8_t fats = b[16];
+    uint16_t rootEntries = le16(b + 17);
+    uint32_t totalSectors = le16(b + 19) ? le16(b + 19) : le32(b + 32);
+    uint16_t fatSize16 = le16(b + 22);
+    uint32_t fatSize32 = le32(b + 36);
+    // FAT12/16 的根目录是固定区域，不在支持范围
+    if (spc == 0 || (spc & (spc - 1)) || fats == 0 || rootEntries != 0 || fatSize16 != 0 || fatSize32 == 0) return false;
+    // 畸形 BPB：保留区与 FAT 必须落在卷内（否则数据区扇区数下溢），整个卷不能超出 32 位扇区号
+    uint64_t metaSectors = (uint64_t)reserved + (uint64_t)fats * fatSize32;
+    if (reserved == 0 || metaSectors >= totalSectors || (uint64_t)base + totalSectors > 0x100000000ull) return false;
+    // FAT 类型只由簇数决定：少于 65525 簇是 FAT12/16，超过 0x0FFFFFF5 簇的簇号与保留值冲突；
+    // FAT 表还必须容纳全部簇（含 0、1 两个保留项），否则簇链查找会读到 FAT 之外
+    uint32_t clusterCount = (uint32_t)((totalSectors - metaSectors) / spc);
+    if (clusterCount < 65525 || clusterCount > 0x0FFFFFF5) return false;
+    if ((uint64_t)fatSize32 * (kSectorSize / 4) < (uint64_t)clusterCount + 2) return false;
+
+    _sectorsPerCluster = spc;
+    _fatStart = base + reserved;
+    _dataStart = base + (uint32_t)metaSectors;
+    _clusterCount = clusterCount;
+    _rootCluster = le32(b + 44);
+    _fatSector = UINT32_MAX;
+    _buf.resize(kBatchSectors * kSectorSize);
+    return validCluster(_rootCluster);
+}
+
+bool FatScanner::nextCluster(uint32_t cluster, uint32_t &next) {
+    uint32_t sector = _fatStart + cluster / (kSectorSize / 4);
+    if (sector != _fatSector) {
+        if (!readSectors(sector, _fatBuf, 1)) return false;
+        _fatSector = sector;
+    }
+    next = le32(_fatBuf + (cluster % (kSectorSize / 4)) * 4) & 0x0FFFFFFF;
+    return true;
+}
+
+void FatScanner::shortName(const uint8_t *e, Entry &out) {
+    // 8.3 名：NT 保留字节 0x08 / 0x10 表示主名 / 扩展名为小写
+    bool lowerBase = e[12] & 0x08;
+    bool lowerExt = e[12] & 0x10;
+    size_t n = 0;
+    for (int i = 0; i < 8 && e[i] != ' '; i++) {
+        uint8_t c = (i == 0 && e[0] == 0x05) ? 0xE5 : e[i];
+        out.name[n++] = lowerBase ? lowerAscii(c) : c;
+    }
+    if (e[8] != ' ') {
+        out.name[n++] = '.';
+        for (int i = 8; i < 11 && e[i] != ' '; i++) out.name[n++] = lowerExt ? lowerAscii(e[i]) : e[i];
+    }
+    out.nameLen = n;
+}
+
+bool FatScanner::forEachEntry(uint32_t dirCluster, const Visitor &visit) {
+    Entry entry;
+    uint16_t lfn[260];
+    int lfnNext = 0;        // 期望的下一个 LFN 序号，0 表示已收齐
+    size_t lfnLen = 0;      // 0 表示当前没有可用的长文件名
+    uint8_t lfnChecksum = 0;
+
+    // 目录最多 65536 个条目（2MB）：簇链更长说明已成环或损坏，不再跟下去
+    uint32_t maxClusters = kMaxDirEntries * 32 / (_sectorsPerCluster * kSectorSize);
+    if (maxClusters == 0) maxClusters = 1;
+    uint32_t cluster = dirCluster;
+    for (uint32_t guard = 0; validCluster(cluster) && guard < maxClusters; guard++) {
+        uint32_t first = _dataStart + (cluster - 2) * _sectorsPerCluster;
+        for (uint32_t s = 0; s < _sectorsPerCluster; s += kBatchSectors) {
+            uint32_t count = _sectorsPerCluster - s < kBatchSectors ? _sectorsPerCluster - s : kBatchSectors;
+            if (!readSectors(first + s, _buf.data(), count)) return false;
+
+            for (uint32_t off = 0; off < count * kSectorSize; off += 32) {
+                const uint8_t *e = _buf.data() + off;
+                if (e[0] == 0x00) return true; // 目录结束
+                if (e[0] == 0xE5) {
+                    lfnLen = 0;
+                    continue;
+                }
+                _entriesSeen++;
+
+                uint8_t attr = e[11];
+                if (attr == kAttrLfn) {
+                    int ord = e[0] & 0x1F;
+                    if (e[0] & 0x40) {
+                        if (ord == 0 || ord > 20) {
+                            lfnLen = 0;
+                            continue;
+                        }
+                        lfnChecksum = e[13];
+                        lfnLen = ord * 13;
+                    } else if (lfnLen == 0 || ord != lfnNext || e[13] != lfnChecksum) {
+                        lfnLen = 0;
+                        continue;
+                    }
+                    for (int i = 0; i < 13; i++) lfn[(ord - 1) * 13 + i] = le16(e + kLfnOffsets[i]);
+                    lfnNext = ord - 1;
+                    continue;
+                }
+                if (attr & kAttrVolume) {
+                    lfnLen = 0;
+                    continue;
+                }
+
+                // 短名条目：长文件名按序号 1 收尾且校验和一致才采用
+                bool useLfn = lfnLen > 0 && lfnNext == 0 && lfnChecksum == shortChecksum(e);
+                if (useLfn) {
+                    size_t n = 0;
+                    while (n < lfnLen && n < 255 && lfn[n] != 0x0000 && lfn[n] != 0xFFFF) {
+                        entry.name[n] = lfn[n];
+                        n++;
+                    }
+                    entry.nameLen = n;
+                } else {
+                    shortName(e, entry);
+                }
+                lfnLen = 0;
+
+                entry.isDir = attr & kAttrDir;
+                entry.cluster = ((uint32_t)le16(e + 20) << 16) | le16(e + 26);
+                if (!visit(entry)) return true;
+            }
+        }
+        if (!nextCluster(cluster, cluster)) return false;
+        if (cluster >= kEndOfChain) return true;
+    }
+    return false; // 簇链损坏或成环
+}
+
+bool FatScanner::isAudio(const Entry &e) const {
+    // 直接在 UTF-16 上比对扩展名（扩展名都是 ASCII）
+    for (size_t i = 0; i < _extensionCount; i++) {
+        const char *ext = _extensions[i];
+        size_t len = strlen(ext);
+        if (e.nameLen <= len) continue;
+        const uint16_t *tail = e.name + e.nameLen - len;
+        size_t k = 0;
+        while (k < len && lowerAscii(tail[k]) == (uint8_t)ext[k]) k++;
+        if (k == len) return true;
+    }
+    return false;
+}
+
+void FatScanner::appendUtf8(std::string &out, const uint16_t *s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uint32_t c = s[i];
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < len && s[i + 1] >= 0xDC00 && s[i + 1] <= 0xDFFF) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (s[++i] - 0xDC00);
+        }
+        if (c < 0x80) {
+            out += (char)c;
+        } else if (c < 0x800) {
+            out += (char)(0xC0 | (c >> 6));
+            out += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += (char)(0xE0 | (c >> 12));
+            out += (char)(0x80 | ((c >> 6) & 0x3F));
+            out += (char)(0x80 | (c & 0x3F));
+        } else {
+            out += (char)(0xF0 | (c >> 18));
+            out += (char)(0x80 | ((c >> 12) & 0x3F));
+            out += (char)(0x80 | ((c >> 6) & 0x3F));
+            out += (char)(0x80 | (c & 0x3F));
+        }
+    }
+}
+
+bool FatScanner::resolve(const char *dir, uint32_t &cluster) {
+    cluster = _rootCluster;
+    std::string name;
+    while (*dir) {
+        while (*dir == '/') dir++;
+        const char *end = dir;
+        while (*end && *end != '/') end++;
+        if (end == dir) break;
+
+        // FAT 文件名不区分大小写（ASCII 部分）
+        std::string want(dir, end);
+        for (char &c : want) c = lowerAscii((uint8_t)c);
+        bool found = false;
+        uint32_t next = 0;
+        bool ok = forEachEntry(cluster, [&](const Entry &e) {
+            if (!e.isDir) return true;
+            name.clear();
+            appendUtf8(name, e.name, e.nameLen);
+            for (char &c : name) c = lowerAscii((uint8_t)c);
+            if (name != want) return true;
+            found = true;
+            next = e.cluster;
+            return false;
+        });
+        if (!ok || !found) return false;
+        cluster = next ? next : _rootCluster; // ".." 指向根目录时簇号为 0
+        dir = end;
+    }
+    return true;
+}
+
+bool FatScanner::walk(uint32_t dirCluster, std::string &path, uint8_t levels, const TrackCallback &cb) {
+    // 正常卷上每个目录只有一个目录项指向它；损坏的卷可能让子目录指回祖先，
+    // 每个目录簇只遍历一次，避免重复曲目与按层数指数增长的遍历
+    if (!_visited.insert(dirCluster).second) return true;
+    std::vector<std::pair<uint32_t, std::string>> subdirs;
+    size_t base = path.size();
+    bool ok = forEachEntry(dirCluster, [&](const Entry &e) {
+        // 与 VFS 扫描一致跳过隐藏文件；"."、".." 及以点开头的系统目录（.Trashes 等）也一并跳过
+        if (e.nameLen == 0 || e.name[0] == '.') return true;
+        if (e.isDir) {
+            if (levels && validCluster(e.cluster)) {
+                std::string name;
+                appendUtf8(name, e.name, e.nameLen);
+                subdirs.emplace_back(e.cluster, name);
+            }
+            return true;
+        }
+        if (!isAudio(e)) return true;
+        path += '/';
+        appendUtf8(path, e.name, e.nameLen);
+        cb(path.c_str(), path.size());
+        path.resize(base);
+        return true;
+    });
+    if (!ok) return false;
+
+    for (const auto &sub : subdirs) {
+        path += '/';
+        path += sub.second;
+        bool subOk = walk(sub.first, path, levels - 1, cb);
+        path.resize(base);
+        if (!subOk) return false;
+    }
+    return true;
+}
+
+bool FatScanner::scan(const char *dir, uint8_t levels, const TrackCallback &cb) {
+    uint32_t cluster;
+    if (!resolve(dir, cluster)) return false;
+    std::string path(dir);
+    while (!path.empty() && path.back() == '/') path.pop_back();
+    _visited.clear();
+    bool ok = walk(cluster, path, levels, cb);
+    _visited.clear();
+    return ok;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 块设备：按 512 字节扇区读取（固件用 SD.readRAW 实现，主机端可用镜像文件）
+class BlockDevice {
+public:
+    virtual ~BlockDevice() {}
+    virtual bool read(uint32_t sector, uint8_t *buf, uint32_t count) = 0;
+};
+
+// FAT32 原始目录遍历：绕过 VFS，按簇链成批读取目录扇区，直接解析 32 字节目录项。
+// 每个条目不再创建 File 对象、不拼接 file.path()；长文件名在 UTF-16 阶段先比对扩展名，
+// 非音频文件不做 UTF-8 转换，文件本身的簇链从不读取。
+// 只支持 512 字节扇区的 FAT32（MBR 分区或无分区）；exFAT / FAT16 或 BPB 自相矛盾时 mount() 返回 false，
+// 由调用方退回 VFS。簇链成环、目录互相指向等损坏只会让 scan() 返回 false 或少报曲目，不会越界或卡死。
+// 纯 C++。遍历顺序：先列出目录内的文件，再依次进入子目录（VFS 扫描是遇到子目录立即进入）。
+class FatScanner {
+public:
+    using TrackCallback = std::function<void(const char *path, size_t len)>;
+
+    static const uint32_t kSectorSize = 512;
+    static const uint32_t kBatchSectors = 8; // 每次连续读取 4KB
+
+    // extensions：小写、带点，如 ".mp3"
+    FatScanner(BlockDevice &dev, const char *const *extensions, size_t extensionCount);
+
+    bool mount();
+    // 扫描 dir（如 "/儿歌"）下 levels 层子目录内的音频文件，路径格式与 File::path() 相同。
+    // 目录不存在或读取失败返回 false（此时可能已回调部分曲目）
+    bool scan(const char *dir, uint8_t levels, const TrackCallback &cb);
+
+    uint32_t sectorsRead() const { return _sectorsRead; }
+    uint32_t entriesSeen() const { return _entriesSeen; }
+
+private:
+    struct Entry {
+        uint16_t name[256]; // UTF-16，不含结尾 0
+        size_t nameLen;
+        bool isDir;
+        uint32_t cluster;
+    };
+    using Visitor = std::function<bool(const Entry &)>; // 返回 false 停止遍历
+
+    bool forEachEntry(uint32_t dirCluster, const Visitor &visit);
+    bool walk(uint32_t dirCluster, std::string &path, uint8_t levels, const TrackCallback &cb);
+    bool resolve(const char *dir, uint32_t &cluster);
+    bool nextCluster(uint32_t cluster, uint32_t &next);
+    bool validCluster(uint32_t c) const { return c >= 2 && c < _clusterCount + 2; }
+    bool readSectors(uint32_t sector, uint8_t *buf, uint32_t count);
+    bool isAudio(const Entry &e) const;
+    static void appendUtf8(std::string &out, const uint16_t *s, size_t len);
+    static void shortName(const uint8_t *e, Entry &out);
+
+    BlockDevice &_dev;
+    const char *const *_extensions;
+    size_t _extensionCount;
+
+    uint32_t _fatStart;     // 第一个 FAT 的扇区号
+    uint32_t _dataStart;    // 簇 2 的扇区号
+    uint32_t _sectorsPerCluster;
+    uint32_t _clusterCount;
+    uint32_t _rootCluster;
+
+    std::vector<uint8_t> _buf;  // 目录批量读取缓冲
+    uint8_t _fatBuf[kSectorSize];
+    uint32_t _fatSector;        // _fatBuf 中缓存的 FAT 扇区，UINT32_MAX 表示无
+    std::unordered_set<uint32_t> _visited; // 本次 scan() 已遍历的目录簇
+
+    uint32_t _sectorsRead;
+    uint32_t _entriesSeen;
+};
@@ -0,0 +1,163 @@
+#include "OrderPolicy.h"
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <string.h>
+#include <vector>
+#include "../util/PathHash.h"
+#include "DirGroups.h"
+
+static bool isDigit(const char *p, const char *end) {
+    return p < end && *p >= '0' && *p <= '9';
+}
+
+// [a, ea) 与 [b, eb) 的自然排序比较
+static int naturalCompare(const char *a, const char *ea, const char *b, const char *eb) {
+    while (a < ea && b < eb) {
+        if (isDigit(a, ea) && isDigit(b, eb)) {
+            // 跳过前导零后，数字位数多者大，位数相同按字典序
+            while (a < ea && *a == '0') a++;
+            while (b < eb && *b == '0') b++;
+            const char *da = a, *db = b;
+            while (isDigit(da, ea)) da++;
+            while (isDigit(db, eb)) db++;
+            if (da - a != db - b) return (da - a) < (db - b) ? -1 : 1;
+            int c = strncmp(a, b, da - a);
+            if (c) return c;
+            a = da;
+            b = db;
+            continue;
+        }
+        if (*a != *b) return (uint8_t)*a < (uint8_t)*b ? -1 : 1;
+        a++;
+        b++;
+    }
+    return a < ea ? 1 : (b < eb ? -1 : 0);
+}
+
+int naturalCompare(const char *a, const char *b) {
+    return naturalCompare(a, a + strlen(a), b, b + strlen(b));
+}
+
+static void naturalSort(uint32_t *ids, size_t n, const char *const *paths) {
+    std::sort(ids, ids + n, [paths](uint32_t x, uint32_t y) {
+        int c = naturalCompare(paths[x], paths[y]);
+        return c ? c < 0 : x < y;
+    });
+}
+
+// 专辑顺序：先按目录（自然排序，"第2册" 在 "第10册" 之前），再按目录内的文件名自然排序。
+// 只比较完整路径做不到：'.'、' ' 等字符小于 '/'，/poem/b/* 会排进 /poem 的文件之间。
+// 自然排序认为相等的不同目录（"01" 与 "1"）再按字节区分，保证每个目录恰好一组
+static void albumSort(uint32_t *ids, size_t n, const char *const *paths) {
+    std::sort(ids, ids + n, [paths](uint32_t x, uint32_t y) {
+        const char *a = paths[x], *b = paths[y];
+        size_t la = dirLength(a), lb = dirLength(b);
+        int c = naturalCompare(a, a + la, b, b + lb);
+        if (!c && la != lb) c = la < lb ? -1 : 1;
+        if (!c) c = memcmp(a, b, la);
+        if (!c) c = naturalCompare(a + la, b + lb);
+        return c ? c < 0 : x < y;
+    });
+}
+
+void RandomOrder::build(uint32_t *ids, size_t n, const OrderContext &ctx) const {
+    std::mt19937 g(ctx.seed);
+    std::shuffle(ids, ids + n, g);
+}
+
+void SequentialOrder::build(uint32_t *ids, size_t n, const OrderContext &ctx) const {
+    naturalSort(ids, n, ctx.paths);
+}
+
+void AlbumShuffleOrder::build(uint32_t *ids, size_t n, const OrderContext &ctx) const {
+    albumSort(ids, n, ctx.paths);
+
+    // 排序后每个目录的曲目恰好连续一段，切成若干组后打乱组的顺序
+    std::vector<std::pair<size_t, size_t>> groups; // (起点, 长度)
+    for (size_t start = 0; start < n;) {
+        size_t end = dirGroupEnd(ids, n, start, ctx.paths);
+        groups.push_back(std::make_pair(start, end - start));
+        start = end;
+    }
+
+    std::mt19937 g(ctx.seed);
+    std::shuffle(groups.begin(), groups.end(), g);
+
+    std::vector<uint32_t> sorted(ids, ids + n);
+    size_t out = 0;
+    for (const auto &grp : groups) {
+        memcpy(ids + out, sorted.data() + grp.first, grp.second * sizeof(uint32_t));
+        out += grp.second;
+    }
+}
+
+void WeightedShuffleOrder::build(uint32_t *ids, size_t n, const OrderContext &ctx) const {
+    if (!ctx.stats) {
+        RandomOrder().build(ids, n, ctx);
+        return;
+    }
+
+    std::mt19937 g(ctx.seed);
+    std::uniform_real_distribution<float> uniform(1e-7f, 1.0f);
+    std::vector<std::pair<float, uint32_t>> keyed(n);
+    for (size_t i = 0; i < n; i++) {
+        // 权重 = 距上次播放的首数 + 1，封顶 n + 1：n 首之内都没播过的曲目同样"久"，
+        // 从未播放的也按封顶值计，不会压倒其余全部曲目
+        uint32_t age = ctx.stats->age(pathHash(ctx.paths[ids[i]]));
+        float w = (float)(age < n ? age : n) + 1.0f;
+        keyed[i].first = -logf(uniform(g)) / w;
+        keyed[i].second = ids[i];
+    }
+    std::sort(keyed.begin(), keyed.end());
+    for (size_t i = 0; i < n; i++) ids[i] = keyed[i].second;
+}
+
+static bool contains(const uint32_t *recent, size_t k, uint32_t id) {
+    for (size_t i = 0; i < k; i++) {
+        if (recent[i] == id) return true;
+    }
+    return false;
+}
+
+void OrderPolicy::avoidRecent(uint32_t *ids, size_t n, const uint32_t *recent, size_t k, const OrderContext &) const {
+    // 前 k 个位置上的"最近播放"曲目与 k 之后第一个非最近曲目交换，其余顺序不变
+    size_t limit = k < n ? k : n;
+    size_t j = limit;
+    for (size_t i = 0; i < limit; i++) {
+        if (!contains(recent, k, ids[i])) continue;
+        while (j < n && contains(recent, k, ids[j])) j++;
+        if (j >= n) return; // 曲目太少，无法满足
+        uint32_t t = ids[i];
+        ids[i] = ids[j];
+        ids[j] = t;
+        j++;
+    }
+}
+
+void AlbumShuffleOrder::avoidRecent(uint32_t *ids, size_t n, const uint32_t *recent, size_t k, const OrderContext &ctx) const {
+    // 开头的目录若包含最近播放的曲目，整组轮转到末尾；最多轮转一圈
+    size_t moved = 0;
+    while (moved < n) {
+        size_t end = dirGroupEnd(ids, n, 0, ctx.paths);
+
+        bool hit = false;
+        for (size_t i = 0; i < end && !hit; i++) hit = contains(recent, k, ids[i]);
+        if (!hit || end == n) return;
+        std::rotate(ids, ids + end, ids + n);
+        moved += end;
+    }
+}
+
+const OrderPolicy &OrderPolicy::forType(ShufflePolicy type) {
+    static const RandomOrder random;
+    static const SequentialOrder sequential;
+    static const AlbumShuffleOrder album;
+    static const WeightedShuffleOrder weighted;
+    switch (type) {
+    case SHUFFLE_SEQUENTIAL: return sequential;
+    case SHUFFLE_ALBUM: return album;
+    case SHUFFLE_WEIGHTED: return weighted;
+    default: return random;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../ModeManifest.h"
+#include "PlayCountTable.h"
+
+// 播放顺序策略（纯 C++，相同 seed 结果确定，便于主机测试）
+// PlaylistManager 把可播放曲目 ID（扫描顺序）交给策略就地重排，得到一轮的播放顺序。
+
+struct OrderContext {
+    const char *const *paths;    // 按曲目 ID 索引的路径
+    const PlayCountTable *stats; // 播放统计，可为空
+    uint32_t seed;
+};
+
+class OrderPolicy {
+public:
+    virtual ~OrderPolicy() {}
+
+    virtual void build(uint32_t *ids, size_t n, const OrderContext &ctx) const = 0;
+    // 新一轮开始时调用：保证最近播放的 k 首（recent）不出现在前 k 个位置（n 足够大时）
+    virtual void avoidRecent(uint32_t *ids, size_t n, const uint32_t *recent, size_t k, const OrderContext &ctx) const;
+    // 播完一轮后是否重新生成顺序（顺序播放直接回到开头）
+    virtual bool reshuffleOnWrap() const { return true; }
+    // 是否需要记录播放统计
+    virtual bool usesStats() const { return false; }
+
+    static const OrderPolicy &forType(ShufflePolicy type);
+};
+
+// 全部打乱
+class RandomOrder : public OrderPolicy {
+public:
+    void build(uint32_t *ids, size_t n, const OrderContext &ctx) const override;
+};
+
+// 按路径自然排序："第2集" 排在 "第10集" 之前
+class SequentialOrder : public OrderPolicy {
+public:
+    void build(uint32_t *ids, size_t n, const OrderContext &ctx) const override;
+    void avoidRecent(uint32_t *, size_t, const uint32_t *, size_t, const OrderContext &) const override {} // 顺序即语义
+    bool reshuffleOnWrap() const override { return false; }
+};
+
+// 专辑随机：目录之间打乱，目录内保持自然顺序（子目录是独立的专辑）
+class AlbumShuffleOrder : public OrderPolicy {
+public:
+    void build(uint32_t *ids, size_t n, const OrderContext &ctx) const override;
+    // 不拆散目录：把含最近播放曲目的开头目录整组移到末尾
+    void avoidRecent(uint32_t *ids, size_t n, const uint32_t *recent, size_t k, const OrderContext &ctx) const override;
+};
+
+// 加权随机：越久没播放的曲目越靠前。权重 = min(age, n) + 1，从未播放的与 n 首之内没播过的同权
+// 采用指数键排序 (key = -ln(u) / w)，等价于按权重逐个无放回抽样，O(n log n)
+class WeightedShuffleOrder : public OrderPolicy {
+public:
+    void build(uint32_t *ids, size_t n, const OrderContext &ctx) const override;
+    bool usesStats() const override { return true; }
+};
+
+// 自然排序比较：数字段按数值比较，其余按字节比较
+int naturalCompare(const char *a, const char *b);
@@ -0,0 +1,290 @@
+// 由 tools/gen_pinyin_initials.py 生成，请勿手工修改
+#include "PinyinInitials.h"
+
+// U+4E00 起每个汉字一个字符：主读音的拼音首字母，'.' 表示未收录
+static const char kInitials[] =
+    "ydkqsxhwzssxjbymgcczqpssqbycdscdqldylybsgjgyqzjjfgcclzzhwdwzjljpfyynwjjtmyyzwzhflyppqhgccyyymjqy"
+    "xxgjxhsdsjnjjsmhmlzrxyfsngsyczqzggllyjlmyzssecykyyhqwjssggyxyqyjtwktjhychmyxjtlxjyqbyxdldmrrjjwy"
+    "srldzjpcbzjjbrcfslbczstzfxxthtrqggbdlyccssymmrjcyqzpwwjjyfcrwfdfzqpyddwyxkyjawjffxjpdftzyhhyccsw"
+    "ccyxsclcxxwzzxnbgnnxbxlzsqsbsjpysyzdhmdzbqbzcwdzzyytzhbtsyyfzgntnxqywqskbphhlxgybfmjebjhhgqtjcys"
+    "xstkzglyckglysmzxyalmeldccxgzyrcxszltjzcqkcnnjwhjczzcqljststbnxbtyxceqxgkwjyflzqlyhjqspsfxlfpbyq"
+    "xxxydcczylllsjxfhjxpjbcffyabyxbhczbjyclwlczggbtssmdtjcxpthyqtgjjscjfzkjzjqnlzwlslhdzbwjncjzyzsqq"
+    "ycjyrzcjjwybrtwpyftwexcskdzctbxhyzcyyjxzcfbzzmjyxxcdczottbzljwfckszsxfyrlnyjmbdthjxsqjccsbxyytsy"
+    "fbjdztgbcnclcyzzbsacyzzscjcshzqydxlbpjllmqxtydzxsqjtzpxlcglqccwjbhctdjjsfxjejjtlbgxsxjmyjjqpfzas"
+    "yjncydjxkjcdjszcbartcclnjqmwnqnclllkbybzzsyhccltwlccrshllzntylnewyzyxczxxgdkdmtcedejtsyys.dqdfms"
+    "d.jlhrwnqlybglxhlgtgxbqjdzfyjsjyjcjmrnymgrcjczgjmzmgxmmryxkjnymsgmzjymklfxmbdtgfbhcjhkylpfmdxlqj"
+    "jsmtqgzsjlqdldgjycylcmzcsdjllnxdjffffjczfmzffpfkhkgdpqxktacjdhhzdddrrcfqyjkqccwjdxhwjlyllzgcfcqj"
+    "smlzpbjjplsbcjggdckkdezsqsckjgcgkdjtjllzycxklqscgjcltfpcqczgwbjdqsdjjbyjhsjddwgfsjgdkccctllpspkj"
+    "gqjhzzljplgjgjjthjjyjzcjmlzlyqbgjwmljkxzdznjqsyzmljlljkywxmkjlhskjgbmclyymkxjqlbmclkmdxxkwyxwslm"
+    "lpsjqjcqxyjfjtjdxmxxllcrqbsyjbgwywbggbcyxpjtgpepfgdjqbhbncfjyzjkjkhxqbgqzkfhygkhdgllsdjjxpqykybn"
+    "qsxqnszswhbsxwhxwbzzxdmndjbsbkbbzklylxgwxjjwaqzmywsjqlcjxxjqwjeqxscwetlzhlyyysdzpyhyzcptlshtzcfy"
+    "cyxyljxdcjjagyslcllyyysglrqqeldxzsccccadycjysfsgbfrsszqsbxjpsgwsdrckgjlgdkzjzbdktcsyqpyhstcldjlh"
+    "mymcgxyzhjdctmhltxzxylymohyjcltyfbqqjbfbdfehtksqhzywwcnxxcdwhhwgyjlegmdqcwgfjhcsntfydolbygwqwesj"
+    "pwnmlrydzsztxyqpzgcwxhngpyxshmdqjhztdppbfyhzhhjyfdzwkgkzbldntsxhqeegzxylzmmzyjzkszxkhkhtxexxgyly"
+    "apsthxdwhzydpxagkydxbhnhxkdfjnmyhylpmgocslnzhkxxlbzzlbmlsfbhhgsgyyggbhscyajtxwlxtzqcwzydqdqmmgdq"
+    "llszhlsjzwfjhqswscelqazynytlsxthaznkzzsdhlacxtwwcsgqqtddyzbcchyqzflxpslzygpzsznglydqcbdlxjtctajd"
+    "kywnsyzljhhdzcwnyyzyomhychhhxhjkzwsxhdnxlyscqydpclyzwmypbkxyjlkzhtyhaxqsyshxasmchkdscrswjpwqsgzj"
+    "lwwschs.hsqnhzsngndaqtbaalzzmsstdqjcjktscjaxplggxhhgoxzcxpdmmhldgtybysjmxhmrcplxjzckzxshflqxccdh"
+    "xezfchzccdytcjyxqhlxdhypjqxnlsyydzozjnhxqezysjyayjkypdghddxsppyzndlthrhxydpcjjhtcxmctlhbynyhmhzl"
+    "lhnxmylllmdcppxhmxdkycyrdltxjchhznxclcclylnzsxzjzzlnnllwhyqsnjhxynttdkyjpychhyegkcttwlgqrlggtgty"
+    "gyhpyhylqyqgcwyqkfyyyttttlhyhlltyttsplkyzwgywgpydqqzzdqxskcqnmjjzzbxyqmjrtfbbtkhzkbjdjjkdjjtlbwf"
+    "zpbtkqtztgpdgntpjyfalqmkgxbcclzfhzclllladpmxdjhlcclgyhdzfgyddgcyyfgydxkssebdhykdkdkhnaxxybfbyyhx"
+    "cqgabfqyjjdmljcsjzllpchbsxgjyndybyqspqwjlzkcddtaccbkzdyzypjzqsjnkktknjdjgyepgtlfyqkasdntcyhblgdz"
+    "hbbydmjrygkzyheyybcmcdtyfzjjhgcjplxhldwxjjkytcyksssmtwcttqzlzbszdtwzxgzagyktywxlhlcpbclloqmmzssl"
+    "cmbjcszzkydczxgqjdsmcytzqqlwzqzxssbpkdfqmddzdsddtdmfhtdyzjaqjqkypbdjyyxtljhdrqxxxhaydhrjlklytwhl"
+    "lrllrcxylbwsrszzsymkzzhhkyhxksmzsyzgcjfbzbsqlfcxxxnxkxwymsddyqwggqmmyhcdzttfgyyhgstttybykjdhkyjb"
+    "elhdypjqnfxfdykzhqkzbyjtzbxhfdxbdaswhawajldyjsfhbldnndnqjtjnchxfjsrfwhzfmdrfjyhwzpdjkzyjymfcyzny"
+    "nxfbytfwfwygdbnzzzdnytxzemmqbsqehxfzmbmflzzsrsymjgsxwzjsprydjsjgxhjjgljjynzjjxhgjkymlpeyycsysgqz"
+    "swhwlyrjlpxslcxmfsmwkcctnxnynpnjszhdzeptxmwywayysywlxjqzqxzdclaeelmcpjpclwbxsqhfwrtffjtnqjhjqdxh"
+    "wlbycnfjlalkyyjldxhhycstdywncjtxywdrmdrqhwqcmfjdyzmhmayxjwmyzqsxtlmrspwwjhaqbxtgcypxyyrrclmpamgk"
+    "qjszyjrmyjsnxtplnbappypylxmyzkynldgyjzczhnlmzhhanqmpgwqtzmxxmllhgdzxyhxkrxycjmffxyhjfsbssqlhxndy"
+    "cannmtcjcyprrnytycnyymbmsxndlylysljnlqyshqmllyzlzjjjkymzcsfbzxxmstbjgnxyzhlsnmcqscyznfzlxbrnnnyl"
+    "mnrtgzqysatswryhyjzmzdhzgzdwybsscskxsyhytsxgcqgxzzbhyxjscrhmkkbsczjyjymkqqzjfnbhmqhysnjnzybknqmc"
+    "jgqhwlsnzswxkhljhyybqcbfcdsxdldspfzfskjjzwzxsddxjseeegjscssmgclxxkywyllymwwwgydkzjgggtggsycknjwn"
+    "jpcxbjjtqtjwdsspjxzxnzxwmelptfsxtllxcljxjjljsxctnswxledhlyqrwhsycsqrybyaywjejqfwqcqqcjqgxaldbzzy"
+    "jgkgxpltqyfxjltpadkyqhpmatlcpdhkxmtxybhblefxdleegqdymsawhzmljtwygxlyjzljeeyxbqqffnlyxhdsctgjhxyy"
+    "lkllxqkcctlhjlqmkkzgcyygllljdzgydhzwxpysjbzkdzgyzzhywyfqytyzszyezklymhjjhtsmqwyzlkyywzcsrkqytltd"
+    "xwcdrjklwsqzwbdcqyncjsrszjlkcdcdtlzzzacqqczddxyplxcbqjylzllljddzjgyjyjzyxnyyynxjxkxdazwyrdlzyyyr"
+    "jlglldrxjcykywnqcclddnyyykyckczhjxcclgzqjgjwppcqqjysbzzxyjxjbxjfzbsbdsfnsfpzxhdwztdmpptblzzbzdmy"
+    "ypqjrsdzsqzsqxbdgcpzswdwcsqzgmdhzxmwwfybpdgphtmjthzsmmbgzmbzjcfzhfcbbzmqcfmbcmcjxlgpnjbbxgyhyyjg"
+    "ptzgzmqbqdcgybjxlwzkydpdymgcftpfxyztzxdzxtgkmtybbclbjaskytssqyymscxfjeglsllszpqjjjaklyldlycctsxm"
+    "cwfgkkbqxlllljyxtyltyxytdpjhnhgnkbyqnfjyyzbyyessessgdyhfhwtcjbsdzjtfdmxhcnjzymqwsrxjdzjqpdqbbsdj"
+    "ggfbkjbxdgjhmgwjjjgdllthzhhyyyyyysxwtyyyccbdbpypzyccztjfzywcbdlfwzcwjdxxhyhlhwczxjtczlcdpxdjczcz"
+    "lyxjjsjbhfxwpywxzptdzzbdccjhjhmlxbqxxbylrddgjrrctttgqsczwmxfytmwzcwjwxjywcskybzqccttqnhxnkxxkhkf"
+    "htswoccjybcmpzzyjbnnzpbthhjdlscddytyfjpxyngfxbyqxcbhxcbsxtyzdmzysnxsxlhkmzxlthdhkghxjsshqyhhcjyx"
+    "glhzxcsnhekdtgqxqypkdhextykcnymyyypkqyytjxzlthhqtbyqhxbmyhsqckwwyllhcyylnneqxqwmcfbdccmsjggxdqkt"
+    "lxkgnqcdgzjwyjjlyhhqtttnwchhxcxwheszjydjccdbqcdgdnyxzdhcqrxcbmztqcbxwgqwyybxhmbymykdyecmqkyaqyng"
+    "yzslfykkqgyssqyshjgjcnxkzycxsbkyxhyylstycxqthysmgscpmmgcccccmtztasmgqzjhklosqylswtmqsyqkdzljqqyp"
+    "lcycztcqqpbbqjzclpkhqcyyxxdtdddsjcxffllchqxmjlwcjcxtspycxndtjshjwxdqqjckxyamylsjhmlalykxcyydmamd"
+    "qmlmcznnyybzkkyflmchcmlhxrcjjhsylnmtjggzgywjxsrxcwjgjqhqzdqjdzjjzkjkgdzqgjjyjylhzxxcdqhhhestmhlf"
+    "sbdjsyyshfyssczqlpbdrfrztzdkykgsctgkwdqzrkmsynbcrxqbjyfaxpzzedzcjykbcjwhyjbqdzywnyszptdkzpfpbazt"
+    "klqyhbbzptbptyzzybhnydcpjmmcycqmcjfzzdcmnlfpbplngqjtbttajzpzbbdnjkljqylnbzqhksjznggqsczkyxchpzsn"
+    "bcgzkddzqanzgjkdntlzldwjljzlywtxndjzjhxyatncbgtzcsskmljpjytsrwxcfjwjjtkhtzplbhsnjzsyjbwbzyzlstls"
+    "bjhdwwqpslmmfbjdwajyzccjtbnnrzwxxcdslqgdsdpdzhjtqqpsqlyyjzlgyhszlctcbjtktyczjtqkbpjlgmgzdmcsgpyn"
+    "jzjjyyknhrpwszxmtncszzyxybyhyzaxywkcjtllckjjtjhgcxdxyqyczbywblwqcglzgjgqrqcczssbcrbcskydznljsqgx"
+    "ssjmecnstztpbdlthzwhqwqtzexnqczgweskssbybstscsjccgbfsdqszlccglllzghzcthcnmjgyzaznmckcstjmmzckbjy"
+    "gqljyjppldxrgzyxccsnhshgdznlzhzjjcddcbcjflbfqbczzwpqdnhxljcthqwjgylnlszzpcjdscqqhjqkdxkpbajyemsm"
+    "jtzdxlcjyryynwjbngzzkmjxltbsllrtpylcsznxjhllhyllqqzqlxymrcycxsljmlzltzldwdjjllnzggqxpsskygyggbfz"
+    "pdkmwghcxmcgdxjmcjsdycabxjdlnbcddygskydjtxdjjyxmsaqazdzfslqxyjsjzylblxxwxqqzbjzlfbblylwdsljhxjyz"
+    "jwtdjcyfqzqzzdcsxzzqlzcdzfchyspympqzmlpplffxjjnzzylsjyyqzfpfzksywjjjhrdjzzxtxxglghtdxcskyswmmtcw"
+    "ybazbjkshfhgcxmhfqhyxxyzftsjyzbxyxpzlchmzmbxhzzssyfdmncwdabazlxktcshhxkxjjzjsthygxsxyyhhhjwxkzxc"
+    "sbzzwhhhcwtzzzpjxsnxqqjgzyzawllcwxzfxgyxyhxmkyyswsqmnjnaycysjmjkgwcqhylajjmzxhmmcnzhbhxclxdjpltx"
+    "yjhdyylttxfszhyxxsjbjyayrsmxyplckdlyhlxrlnllstyzyyqygyhhsccsmcztzcxhyqfpyyrpfflfqtntszllzmhwtcjq"
+    "yzwtllmlmdwmbzssmzrbpdddlgjjbxccsrzqqygwcsxfwzlxccrbtdzmcyggdlqsgtjswljmymmsyhfbjdgyxccpshxczcsb"
+    "sjwjgjmpbwaffyfnxhydxzylremzgzcyzdszdlljcsqfnxxkptxzgxjjgbmyyysnbdylbnlhbfzdcyfbmgqrrmsszxysgtzn"
+    "nydzzcdgbjafjbdknzblcsscpsgzycjszlmlrzzbzzldlsllysxsqzqlyxzlsgkbrxbrbzcycxzjzeeyfgklzlyyhgysgzlf"
+    "jhgtgwkraajyzkzqtsshjjxdzyz.yjlzyrzdqqhgjzxsszbtkjpbfrtjxllfqwjgslqtymblpzdxtzagbdhzzrbgjhwnjtjx"
+    "lhscfsmwlldqysjtxkzscfwjlbxftzlljzllqblcqmqqcgcdfpbbhzczjlpyygjdtgwdcfczqyyyqysrclqzfklzzzgffsqn"
+    "wglhjycjjczlqzzyjbjzzbpdccmhjgxdqdgdlzqmfgpzytsdyfwwdjzjysxyycjcyhzwpbyhxrylybhkjksfxtzjmmchhllt"
+    "nyymsxxyzpyjjycdyzwmtjjkqyrhllqxpsgtlwycljscpxjyzfnmlrgjjtyzbsyzmsjyjhgfzqmsyxrszcytlrtqzsstkxgq"
+    "ggsptgxdnjsgcqcqhmxggztqydjjzdlbzsxjlhyqgggthqscpyhjhhgnygkggcmjdzllcclxqsftgzslllmlcskctbljzzsz"
+    "mmnytpzsxqhjcjyqxyexzqzcpshkzzysxcdfgmwqrllqxrfztlysdctmjcsjjdhjnxtnrztzfqrhqgllgcxszsjdjljcytsj"
+    "tlnyxsszxcgjzyqpylfhdjsbpcczgjjjqzjqdybssllcmyttmqtbhjqnnygkynqyqmzgcjkpdcgmyzhqllsllclmholzgdyl"
+    "fzsljcqzlylzcjeshnylljxgjxlyjyyyxnbcljsswcqqcjyllcldjyllzllbnylgqchxyyqoxccqkyjxxhyklksxayqccqkk"
+    "kkcsgyxxyqxygwtjohthxpxxcsshcyeychzzcbwqbbwjqcscszsslcylgdesjzmmymcytsdsxxscjpqqsqylyfzychdjdzyw"
+    "cbtjsydjhcyddjlbdjjsodzyqysqkxxdhhgqjyohdyxwgmmmajdybbbppbcmhcpljzsmtxerxjmhqdstpjdcbssmssythjts"
+    "lmmtrcplzszmlqdsdmjmqpnqdxcfynbfsdqqyxhyaykqyddlqyyysszbydslntfgtzqbzmchdhczcwfdxtmqqsphqwwxsrgj"
+    "cwtjtzzqmgwjjrjhtqjbbgwzfxjhnqfxxqywyyhyscdydhhqmnmdmmcpbszppzzglmzfollcfwhmmsjzttthlmyffytzzgzy"
+    "skjjxqyjzqbhmbzzlyghgfmshpcfzsnclpbqsnjszslxjfpmtyjygbxlldlxpzjypjyhhzcywhjylsjexfsszywxkzjlladt"
+    "mlymqjpwxxhxsktqjezrpxxzghmhwqpwqlyjjqjjzszcfhjlchhnxjlqwzjhbmzyxbdhhypylhlhlgfwlcfyytlhjjcjmscp"
+    "xstkpnhjxsntyxxtestjctlsslstdlllwwyhdhrjzsfgxssyczykwhtdhwjslhtzdqdjzxxqggyltzphcsqfzlnjtclzpfst"
+    "pdynylgmjllycqhynsbchylhqyqtmzymbywrfqykjsyslzdqjmpxyyssrhzjnyqtqdfzbwwdwwrxcwhgyhxmkmyyyhmsmzhn"
+    "gcepmlqqmtcwctmhmxjpjjhfxyyzsjchtybmstsyjdtjjqytlhynbyqzlcycnzwsmylkfjxlwgxypjytysylymzckttwlgsm"
+    "zsylmpwlcwxwqzssaqsyxyrhssntsrapccpwcmgdhhxzdzxfjhgzttsbjhgyglzysmyclllxbtyxhbbzjkssdmalhhycfygm"
+    "qypjycqxjllljgclzgqlycjcctotyxmtmshllwcgfxymzmklpszzzxhhjyslctyjcyhxsgyxzkxlzwpyjpdhjwpjpwsqqxlx"
+    "xdhmrslzcyzwstcxkystzshbsccstplwsscjchjlcgchssphylhfhhxjsxyllnylmzdhzxylsxlwzyhcldyahzcmddyspjtq"
+    "jzlngjfsjshctsdszlblmssmnyymjqbjhrcwtyydchjljapzwbgqybkfcmjwlzllyylszydwhxpsbcmljpscgbhxlqhyrljx"
+    "yswxhxzlldfhlslymjljyflyjycdrjlfsyzfsllcqyqfgqyhyszlylmstdjcyhbzllnwlxxygyyhbmgdhxxhhlzzjzxczzzc"
+    "yqzfnjwpylcpkpykpmclqkdgxzggwqbdxzzkzfbxdlzxjtpjpttbythzzdwslchzhsltjxhqlhyxxxywzyswtmzkhlxzxzpy"
+    "hgchkcfsyh.tjrlxfjxptztwhplyxfcrhxshxkjxxyhzjdxjwylhyhmjdbflkhtxcwhcfwjcfpqrxqxcyyyjygrpxwscsxng"
+    "wchkzdxhflxxhjjbyzwtsxnncyjjymswzxqrmhxzwfqsylzjggbhyxslbgttcsebhxxwxyhhxyxnsqyxmlywrgyqlxbbcljs"
+    "ylpsytjzyhyzawlhorjmksczjxxxyxchcytryxqjddsjfslyltsffyxlmtyjmjjyyyxltzcsxqclhzxlwyxzhdnlrxkxjcdy"
+    "hlbrlmbrllaxksllljlyxxlycrylcjcgjcmtlzllcyzzpzpcyawhjjfybdyyzsepckzdqyqpbpcjpdcyzbdbbcyydycnnpjm"
+    "tmlrmfmmgwygbsjgygsmdqqqztxmkqwgxllpjgzbqcdjjjfpkjkcxbljmswmdtqjxldlppbxcwkcqqbfqjczagzgmykbhyyh"
+    "zykndqzmbpjyspxthlfpnyygxjdbkxnhhjhzjxstrstldxskzysybmxjlxyslbzyslhxjpfxbqnbylljqkygzmcyzzymccsl"
+    "dlhzgwfwyxzmwcxtynxjhbyymcysbmhysmydyshqyzchmjjmzcaahcbjbbhplxtylsxsdjgjdhkxxtxxnphnmlngsltxmrhn"
+    "lxqjxmzllyswqgdlbjhdcgjyqycmgwfwjybbbyjmjwjmdpwhxqldyapdfxxbcgjspckrssyzjmslbzzjfljjjlgxzgyxyxls"
+    "zqyxbexyxhgcxbpldyhwecdwwcjmbtxchxyqxllxflyxlljlssfwdpzsmyjclwswtczbchqekcqbwlcgydblqppqzqfjqdjh"
+    "ymmcxtxdrmjwrhxcjzclqxdyynhyyhrslsrsywwzjymtltllgzqcjzyabsckzcjyccqlysqxalmzyhywlwdxzxqdllqshgpj"
+    "fjljhjabcqzdjgthhsstcyjlbswzlxzxrwgldlzrlzqtgsllllzlymxqgdzhgbdbhzpbrlw.xqbpfdwo..whlypcbjcc.dmb"
+    "zpbzz.cyqxldomzblzwpdwyygdstthcsqsccrsssyslfybfntyjszdfndpthtzzmbqlxlcmyffgtjjqwftmdpjwdnlbzxmmc"
+    "tgbdzlqlpyfhsymjylsdchdzjwjcctljcldtljjcpddpjdsszynndbjlggjzxsxnlycybjjqxcbylzcfzppgkcxzdzfztjjf"
+    "jsjxzbnzyjqttyjwhtyczhymdjxttmpxsflzcdwslshxybzgtfmlcjtacbbmgdewycyzcdszcyhflyctygwhkjyylsjcxgyw"
+    "jcbhlcsnddbtzbsclyzczzssqdllmqyyhfllqllxfdyhabxggnywyypllsdldllbjcyxjzmlhljdxyyqytdlllbbgbfdfbbq"
+    "jzzmdpjhgclgmjjpgaehhbwcqxaxhhhzchxyphjaxhlphjpgpzjqcqzgjjzzgzdmqyybzzphyhybwhazyjhykfgdpfqsdlzm"
+    "ljxjpgalxzdaglmdgxmwzqytxdxxpfdmmssympfmdmmkxksyzyshdzkjsysmmzzzmsydnzzczxbmlstmddnmxckjmztyymzm"
+    "zzmsshhdccjemxxkljstgwlsqlyjzllsjssdbpmhnlyjczyhmxxhgzcjmdhxtkgrmxfwmckmwkdcksxqmmmszzydkmsclcmp"
+    "cgmhrpxqpzdsslcxkyxtmlgjyahzjgzqmcsnxyhmmpmlkjxmhlmlgmxctkzmjlyszjsyszhsyjzjcdajzybsdqjzgwzkgxfk"
+    "dmsdjlfmehkzqkjbeypzyszcdpyjffmzjykttdzzefmzlbnpplplpbpszalltylkckqzkgenqlwagxxydpxlhsxqqwqykxqc"
+    "lhyxxmlyccwlymqyskychlcjnszkpyzkcqzqljbdmdjhlasqlbydwqlwdnbqcrydddtjybkbwszdxdtnpjdtctqdfxqqmgns"
+    "eclstbhpwslctxxlpwydzklzqgzcqapllkccylbqmqczqcljslqzdjxldthpzqdljjxzqdjyzhkzlkcyqdyjppypeakjyrmp"
+    "cbymcxkllzllfqpylllmbsglzysslrsysqtmxyxqqzbdzrysyztffmzzsmzqhzssccmlyxwtpzgxzjgzgsjsgkddhtqggzll"
+    "bjdzlcbzhyxyzhzfywxyzymsdbzzyjgtsmtfxqyxjscdgslnmdlrytzlryylxqhtxsrtzcgyxbnqqzfhykmzjbzymkbpnlyz"
+    "pblmcnqyzzzsjzhjctzhhyzzjrdyzhnfxklfxslkgjtctssyllgzrzbbjzzklpkbczyslxyxbjfpnjzzxcdwxzyjxzzdjjgg"
+    "grsrjkmcmzjlsjywqshyhqjsxpjzzzlsnshrnypjtwchklbsrzlcxwjqxqkysjycztlqzybbybwzjqdwgyzcytjcjxckcwdk"
+    "kzxsgkdzxwwyyjqyytcytdjlxwkczkklccpzcqqdzlqlcsfqchqhsfsmqzzllbjjzbsjhtsjdysjqjpdszcdcwjkjzzlpycg"
+    "mzwdjxbsjqzsyzyhhxcbbjydssddzncglqmbtsfcbpdzdlznfgfjgfsmptjqlmblgqcyyxbqkdxjqsrfkztjdhczklbsdzcf"
+    "ytplljgjhtxzcsszzxstcygkgckgyoqxjplzbbbgtgyjdgczqszlbjlsjfzgkqqjcgyczbzqtldxrjxbsxxpzxhyzyclwdsj"
+    "jhxmfczpfzhqhqmqgkslyhtycgfrzgnqxclpdlbzcsczqlljblhbdcypczppdymtzsgyhckcpzjgslclnscdsldlxbmsdldd"
+    "fjmkdjdhslzxlszqpqpgjdlybdszlqlbzlslkyyhzttncjyqtzzfszqztlljtyyllqllqyzqlbdzlslyyzymdfszsnhlxznc"
+    "zqzbbwskrfbcyzcthblgjpmczzlstlxshtzcyzlzblfeqhlxflcjlyljqcbzlzjghsstbrmhxzhjzclxfnbgxgtqjcztmsfz"
+    "kjmssnxljkbhszxntnlzdntlmsjxgzjyjczxyhyhwrwwqnztnfjscpzshzjfyrdjsfscjzbjfzczchzlxfxsbzqlzsgyftzd"
+    "cszxzjbqmszkjrhxjzcgbjkhchgtjkjqglxbxfgdrtylxjxgdtsjxhjzjjcmzlcqsbtxhqgxttxhxftsdkfjhzyjfjxrzcdl"
+    "llcqsqqzqwqxswqtwgwbzcgcllqzbclmqqtzgzxzxljfrmyzflxysqxxjkxrmjdcdmmyxbsqbhgcmwfwtgmxlzbyytgzyccd"
+    "xyzxywgxyjyznbgpzjcqsyxcxrtfycgrhztxszzthcbfclsyxzljqmzlmplmxzjssflbysmyqhxjsxrxsqzzzsslyflczjrc"
+    "rxhhzxqydshxsjjhzcxjbdynsysxjbqlpxzqpymlxzkyxlxcjlcycrxzzlldlllsjyhzxgyjwkjrwyhcpsgnrzlfzwfzznsx"
+    "gxflzsxzzzbfcsyjdbrjkrdhhgxjljjtgxjxxstjtjxlyxqfcsgswmsbctlqzzwlzzkxjmltmjyhsddbxgzhdlbmyjfrzfcg"
+    "clyjbpmlysmsxlszjqqhjzfxgfqfqbpxzgyyqxgztcqwyltlgwwgwhllfmfgzjmgmgbgtjfsyzzgzyzaflsspmlbflcwbjzc"
+    "ljjmzlpjjlymqdmyyyfbgygqzglyzdxqyxrqqqhsxyyqqygjtyxfsfsllgnqcygycwfhcccfxbylypllzqxxxxxkqhhxshjd"
+    "cfdsczjxcpzwhhhhhapylhalpqafyhxdyllkmzqgggddesrnndltzgchybpysqjjhclljtolnjpzljlhymheydydsqycddhg"
+    "zpndzclzywllznteytgxlhslpjjbdgwxpcdntjcklkclwkllcasstknzdnqnttlyyzssysszzryljqkcgbhhyrxrzydgrgcw"
+    "cgzhfffppjfzynakrgywyqpqxxfkjtszzxswzddfbbqtbgtzkznpzfpzxzpjszbmqhkcyxyldkljnypkyghgdcjxxeahpnzg"
+    "ctzcmxcxmmjxnkszqnmnlwbwwxjjyhclstmcsqdjcxxtpcnfdtnnpglllzcjlspblplkcdtnjnlyyrscffjfqwdpgzdwmnzc"
+    "clodaxnssnyzrestyjwjyjdbcfxnmwttbqlwstszgybljpxglboclgpcbjftmxzljylzxcltpnclcgxtfzjshcrxsfyszdkn"
+    "tlbyjcyjllstgqcbxnwzxbxklylhzlqzlnzcqwgzlgzjncjgcmnzzgjdzxtzjxycyycxxjyyxjjxsssjstssttppghtcsxwz"
+    "dcsyfptfbchfbblzjclzzdbxgcxlqpxkfzflsyltywbmnjhskbmddbcysccldxycddqlyjjhmqllcsgljjsyfpyyccyltjan"
+    "tjjpwycmmgqyysqdhqmzhszxpftwwzqswqrfkjlxjqqyfbrxjhhfwjgzyqacmyfrhcyybyqwlpexcczstyrltsdmqlykmbbg"
+    "myyjprknnbbsxyxbhyzdjdnghpmfsgbwfzmfqmmbcmzdcjjlcnyxyqgmlrygqccyhzlwjgcjcggmcjjfyzzjhycfrrcmtzqz"
+    "xhfqgdjxccjeaqcrjthpljlszdjrbzqhjdyrhxlyxjsymhzydwldfryhbbydtssccwbxglpzmlzztqsscpjmmxjcsjytycgh"
+    "ycjwsnsxlfemwjnmkllswtxhyyygcmmcwjdqdjzglljwjnkhpzggflccsczmcbltbhbqjxqdjpdjqtghglfqawbzyjjltstd"
+    "hqhctcbchflqmpwdshyytqwcnztjtlbymbpdyyyxsqkxwyyflxxncwcxybmaelykkjmzzzbrxyaqjfljpfhhhytzzxrgqqmh"
+    "spgdzjwbwpjhzjdyscqwzkthxsqlzyymysdzgrxckkhjlwpysyscsyzlrmlqsyljxbcxtlhdqzpcycykpppnsxfyzjjrcemh"
+    "szmsxlxglrwgcstlrsxbygbzgztcpldjlslylymdtmtcpalcxpqjcjwtcyyzlblxbzlqmyljbghdslssdmxmbdczsxwhamlc"
+    "zcpjmcnhjyjnsygchskqmzzqdllkablwjqsfmocdxjrrlyqchjmybyqlrhetfjzfrfksryxfjdwdsxxlwsqjyslyxwjhsnlx"
+    "yyxhbhawhhjcxwmyljcsqlkydttxbzsxfdxgxsjhhsxxybssxdpwncmrptjzczenygcxqfjxkjbdmljcmqqxloxslyxxlyll"
+    "jdzbtymhbfsttqqwlhogyblscalzxqlhtwrrqhlstmypyxjjxmqsjfnbryxyjllyqyltwylqyfmhkljdmllhfzwkzhljmlhl"
+    "jkljstlqxylmbhhlnlsxqchxcfxxlhyhjjgbyzzkbxscqdjqdsxjzsyhzhhmgsxcsymxfebcqwwrbpyyjqtyqcyjhqqzyhmw"
+    "ffhgzfrjfcdbxntqyzpcyhhjlfrzgppxzdbbgzqstlgdgylcqmgchhmfywlzyxkjlypqgsywmqqgqzmlzjnsqxjqsyjtcbeh"
+    "sxfssfxzwfllbcyyjdytdthwzsfjmqqyjlmqsxlldttkhhybfpwdyysqqrnqwlgwdebdwcyygcdlkjxtmxmyjsxhybrwfymw"
+    "frxyqmxysctzztfykmldhqdlwyqnlcryjblpsxcxywlsbrrjwxhqybhtydnhhgmmywytzcsqmtssccdalwztcpqpyjllqzyj"
+    "swxwzzmmglmxclmxczmxmzsqtzppjqblpgxjzhfljjhycjsnxwcxsccdlxsyjdcqcxslqyclzxlzzxmxqrjmhrhzjphmfljl"
+    "mlclqnldxzlllfybngjysxcqqdcmqjzzxhnpnxzmekmxxykyqlxsxtxjxyhwdcwdzhqyybgybcyscfgfsjnzdyzzjzxrzrqj"
+    "jymcanhrjtldbpyzbstjhxxzypbdwfgzzrpymtngxzqbgxnbbfcckrjjjbjegrzgyclkxzdxkknsjkcljspgyyzlqqjybzss"
+    "qlllkjfcbktylcccdblsppfylgydtzjyjzgkqttfcxbdkdxxhybbfytyhbclpdytgdhryrnjsbtcsnyjqhklllzslydxxwbc"
+    "jqsbxbfjzjcjdzfbxxbrmlazgcsnclbjdstblprzdswsbxbcllxxlzdjzsjpylyxxyftfffbhjjjgbygjpmmmmsscljmtlyz"
+    "jxswxtyledqpjmygqzjgdjlqjwjqllsdgjgygmscljjxdtygjqjqjcjzcjgdzdshqgsjggcjhqxsnjlzzbxhsgzxcxyljxyx"
+    "yydfqqjhjfxdhctxjyrxysqtjxyefyyssyxjxncyzxfxcsxszxyyschshxzzzgzzzgfjdldylnpzgyjyzyyqzpbxqbdztzcz"
+    "yxxyhhscxshcggqhjhgxwsztmzmehyxgebtylzkkwytjzrclekestdbcykqqsayxcjxwwgsbhjszsdhcsjkqcxswxfctynyd"
+    "pzcczjqtzwjqdzzzqzljchlsbhpydxpsxshhezdxfptjqyzzxhyaxncfzyyhxgnqmywxtzsjpkhhgymxmxqcxtsbcqsjyxht"
+    "yyzybcqlmmszmjzjllcogxzaajzyhjmchhcxzsxzdznleyjjzjbhzwzzsqtzpsxztdsxjjjznyazphhyysrnqzthzhayjyjh"
+    "dzxzlswclybzyecwcycrylcxnhzydzydyjdfrjjhtrsqtxyxjrjhojynxelxsfsfjzghpzsxzszdzcqzbyyklsgsjhczshdg"
+    "qgxyzgxchxzjwyqwgyhksseqzzndzfkwyssdclzstsymcdhjxxyweyxczaydmpxmdsxybsqmjmzjmtzqlpjyqzcgqhxjhhhx"
+    "xhlhdldjqsldwbsxfzzyyschtytyjbhecxhjkgjfxbhyzjfxbwhbdzfyzbcapnpgnydmsxhkhhmhmlnbyjtmpxejmcthjbzy"
+    "fcgtyhwphftgzzezsbzegpbmdskftycmhbllhgpzjxzjgzjyxzsbbqsczzlzccstpgxmjsftcczjzdjxcybzlfcjsyzfgszl"
+    "ybcwzzbyzdzypswyjgxzbdsysxlgzbzfygczxbzhzftpbgzgejbstgkdmfhyzzjhzllzzgjqzlsfdjsscbzgpdlfzfzszyzy"
+    "zsygcxsntxchczxtzzljfzgqsqyxcjqccccdjcdxzjyqjccgxztdlgscxzsyjjqtcclqdqztqchqqjztezzzpbkkdjfcjfzt"
+    "ybqyqttynlmbdktjcpqzjdzfpjsbnjlgyjdxjdzqkzgqkxclpzjtcjtqbxdjjjstcjnxbxcmslyjcqmtjqwwcjjnjjlllhjc"
+    "wqtbzqyczczpzzdzyddcyzdzccjgtjfzdprntctjdcqtqndtjnplzbcllctdsxkjzqdpzlbznbtjdcxfczdbccjjltqjpldc"
+    "kzdbbzjcqdcjwynllzlzccdwllxwzlxrsntqjccxkjlsgdfqtddglrlajjtklymkqlldzytdyycygjwyxdxfrskstcdenqmr"
+    "rqzhhqkdldazfkypbggpzrebzzykyzspegjjghkqzzzslysywyzwfqznlzzlzhwcgkypqgnpgblplrrjyxcccgyhsfzfwbzy"
+    "wtgzxyljczwhxzjzblfflgskhyjzeyjhlpllllczgxdrzelrhgklzzyhzlyqszzjzqljzflnbhgwlczcfjwspyxzlzlxgccb"
+    "zbllcxbbbbxbbcbbcrnncccyrbbsrldcgqyyqxygmqzwtzytyjhyfwdehzzjywlccntzyjjcdedpzdztstqjhdymbjnyjzlx"
+    "tsstphndjxxbyxqtzqddtjtdyztgwscszqflshlglbcjbhdlyzjyckwtydylbnydsdsycctyszyyebgexhqddwnygyclxtdc"
+    "ystqmygzasccszzddlcclzrqxyywljsbymxshztembbllyyllytdqyshymrqwkfkbfxnxsbychxbwjyhtqbpbsbwdzylkgzs"
+    "kyghqzjhhxjxgnljkzlyycdxlfwfghljgjybxblybxqpqgztzplncybxdjyqydymrbesjyyhkxxstmxrczzywxyhybmcflyz"
+    "hqyzmqxdbxbzwzmslpdmyckfmzklzcyjycclhxfzlydqzpzygyjyzmzxdzfyfyttqtchgsfczmlccytzxjcytjmkslpzhysn"
+    "wllytpzctzzcktxdhxxtqcypksmqccyyazhtjpcylzlyjbjxtfnyljyynrxcylmmnxjsmybcsysslzylljjqyldzdpqbfzzb"
+    "lfndsqkczfhhhgqmrdsxycstxnqqjpyjbfcxdyqfpnxejdgyqbsrcnfyjqpghyjsyzxgrhtkylewdzntsmgklbsgbpyszbyt"
+    "jzsszjcssxzbhbscsbzczptqfzlqflypybbjgszmxxdjmthyskkbjtxhjcelbsmjyjzcxtmljyxrzzqscxxqptzxmkyxxxjc"
+    "ljprmyygadyskqlsadhrskqxzxztcghztlmlwxybwsycdbhjhcfcwzsxhytgzlxqshlyczjxtmplprcgltbzztlzjcyjgdtc"
+    "lglbllqpjmzpapxyzlkktkdnczzbnzctdqqzjyjgmctxltgcszlmlhbglkfwnwzhdxphlfmkydlgxdtwzfrjejctzhydxykx"
+    "hwfzcqshktmqqhtchymjdjskhxdjzbzzxympajqmsdbxlsklyynwrtsqlscbpdbsgzwyhtlkssswhzzlyytnxjgmjszsxfwn"
+    "lsoztxgxlsammlbwldszylakqcqctmycfjbslxclzjclxxksbzqclhjphqplsxsckslnhpsfqqytxjjzlqldxzjjzdyydjnz"
+    "ptfzdskjfsljhylzqjzlbthydgdjfdbyazxdzhzjnhhqbyknxjjqczmlljzkspldsclbblxklelxjlbjycxjxgcnlcqplzlz"
+    "njtsljgyzdzpltqcsjfdmnycxgbtjdcznbgbqyqjwgkfhtnbyqzqgbepbbyzmtjdytblsqmbsxtbnpdxklemyycjynzdtldy"
+    "kzzxddxhqshdgmzsjycctayrzlpwltlkxslzcggexclfxlkjrtlqjaqzncmbqdkkcxglczjzxjhptdjjmzqykqsecqzdshha"
+    "dmlzfmmzbgntjnnlgbyjbrbtmlbyjdzxlcjlpldlpcqdhlhzlycblcxzcjadqlmcmmsshmybhbskkbhrsxxjmxsdznzpxlbb"
+    "ragggfchgmsklltsjyycqlcskywyehywxbhqywbawykqldqftntkhqcgdqktgpkxhcpdhtwtmssyhbwcrwxhjmkmzngwtmlk"
+    "fghkjyldyycxwhyeclqhkqhtdqhhffldxqwgzyydesbpkyrzpjfyyzjceqdzzdlattbbfjllcxdlmjsdxegygsjqxcfbxssz"
+    "pdyzcxdnyxpfzydlyjccpltxlsxyzyrxcyysdylwwndsahjsygyhgywkaxtjzdaxysrltdjssaxfnejdxyehlxlllzhzsjny"
+    "qyqqxyjghzgjcyjchzlycdshwsgczyjxcllnxzjjyyxnfsmwfpylcyllabwddhwdxjmcxztzpmlqzhsfhzynztlldywlslxh"
+    "ymmylmbwwkyxyadtsylldjpybpwfxjmmmllhafdllaflbhhhbqqjtzjcqjjdjtffkmmmbythygdcqrddwrqjxnbysnmzdbyy"
+    "tbjhpybygtjxaahgqdqtmystqxkbtsbkjlxrbeqqhxmjjbdjwtgtbxpgbktlgqxjjjcdhxqdwjlwrfmqgwqhckryswgbtgyg"
+    "bwsdwdwrfhwytjjxxxjyzyslphyypayxhydqkxshxyxeskqhywbdddpplcjlhqeewxksyshdyplfjthkjltcyyhhjttpltzz"
+    "cdlthqkcxqysteeywkyzyxxyysddjkllpwmcyhqgxyhcrmbxpllnqydqhxsxxwgdqbshyllpjjjthyjkyphthyyktyezyenm"
+    "dshlcrpqfbgfxzbsbtlgxsjbswyysksflxlpplbbblbsfxfyzbsjssylpbbffffsscjdstzsxtryjcyffsytyzbjtlctsbsd"
+    "hrtjjbytcxyjeylxcbnebjdsysyhgsjzbxbytfzwgenyhhthjhatfwgcstbgxklstyymtmbyxjskzscdyjrcytwxzfhmymcx"
+    "lznsdjtttxrycfyjsbsdyerxhljxbbdeynjghxgckgscymblxjmsznskgxfbnbbthfjaafxyxfpxmyfhdtzcxzzpxrsywzdl"
+    "ybbjtyqpqjpzypzjznjpzjlztfysbttslmptzrtdxqsjehbzylzdxljsqmlhtxtjecxalzzspktlzkqqyfsygywpcpqfhqhy"
+    "tqxzkrsgtgsqczlptxcdyyzsslzslxlzmacbcqbzyxhbsxlzdltcdjtylzjyytpzylltxjsjxhlbmytxcqrblzssfjzztnjy"
+    "dxmyjhlhpblcyxqjqqkzzscpzkswalqsblcczjsxgwwwygyatjbbctdkhqhkgtgpbkqyslbxbbckbmllxdzstbklggqkqlsb"
+    "kkdfxrmdkbftpzfrtbbmferqgxkjpzsstlbzdpszqzsjthljqlzbpmsmmsxlqqnhknblrddnhxdhddjcyygyfqgzlgsygmjq"
+    "gkhbpmxyxlytqwlwgcpbmjxcyzydrjbhtdjxeeshtmjsbyplwhlzffnypmhxqhpltbqpfbcwjdbygpnxtbfzjgsddtjshxea"
+    "wzzyllttybwjkgxghlfkxdjtmszsqynzggswqsphtlsskmclzxynzqzxncjdqgzdlfnykljcjllzlmzznhydsshthxzlzzbb"
+    "hqzwwycrdhlyqqjbeyfsgxthsrxwqhwfslmssgzttyeyqqwrslalhmjtqjsmxqbjjzjxzyzkxbyqxbjxshzssfglxmxzxfgh"
+    "kzszggylclsarjxhslllmzxelglxydjytlfbhbpnlyzfbbhptgjkwetzhkjjxzxxglljlstgshjjyqlqzfkcgnndjsszfdbc"
+    "twwseqfhqjbsaqtgypjlbxbmmywxgslzhglzgnyfljbyfdjfrgsfmbyzhqfbwjsyfyjjphzbyyzffwodgrlmftmlbzgycqxc"
+    "djygdyyrytytydwegazyhxjlzythlrmgrjxzzlhneljjthtbwjybjxbxjjtjteekhwsljplpsfazpqqbdlqjjtyyqlyzkdks"
+    "qjyyjzldqcgjjyzjsycmraqthtejmfctyhypkmhycwjdcfhyyxwshctxrljgjshccyyyjltkttytmjgtcjtzayyoczlylbsz"
+    "ywjytsjyhbyshfjlygjxxtmzyyltxxypclxyjzyzyypnhmymdyylblhlsyygqllnjjymsoycbzgdlyxylcqyxtszegxhzglh"
+    "wbljgeyxtwqmakbpqcgyshhegqcmwyywljyjhyyzlljjylhzyhmgsljljxcjjyclycjpcpzjzjmmylcjlnqljjjlxxjmlszl"
+    "jqlycmmhcfmmfpqqmfxlqmcffqmmmmhmznfhhjgtthhkhslnchhyqdxtmmqdcydyxyqmyqylddcyyydazdcymzydlzfffmmy"
+    "cqcwzzmabtbyctdmndzggdftypcgqyttssffwbdtzqssystwnjhjytsxxylbyqhwwhxezxwznnqzjzjjqjccchyyxbzxccyj"
+    "tllcqxknjyckycynzzqyyoewyczdcjycchyjlbtzkycqwlpgpyllgkdldlgkgqbgychjxy"
+;
+
+// 多音字的首字母集合，按位（bit 0 = 'a'）
+static const uint32_t kSets[] = {
+    0x0000005, 0x0000011, 0x0000081, 0x0002001, 0x1000001, 0x0000022, 0x0001002, 0x0008002,
+    0x000000C, 0x004000C, 0x0000204, 0x0010004, 0x0040004, 0x0800004, 0x2000004, 0x0002008,
+    0x0040008, 0x0080008, 0x2000008, 0x0002010, 0x0004010, 0x0400010, 0x0008020, 0x00000C0,
+    0x0000240, 0x0010240, 0x0000440, 0x0000C40, 0x0000840, 0x0010040, 0x0000280, 0x0000480,
+    0x0001080, 0x0800080, 0x0000600, 0x0010200, 0x0800200, 0x2000200, 0x0010400, 0x0002800,
+    0x0040800, 0x1000800, 0x0401000, 0x1002000, 0x2002000, 0x0014000, 0x0404000, 0x0810000,
+    0x1010000, 0x00C0000, 0x0840000, 0x2040000, 0x1400000, 0x1800000, 0x3000000,
+};
+
+// 按码位排序：{ 码位, kSets 下标 }
+static const struct {
+    uint16_t cp;
+    uint8_t set;
+} kPolyphones[] = {
+    { 0x4E07, 42 }, { 0x4E14, 35 }, { 0x4E50, 41 }, { 0x4E58, 12 }, { 0x4E7E, 29 }, { 0x4E9F, 35 },
+    { 0x4EC7, 11 }, { 0x4F1A, 31 }, { 0x4F20, 14 }, { 0x4F3A, 12 }, { 0x4FA7, 14 }, { 0x4FBF,  7 },
+    { 0x5080, 26 }, { 0x5228,  7 }, { 0x5239, 12 }, { 0x5319, 12 }, { 0x533A, 45 }, { 0x5355,  9 },
+    { 0x5361, 38 }, { 0x5382,  0 }, { 0x5395, 12 }, { 0x53A6, 50 }, { 0x53C2, 12 }, { 0x53E5, 24 },
+    { 0x53F6, 53 }, { 0x5401, 53 }, { 0x5408, 23 }, { 0x5413, 33 }, { 0x5426, 22 }, { 0x542D, 31 },
+    { 0x5475,  2 }, { 0x5496, 26 }, { 0x54AF, 27 }, { 0x54B3, 31 }, { 0x54E6, 20 }, { 0x5594, 46 },
+    { 0x55EF, 19 }, { 0x563F, 32 }, { 0x56E4, 17 }, { 0x5708, 35 }, { 0x57D4,  7 }, { 0x5821,  7 },
+    { 0x58F3, 38 }, { 0x5939, 24 }, { 0x5947, 35 }, { 0x5BBF, 50 }, { 0x5C09, 52 }, { 0x5C3E, 52 },
+    { 0x5C5E, 51 }, { 0x5CD9, 51 }, { 0x5DF7, 33 }, { 0x5E62, 14 }, { 0x5F04, 39 }, { 0x5F39, 17 },
+    { 0x5F3A, 35 }, { 0x6076, 21 }, { 0x6241,  7 }, { 0x625B, 26 }, { 0x6298, 51 }, { 0x62D7,  3 },
+    { 0x62FD, 54 }, { 0x63D0, 17 }, { 0x64AE, 14 }, { 0x6512, 14 }, { 0x66B4,  7 }, { 0x66DD,  7 },
+    { 0x66FE, 14 }, { 0x671D, 14 }, { 0x671F, 35 }, { 0x672F, 51 }, { 0x67B8, 24 }, { 0x6805, 51 },
+    { 0x6816, 47 }, { 0x6821, 36 }, { 0x690E, 14 }, { 0x69DB, 34 }, { 0x6B59, 50 }, { 0x6B96, 51 },
+    { 0x6C0F, 51 }, { 0x6C64, 49 }, { 0x6C88, 12 }, { 0x6CCA,  7 }, { 0x6CCC,  6 }, { 0x6CF7, 40 },
+    { 0x6D52, 33 }, { 0x6F84,  8 }, { 0x7011,  7 }, { 0x7094, 29 }, { 0x70AE,  7 }, { 0x7387, 40 },
+    { 0x755C, 13 }, { 0x756A, 22 }, { 0x759F, 43 }, { 0x76DB, 12 }, { 0x7701, 50 }, { 0x77F3, 16 },
+    { 0x796D, 37 }, { 0x79CD, 14 }, { 0x79D8,  6 }, { 0x7A3D, 35 }, { 0x7AA8, 53 }, { 0x7C98, 44 },
+    { 0x7CA5, 54 }, { 0x7CFB, 36 }, { 0x7E41, 22 }, { 0x7EA2, 23 }, { 0x7EA4, 47 }, { 0x7EB6, 28 },
+    { 0x7ED9, 24 }, { 0x7F09, 35 }, { 0x7FDF, 18 }, { 0x812F, 22 }, { 0x814C,  4 }, { 0x81ED, 13 },
+    { 0x827E,  4 }, { 0x82A5, 24 }, { 0x82E3, 35 }, { 0x8304, 35 }, { 0x831C, 47 }, { 0x8368, 47 },
+    { 0x8513, 42 }, { 0x851A, 52 }, { 0x8543,  5 }, { 0x85CF, 14 }, { 0x8679, 30 }, { 0x86E4, 23 },
+    { 0x884C, 33 }, { 0x89E3, 36 }, { 0x8BC6, 51 }, { 0x8C03, 17 }, { 0x8D3E, 24 }, { 0x8E4A, 47 },
+    { 0x8F66, 10 }, { 0x8F67, 54 }, { 0x8F97, 44 }, { 0x8F9F,  7 }, { 0x91CD, 14 }, { 0x94C5, 48 },
+    { 0x9550, 23 }, { 0x957F, 14 }, { 0x963F,  1 }, { 0x9642,  7 }, { 0x964D, 36 }, { 0x9888, 24 },
+    { 0x9A91, 35 }, { 0x9E1F, 15 }, { 0x9E44, 23 }, { 0x9F9F, 25 },
+};
+
+uint8_t pinyinKey(uint32_t cp) {
+    if (cp < 0x4E00 || cp > 0x9FA5) return 0;
+    size_t lo = 0, hi = sizeof(kPolyphones) / sizeof(kPolyphones[0]);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (kPolyphones[mid].cp < cp) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < sizeof(kPolyphones) / sizeof(kPolyphones[0]) && kPolyphones[lo].cp == cp) {
+        return kPinyinSetBase + kPolyphones[lo].set;
+    }
+    char c = kInitials[cp - 0x4E00];
+    return c == '.' ? 0 : (uint8_t)c;
+}
+
+uint32_t pinyinKeyMask(uint8_t key) {
+    if (key >= 'a' && key <= 'z') return 1u << (key - 'a');
+    size_t set = key - kPinyinSetBase;
+    return key >= kPinyinSetBase && set < sizeof(kSets) / sizeof(kSets[0]) ? kSets[set] : 0;
+}
+
+uint32_t pinyinTableId() { return 0x545DC35A; }
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 汉字的拼音首字母，用作检索键中的一个字节。
+// 收录 CJK 基本区（U+4E00..U+9FA5）全部 20902 个字中有读音数据的字：一般字为主读音的首字母 'a'..'z'；
+// 首字母不同的常用多音字（"重" zhong / chong）为 kPinyinSetBase 起的集合编号，可由 pinyinKeyMask 展开。
+// 扩展 A 区及以后的字、以及表外多音字的次要读音不收录。
+// 表由 tools/gen_pinyin_initials.py 生成，约 21KB，放在 flash 中。纯 C++。
+static const uint8_t kPinyinSetBase = 0x80;
+
+// 未收录返回 0
+uint8_t pinyinKey(uint32_t codepoint);
+// 检索键字节可匹配的首字母，按位（bit 0 = 'a'）；字母返回单个位，集合编号返回全部读音，其余返回 0
+uint32_t pinyinKeyMask(uint8_t key);
+// 表内容的校验值：表重新生成后，按旧表建立的检索索引随之失效
+uint32_t pinyinTableId();
@@ -0,0 +1,81 @@
+#include "PlayCountTable.h"
+#include <string.h>
+
+void PlayCountTable::clear() {
+    _entries.clear();
+    _clock = 0;
+    _dirty = false;
+}
+
+size_t PlayCountTable::lowerBound(uint32_t key) const {
+    size_t lo = 0, hi = _entries.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (_entries[mid].key < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void PlayCountTable::notePlayed(uint64_t pathHash) {
+    uint32_t key = fold(pathHash);
+    size_t i = lowerBound(key);
+    _clock++;
+    if (i < _entries.size() && _entries[i].key == key) {
+        if (_entries[i].plays < 0xFFFF) _entries[i].plays++;
+        _entries[i].last = _clock;
+    } else {
+        // 只在首次播放时插入，搬移量有限（1 万首约 120KB）
+        _entries.insert(_entries.begin() + i, Entry{ key, _clock, 1, 0 });
+    }
+    _dirty = true;
+}
+
+uint16_t PlayCountTable::plays(uint64_t pathHash) const {
+    uint32_t key = fold(pathHash);
+    size_t i = lowerBound(key);
+    return i < _entries.size() && _entries[i].key == key ? _entries[i].plays : 0;
+}
+
+uint32_t PlayCountTable::age(uint64_t pathHash) const {
+    uint32_t key = fold(pathHash);
+    size_t i = lowerBound(key);
+    if (i >= _entries.size() || _entries[i].key != key) return kNeverPlayed;
+    uint32_t a = _clock - _entries[i].last;
+    return a < kNeverPlayed ? a : kNeverPlayed - 1;
+}
+
+size_t PlayCountTable::serializedSize() const {
+    return 4 + 4 + _entries.size() * sizeof(Entry);
+}
+
+void PlayCountTable::serialize(uint8_t *out) const {
+    uint32_t count = _entries.size();
+    memcpy(out, &_clock, 4);
+    memcpy(out + 4, &count, 4);
+    if (count) memcpy(out + 8, _entries.data(), count * sizeof(Entry));
+}
+
+bool PlayCountTable::sorted() const {
+    for (size_t i = 1; i < _entries.size(); i++) {
+        if (_entries[i - 1].key >= _entries[i].key) return false;
+    }
+    return true;
+}
+
+bool PlayCountTable::deserialize(const uint8_t *in, size_t len) {
+    clear();
+    if (len < 8) return false;
+    uint32_t clock, count;
+    memcpy(&clock, in, 4);
+    memcpy(&count, in + 4, 4);
+    if (count > (len - 8) / sizeof(Entry) || len != 8 + (size_t)count * sizeof(Entry)) return false;
+    _entries.resize(count);
+    if (count) memcpy(_entries.data(), in + 8, count * sizeof(Entry));
+    _clock = clock;
+    if (!sorted()) { // 未排序即视为损坏
+        clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../util/CountingAllocator.h"
+
+// 紧凑的播放统计表：每首 12 字节（32 位路径哈希 + 最近播放序号 + 播放次数），按哈希排序二分查找。
+// 序号是表内的 32 位播放计数器，age = clock - last 即"距上次播放又播了多少首"（约 40 亿次播放才回绕）。
+// 纯 C++，持久化由调用方负责（serialize / deserialize 为原始字节）。
+class PlayCountTable {
+public:
+    static const uint32_t kNeverPlayed = 0xFFFFFFFF; // 未播放过的曲目的 age
+
+    void clear();
+    void notePlayed(uint64_t pathHash);
+    uint16_t plays(uint64_t pathHash) const;
+    uint32_t age(uint64_t pathHash) const; // 未播放过返回 kNeverPlayed
+    size_t size() const { return _entries.size(); }
+    bool isDirty() const { return _dirty; }
+
+    // 持久化格式：clock (u32) + count (u32) + entries；校验由调用方附加
+    size_t serializedSize() const;
+    void serialize(uint8_t *out) const;
+    bool deserialize(const uint8_t *in, size_t len);
+    void markClean() { _dirty = false; }
+
+private:
+    struct Entry {
+        uint32_t key;
+        uint32_t last;
+        uint16_t plays;
+        uint16_t reserved; // 0，保持 12 字节无填充，序列化结果确定
+    };
+    static_assert(sizeof(Entry) == 12, "stats file format depends on the entry size");
+
+    static uint32_t fold(uint64_t h) { return (uint32_t)(h ^ (h >> 32)); }
+    size_t lowerBound(uint32_t key) const;
+    bool sorted() const;
+
+    TaggedVector<Entry, MEM_PLAYLIST> _entries;
+    uint32_t _clock = 0;
+    bool _dirty = false;
+};
@@ -0,0 +1,45 @@
+#include "PlayHistory.h"
+#include <string.h>
+
+void PlayHistory::clear() {
+    memset(_slots, 0, sizeof(_slots));
+    _head = kCapacity - 1;
+    _count = 0;
+    _cursor = 0;
+}
+
+bool PlayHistory::push(uint64_t hash) {
+    _cursor = 0;
+    if (_count && _slots[_head] == hash) return false;
+    _head = (_head + 1) % kCapacity;
+    _slots[_head] = hash;
+    if (_count < kCapacity) _count++;
+    return true;
+}
+
+uint64_t PlayHistory::at(size_t back) const {
+    if (back >= _count) return 0;
+    return _slots[(_head + kCapacity - back) % kCapacity];
+}
+
+bool PlayHistory::back(uint64_t &hash) {
+    if (_cursor + 1u >= _count) return false;
+    _cursor++;
+    hash = at(_cursor);
+    return true;
+}
+
+bool PlayHistory::forward(uint64_t &hash) {
+    if (_cursor == 0) return false;
+    _cursor--;
+    hash = at(_cursor);
+    return true;
+}
+
+void PlayHistory::restore(const uint64_t *slots, uint16_t head, uint16_t count) {
+    clear();
+    if (head >= kCapacity || count > kCapacity) return;
+    memcpy(_slots, slots, sizeof(_slots));
+    _head = head;
+    _count = count;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 播放历史环形缓冲：记录最近 kCapacity 首的路径哈希，push / 回退 / 前进均为 O(1)。
+// 游标表示当前正在回看第几首（0 为最新），prev() 沿真实历史回退、到最早一条为止，next() 先重放回退过的曲目。
+// 持久化为全部槽位加头部（见 slot() / head()）。纯 C++。
+class PlayHistory {
+public:
+    static const uint16_t kCapacity = 64;
+
+    PlayHistory() { clear(); }
+
+    void clear();
+    bool push(uint64_t hash); // 与最新一条相同则忽略并返回 false；游标回到最新
+    size_t size() const { return _count; }
+    uint64_t at(size_t back) const; // 0 为最新
+
+    bool back(uint64_t &hash);    // 游标后退一首
+    bool forward(uint64_t &hash); // 游标前进一首
+    bool atHead() const { return _cursor == 0; }
+    void toHead() { _cursor = 0; } // 放弃待重放的曲目（用户直接选曲时）
+    size_t cursor() const { return _cursor; }
+
+    // 持久化
+    uint16_t head() const { return _head; } // 最新一条所在槽位
+    uint16_t count() const { return _count; }
+    uint64_t slot(uint16_t i) const { return _slots[i]; }
+    void restore(const uint64_t *slots, uint16_t head, uint16_t count);
+
+private:
+    uint64_t _slots[kCapacity];
+    uint16_t _head;
+    uint16_t _count;
+    uint16_t _cursor;
+};
@@ -0,0 +1,235 @@
+#include "SearchIndex.h"
+#include "PinyinInitials.h"
+#include <string.h>
+#include <algorithm>
+
+enum CharClass : uint8_t { CLASS_NONE, CLASS_LETTER, CLASS_DIGIT, CLASS_CJK };
+
+// 解码一个 UTF-8 字符，非法序列按单字节返回 U+FFFD
+static size_t decodeUtf8(const uint8_t *s, size_t len, uint32_t &cp) {
+    uint8_t b = s[0];
+    size_t n = b < 0x80 ? 1 : (b & 0xE0) == 0xC0 ? 2 : (b & 0xF0) == 0xE0 ? 3 : (b & 0xF8) == 0xF0 ? 4 : 0;
+    if (n == 0 || n > len) {
+        cp = 0xFFFD;
+        return 1;
+    }
+    cp = n == 1 ? b : b & (0x7F >> n);
+    for (size_t i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            cp = 0xFFFD;
+            return 1;
+        }
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    return n;
+}
+
+size_t SearchIndex::normalize(const char *in, size_t len, char *out, size_t cap, uint64_t *starts) {
+    if (starts) *starts = 0;
+    if (cap == 0) return 0;
+    size_t n = 0;
+    uint8_t prev = CLASS_NONE;
+    size_t i = 0;
+    while (i < len && n + 1 < cap) {
+        uint32_t cp;
+        i += decodeUtf8((const uint8_t *)in + i, len - i, cp);
+        if (cp >= 0xFF01 && cp <= 0xFF5E) cp -= 0xFEE0; // 全角 ASCII
+
+        char c = 0;
+        uint8_t cls = CLASS_NONE;
+        if (cp >= 'A' && cp <= 'Z') {
+            c = cp + 32;
+            cls = CLASS_LETTER;
+        } else if (cp >= 'a' && cp <= 'z') {
+            c = cp;
+            cls = CLASS_LETTER;
+        } else if (cp >= '0' && cp <= '9') {
+            c = cp;
+            cls = CLASS_DIGIT;
+        } else if (cp >= 0x80 && (c = (char)pinyinKey(cp)) != 0) {
+            cls = CLASS_CJK;
+        }
+        if (!c) {
+            prev = CLASS_NONE; // 空格、标点、未收录的字：只作词边界
+            continue;
+        }
+        // 词首：每个汉字；字母 / 数字串的第一个字符
+        if (starts && n < 64 && (cls == CLASS_CJK || cls != prev)) *starts |= 1ull << n;
+        out[n++] = c;
+        prev = cls;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+void SearchIndex::clear() {
+    _keyOffsets.clear();
+    _keys.clear();
+    _entries.clear();
+}
+
+void SearchIndex::add(uint32_t id, const char *path, size_t rootLen) {
+    if (id >= (1u << (32 - kOffsetBits))) return;
+    if (_keyOffsets.size() <= id) _keyOffsets.resize(id + 1, (uint32_t)kNoKey);
+
+    // 文件名去掉扩展名
+    const char *slash = strrchr(path, '/');
+    const char *name = slash ? slash + 1 : path;
+    const char *dot = strrchr(name, '.');
+    size_t nameLen = (dot && dot != name) ? dot - name : strlen(name);
+
+    char key[kMaxKey + 1];
+    uint64_t starts;
+    size_t n = normalize(name, nameLen, key, kMaxName + 1, &starts);
+
+    // 目录标签：所在目录名，模式目录本身不算
+    if (slash && (size_t)(slash - path) > rootLen && n + 2 < sizeof(key)) {
+        const char *dir = slash;
+        while (dir > path && dir[-1] != '/') dir--;
+        uint64_t dirStarts;
+        size_t d = normalize(dir, slash - dir, key + n + 1, sizeof(key) - n - 1, &dirStarts);
+        if (d) {
+            key[n] = kTagSeparator;
+            starts |= dirStarts << (n + 1);
+            n += 1 + d;
+        }
+    }
+    if (n == 0) return;
+
+    _keyOffsets[id] = _keys.size();
+    _keys.insert(_keys.end(), key, key + n + 1);
+    for (size_t i = 0; i < n && i < 64; i++) {
+        if (starts & (1ull << i)) _entries.push_back((id << kOffsetBits) | i);
+    }
+}
+
+void SearchIndex::finalize() {
+    std::sort(_entries.begin(), _entries.end(), [this](uint32_t a, uint32_t b) {
+        int c = strcmp(suffix(a), suffix(b));
+        return c != 0 ? c < 0 : a < b;
+    });
+    _entries.shrink_to_fit();
+    _keys.shrink_to_fit();
+}
+
+bool SearchIndex::inTag(uint32_t entry) const {
+    const char *key = &_keys[_keyOffsets[entry >> kOffsetBits]];
+    return memchr(key, kTagSeparator, entry & 63) != nullptr;
+}
+
+size_t SearchIndex::query(const char *prefix, uint32_t *out, size_t max) const {
+    char q[kMaxKey + 1];
+    size_t qlen = normalize(prefix, strlen(prefix), q, sizeof(q));
+    if (qlen == 0 || max == 0 || _entries.empty()) return 0;
+
+    // 逐字节收窄：区间内的后缀前 depth 个字节相同，因而按第 depth 个字节有序。
+    // 多音字的键字节可匹配多个字母，每层可能分出几个区间；区间按候选字节升序产生，始终保持排序顺序
+    Range ranges[kMaxRanges], next[kMaxRanges];
+    size_t count = 1;
+    ranges[0] = { 0, (uint32_t)_entries.size() };
+    for (size_t depth = 0; depth < qlen && count; depth++) {
+        uint8_t cand[26 + 128];
+        size_t candCount = candidates((uint8_t)q[depth], cand);
+        size_t n = 0;
+        for (size_t r = 0; r < count; r++) {
+            auto first = _entries.begin() + ranges[r].lo, last = _entries.begin() + ranges[r].hi;
+            for (size_t c = 0; c < candCount && n < kMaxRanges; c++) {
+                auto lo = std::lower_bound(first, last, cand[c], [this, depth](uint32_t e, uint8_t b) {
+                    return (uint8_t)suffix(e)[depth] < b;
+                });
+                auto hi = std::upper_bound(lo, last, cand[c], [this, depth](uint8_t b, uint32_t e) {
+                    return b < (uint8_t)suffix(e)[depth];
+                });
+                if (lo != hi) next[n++] = { (uint32_t)(lo - _entries.begin()), (uint32_t)(hi - _entries.begin()) };
+                first = hi;
+            }
+        }
+        memcpy(ranges, next, n * sizeof(Range));
+        count = n;
+    }
+
+    size_t n = 0;
+    for (int pass = 0; pass < 2 && n < max; pass++) {
+        for (size_t r = 0; r < count; r++) {
+            for (uint32_t i = ranges[r].lo; i < ranges[r].hi && n < max; i++) {
+                uint32_t e = _entries[i];
+                if (inTag(e) != (pass == 1)) continue;
+                uint32_t id = e >> kOffsetBits;
+                size_t k = 0;
+                while (k < n && out[k] != id) k++;
+                if (k == n) out[n++] = id;
+            }
+        }
+    }
+    return n;
+}
+
+// 查询字节可匹配的键字节（升序）：数字与分隔符只匹配自身；字母匹配自身及含该字母的多音字集合；
+// 查询中的多音字（直接输入汉字时）匹配其任一首字母及与之有交集的集合
+size_t SearchIndex::candidates(uint8_t want, uint8_t *out) {
+    uint32_t mask = pinyinKeyMask(want);
+    if (mask == 0) {
+        out[0] = want;
+        return 1;
+    }
+    size_t n = 0;
+    for (int i = 0; i < 26; i++) {
+        if (mask & (1u << i)) out[n++] = 'a' + i;
+    }
+    for (unsigned key = kPinyinSetBase; key < 256; key++) {
+        uint32_t set = pinyinKeyMask(key);
+        if (set == 0) break;
+        if (set & mask) out[n++] = key;
+    }
+    return n;
+}
+
+size_t SearchIndex::bytes() const {
+    return _keyOffsets.capacity() * 4 + _keys.capacity() + _entries.capacity() * 4;
+}
+
+size_t SearchIndex::serializedSize() const {
+    return 20 + _keyOffsets.size() * 4 + _keys.size() + _entries.size() * 4;
+}
+
+void SearchIndex::serialize(uint8_t *out, uint32_t sourceCrc) const {
+    uint32_t header[5] = { sourceCrc, pinyinTableId(), (uint32_t)_keyOffsets.size(), (uint32_t)_keys.size(),
+                           (uint32_t)_entries.size() };
+    memcpy(out, header, 20);
+    out += 20;
+    if (!_keyOffsets.empty()) memcpy(out, _keyOffsets.data(), _keyOffsets.size() * 4);
+    out += _keyOffsets.size() * 4;
+    if (!_keys.empty()) memcpy(out, _keys.data(), _keys.size());
+    out += _keys.size();
+    if (!_entries.empty()) memcpy(out, _entries.data(), _entries.size() * 4);
+}
+
+bool SearchIndex::deserialize(const uint8_t *in, size_t len, uint32_t sourceCrc) {
+    clear();
+    if (len < 20) return false;
+    uint32_t header[5];
+    memcpy(header, in, 20);
+    // 拼音表变了，旧索引中的键字节含义随之改变
+    if (header[0] != sourceCrc || header[1] != pinyinTableId()) return false;
+    if (len != 20 + (size_t)header[2] * 4 + header[3] + (size_t)header[4] * 4) return false;
+
+    _keyOffsets.resize(header[2]);
+    _keys.resize(header[3]);
+    _entries.resize(header[4]);
+    in += 20;
+    if (header[2]) memcpy(_keyOffsets.data(), in, header[2] * 4);
+    in += header[2] * 4;
+    if (header[3]) memcpy(_keys.data(), in, header[3]);
+    in += header[3];
+    if (header[4]) memcpy(_entries.data(), in, header[4] * 4);
+
+    // 校验下标，保证查询不会越界（内容完整性由调用方的 CRC 保证）
+    bool ok = _keys.empty() || _keys.back() == '\0';
+    for (uint32_t off : _keyOffsets) ok = ok && (off == kNoKey || off < _keys.size());
+    for (uint32_t e : _entries) {
+        uint32_t id = e >> kOffsetBits;
+        ok = ok && id < _keyOffsets.size() && _keyOffsets[id] != kNoKey && _keyOffsets[id] + (e & 63) < _keys.size();
+    }
+    if (!ok) clear();
+    return ok;
+}
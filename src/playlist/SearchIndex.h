@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../util/CountingAllocator.h"
+
+// 曲目检索：前缀匹配文件名与所在目录名（专辑），汉字按拼音首字母匹配。
+// 每首生成一个归一化键（"静夜思" → "jys"，"Twinkle Star" → "twinklestar"，目录名以 '|' 接在后面），
+// 在每个词首（ASCII 单词、数字串、每个汉字）建一条后缀，按后缀排序后二分查找，
+// 因此 "ys" 能命中 "静夜思"，"star" 能命中 "Twinkle Star"。
+// 多音字在键中是一个集合字节（见 PinyinInitials.h），"重阳" 用 "zy" 或 "cy" 都能找到：
+// 查询逐字节二分收窄区间，遇到多音字时分成几个区间，区间数有上限 kMaxRanges。
+// 内存：键约 10~40 字节 + 每个词首 4 字节。纯 C++，持久化由调用方负责（serialize / deserialize 为原始字节）。
+class SearchIndex {
+public:
+    static const size_t kMaxKey = 48;   // 键长上限（含目录部分），超出截断
+    static const size_t kMaxName = 32;  // 文件名部分上限
+    static const char kTagSeparator = '|';
+
+    void clear();
+    // 按曲目 ID 递增顺序添加；rootLen 为模式目录长度，直接位于模式目录下的曲目不带目录标签
+    void add(uint32_t id, const char *path, size_t rootLen);
+    void finalize(); // 全部添加后排序
+    // 前缀查询：文件名命中在前、目录名命中在后，同类按键的字典序；结果去重，最多 max 个
+    size_t query(const char *prefix, uint32_t *out, size_t max) const;
+    size_t bytes() const;
+    size_t entryCount() const { return _entries.size(); }
+
+    // 把输入归一化为检索字符：ASCII / 全角字母数字转小写半角，汉字取拼音首字母（多音字为集合字节），
+    // 其余字符丢弃。
+    // starts 非空时按位标记词首（第 i 位对应 out[i]）。返回写入长度（不含结尾 0）
+    static size_t normalize(const char *in, size_t len, char *out, size_t cap, uint64_t *starts = nullptr);
+
+    // 持久化格式：sourceCrc (u32) + 拼音表 ID (u32) + 曲目数 (u32) + 键字节数 (u32) + 后缀数 (u32)
+    // + 键偏移 + 键 + 后缀。sourceCrc 为建索引时播放列表缓存的 CRC，与拼音表 ID 任一不一致即视为过期
+    size_t serializedSize() const;
+    void serialize(uint8_t *out, uint32_t sourceCrc) const;
+    bool deserialize(const uint8_t *in, size_t len, uint32_t sourceCrc);
+
+private:
+    static const uint32_t kNoKey = 0xFFFFFFFF;
+    static const size_t kMaxRanges = 64; // 查询中同时存在的候选区间上限，超出的匹配被舍弃
+    static const uint32_t kOffsetBits = 6; // 后缀 = 曲目 ID << 6 | 键内偏移
+
+    const char *suffix(uint32_t entry) const { return &_keys[_keyOffsets[entry >> kOffsetBits]] + (entry & 63); }
+    bool inTag(uint32_t entry) const;
+    static size_t candidates(uint8_t want, uint8_t *out);
+
+    struct Range {
+        uint32_t lo, hi; // _entries 下标，左闭右开
+    };
+
+    TaggedVector<uint32_t, MEM_PLAYLIST> _keyOffsets; // 曲目 ID → 键在 _keys 中的偏移
+    TaggedVector<char, MEM_PLAYLIST> _keys;           // 以 0 结尾的键依次相连
+    TaggedVector<uint32_t, MEM_PLAYLIST> _entries;    // 按后缀排序
+};
@@ -0,0 +1,96 @@
+#include "TrackTable.h"
+#include "../util/PathHash.h"
+#include <string.h>
+
+TrackTable::TrackTable()
+    : arena(32 * 1024, MEM_PLAYLIST), playlist(ArenaAllocator<const char *>(&arena)),
+      removed(ArenaAllocator<bool>(&arena)), removedCount(0), duplicateCount(0), index(arena),
+      missing(ArenaAllocator<uint32_t>(&arena)), exhausted(false) {}
+
+bool TrackTable::add(const char *path, size_t len) {
+    if (exhausted) return false;
+    // 扩容后的指针数组与路径字符串一次预留，随后的两次分配都不会失败
+    size_t cap = playlist.capacity();
+    size_t grown = playlist.size() < cap ? cap : (cap ? cap * 2 : 64);
+    size_t need = (grown > cap ? grown * sizeof(const char *) : 0) + len + 1;
+    if (!arena.reserve(need)) {
+        exhausted = true;
+        return false;
+    }
+    if (grown > cap) playlist.reserve(grown);
+    playlist.push_back(arena.strdup(path, len));
+    return true;
+}
+
+void TrackTable::discard() {
+    index.clear();
+    arenaRelease(playlist);
+    arenaRelease(removed);
+    arenaRelease(missing);
+    removedCount = 0;
+    duplicateCount = 0;
+    arena.reset();
+}
+
+void TrackTable::markRemoved(uint32_t id) {
+    if (id >= removed.size() || removed[id]) return;
+    removed[id] = true;
+    removedCount++;
+}
+
+bool TrackTable::buildIndex() {
+    size_t n = playlist.size();
+    index.clear();
+    arenaRelease(removed);
+    arenaRelease(missing);
+    removedCount = 0;
+    duplicateCount = 0;
+    // 索引两个数组 + 墓碑（按 64 位字）+ 缺失位图，各留一份对齐余量
+    size_t need = PathIndex::bytesFor(n) + (n + 63) / 64 * 8 + (n + 31) / 32 * 4 + 4 * 8;
+    if (exhausted || !arena.reserve(need)) {
+        exhausted = true;
+        discard();
+        return false;
+    }
+    index.reserve(n);
+    removed.assign(n, false);
+    missing.assign((n + 31) / 32, 0);
+
+    for (uint32_t id = 0; id < playlist.size(); id++) {
+        if (index.insert(pathHash(playlist[id]), id) != id) {
+            markRemoved(id); // 同一路径出现两次
+            duplicateCount++;
+        }
+    }
+
+    // 副本检测：同目录下存在 "song.mp3" 时，"song_1.mp3" 视为重复
+    char original[256];
+    for (uint32_t id = 0; id < playlist.size(); id++) {
+        const char *path = playlist[id];
+        const char *slash = strrchr(path, '/');
+        const char *dot = strrchr(path, '.');
+        const char *underscore = strrchr(path, '_');
+        if (!dot || !underscore) continue;
+        const char *name = slash ? slash + 1 : path;
+        if (underscore <= name || dot <= underscore + 1) continue;
+
+        bool digits = true;
+        for (const char *p = underscore + 1; p < dot; p++) {
+            if (*p < '0' || *p > '9') { digits = false; break; }
+        }
+        if (!digits) continue;
+
+        // 去掉 "_N" 后的原始路径，在栈上拼接，不分配堆内存
+        size_t head = underscore - path;
+        size_t tail = strlen(dot);
+        if (head + tail >= sizeof(original)) continue;
+        memcpy(original, path, head);
+        memcpy(original + head, dot, tail + 1);
+        uint32_t orig = index.find(pathHash(original, head + tail));
+        if (orig != PathIndex::kNotFound && orig != id && !isRemoved(orig) && !isRemoved(id)) {
+            markRemoved(id);
+            duplicateCount++;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../util/Arena.h"
+#include "../util/PathIndex.h"
+
+// 单个模式的曲目表：路径字符串、路径索引、墓碑与缺失位图，全部分配在自己的 arena 中（计入 MEM_PLAYLIST）。
+// 纯 C++，不依赖 Arduino String / SD：扫描与缓存加载由 PlaylistManager 负责，逐条 add() 后 buildIndex()。
+// 主机端据此测试模式反复重建时的内存增长。
+struct TrackTable {
+    TrackTable();
+
+    Arena arena;
+    ArenaVector<const char *> playlist; // 按扫描顺序存放，下标即曲目 ID
+    ArenaVector<bool> removed;          // 墓碑：缺失或重复的曲目
+    size_t removedCount;
+    size_t duplicateCount;
+    PathIndex index;                    // 路径哈希 → 曲目 ID
+    ArenaVector<uint32_t> missing;      // 位图：后台校验发现已不存在的曲目
+    bool exhausted;                     // 曾经内存不足：此后 add() 一律失败，模式按无法加载处理
+
+    // 内存不足返回 false 且不加入任何条目（不会出现空路径）
+    bool add(const char *path, size_t len);
+    // 重建路径索引与墓碑：完全相同的路径，以及同目录下已有 "song.mp3" 时的 "song_N.mp3" 记为重复。
+    // 所需内存一次预留，不足时丢弃全部曲目并返回 false
+    bool buildIndex();
+    // 丢弃全部曲目并整体回收 arena（扫描 / 缓存加载中途失败时）；调用方自己放在 arena 中的容器须先清空。
+    // 不清除 exhausted
+    void discard();
+
+    bool isRemoved(uint32_t id) const { return id < removed.size() && removed[id]; }
+    bool isMissing(uint32_t id) const {
+        return id / 32 < missing.size() && (__atomic_load_n(&missing[id / 32], __ATOMIC_RELAXED) & (1u << (id % 32)));
+    }
+    bool isPlayable(uint32_t id) const { return !isRemoved(id) && !isMissing(id); }
+    size_t count() const { return playlist.size() - removedCount; }
+    void markRemoved(uint32_t id);
+};
@@ -0,0 +1,122 @@
+#include "HandoffState.h"
+#include <string.h>
+#include "../util/Crc32.h"
+
+// 显式按小端逐字段读写，与结构体布局和编译器填充无关
+static inline void put16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static inline void put32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = v >> (8 * i);
+}
+
+static inline void put64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = v >> (8 * i);
+}
+
+static inline uint16_t get16(const uint8_t *p) {
+    return p[0] | (uint16_t)p[1] << 8;
+}
+
+static inline uint32_t get32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+static inline uint64_t get64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+// CRC 覆盖版本、保留字节、长度与负载
+static uint32_t blobCrc(const uint8_t *blob) {
+    return crc32(blob + HandoffState::kHeaderSize, get16(blob + 6), crc32(blob + 4, 4));
+}
+
+void HandoffState::clear() {
+    mode = -1;
+    volume = 0;
+    flags = 0;
+    manifestHash = 0;
+    trackId = 0;
+    filePos = 0;
+    seconds = 0;
+    shuffleSeed = 0;
+    historySkip = 0;
+    path[0] = '\0';
+}
+
+void HandoffState::setPath(const char *p) {
+    size_t n = p ? strlen(p) : 0;
+    if (n > kMaxPath) n = 0;
+    if (n) memcpy(path, p, n);
+    path[n] = '\0';
+}
+
+size_t HandoffState::encode(uint8_t *out, size_t capacity) const {
+    size_t pathLen = strlen(path);
+    size_t payload = kFixedSize + pathLen;
+    if (capacity < kHeaderSize + payload) return 0;
+
+    uint8_t *p = out + kHeaderSize;
+    p[0] = (uint8_t)mode;
+    p[1] = volume;
+    p[2] = flags;
+    p[3] = (uint8_t)pathLen;
+    put64(p + 4, manifestHash);
+    put64(p + 12, trackId);
+    put32(p + 20, filePos);
+    put32(p + 24, seconds);
+    put32(p + 28, shuffleSeed);
+    put16(p + 32, historySkip);
+    put16(p + 34, 0); // 保留
+    memcpy(p + kFixedSize, path, pathLen);
+
+    put32(out, kMagic);
+    out[4] = kVersion;
+    out[5] = 0;
+    put16(out + 6, payload);
+    put32(out + 8, blobCrc(out));
+    return kHeaderSize + payload;
+}
+
+HandoffState::Result HandoffState::decode(const uint8_t *data, size_t len) {
+    clear();
+    if (len < kHeaderSize || get32(data) != kMagic) return EMPTY;
+    if (data[4] == 0) return UNSUPPORTED;
+
+    size_t payload = get16(data + 6);
+    if (payload < kFixedSize || len < kHeaderSize + payload) return CORRUPT;
+    const uint8_t *p = data + kHeaderSize;
+    if (blobCrc(data) != get32(data + 8)) return CORRUPT;
+    // 更高版本追加的字段在路径之后，这里只取认识的部分
+    size_t pathLen = p[3];
+    if (kFixedSize + pathLen > payload) return CORRUPT;
+
+    mode = (int8_t)p[0];
+    volume = p[1];
+    flags = p[2];
+    manifestHash = get64(p + 4);
+    trackId = get64(p + 12);
+    filePos = get32(p + 20);
+    seconds = get32(p + 24);
+    shuffleSeed = get32(p + 28);
+    historySkip = get16(p + 32);
+    memcpy(path, p + kFixedSize, pathLen);
+    path[pathLen] = '\0';
+    return OK;
+}
+
+const char *HandoffState::resultName(Result r) {
+    switch (r) {
+        case OK:          return "ok";
+        case EMPTY:       return "empty";
+        case CORRUPT:     return "corrupt";
+        case UNSUPPORTED: return "unsupported";
+    }
+    return "?";
+}
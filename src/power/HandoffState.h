@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 切换到另一个应用分区前的播放状态，回来时据此跳过加载界面直接续播。
+// 序列化格式（小端）：
+//   头部 12 字节：魔数 "HOFF"、版本、保留、负载长度 (u16)、CRC32（覆盖魔数之后的头部字段与负载）
+//   负载：固定字段 kFixedSize 字节 + 路径（长度在负载第 4 字节）
+// 版本规则：新字段只追加在负载末尾并提升版本号，旧固件按自己认识的部分解码、忽略多出的尾部；
+// 新固件读到旧版本时缺少的字段取默认值。不兼容的改动必须更换魔数。纯 C++，不依赖 Arduino。
+struct HandoffState {
+    static const uint32_t kMagic = 0x46464F48; // "HOFF"
+    static const uint8_t kVersion = 1;
+    static const size_t kHeaderSize = 12;
+    static const size_t kFixedSize = 36;
+    static const size_t kMaxPath = 255;
+    static const size_t kMaxSize = kHeaderSize + kFixedSize + kMaxPath;
+
+    enum Flags : uint8_t {
+        FLAG_MUTED = 1,
+        FLAG_PAUSED = 2,
+    };
+
+    enum Result : uint8_t {
+        OK,
+        EMPTY,       // 魔数不符：从未写入或已被清除 / 覆盖
+        CORRUPT,     // 长度或 CRC 不符
+        UNSUPPORTED, // 版本号无效
+    };
+
+    int8_t mode;           // 模式编号，-1 表示无效
+    uint8_t volume;
+    uint8_t flags;
+    uint64_t manifestHash; // 模式清单哈希，SD 卡内容变化后不再沿用
+    uint64_t trackId;      // 路径哈希
+    uint32_t filePos;      // 文件字节偏移
+    uint32_t seconds;
+    uint32_t shuffleSeed;  // 当前一轮播放顺序的随机种子
+    uint16_t historySkip;  // 该轮生成之后新增的历史条数，重建顺序时跳过
+    char path[kMaxPath + 1]; // 过长时为空，回来后先建索引再按 trackId 选曲
+
+    HandoffState() { clear(); }
+    void clear();
+    void setPath(const char *p);
+
+    // 返回写入字节数，out 空间不足时返回 0
+    size_t encode(uint8_t *out, size_t capacity) const;
+    Result decode(const uint8_t *data, size_t len);
+
+    static const char *resultName(Result r);
+};
@@ -0,0 +1,47 @@
+#include "HandoffStore.h"
+#include <Preferences.h>
+
+// 不随启动清零；内容是否有效完全由魔数和 CRC 判断
+RTC_NOINIT_ATTR static uint8_t s_rtcBlob[HandoffState::kMaxSize];
+
+bool HandoffStore::save(const HandoffState &state) {
+    uint8_t buf[HandoffState::kMaxSize];
+    size_t n = state.encode(buf, sizeof(buf));
+    if (n == 0) return false;
+    memcpy(s_rtcBlob, buf, n);
+
+    Preferences prefs;
+    prefs.begin("handoff", false);
+    bool ok = prefs.putBytes("state", buf, n) == n;
+    prefs.end();
+    Serial.printf("Handoff state saved (%u bytes, nvs %s)\n", (unsigned)n, ok ? "ok" : "failed");
+    return true;
+}
+
+bool HandoffStore::load(HandoffState &state) {
+    HandoffState::Result r = state.decode(s_rtcBlob, sizeof(s_rtcBlob));
+    if (r == HandoffState::OK) {
+        Serial.println("Handoff state from RTC");
+        return true;
+    }
+    Serial.printf("Handoff RTC: %s\n", HandoffState::resultName(r));
+
+    uint8_t buf[HandoffState::kMaxSize];
+    Preferences prefs;
+    prefs.begin("handoff", true);
+    size_t n = prefs.isKey("state") ? prefs.getBytes("state", buf, sizeof(buf)) : 0;
+    prefs.end();
+    if (n == 0) return false;
+    r = state.decode(buf, n);
+    Serial.printf("Handoff NVS: %s\n", HandoffState::resultName(r));
+    return r == HandoffState::OK;
+}
+
+void HandoffStore::clear() {
+    memset(s_rtcBlob, 0, HandoffState::kHeaderSize);
+    Preferences prefs;
+    prefs.begin("handoff", false);
+    // 没有记录时不写 Flash
+    if (prefs.isKey("state")) prefs.remove("state");
+    prefs.end();
+}
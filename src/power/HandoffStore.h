@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Arduino.h>
+#include "HandoffState.h"
+
+// 交接状态的存放：RTC 慢速内存（软件复位后保留，读取不碰 Flash）为主，
+// NVS "handoff" 命名空间为备份（另一个应用可能复用 RTC 内存，或中途断电）。
+// 开机 load() 成功后即 clear()，只用于紧接着的这一次启动。
+class HandoffStore {
+public:
+    bool save(const HandoffState &state);
+    bool load(HandoffState &state); // 先 RTC 后 NVS，两处都无效时返回 false
+    void clear();
+};
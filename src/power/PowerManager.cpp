@@ -0,0 +1,171 @@
+#include "PowerManager.h"
+#include "config.h"
+#include "../diag/TraceRecorder.h"
+#include <driver/i2s.h>
+#include <driver/gpio.h>
+#include <driver/rtc_io.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+static const uint32_t kCpuMhz[] = { 240, 160, 80 };
+static const uint8_t kBacklightLevel[] = { 128, POWER_BACKLIGHT_DIM_LEVEL, 0 };
+// 估算电流 (mA)：数据手册典型值，仅用于统计对比
+static const uint16_t kCpuMilliAmp[] = { 68, 50, 32 };
+static const uint16_t kBacklightMilliAmp[] = { 20, 6, 0 };
+
+PowerManager::PowerManager()
+    : _lastActivityMs(0), _pausedSinceMs(0), _wasPlaying(false), _i2sStopped(false),
+      _cpu(CPU_PERFORMANCE), _backlight(BACKLIGHT_FULL), _lightSleep(false),
+      _loopStartUs(0), _maxLoopWorkUs(0),
+      _lastAccountMs(0), _lastReportMs(0) {
+    memset(_cpuResidencyMs, 0, sizeof(_cpuResidencyMs));
+    memset(_backlightResidencyMs, 0, sizeof(_backlightResidencyMs));
+}
+
+void PowerManager::begin() {
+    _scheduler.dimAfterMs = POWER_BACKLIGHT_DIM_MS;
+    _scheduler.backlightOffAfterMs = POWER_BACKLIGHT_OFF_MS;
+    _scheduler.deepSleepAfterMs = POWER_DEEP_SLEEP_MS;
+
+    uint32_t now = millis();
+    _lastActivityMs = now;
+    _pausedSinceMs = now;
+    _lastAccountMs = now;
+    _lastReportMs = now;
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0) {
+        Serial.println("Power: woke from deep sleep by button");
+    }
+}
+
+void PowerManager::noteActivity() {
+    _lastActivityMs = millis();
+    if (_backlight != BACKLIGHT_FULL) applyBacklight(BACKLIGHT_FULL);
+}
+
+void PowerManager::onPause() {
+    // 暂停时停止 I2S：驱动持有的 PM 锁随之释放，才可能进入 light sleep
+    i2s_zero_dma_buffer(I2S_NUM_0);
+    i2s_stop(I2S_NUM_0);
+    _i2sStopped = true;
+}
+
+void PowerManager::onResume() {
+    if (!_i2sStopped) return;
+    i2s_start(I2S_NUM_0);
+    _i2sStopped = false;
+}
+
+void PowerManager::update(bool playing, bool heavyDecode) {
+    uint32_t now = millis();
+    uint32_t workUs = _loopStartUs ? micros() - _loopStartUs : 0;
+    if (workUs > _maxLoopWorkUs) _maxLoopWorkUs = workUs;
+    // 兜底：没有经过 onResume() 就开始播放的路径（I2S 仍停止，解码写入会阻塞）
+    if (playing && _i2sStopped) {
+        Serial.println("Power: playback started with I2S stopped, restarting");
+        onResume();
+    }
+    if (playing != _wasPlaying) {
+        if (!playing) _pausedSinceMs = now;
+        _wasPlaying = playing;
+    }
+
+    account(now);
+
+    PowerInputs in;
+    in.nowMs = now;
+    in.lastActivityMs = _lastActivityMs;
+    in.pausedSinceMs = _pausedSinceMs;
+    in.loopWorkUs = workUs;
+    in.playing = playing;
+    in.heavyDecode = heavyDecode;
+    PowerPlan plan = _scheduler.plan(in);
+
+    if (plan.deepSleep) {
+        enterDeepSleep();
+        return;
+    }
+    if (plan.cpu != _cpu) applyCpu(plan.cpu);
+    if (plan.backlight != _backlight) applyBacklight(plan.backlight);
+    if (plan.lightSleep != _lightSleep) applyLightSleep(plan.lightSleep);
+
+    if (now - _lastReportMs >= 60000) report(now);
+
+    if (plan.loopSleepMs > 0) delay(plan.loopSleepMs);
+    _loopStartUs = micros();
+}
+
+void PowerManager::applyCpu(CpuProfile profile) {
+    _cpu = profile;
+    setCpuFrequencyMhz(kCpuMhz[profile]);
+}
+
+void PowerManager::applyBacklight(BacklightLevel level) {
+    _backlight = level;
+    if (_backlightCb) _backlightCb(kBacklightLevel[level]);
+}
+
+void PowerManager::applyLightSleep(bool enable) {
+    _lightSleep = enable;
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    // 按键需能唤醒 light sleep
+    if (enable) {
+        gpio_wakeup_enable(MODEL_BUTTON_GPIO, GPIO_INTR_LOW_LEVEL);
+        gpio_wakeup_enable(VOLUME_UP_BUTTON_GPIO, GPIO_INTR_LOW_LEVEL);
+        gpio_wakeup_enable(VOLUME_DOWN_BUTTON_GPIO, GPIO_INTR_LOW_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+    }
+    esp_pm_config_esp32s3_t cfg = {
+        .max_freq_mhz = (int)kCpuMhz[_cpu],
+        .min_freq_mhz = 80,
+        .light_sleep_enable = enable,
+    };
+    esp_pm_configure(&cfg);
+#endif
+    // 未启用 PM 的固件只能依靠降频与主循环休眠
+}
+
+void PowerManager::enterDeepSleep() {
+    Serial.println("Power: entering deep sleep");
+    if (_beforeSleepCb) _beforeSleepCb();
+    applyBacklight(BACKLIGHT_OFF);
+    Serial.flush();
+
+    // 模式键唤醒（RTC GPIO，低电平有效）
+    rtc_gpio_pullup_en(MODEL_BUTTON_GPIO);
+    rtc_gpio_pulldown_dis(MODEL_BUTTON_GPIO);
+    esp_sleep_enable_ext0_wakeup(MODEL_BUTTON_GPIO, 0);
+    esp_deep_sleep_start();
+}
+
+void PowerManager::account(uint32_t nowMs) {
+    uint32_t dt = nowMs - _lastAccountMs;
+    _lastAccountMs = nowMs;
+    _cpuResidencyMs[_cpu] += dt;
+    _backlightResidencyMs[_backlight] += dt;
+}
+
+void PowerManager::report(uint32_t nowMs) {
+    uint32_t total = nowMs - _lastReportMs;
+    if (total == 0) return;
+
+    uint64_t mAms = 0;
+    for (int i = 0; i < 3; i++) {
+        mAms += (uint64_t)_cpuResidencyMs[i] * kCpuMilliAmp[i];
+        mAms += (uint64_t)_backlightResidencyMs[i] * kBacklightMilliAmp[i];
+    }
+    Serial.printf("Power: cpu 240/160/80 = %u/%u/%u%%, backlight full/dim/off = %u/%u/%u%%, est %u mA, "
+                  "max loop work %u ms\n",
+                  (unsigned)(_cpuResidencyMs[0] * 100 / total), (unsigned)(_cpuResidencyMs[1] * 100 / total),
+                  (unsigned)(_cpuResidencyMs[2] * 100 / total), (unsigned)(_backlightResidencyMs[0] * 100 / total),
+                  (unsigned)(_backlightResidencyMs[1] * 100 / total), (unsigned)(_backlightResidencyMs[2] * 100 / total),
+                  (unsigned)(mAms / total), (unsigned)(_maxLoopWorkUs / 1000));
+
+    memset(_cpuResidencyMs, 0, sizeof(_cpuResidencyMs));
+    memset(_backlightResidencyMs, 0, sizeof(_backlightResidencyMs));
+    _maxLoopWorkUs = 0;
+    _lastReportMs = nowMs;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "SleepScheduler.h"
+
+// 功耗管理：动态调频、暂停时 light sleep、背光渐暗/关闭、长时间暂停后深度睡眠
+// 同时统计各功耗状态的驻留时间（估算平均电流）和主循环单轮最长耗时，定期通过串口输出。
+// 只在主循环中调用；断流由音频任务按截止期统计（AudioTask::getMissedDeadlines）。
+class PowerManager {
+public:
+    using BacklightCallback = std::function<void(uint8_t)>;
+    using Callback = std::function<void()>;
+
+    PowerManager();
+    void begin();
+
+    void onBacklight(BacklightCallback cb) { _backlightCb = cb; }
+    void onBeforeDeepSleep(Callback cb) { _beforeSleepCb = cb; }
+
+    void noteActivity();
+    void onPause();  // 停止 I2S，释放 light sleep 锁
+    void onResume(); // I2S 已停止时重新启动；任何开始播放的路径（继续、暂停中切歌、电台起播）都要先调用
+
+    void update(bool playing, bool heavyDecode); // 在 loop() 末尾调用，可能休眠
+    void enterDeepSleep(); // 立即进入深度睡眠（模式键唤醒）
+
+    SleepScheduler &scheduler() { return _scheduler; }
+
+private:
+    void applyCpu(CpuProfile profile);
+    void applyBacklight(BacklightLevel level);
+    void applyLightSleep(bool enable);
+    void account(uint32_t nowMs);
+    void report(uint32_t nowMs);
+
+    SleepScheduler _scheduler;
+    BacklightCallback _backlightCb;
+    Callback _beforeSleepCb;
+
+    uint32_t _lastActivityMs;
+    uint32_t _pausedSinceMs;
+    bool _wasPlaying;
+    bool _i2sStopped;
+
+    CpuProfile _cpu;
+    BacklightLevel _backlight;
+    bool _lightSleep;
+
+    // 主循环耗时：上一次 update() 休眠结束即本轮开始
+    uint32_t _loopStartUs;
+    uint32_t _maxLoopWorkUs;
+
+    // 驻留时间统计
+    uint32_t _lastAccountMs;
+    uint32_t _lastReportMs;
+    uint32_t _cpuResidencyMs[3];
+    uint32_t _backlightResidencyMs[3];
+};
@@ -0,0 +1,26 @@
+#include "SleepScheduler.h"
+
+PowerPlan SleepScheduler::plan(const PowerInputs &in) const {
+    PowerPlan p;
+
+    uint32_t idle = in.nowMs - in.lastActivityMs;
+    if (idle >= backlightOffAfterMs) p.backlight = BACKLIGHT_OFF;
+    else if (idle >= dimAfterMs) p.backlight = BACKLIGHT_DIM;
+    else p.backlight = BACKLIGHT_FULL;
+
+    if (in.playing) {
+        p.cpu = in.heavyDecode ? CPU_PERFORMANCE : CPU_BALANCED;
+        p.lightSleep = false;
+        p.deepSleep = false;
+    } else {
+        p.cpu = CPU_ECO;
+        p.lightSleep = true;
+        p.deepSleep = in.nowMs - in.pausedSinceMs >= deepSleepAfterMs &&
+                      idle >= deepSleepAfterMs;
+    }
+
+    // 一轮主循环（工作 + 休眠）不超过预算：工作已超出预算时不休眠，直接进入下一轮
+    uint32_t budgetUs = (p.backlight == BACKLIGHT_OFF ? inputLatencyMs : uiFrameMs) * 1000UL;
+    p.loopSleepMs = in.loopWorkUs < budgetUs ? (budgetUs - in.loopWorkUs) / 1000 : 0;
+    return p;
+}
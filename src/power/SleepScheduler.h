@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+// 功耗调度策略（纯 C++，不依赖 Arduino）
+// 根据播放状态、最近一次按键时间和本轮主循环的耗时，给出本轮的功耗方案。
+// 解码与 I2S 送数在音频任务中，主循环休眠不影响送数；休眠只受界面与按键响应约束：
+// 屏幕亮着时按频谱动画的帧周期补足本轮剩余时间，熄屏后按按键分发的延迟预算补足。
+
+enum BacklightLevel : uint8_t {
+    BACKLIGHT_FULL,
+    BACKLIGHT_DIM,
+    BACKLIGHT_OFF,
+};
+
+enum CpuProfile : uint8_t {
+    CPU_PERFORMANCE, // 240MHz：FLAC / 变速
+    CPU_BALANCED,    // 160MHz：MP3 / AAC 常规播放
+    CPU_ECO,         // 80MHz：暂停
+};
+
+struct PowerInputs {
+    uint32_t nowMs;
+    uint32_t lastActivityMs; // 最近一次按键
+    uint32_t pausedSinceMs;  // 进入暂停的时间（播放中忽略）
+    uint32_t loopWorkUs;     // 本轮主循环（不含休眠）已耗时
+    bool playing;
+    bool heavyDecode;
+};
+
+struct PowerPlan {
+    BacklightLevel backlight;
+    CpuProfile cpu;
+    uint16_t loopSleepMs; // 本轮结束后主循环休眠，补足到 uiFrameMs / inputLatencyMs
+    bool lightSleep;      // 允许自动 light sleep（仅暂停时，I2S 已停止）
+    bool deepSleep;       // 应进入深度睡眠
+};
+
+class SleepScheduler {
+public:
+    uint32_t dimAfterMs = 30000;
+    uint32_t backlightOffAfterMs = 120000;
+    uint32_t deepSleepAfterMs = 10 * 60000;
+
+    uint16_t uiFrameMs = 30;       // 屏幕亮着：与频谱动画的帧间隔一致（约 33fps）
+    uint16_t inputLatencyMs = 50;  // 熄屏：按键边沿由中断打时间戳，只推迟手势分发，50ms 内无感
+
+    PowerPlan plan(const PowerInputs &in) const;
+};
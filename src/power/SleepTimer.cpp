@@ -0,0 +1,55 @@
+#include "SleepTimer.h"
+
+static const uint32_t kPresetMinutes[SLEEP_MODE_COUNT] = { 0, 15, 30, 60, 0 };
+
+SleepTimer::SleepTimer() : _mode(SLEEP_OFF), _deadlineMs(0), _trackEnded(false) {}
+
+SleepTimerMode SleepTimer::cycle(uint32_t nowMs) {
+    _mode = (SleepTimerMode)((_mode + 1) % SLEEP_MODE_COUNT);
+    _deadlineMs = nowMs + kPresetMinutes[_mode] * 60000;
+    _trackEnded = false;
+    return _mode;
+}
+
+void SleepTimer::cancel() {
+    _mode = SLEEP_OFF;
+    _trackEnded = false;
+}
+
+bool SleepTimer::onTrackEnd() {
+    if (_mode != SLEEP_END_OF_TRACK) return false;
+    _trackEnded = true;
+    return true;
+}
+
+SleepTimerState SleepTimer::update(uint32_t nowMs, uint32_t trackRemainingMs) {
+    SleepTimerState st = { 256, false, false, -1 };
+    if (_mode == SLEEP_OFF) return st;
+
+    uint32_t remaining;
+    if (_mode == SLEEP_END_OF_TRACK) {
+        st.minutesLeft = 0;
+        if (_trackEnded) {
+            st.gain = 0;
+            st.expired = true;
+            return st;
+        }
+        if (trackRemainingMs == 0) return st; // 时长未知，到曲目结束时直接停止
+        remaining = trackRemainingMs;
+    } else {
+        int32_t left = (int32_t)(_deadlineMs - nowMs);
+        remaining = left > 0 ? left : 0;
+        st.minutesLeft = (remaining + 59999) / 60000;
+        if (remaining == 0) {
+            st.gain = 0;
+            st.expired = true;
+            return st;
+        }
+    }
+
+    if (remaining < fadeMs) {
+        st.fading = true;
+        st.gain = (uint16_t)((uint64_t)remaining * 256 / fadeMs);
+    }
+    return st;
+}
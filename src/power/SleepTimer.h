@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+// 睡眠定时器（纯 C++，不依赖 Arduino）
+// 档位：关闭 → 15 → 30 → 60 分钟 → 播完本曲 → 关闭。
+// 到点前 fadeMs 开始线性淡出音量，淡出结束即到期，由调用方进入最低功耗状态。
+
+enum SleepTimerMode : uint8_t {
+    SLEEP_OFF,
+    SLEEP_15_MIN,
+    SLEEP_30_MIN,
+    SLEEP_60_MIN,
+    SLEEP_END_OF_TRACK,
+    SLEEP_MODE_COUNT
+};
+
+struct SleepTimerState {
+    uint16_t gain;       // 音量系数，256 为原音量
+    bool fading;
+    bool expired;
+    int16_t minutesLeft; // 状态栏显示：-1 未启用，0 表示"播完本曲"
+};
+
+class SleepTimer {
+public:
+    uint32_t fadeMs = 30000;
+
+    SleepTimer();
+
+    SleepTimerMode cycle(uint32_t nowMs);
+    void cancel();
+    SleepTimerMode getMode() const { return _mode; }
+
+    // trackRemainingMs 仅在"播完本曲"档位使用，未知时传 0
+    SleepTimerState update(uint32_t nowMs, uint32_t trackRemainingMs);
+    // 曲目自然结束时调用，返回 true 表示应停止播放
+    bool onTrackEnd();
+
+private:
+    SleepTimerMode _mode;
+    uint32_t _deadlineMs;
+    bool _trackEnded;
+};
@@ -0,0 +1,99 @@
+#include "FrameSync.h"
+
+namespace {
+
+// MPEG 音频码率表（kbps），[MPEG-1 ? 0 : 1][层 - 1][码率索引]
+const uint16_t kMpegBitrates[2][3][16] = {
+    {
+        { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 },
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },
+        { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 },
+    },
+    {
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 },
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },
+    },
+};
+const uint32_t kMpegRates[3] = { 44100, 48000, 32000 };
+const uint32_t kAdtsRates[13] = { 96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050,
+                                  16000, 12000, 11025, 8000, 7350 };
+
+bool parseMpeg(const uint8_t *p, FrameInfo &info) {
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) return false;
+    int version = (p[1] >> 3) & 3; // 0 = 2.5，1 保留，2 = MPEG-2，3 = MPEG-1
+    int layer = 4 - ((p[1] >> 1) & 3); // 编码 0 保留
+    int bitrateIndex = p[2] >> 4;
+    int rateIndex = (p[2] >> 2) & 3;
+    int padding = (p[2] >> 1) & 1;
+    if (version == 1 || layer == 4 || rateIndex == 3) return false;
+    uint32_t kbps = kMpegBitrates[version == 3 ? 0 : 1][layer - 1][bitrateIndex];
+    if (kbps == 0) return false; // 自由格式与无效索引都不支持
+
+    uint32_t rate = kMpegRates[rateIndex] >> (version == 3 ? 0 : version == 2 ? 1 : 2);
+    uint32_t length;
+    uint16_t samples;
+    if (layer == 1) {
+        length = (12 * kbps * 1000 / rate + padding) * 4;
+        samples = 384;
+    } else if (layer == 2 || version == 3) {
+        length = 144 * kbps * 1000 / rate + padding;
+        samples = 1152;
+    } else {
+        length = 72 * kbps * 1000 / rate + padding; // MPEG-2/2.5 Layer III 每帧 576 个采样
+        samples = 576;
+    }
+    info.codec = CODEC_MP3;
+    info.length = length;
+    info.samples = samples;
+    info.sampleRate = rate;
+    return true;
+}
+
+bool parseAdts(const uint8_t *p, FrameInfo &info) {
+    if (p[0] != 0xFF || (p[1] & 0xF6) != 0xF0) return false; // 同步字 12 位，层固定为 0
+    int rateIndex = (p[2] >> 2) & 0xF;
+    if (rateIndex >= 13) return false;
+    uint32_t length = ((p[3] & 3) << 11) | (p[4] << 3) | (p[5] >> 5);
+    int headerLen = (p[1] & 1) ? 7 : 9; // 无 CRC 时 7 字节
+    if ((int)length <= headerLen) return false;
+    info.codec = CODEC_AAC;
+    info.length = length;
+    info.samples = 1024 * ((p[6] & 3) + 1);
+    info.sampleRate = kAdtsRates[rateIndex];
+    return true;
+}
+
+} // namespace
+
+namespace FrameSync {
+
+bool parseHeader(const uint8_t *p, size_t avail, StreamCodec codec, FrameInfo &info) {
+    if (avail < kHeaderBytes) return false;
+    if (codec != CODEC_AAC && parseMpeg(p, info)) return true;
+    if (codec != CODEC_MP3 && parseAdts(p, info)) return true;
+    return false;
+}
+
+int find(const uint8_t *p, size_t len, StreamCodec codec, FrameInfo &info, size_t &keep) {
+    for (size_t i = 0; i + kHeaderBytes <= len; i++) {
+        if (p[i] != 0xFF) continue;
+        FrameInfo first;
+        if (!parseHeader(p + i, len - i, codec, first)) continue;
+        size_t next = i + first.length;
+        if (next + kHeaderBytes > len) {
+            // 下一帧头还没到，从这里开始等
+            keep = i;
+            return -1;
+        }
+        FrameInfo second;
+        if (parseHeader(p + next, len - next, first.codec, second) && second.sampleRate == first.sampleRate) {
+            info = first;
+            return (int)i;
+        }
+    }
+    keep = len > kHeaderBytes ? len - kHeaderBytes + 1 : 0;
+    return -1;
+}
+
+} // namespace FrameSync
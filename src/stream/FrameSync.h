@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 网络流的帧边界：MPEG 音频（Layer I/II/III）与 AAC ADTS 的帧头解析和同步。
+// 写入抖动缓冲的只有完整的帧，重连时新旧数据在帧边界处拼接，解码器不会读到半帧。纯 C++。
+enum StreamCodec : uint8_t {
+    CODEC_UNKNOWN, // 未知时按帧头嗅探
+    CODEC_MP3,
+    CODEC_AAC,     // ADTS
+};
+
+struct FrameInfo {
+    StreamCodec codec;
+    uint16_t length;     // 整帧字节数（含帧头）
+    uint16_t samples;    // 每声道采样数
+    uint32_t sampleRate;
+};
+
+namespace FrameSync {
+
+static const size_t kHeaderBytes = 7;     // 判断帧头至少需要的字节数（ADTS 为 7）
+static const size_t kMaxFrame = 8192;     // ADTS 帧长字段上限
+
+// 解析 p 处的帧头；codec 为 CODEC_UNKNOWN 时两种格式都尝试
+bool parseHeader(const uint8_t *p, size_t avail, StreamCodec codec, FrameInfo &info);
+
+// 查找同步点：帧头有效且紧随其后的下一帧头也有效、格式和采样率一致。
+// 返回同步点偏移；找不到时返回 -1，并把 keep 设为须保留等待更多数据的起点（之前的字节可丢弃）
+int find(const uint8_t *p, size_t len, StreamCodec codec, FrameInfo &info, size_t &keep);
+
+} // namespace FrameSync
@@ -0,0 +1,196 @@
+#include "JitterBuffer.h"
+#include <string.h>
+
+// 迟到量基准的上浮时间常数：容忍服务器与本地时钟的微小偏差，又不至于把一次卡顿很快"忘掉"
+static const uint32_t kFloorTauMs = 30000;
+
+JitterBuffer::JitterBuffer() : _mem(nullptr), _capacity(0), _mask(0), _writePos(0), _readPos(0) {
+    reset(0);
+}
+
+void JitterBuffer::begin(uint8_t *mem, size_t capacity) {
+    size_t c = 1;
+    while (c * 2 <= capacity) c *= 2;
+    _mem = mem;
+    _capacity = mem && c > kRewind ? c : 0;
+    _mask = c - 1;
+    reset(0);
+}
+
+void JitterBuffer::reset(uint32_t nowMs) {
+    _writePos.store(0);
+    _readPos.store(0);
+    _base = 0;
+
+    _mediaUs = 0;
+    _bytesIn = 0;
+    _anchorMs = nowMs;
+    _anchorMediaUs = 0;
+    _floorMs = 0;
+    _peakMs = 0;
+    _lastArrivalMs = nowMs;
+    _rebase = true;
+    _hintRate = 0;
+    _stallStartMs = 0;
+
+    _byteRate.store(kDefaultByteRate);
+    _jitterMs.store(0);
+    _peakShared.store(0);
+    _playout.store(PLAYOUT_PREBUFFER);
+    _underruns.store(0);
+    _stallMs.store(0);
+    _rate = 0;
+    updateTarget(nowMs);
+}
+
+uint32_t JitterBuffer::toMs(uint32_t bytes) const {
+    uint32_t rate = _byteRate.load(std::memory_order_relaxed);
+    return rate ? (uint32_t)((uint64_t)bytes * 1000 / rate) : 0;
+}
+
+uint32_t JitterBuffer::buffered() const {
+    return _writePos.load(std::memory_order_acquire) - _readPos.load(std::memory_order_acquire);
+}
+
+uint32_t JitterBuffer::depthMs(uint32_t leadBytes) const {
+    return toMs(buffered() + leadBytes);
+}
+
+size_t JitterBuffer::writable() const {
+    if (_capacity == 0) return 0;
+    uint32_t r = _readPos.load(std::memory_order_acquire);
+    uint32_t back = r - _base < kRewind ? r - _base : kRewind; // 读指针之后保留的回读区
+    uint32_t used = _writePos.load(std::memory_order_relaxed) - r + back;
+    return used < _capacity ? _capacity - used : 0;
+}
+
+void JitterBuffer::setByteRateHint(uint32_t rate) {
+    _hintRate = rate;
+    if (_mediaUs < 1000000 && rate) _byteRate.store(rate);
+}
+
+void JitterBuffer::noteBlocked() {
+    _rebase = true;
+}
+
+void JitterBuffer::commit(const uint8_t *data, size_t len, uint32_t mediaUs, uint32_t nowMs) {
+    uint32_t w = _writePos.load(std::memory_order_relaxed);
+    size_t at = w & _mask;
+    size_t first = len < _capacity - at ? len : _capacity - at;
+    memcpy(_mem + at, data, first);
+    memcpy(_mem, data + first, len - first);
+    _writePos.store(w + len, std::memory_order_release);
+
+    uint64_t firstUs = _mediaUs; // 本批第一帧的媒体时间：整批中它相对应到时刻最迟
+    _bytesIn += len;
+    _mediaUs += mediaUs;
+    // 满 1 秒媒体时长后改用实测字节率（VBR 取平均）
+    if (_mediaUs >= 1000000) _byteRate.store((uint32_t)(_bytesIn * 1000000 / _mediaUs));
+
+    uint32_t dt = nowMs - _lastArrivalMs;
+    _lastArrivalMs = nowMs;
+    if (_rebase) {
+        _anchorMs = nowMs;
+        _anchorMediaUs = firstUs;
+        _floorMs = 0;
+        _rebase = false;
+        updateTarget(nowMs);
+        return;
+    }
+
+    // 迟到量：到达时刻 - 应到时刻（锚点 + 之后写入的媒体时长）。Icecast 连接时的突发使它为负
+    int32_t late = (int32_t)(nowMs - _anchorMs) - (int32_t)((firstUs - _anchorMediaUs) / 1000);
+    uint32_t jitter = late > _floorMs ? late - _floorMs : 0;
+    if (late < _floorMs) {
+        _floorMs = late;
+    } else {
+        uint32_t step = dt < kFloorTauMs ? dt : kFloorTauMs;
+        _floorMs += (int32_t)((int64_t)(late - _floorMs) * step / kFloorTauMs);
+    }
+
+    uint32_t release = config.releaseMs ? config.releaseMs : 1;
+    _peakMs -= (uint32_t)((uint64_t)_peakMs * (dt < release ? dt : release) / release);
+    if (jitter > _peakMs) _peakMs = jitter;
+    int32_t smooth = (int32_t)_jitterMs.load(std::memory_order_relaxed);
+    smooth += ((int32_t)jitter - smooth) / 16;
+    _jitterMs.store(smooth > 0 ? smooth : 0, std::memory_order_relaxed);
+    _peakShared.store(_peakMs, std::memory_order_relaxed);
+    updateTarget(nowMs);
+}
+
+void JitterBuffer::updateTarget(uint32_t) {
+    uint32_t target = _peakMs + _peakMs / 4 + config.guardMs;
+    if (target < config.minTargetMs) target = config.minTargetMs;
+    if (target > config.maxTargetMs) target = config.maxTargetMs;
+    // 目标不超过容量的 3/4，留出余量吸收到达突发
+    uint32_t cap = _capacity > kRewind ? toMs(_capacity - kRewind) * 3 / 4 : 0;
+    if (cap && target > cap) target = cap;
+    _targetMs.store(target, std::memory_order_relaxed);
+}
+
+size_t JitterBuffer::read(uint8_t *dst, size_t len, uint32_t leadBytes, uint32_t nowMs) {
+    uint32_t r = _readPos.load(std::memory_order_relaxed);
+    uint32_t avail = _writePos.load(std::memory_order_acquire) - r;
+
+    uint8_t state = _playout.load(std::memory_order_relaxed);
+    if (state != PLAYOUT_PLAYING) {
+        if (toMs(avail + leadBytes) < config.startMs) return 0;
+        if (state == PLAYOUT_REBUFFER) _stallMs.fetch_add(nowMs - _stallStartMs, std::memory_order_relaxed);
+        _playout.store(PLAYOUT_PLAYING, std::memory_order_relaxed);
+    }
+    if (avail == 0) {
+        // 解码器手里还有余量时只是暂时读空，余量也快耗尽才算断流
+        if (leadBytes < config.underrunLead) {
+            _playout.store(PLAYOUT_REBUFFER, std::memory_order_relaxed);
+            _underruns.fetch_add(1, std::memory_order_relaxed);
+            _stallStartMs = nowMs;
+        }
+        return 0;
+    }
+
+    size_t n = len < avail ? len : avail;
+    size_t at = r & _mask;
+    size_t first = n < _capacity - at ? n : _capacity - at;
+    memcpy(dst, _mem + at, first);
+    memcpy(dst + first, _mem, n - first);
+    _readPos.store(r + n, std::memory_order_release);
+    return n;
+}
+
+bool JitterBuffer::seek(uint32_t pos) {
+    uint32_t r = _readPos.load(std::memory_order_relaxed);
+    uint32_t w = _writePos.load(std::memory_order_acquire);
+    int32_t delta = (int32_t)(pos - r);
+    if (delta > 0 && (uint32_t)delta > w - r) return false;
+    if (delta < 0) {
+        uint32_t back = r - _base < kRewind ? r - _base : kRewind;
+        if ((uint32_t)-delta > back) return false;
+    }
+    _readPos.store(pos, std::memory_order_release);
+    return true;
+}
+
+void JitterBuffer::fillHealth(StreamHealth &h, uint32_t leadBytes) const {
+    uint32_t bytes = buffered();
+    h.depthMs = toMs(bytes + leadBytes);
+    h.targetMs = targetMs();
+    h.jitterMs = _jitterMs.load(std::memory_order_relaxed);
+    h.peakMs = _peakShared.load(std::memory_order_relaxed);
+    h.byteRate = byteRate();
+    h.stallMs = _stallMs.load(std::memory_order_relaxed);
+    h.underruns = _underruns.load(std::memory_order_relaxed);
+    h.fillPercent = _capacity ? (uint8_t)((uint64_t)bytes * 100 / _capacity) : 0;
+    h.playout = playout();
+}
+
+int JitterBuffer::rateAdjust(uint32_t leadBytes) {
+    if (playout() != PLAYOUT_PLAYING) {
+        _rate = 0;
+        return 0;
+    }
+    uint32_t depth = depthMs(leadBytes);
+    uint32_t target = targetMs();
+    if (_rate == 0 && depth < target * 3 / 4) _rate = -1;
+    else if (_rate < 0 && depth >= target) _rate = 0;
+    return _rate;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// 网络流的自适应抖动缓冲（单生产者 / 单消费者环形缓冲，内存由调用方提供，放在 PSRAM）。
+//
+// 生产者（网络任务）只写入完整的帧，并给出这些帧的媒体时长。每次到达计算"迟到量"：
+// 到达时刻减去按媒体时间推算的应到时刻，相对历史最早值的差即抖动；目标深度 = 抖动峰值 × 1.25 + guardMs，
+// 峰值立即上升、按 releaseMs 缓慢回落，限制在 [minTargetMs, maxTargetMs] 与容量的 3/4 之内。
+// 缓冲写满（暂停或网络快于播放）时的等待不是抖动，下一次到达重新对齐基准。
+//
+// 消费者（解码器）：深度达到 startMs 即起播（快速起播，不等目标深度）；播放中缓冲耗尽且解码器余量
+// 不足 underrunLead 记一次断流，重新缓冲到 startMs 后继续。起播后深度低于目标的 3/4 时
+// rateAdjust() 建议略微放慢播放，把缓冲补到目标深度。
+// 深度按字节率（已写入字节 / 媒体时长）换算为毫秒，并计入解码器输入缓冲中尚未解码的字节（lead）。
+// 读指针之后保留 kRewind 字节，解码器打开流时的回读（探测帧头）可以 seek 回去。纯 C++。
+
+enum StreamPlayout : uint8_t {
+    PLAYOUT_PREBUFFER, // 首次起播前
+    PLAYOUT_PLAYING,
+    PLAYOUT_REBUFFER,  // 断流后重新缓冲
+};
+
+// 缓冲健康度（供界面和串口报告）
+struct StreamHealth {
+    uint32_t depthMs;     // 当前深度（含解码器余量）
+    uint32_t targetMs;    // 自适应目标深度
+    uint32_t jitterMs;    // 到达抖动（平滑值）
+    uint32_t peakMs;      // 抖动峰值（决定目标深度）
+    uint32_t byteRate;    // 字节 / 秒
+    uint32_t stallMs;     // 累计断流时长
+    uint16_t underruns;
+    uint16_t reconnects;  // 由会话填写
+    uint8_t fillPercent;  // 占容量的百分比
+    uint8_t playout;      // StreamPlayout
+    uint8_t link;         // StreamLink，由会话填写
+};
+
+class JitterBuffer {
+public:
+    struct Config {
+        uint32_t startMs = 400;       // 快速起播 / 断流后恢复的深度
+        uint32_t minTargetMs = 1000;
+        uint32_t maxTargetMs = 10000;
+        uint32_t guardMs = 300;
+        uint32_t releaseMs = 60000;   // 抖动峰值衰减的时间常数
+        uint32_t underrunLead = 2048; // 缓冲为空且解码器余量低于此值即为断流
+    };
+
+    static const size_t kRewind = 16384;
+    static const uint32_t kDefaultByteRate = 16000; // 128kbps，测得媒体时长之前使用
+
+    JitterBuffer();
+
+    void begin(uint8_t *mem, size_t capacity); // 容量向下取 2 的幂
+    void reset(uint32_t nowMs);                // 新的流：清空数据与统计。调用时消费者不得读取
+    Config config;
+
+    // ---- 生产者 ----
+    size_t writable() const;
+    void commit(const uint8_t *data, size_t len, uint32_t mediaUs, uint32_t nowMs); // len <= writable()
+    void noteBlocked();                  // 缓冲已满、暂停读取网络
+    void relink() { _rebase = true; }    // 重连：数据保留，迟到量基准重新对齐
+    void setByteRateHint(uint32_t rate); // 服务器声明的码率（icy-br），测得实际值之前使用
+
+    // ---- 消费者 ----
+    size_t read(uint8_t *dst, size_t len, uint32_t leadBytes, uint32_t nowMs);
+    bool seek(uint32_t pos);
+    uint32_t position() const { return _readPos.load(std::memory_order_relaxed); }
+
+    // ---- 状态（任意任务） ----
+    size_t capacity() const { return _capacity; }
+    uint32_t buffered() const;
+    uint32_t byteRate() const { return _byteRate.load(std::memory_order_relaxed); }
+    uint32_t depthMs(uint32_t leadBytes) const;
+    uint32_t targetMs() const { return _targetMs.load(std::memory_order_relaxed); }
+    StreamPlayout playout() const { return (StreamPlayout)_playout.load(std::memory_order_relaxed); }
+    bool canStart() const { return depthMs(0) >= config.startMs; } // 可以打开解码器
+    void fillHealth(StreamHealth &h, uint32_t leadBytes) const;
+
+    // 主循环：-1 建议放慢播放（起播后深度低于目标的 3/4，补到目标为止），0 原速
+    int rateAdjust(uint32_t leadBytes);
+
+private:
+    uint32_t toMs(uint32_t bytes) const;
+    void updateTarget(uint32_t nowMs);
+
+    uint8_t *_mem;
+    size_t _capacity;
+    size_t _mask;
+
+    std::atomic<uint32_t> _writePos; // 生产者写；字节计数，可回绕
+    std::atomic<uint32_t> _readPos;  // 消费者写
+    uint32_t _base;                  // reset 时的位置，回读不超过它
+
+    // 生产者私有：迟到量估计
+    uint64_t _mediaUs;
+    uint64_t _bytesIn;
+    uint32_t _anchorMs;
+    uint64_t _anchorMediaUs;
+    int32_t _floorMs;   // 迟到量的历史最早值（缓慢上浮以容忍时钟偏差）
+    uint32_t _peakMs;
+    uint32_t _lastArrivalMs;
+    bool _rebase;
+    uint32_t _hintRate;
+
+    // 消费者私有
+    uint32_t _stallStartMs;
+
+    // 共享（生产者 / 消费者写，其他任务读）
+    std::atomic<uint32_t> _byteRate;
+    std::atomic<uint32_t> _targetMs;
+    std::atomic<uint32_t> _jitterMs;
+    std::atomic<uint32_t> _peakShared;
+    std::atomic<uint8_t> _playout;
+    std::atomic<uint32_t> _underruns;
+    std::atomic<uint32_t> _stallMs;
+
+    // 主循环私有
+    int _rate;
+};
@@ -0,0 +1,260 @@
+#include "StreamPlayer.h"
+#include <new>
+#include <esp_heap_caps.h>
+#include <FSImpl.h>
+#include <WiFi.h>
+#include "config.h"
+#include "../diag/TraceRecorder.h"
+
+namespace {
+
+// 设备上的网络收发：WiFiClient。WiFi 尚未连上时连接直接失败，由会话按退避重试
+class WifiTransport : public StreamTransport {
+public:
+    bool connect(const char *host, uint16_t port, uint32_t timeoutMs) override {
+        _client.stop();
+        if (WiFi.status() != WL_CONNECTED) return false;
+        return _client.connect(host, port, timeoutMs);
+    }
+    int read(uint8_t *buf, size_t len) override {
+        int avail = _client.available();
+        if (avail > 0) {
+            int n = _client.read(buf, len < (size_t)avail ? len : (size_t)avail);
+            return n > 0 ? n : 0;
+        }
+        // WiFiClient::read 不区分"暂无数据"与"对端关闭"，后者由 connected() 判断
+        return _client.connected() ? 0 : -1;
+    }
+    bool write(const uint8_t *buf, size_t len) override {
+        return _client.write(buf, len) == len;
+    }
+    void close() override {
+        _client.stop();
+    }
+
+private:
+    WiFiClient _client;
+};
+
+// 解码器看到的虚拟文件（在音频任务中访问）：读取来自抖动缓冲，位置相对打开时的读指针。
+// FileImpl 的纯虚函数随 Arduino 核心版本增减，这里实现全部已知接口且不加 override，两边都能编译
+class StreamFile : public fs::FileImpl {
+public:
+    StreamFile(JitterBuffer &buffer, Audio &audio, const char *path)
+        : _buffer(buffer), _audio(audio), _origin(buffer.position()) {
+        strncpy(_path, path, sizeof(_path) - 1);
+        _path[sizeof(_path) - 1] = '\0';
+    }
+
+    size_t read(uint8_t *buf, size_t size) {
+        uint32_t lead = _audio.inBufferFilled();
+        size_t room = lead < STREAM_DECODER_LEAD ? STREAM_DECODER_LEAD - lead : 0;
+        return _buffer.read(buf, size < room ? size : room, lead, millis());
+    }
+    bool seek(uint32_t pos, fs::SeekMode mode) {
+        if (mode == fs::SeekCur) pos += position();
+        else if (mode != fs::SeekSet) return false;
+        return _buffer.seek(_origin + pos);
+    }
+    size_t position() const { return _buffer.position() - _origin; }
+    size_t size() const { return position() + (1UL << 30); }
+    const char *path() const { return _path; }
+    const char *name() const { return _path + 1; }
+    operator bool() { return true; }
+
+    size_t write(const uint8_t *, size_t) { return 0; }
+    void flush() {}
+    bool setBufferSize(size_t) { return false; }
+    void close() {}
+    time_t getLastWrite() { return 0; }
+    boolean isDirectory(void) { return false; }
+    fs::FileImplPtr openNextFile(const char *) { return fs::FileImplPtr(); }
+    boolean seekDir(long) { return false; }
+    String getNextFileName(void) { return String(); }
+    String getNextFileName(bool *isDir) {
+        if (isDir) *isDir = false;
+        return String();
+    }
+    void rewindDirectory(void) {}
+
+private:
+    JitterBuffer &_buffer;
+    Audio &_audio;
+    uint32_t _origin;
+    char _path[16];
+};
+
+class StreamFs : public fs::FSImpl {
+public:
+    StreamFs(JitterBuffer &buffer, Audio *const &audio) : _buffer(buffer), _audio(audio) {}
+
+    fs::FileImplPtr open(const char *path, const char *mode, const bool create) {
+        if (!_audio || !exists(path)) return fs::FileImplPtr();
+        return std::make_shared<StreamFile>(_buffer, *_audio, path);
+    }
+    bool exists(const char *path) {
+        return path && (strcmp(path, "/stream.mp3") == 0 || strcmp(path, "/stream.aac") == 0);
+    }
+    bool rename(const char *, const char *) { return false; }
+    bool remove(const char *) { return false; }
+    bool mkdir(const char *) { return false; }
+    bool rmdir(const char *) { return false; }
+
+private:
+    JitterBuffer &_buffer;
+    Audio *const &_audio; // StreamPlayer::begin 之后才有
+};
+
+const char *const kLinkNames[] = { "idle", "connecting", "streaming", "backoff", "failed" };
+
+} // namespace
+
+StreamPlayer::StreamPlayer()
+    : _audio(nullptr), _transport(nullptr), _session(nullptr), _fs(std::make_shared<StreamFs>(_buffer, _audio)),
+      _task(nullptr), _wifiStarted(false), _mux(portMUX_INITIALIZER_UNLOCKED), _requestGen(0), _appliedGen(0), _active(false), _lastUnderruns(0),
+      _lastReportMs(0) {
+    _ssid[0] = '\0';
+    _password[0] = '\0';
+    _url[0] = '\0';
+}
+
+bool StreamPlayer::begin(Audio &audio, const char *ssid, const char *password) {
+    _audio = &audio;
+    strncpy(_ssid, ssid ? ssid : "", sizeof(_ssid) - 1);
+    _ssid[sizeof(_ssid) - 1] = '\0';
+    strncpy(_password, password ? password : "", sizeof(_password) - 1);
+    _password[sizeof(_password) - 1] = '\0';
+    if (!_ssid[0]) Serial.println("Stream: wifi_ssid not set in " MODE_MANIFEST_PATH);
+
+    // 缓冲与会话（含 16KB 暂存区）都放在 PSRAM
+    uint8_t *mem = (uint8_t *)heap_caps_malloc(STREAM_BUFFER_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    void *session = heap_caps_malloc(sizeof(StreamSession), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!mem || !session) {
+        Serial.println("Stream: buffer allocation failed");
+        free(mem);
+        free(session);
+        return false;
+    }
+    _buffer.config.startMs = STREAM_START_MS;
+    _buffer.config.minTargetMs = STREAM_MIN_TARGET_MS;
+    _buffer.config.maxTargetMs = STREAM_MAX_TARGET_MS;
+    _buffer.begin(mem, STREAM_BUFFER_SIZE);
+    _transport = new WifiTransport();
+    _session = new (session) StreamSession(*_transport, _buffer);
+
+    xTaskCreatePinnedToCore(taskEntry, "stream", STREAM_TASK_STACK, this, STREAM_TASK_PRIORITY, &_task, STREAM_TASK_CORE);
+    _lastReportMs = millis();
+    Serial.printf("Stream: %u KB jitter buffer\n", (unsigned)(_buffer.capacity() / 1024));
+    return true;
+}
+
+void StreamPlayer::start(const char *url) {
+    portENTER_CRITICAL(&_mux);
+    strncpy(_url, url ? url : "", kUrlMax - 1);
+    _url[kUrlMax - 1] = '\0';
+    _requestGen++;
+    portEXIT_CRITICAL(&_mux);
+    _active = _url[0] != '\0';
+    _lastUnderruns = 0;
+    if (_task) xTaskNotifyGive(_task);
+}
+
+void StreamPlayer::stop() {
+    if (!_active) return;
+    start("");
+}
+
+bool StreamPlayer::canStart() const {
+    return _active && _session && _appliedGen == _requestGen && _buffer.canStart() && _session->codec() != CODEC_UNKNOWN;
+}
+
+const char *StreamPlayer::decoderPath() const {
+    return _session && _session->codec() == CODEC_AAC ? "/stream.aac" : "/stream.mp3";
+}
+
+StreamLink StreamPlayer::link() const {
+    if (_active && !_ssid[0]) return LINK_FAILED;
+    if (!_session) return LINK_FAILED;
+    // 网络任务应用新请求之前，会话仍是上一个地址的状态
+    return _appliedGen == _requestGen ? _session->link() : LINK_CONNECTING;
+}
+
+const char *StreamPlayer::error() const {
+    if (!_ssid[0]) return "wifi_ssid not set";
+    if (!_session) return "no buffer";
+    return _session->error();
+}
+
+uint32_t StreamPlayer::leadBytes() const {
+    return _audio ? _audio->inBufferFilled() : 0;
+}
+
+void StreamPlayer::health(StreamHealth &h) const {
+    _buffer.fillHealth(h, leadBytes());
+    h.reconnects = _session ? _session->reconnects() : 0;
+    h.link = link();
+}
+
+int StreamPlayer::rateAdjust() {
+    return _active ? _buffer.rateAdjust(leadBytes()) : 0;
+}
+
+void StreamPlayer::report() {
+    if (!_active || !_session) return;
+    StreamHealth h;
+    health(h);
+    if (h.underruns != _lastUnderruns) {
+        _lastUnderruns = h.underruns;
+        trace(TRACE_STREAM, TRACE_STREAM_UNDERRUN, h.reconnects, h.targetMs);
+    }
+
+    uint32_t now = millis();
+    if (now - _lastReportMs < STREAM_REPORT_MS) return;
+    _lastReportMs = now;
+    Serial.printf("Stream: %s, depth %u / target %u ms, jitter %u (peak %u) ms, %u kbps, fill %u%%, "
+                  "underruns %u (%u ms), reconnects %u, spliced %u frames\n",
+                  kLinkNames[h.link], (unsigned)h.depthMs, (unsigned)h.targetMs, (unsigned)h.jitterMs, (unsigned)h.peakMs,
+                  (unsigned)(h.byteRate / 125), h.fillPercent, h.underruns, (unsigned)h.stallMs, h.reconnects,
+                  (unsigned)_session->splicedFrames());
+}
+
+void StreamPlayer::taskEntry(void *arg) {
+    ((StreamPlayer *)arg)->run();
+}
+
+void StreamPlayer::run() {
+    while (true) {
+        if (_requestGen != _appliedGen) apply();
+        uint32_t wait = _session->step(millis());
+        // 新请求经任务通知提前唤醒；有数据待读时也至少让出 1 tick
+        ulTaskNotifyTake(pdTRUE, wait ? pdMS_TO_TICKS(wait) : 1);
+    }
+}
+
+// 应用最新的请求：旧连接关闭、缓冲清空，主循环在此之前已停止解码器
+void StreamPlayer::apply() {
+    char url[kUrlMax];
+    portENTER_CRITICAL(&_mux);
+    uint32_t gen = _requestGen;
+    memcpy(url, _url, sizeof(url));
+    portEXIT_CRITICAL(&_mux);
+
+    _session->close();
+    _buffer.reset(millis());
+    if (url[0] && ensureWifi()) {
+        Serial.printf("Stream: open %s\n", url);
+        _session->open(url, millis());
+    }
+    _appliedGen = gen;
+}
+
+bool StreamPlayer::ensureWifi() {
+    if (!_ssid[0]) return false;
+    if (!_wifiStarted) {
+        _wifiStarted = true;
+        WiFi.mode(WIFI_STA);
+        WiFi.begin(_ssid, _password);
+        Serial.printf("Stream: WiFi connecting to %s\n", _ssid);
+    }
+    return true; // 尚未连上时由会话退避重试
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Audio.h"
+#include "JitterBuffer.h"
+#include "StreamSession.h"
+
+// 网络电台播放：WiFi 连接、网络任务与 PSRAM 抖动缓冲，解码仍交给 Audio::connecttoFS。
+//
+// 库自带的 connecttohost 只有固定大小的输入缓冲，没有抖动统计，断线即停播；这里由网络任务
+// （STREAM_TASK_CORE）跑 StreamSession，把完整的帧写入 JitterBuffer，再以虚拟文件系统 fs()
+// 上的 "/stream.mp3" / "/stream.aac" 交给解码器读取：
+//   - 读取受 STREAM_DECODER_LEAD 限制，解码器输入缓冲只预取这么多，其余数据留在抖动缓冲中计入深度
+//   - 文件大小永远比当前位置多 1GB，库不会按大小判定播放结束；seek 只能在缓冲保留的回读区内进行
+//   - 缓冲读空时读取返回 0。库若据此判定结束（EOF 回调），主循环在重新缓冲后再次 connect
+//
+// 调度约定：start / stop 与其余接口只在主循环调用；网络任务按代号应用最新的请求，
+// 之前重置缓冲并打开会话。调用方须先停止解码器（AudioTask::stop），缓冲重置时不能有读取。
+// WiFi 在第一次 start 时才以 STA 模式连接，没有电台模式的清单不会打开射频。
+class StreamPlayer {
+public:
+    static const size_t kUrlMax = 256;
+
+    StreamPlayer();
+    bool begin(Audio &audio, const char *ssid, const char *password); // 分配缓冲、创建网络任务
+
+    void start(const char *url);
+    void stop();
+    bool isActive() const { return _active; }
+    const char *url() const { return _url; }
+
+    // 网络任务已应用最新的请求、缓冲达到起播深度且格式已知：可以打开解码器
+    bool canStart() const;
+    const char *decoderPath() const; // 按格式返回 "/stream.mp3" 或 "/stream.aac"
+    fs::FS &fs() { return _fs; }
+
+    StreamLink link() const;
+    const char *error() const;
+    void health(StreamHealth &h) const;
+    int rateAdjust(); // JitterBuffer::rateAdjust，计入解码器输入缓冲
+
+    void report(); // 主循环周期调用：断流写入追踪，按 STREAM_REPORT_MS 输出健康度
+    TaskHandle_t task() const { return _task; }
+
+private:
+    static void taskEntry(void *arg);
+    void run();
+    void apply();
+    bool ensureWifi();
+    uint32_t leadBytes() const;
+
+    Audio *_audio;
+    JitterBuffer _buffer;
+    StreamTransport *_transport;
+    StreamSession *_session; // 与传输对象一起在 begin() 中创建（会话含暂存区，放在 PSRAM）
+    fs::FS _fs;
+    TaskHandle_t _task;
+    char _ssid[33];
+    char _password[65];
+    bool _wifiStarted; // 网络任务私有
+
+    // 主循环 → 网络任务：请求的地址，代号递增表示有新请求
+    portMUX_TYPE _mux;
+    char _url[kUrlMax];
+    volatile uint32_t _requestGen;
+    volatile uint32_t _appliedGen;
+    bool _active;
+
+    // 主循环私有
+    uint32_t _lastUnderruns;
+    uint32_t _lastReportMs;
+};
@@ -0,0 +1,420 @@
+#include "StreamSession.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include "../diag/TraceRecorder.h"
+#include "../util/Crc32.h"
+
+static std::string lower(std::string s) {
+    for (char &c : s) c = tolower((unsigned char)c);
+    return s;
+}
+
+static std::string trim(const std::string &s) {
+    size_t b = 0, e = s.size();
+    while (b < e && (s[b] == ' ' || s[b] == '\t' || s[b] == '\r')) b++;
+    while (e > b && (s[e - 1] == ' ' || s[e - 1] == '\t' || s[e - 1] == '\r')) e--;
+    return s.substr(b, e - b);
+}
+
+bool StreamUrl::parse(const std::string &url) {
+    if (url.size() < 8 || strncasecmp(url.c_str(), "http://", 7) != 0) return false;
+    size_t slash = url.find('/', 7);
+    std::string authority = url.substr(7, slash == std::string::npos ? std::string::npos : slash - 7);
+    path = slash == std::string::npos ? "/" : url.substr(slash);
+    size_t hash = path.find('#');
+    if (hash != std::string::npos) path.erase(hash);
+
+    if (authority.find('@') != std::string::npos) return false; // 不支持用户名密码
+    port = 80;
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        char *end = nullptr;
+        long p = strtol(authority.c_str() + colon + 1, &end, 10);
+        if (end == authority.c_str() + colon + 1 || *end || p <= 0 || p > 65535) return false;
+        port = (uint16_t)p;
+        authority.erase(colon);
+    }
+    host = authority;
+    return !host.empty() && host.find_first_of(" \t") == std::string::npos;
+}
+
+StreamSession::StreamSession(StreamTransport &transport, JitterBuffer &buffer)
+    : _transport(transport), _buffer(buffer), _link(LINK_IDLE), _codec(CODEC_UNKNOWN), _redirects(0),
+      _reconnects(0), _failures(0), _gotData(false), _phaseMs(0), _waitMs(0), _lastDataMs(0),
+      _stageLen(0), _synced(false), _usRemainder(0), _recentHead(0), _recentCount(0), _splicing(false), _spliceBudget(0), _spliced(0) {
+    _error[0] = '\0';
+}
+
+void StreamSession::setError(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(_error, sizeof(_error), fmt, args);
+    va_end(args);
+}
+
+bool StreamSession::open(const char *url, uint32_t nowMs) {
+    close();
+    _origin = url ? url : "";
+    _codec = CODEC_UNKNOWN;
+    _redirects = 0;
+    _reconnects = 0;
+    _failures = 0;
+    _recentCount = 0;
+    _splicing = false;
+    _spliced = 0;
+    _error[0] = '\0';
+    if (!_url.parse(_origin)) {
+        setError("bad url");
+        fail();
+        return false;
+    }
+    connect(nowMs);
+    return true;
+}
+
+void StreamSession::close() {
+    _transport.close();
+    _link = LINK_IDLE;
+    _header.clear();
+    _stageLen = 0;
+    _synced = false;
+    _usRemainder = 0;
+}
+
+void StreamSession::fail() {
+    _transport.close();
+    _link = LINK_FAILED;
+    int status = 0;
+    sscanf(_error, "http %d", &status);
+    trace(TRACE_STREAM, TRACE_STREAM_FAILED, _reconnects, status);
+}
+
+void StreamSession::backoff(uint32_t nowMs) {
+    _transport.close();
+    _waitMs = kBackoffMinMs << (_failures < 5 ? _failures : 5);
+    if (_waitMs > kBackoffMaxMs) _waitMs = kBackoffMaxMs;
+    if (_failures < UINT8_MAX) _failures++;
+    _link = LINK_BACKOFF;
+    _phaseMs = nowMs;
+    trace(TRACE_STREAM, TRACE_STREAM_BACKOFF, _reconnects, _waitMs);
+}
+
+void StreamSession::connect(uint32_t nowMs) {
+    _transport.close();
+    _header.clear();
+    _gotData = false;
+    _link = LINK_CONNECTING;
+    _phaseMs = nowMs;
+    trace(TRACE_STREAM, TRACE_STREAM_CONNECT, _reconnects, _failures);
+
+    if (!_transport.connect(_url.host.c_str(), _url.port, kConnectTimeoutMs)) {
+        setError("connect failed");
+        backoff(nowMs);
+        return;
+    }
+    // HTTP/1.0 + Connection: close：服务器不会使用分块传输
+    std::string req = "GET " + _url.path + " HTTP/1.0\r\nHost: " + _url.host;
+    if (_url.port != 80) req += ":" + std::to_string(_url.port);
+    req += "\r\nUser-Agent: esp32-player\r\nAccept: */*\r\nIcy-MetaData: 0\r\nConnection: close\r\n\r\n";
+    if (!_transport.write((const uint8_t *)req.data(), req.size())) {
+        setError("request failed");
+        backoff(nowMs);
+    }
+}
+
+void StreamSession::drop(uint32_t nowMs, bool stalled) {
+    trace(TRACE_STREAM, stalled ? TRACE_STREAM_STALL : TRACE_STREAM_CLOSED, _reconnects, nowMs - _lastDataMs);
+    _transport.close();
+    _reconnects++;
+    _buffer.relink();
+    _stageLen = 0;
+    _synced = false;
+    _usRemainder = 0;
+    _redirects = 0;
+    _splicing = _recentCount > 0;
+    _spliceBudget = _recentCount; // 长段静音帧彼此相同，最多跳过历史长度，避免把新的静音也当作重复
+    _url.parse(_origin);
+    // 这次连接收到过数据：立即重连，缓冲还在播放；一开始就断开的按退避重试，避免空转
+    if (_gotData) connect(nowMs);
+    else backoff(nowMs);
+}
+
+uint32_t StreamSession::step(uint32_t nowMs) {
+    switch (_link) {
+        case LINK_CONNECTING:
+            readHeaders(nowMs);
+            return _link == LINK_STREAMING ? 0 : 10;
+        case LINK_STREAMING:
+            return pump(nowMs);
+        case LINK_BACKOFF: {
+            uint32_t waited = nowMs - _phaseMs;
+            if (waited < _waitMs) return _waitMs - waited < 50 ? _waitMs - waited : 50;
+            _redirects = 0;
+            _url.parse(_origin);
+            connect(nowMs);
+            return 0;
+        }
+        default:
+            return 100;
+    }
+}
+
+void StreamSession::readHeaders(uint32_t nowMs) {
+    char buf[512];
+    while (true) {
+        int n = _transport.read((uint8_t *)buf, sizeof(buf));
+        if (n < 0) {
+            setError("closed before headers");
+            backoff(nowMs);
+            return;
+        }
+        if (n == 0) break;
+        _header.append(buf, n);
+
+        size_t end = _header.find("\r\n\r\n");
+        size_t bare = _header.find("\n\n"); // 个别 ICY 服务器只用 LF
+        if (end != std::string::npos && (bare == std::string::npos || end < bare)) {
+            parseHeaders(end + 4, nowMs);
+            return;
+        }
+        if (bare != std::string::npos) {
+            parseHeaders(bare + 2, nowMs);
+            return;
+        }
+        if (_header.size() > kMaxHeader) {
+            setError("header too long");
+            fail();
+            return;
+        }
+    }
+    if (nowMs - _phaseMs > kHeaderTimeoutMs) {
+        setError("header timeout");
+        backoff(nowMs);
+    }
+}
+
+void StreamSession::parseHeaders(size_t headerLen, uint32_t nowMs) {
+    std::string head = _header.substr(0, headerLen);
+    std::string body = _header.substr(headerLen);
+    _header.clear();
+
+    // 状态行："HTTP/1.x 200 OK" 或 SHOUTcast 的 "ICY 200 OK"
+    int status = 0;
+    if (head.compare(0, 5, "HTTP/") == 0 || head.compare(0, 4, "ICY ") == 0) {
+        size_t sp = head.find(' ');
+        if (sp != std::string::npos) status = atoi(head.c_str() + sp + 1);
+    }
+    if (status == 0) {
+        setError("bad response");
+        fail();
+        return;
+    }
+
+    std::string location, type, bitrate, transfer;
+    size_t pos = head.find('\n');
+    while (pos != std::string::npos && pos + 1 < head.size()) {
+        size_t next = head.find('\n', pos + 1);
+        std::string line = head.substr(pos + 1, next == std::string::npos ? std::string::npos : next - pos - 1);
+        pos = next;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = lower(trim(line.substr(0, colon)));
+        std::string value = trim(line.substr(colon + 1));
+        if (key == "location") location = value;
+        else if (key == "content-type") type = lower(value.substr(0, value.find(';')));
+        else if (key == "icy-br") bitrate = value;
+        else if (key == "transfer-encoding") transfer = lower(value);
+    }
+    type = trim(type);
+
+    if (status >= 300 && status < 400 && !location.empty()) {
+        StreamUrl target = _url;
+        if (location[0] == '/') {
+            target.path = location;
+        } else if (!target.parse(location)) {
+            setError("bad redirect");
+            fail();
+            return;
+        }
+        if (++_redirects > kMaxRedirects) {
+            setError("too many redirects");
+            fail();
+            return;
+        }
+        _url = target;
+        connect(nowMs);
+        return;
+    }
+    if (status >= 500) {
+        setError("http %d", status);
+        backoff(nowMs);
+        return;
+    }
+    if (status != 200) {
+        setError("http %d", status);
+        fail();
+        return;
+    }
+    if (transfer.find("chunked") != std::string::npos) {
+        setError("chunked not supported");
+        fail();
+        return;
+    }
+
+    StreamCodec codec = CODEC_UNKNOWN;
+    if (type == "audio/mpeg" || type == "audio/mp3" || type == "audio/mpeg3") {
+        codec = CODEC_MP3;
+    } else if (type == "audio/aac" || type == "audio/aacp" || type == "audio/x-aac") {
+        codec = CODEC_AAC;
+    } else if (!type.empty() && type != "application/octet-stream") {
+        setError("type %s", type.c_str());
+        fail();
+        return;
+    }
+    // 解码器已按原格式打开，重连后格式变了无法无缝拼接
+    if (codec != CODEC_UNKNOWN && _codec != CODEC_UNKNOWN && codec != _codec) {
+        setError("codec changed");
+        fail();
+        return;
+    }
+    if (codec != CODEC_UNKNOWN) _codec = codec;
+
+    // icy-br 可能是 "128" 或 "128,128"（千比特 / 秒）
+    long kbps = atol(bitrate.c_str());
+    if (kbps > 0 && kbps <= 640) _buffer.setByteRateHint((uint32_t)kbps * 125);
+
+    _redirects = 0;
+    _link = LINK_STREAMING;
+    _lastDataMs = nowMs;
+    trace(TRACE_STREAM, TRACE_STREAM_START, _reconnects, status);
+
+    size_t n = body.size() < kStageSize ? body.size() : kStageSize;
+    memcpy(_stage, body.data(), n);
+    _stageLen = n;
+}
+
+uint32_t StreamSession::stallTimeoutMs() const {
+    uint32_t t = _buffer.depthMs(0) / 2;
+    if (t < kStallMinMs) t = kStallMinMs;
+    if (t > kStallMaxMs) t = kStallMaxMs;
+    return t;
+}
+
+uint32_t StreamSession::pump(uint32_t nowMs) {
+    bool blocked = false;
+    bool got = false;
+    int n = 0;
+    // 每步最多读几批，给停止 / 切换请求留出检查机会
+    for (int i = 0; i < 8; i++) {
+        n = 0;
+        if (_stageLen < kStageSize) {
+            n = _transport.read(_stage + _stageLen, kStageSize - _stageLen);
+            if (n > 0) {
+                _stageLen += n;
+                got = true;
+                _lastDataMs = nowMs;
+            }
+        }
+        commitFrames(nowMs, blocked);
+        if (blocked || n <= 0) break;
+    }
+
+    if (n < 0) {
+        drop(nowMs, false);
+        return 0;
+    }
+    if (blocked) {
+        // 暂停或网络快于播放：不读 socket，也不算断流
+        _buffer.noteBlocked();
+        _lastDataMs = nowMs;
+        return 20;
+    }
+    if (!got && nowMs - _lastDataMs > stallTimeoutMs()) {
+        drop(nowMs, true);
+        return 0;
+    }
+    return got ? 0 : 10;
+}
+
+bool StreamSession::isRecent(uint32_t crc) const {
+    for (size_t i = 0; i < _recentCount; i++) {
+        if (_recent[i] == crc) return true;
+    }
+    return false;
+}
+
+void StreamSession::consume(size_t n) {
+    if (n >= _stageLen) {
+        _stageLen = 0;
+        return;
+    }
+    memmove(_stage, _stage + n, _stageLen - n);
+    _stageLen -= n;
+}
+
+size_t StreamSession::commitFrames(uint32_t nowMs, bool &blocked) {
+    FrameInfo info;
+    size_t start = 0;
+    if (!_synced) {
+        size_t keep = 0;
+        int off = FrameSync::find(_stage, _stageLen, _codec, info, keep);
+        if (off < 0) {
+            consume(keep);
+            return 0;
+        }
+        start = off;
+        _synced = true;
+        if (_codec == CODEC_UNKNOWN) _codec = info.codec;
+    }
+
+    // 只写入完整的帧，并且整批一次写入：缓冲放不下的帧留在暂存里
+    size_t room = _buffer.writable();
+    size_t end = start;
+    uint64_t mediaUs = 0;
+    while (end + FrameSync::kHeaderBytes <= _stageLen) {
+        if (!FrameSync::parseHeader(_stage + end, _stageLen - end, _codec, info)) {
+            _synced = false; // 失步：之前的完整帧照常写入，下一轮从这里重新同步
+            break;
+        }
+        if (end + info.length > _stageLen) break;
+        if (end - start + info.length > room) {
+            blocked = true;
+            break;
+        }
+        uint32_t crc = crc32(_stage + end, info.length);
+        if (_splicing) {
+            if (_spliceBudget && isRecent(crc)) {
+                // 突发重发的旧内容：跳过，本批从下一帧开始
+                end += info.length;
+                start = end;
+                _spliced++;
+                _spliceBudget--;
+                continue;
+            }
+            _splicing = false;
+            trace(TRACE_STREAM, TRACE_STREAM_SPLICE, _reconnects, _spliced);
+        }
+        _recent[_recentHead] = crc;
+        _recentHead = (_recentHead + 1) % kRecentFrames;
+        if (_recentCount < kRecentFrames) _recentCount++;
+        uint64_t total = (uint64_t)info.samples * 1000000 + _usRemainder;
+        mediaUs += total / info.sampleRate;
+        _usRemainder = total % info.sampleRate;
+        end += info.length;
+    }
+
+    size_t n = end - start;
+    if (n) {
+        _buffer.commit(_stage + start, n, (uint32_t)mediaUs, nowMs);
+        if (!_gotData) {
+            _gotData = true;
+            _failures = 0;
+        }
+    }
+    consume(end);
+    return n;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include "FrameSync.h"
+#include "JitterBuffer.h"
+
+// 网络电台会话：HTTP/Icecast 连接、响应头、按帧写入抖动缓冲、断线重连。纯 C++，
+// 网络收发经 StreamTransport 注入（设备上是 WiFiClient，主机测试用 POSIX socket）。
+//
+// 由网络任务循环调用 step()，返回值为建议等待的毫秒数。
+//   - 只支持 http://（不支持 https、分块传输和 ICY 元数据，请求头中声明 Icy-MetaData: 0）
+//   - 3xx 跟随 Location（最多 kMaxRedirects 次）；4xx 与不支持的 Content-Type 为 LINK_FAILED，不再重试；
+//     5xx 与连接失败按 250ms × 2^n（上限 8 秒）退避重试，收到数据后清零
+//   - 断流判定：kStallMinMs..kStallMaxMs（取缓冲深度的一半）内没有收到任何数据，或服务器关闭连接。
+//     立即重连原始地址，缓冲中的数据保留继续播放；新连接从帧同步点开始写入，与旧数据在帧边界拼接。
+//     Icecast 对新连接先突发发送一段已播出的内容：最近 kRecentFrames 帧记录 CRC，重连后开头与之
+//     重复的帧丢弃，从第一帧新内容接上，不会重播几秒
+//   - 缓冲写满（暂停或网络快于播放）时停止读取 socket，由 TCP 流控让服务器等待
+class StreamTransport {
+public:
+    virtual ~StreamTransport() {}
+    virtual bool connect(const char *host, uint16_t port, uint32_t timeoutMs) = 0;
+    virtual int read(uint8_t *buf, size_t len) = 0; // 0 暂无数据，-1 连接已关闭
+    virtual bool write(const uint8_t *buf, size_t len) = 0;
+    virtual void close() = 0;
+};
+
+struct StreamUrl {
+    std::string host;
+    uint16_t port = 80;
+    std::string path = "/";
+
+    bool parse(const std::string &url); // 仅 http://host[:port][/path]
+};
+
+enum StreamLink : uint8_t {
+    LINK_IDLE,
+    LINK_CONNECTING, // 建立连接、等待响应头
+    LINK_STREAMING,
+    LINK_BACKOFF,    // 等待重试
+    LINK_FAILED,     // 不可恢复（地址无效、4xx、格式不支持），需重新 open()
+};
+
+class StreamSession {
+public:
+    static const size_t kStageSize = 16384;  // 网络读取暂存：只把完整的帧写入缓冲
+    static const size_t kMaxHeader = 4096;
+    static const int kMaxRedirects = 4;
+    static const uint32_t kConnectTimeoutMs = 4000;
+    static const uint32_t kHeaderTimeoutMs = 5000;
+    static const uint32_t kStallMinMs = 1500;
+    static const uint32_t kStallMaxMs = 5000;
+    static const uint32_t kBackoffMinMs = 250;
+    static const uint32_t kBackoffMaxMs = 8000;
+    static const size_t kRecentFrames = 512;  // 覆盖 Icecast 默认 64KB 突发（32kbps 时约 360 帧）
+
+    StreamSession(StreamTransport &transport, JitterBuffer &buffer);
+
+    bool open(const char *url, uint32_t nowMs); // 地址无效时返回 false（LINK_FAILED）
+    void close();
+    uint32_t step(uint32_t nowMs);
+
+    StreamLink link() const { return _link; }
+    StreamCodec codec() const { return _codec; }
+    uint16_t reconnects() const { return _reconnects; }
+    uint32_t splicedFrames() const { return _spliced; } // 重连时丢弃的重复帧累计
+    const char *error() const { return _error; }
+
+private:
+    void connect(uint32_t nowMs);
+    void drop(uint32_t nowMs, bool stalled); // 断流：立即重连，缓冲保留
+    void backoff(uint32_t nowMs);
+    void fail();
+    void setError(const char *fmt, ...);
+    void readHeaders(uint32_t nowMs);
+    void parseHeaders(size_t headerLen, uint32_t nowMs);
+    uint32_t pump(uint32_t nowMs);
+    size_t commitFrames(uint32_t nowMs, bool &blocked);
+    void consume(size_t n);
+    bool isRecent(uint32_t crc) const;
+    uint32_t stallTimeoutMs() const;
+
+    StreamTransport &_transport;
+    JitterBuffer &_buffer;
+
+    std::string _origin;    // open() 的地址，重连总是从它开始（重定向目标可能是临时的）
+    StreamUrl _url;         // 当前连接的地址
+    StreamLink _link;
+    StreamCodec _codec;     // Content-Type 给出，或首次同步时嗅探
+    int _redirects;
+    uint16_t _reconnects;
+    uint8_t _failures;      // 连续失败次数（退避指数）
+    bool _gotData;          // 本次连接已写入过帧
+    uint32_t _phaseMs;      // 进入当前状态的时刻（响应头超时 / 退避到期）
+    uint32_t _waitMs;
+    uint32_t _lastDataMs;
+    char _error[48];
+
+    std::string _header;
+    uint8_t _stage[kStageSize];
+    size_t _stageLen;
+    bool _synced;
+    uint64_t _usRemainder;  // 帧时长换算的余数（采样数 × 1e6 / 采样率不是整数）
+
+    // 重连拼接：已写入帧的 CRC 环形记录
+    uint32_t _recent[kRecentFrames];
+    size_t _recentHead;
+    size_t _recentCount;
+    bool _splicing;         // 重连后尚未遇到新内容
+    size_t _spliceBudget;
+    uint32_t _spliced;
+};
@@ -0,0 +1,76 @@
+#include "TrackBrowser.h"
+#include <math.h>
+
+TrackBrowser::TrackBrowser()
+    : _count(0), _cursor(0), _top(0), _open(false), _holdDir(0), _holdStartMs(0), _lastTickMs(0), _carry(0) {}
+
+void TrackBrowser::open(size_t count, size_t cursor) {
+    _count = count;
+    _open = true;
+    _holdDir = 0;
+    _top = 0;
+    moveTo(cursor < count ? cursor : 0);
+    // 当前曲目尽量放在窗口中部
+    _top = _cursor > kRows / 2 ? _cursor - kRows / 2 : 0;
+    if (_count > (size_t)kRows && _top > _count - kRows) _top = _count - kRows;
+}
+
+void TrackBrowser::close() {
+    _open = false;
+    _holdDir = 0;
+}
+
+void TrackBrowser::moveTo(size_t cursor) {
+    _cursor = cursor;
+    if (_cursor < _top) _top = _cursor;
+    if (_cursor >= _top + kRows) _top = _cursor - kRows + 1;
+}
+
+void TrackBrowser::step(int delta) {
+    if (_count == 0) return;
+    long next = ((long)_cursor + delta) % (long)_count;
+    if (next < 0) next += _count;
+    moveTo((size_t)next);
+}
+
+void TrackBrowser::jumpTo(size_t cursor) {
+    if (cursor < _count) moveTo(cursor);
+}
+
+void TrackBrowser::startHold(int dir, uint32_t nowMs) {
+    _holdDir = dir;
+    _holdStartMs = nowMs;
+    _lastTickMs = nowMs;
+    _carry = 0;
+}
+
+void TrackBrowser::stopHold() {
+    _holdDir = 0;
+}
+
+float TrackBrowser::rate(uint32_t heldMs) {
+    float r = kStartRate * exp2f((float)heldMs / kDoubleMs);
+    return r < kMaxRate ? r : kMaxRate;
+}
+
+bool TrackBrowser::tick(uint32_t nowMs) {
+    if (!_open || _holdDir == 0 || _count == 0) return false;
+
+    // 按上一帧以来的速度积分，帧率波动不影响滚动距离
+    uint32_t dt = nowMs - _lastTickMs;
+    _lastTickMs = nowMs;
+    _carry += rate(nowMs - _holdStartMs) * dt / 1000.0f;
+    size_t rows = (size_t)_carry;
+    if (rows == 0) return false;
+    _carry -= rows;
+
+    // 长按滚动停在首尾，不循环
+    size_t before = _cursor;
+    if (_holdDir < 0) {
+        moveTo(rows > _cursor ? 0 : _cursor - rows);
+    } else {
+        size_t last = _count - 1;
+        moveTo(rows > last - _cursor ? last : _cursor + rows);
+    }
+    return _cursor != before;
+}
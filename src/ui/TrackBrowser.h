@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 曲目浏览器的光标与可见窗口。只保存位置，不持有曲目数据：
+// 渲染时按可见行向调用方索取名称（见 UIManager::drawBrowser），列表长度不影响单帧开销。
+// 长按加速滚动：速度从 kStartRate 起每 kDoubleMs 翻倍，直到 kMaxRate（行/秒）。纯 C++。
+class TrackBrowser {
+public:
+    static const int kRows = 8;               // 可见行数
+    static const uint32_t kStartRate = 10;
+    static const uint32_t kDoubleMs = 600;
+    static const uint32_t kMaxRate = 4000;
+
+    TrackBrowser();
+
+    void open(size_t count, size_t cursor);
+    void close();
+    bool isOpen() const { return _open; }
+
+    void step(int delta);                    // 单击 / 翻页，首尾循环
+    void jumpTo(size_t cursor);              // 跳到指定行（检索结果）
+    void startHold(int dir, uint32_t nowMs); // dir = -1 向上，+1 向下
+    void stopHold();
+    int holdDirection() const { return _holdDir; }
+    bool tick(uint32_t nowMs);               // 推进长按滚动，返回光标是否移动
+
+    size_t count() const { return _count; }
+    size_t cursor() const { return _cursor; }
+    size_t top() const { return _top; }
+
+    static float rate(uint32_t heldMs); // 长按 heldMs 后的滚动速度（行/秒）
+
+private:
+    void moveTo(size_t cursor);
+
+    size_t _count;
+    size_t _cursor;
+    size_t _top;
+    bool _open;
+
+    int _holdDir;
+    uint32_t _holdStartMs;
+    uint32_t _lastTickMs;
+    float _carry; // 未满一行的滚动量
+};
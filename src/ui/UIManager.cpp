@@ -20,9 +20,10 @@ void UIManager::begin() {
         return;
     }
     Serial.println("UIManager: Display init success");
+    _ready = true;
 
     _lcd.setRotation(3);
-    _lcd.setBrightness(128);
+    _lcd.setBrightness(_backlight);
     _lcd.setFont(&fonts::efontCN_16); // Support Chinese characters
     _lcd.fillScreen(_currentTheme.bgColor);
     
@@ -30,6 +31,12 @@ void UIManager::begin() {
     Serial.println("UIManager: UI drawn");
 }
 
+void UIManager::setBacklight(uint8_t level) {
+    if (level == _backlight) return;
+    _backlight = level;
+    _lcd.setBrightness(level);
+}
+
 void UIManager::setTheme(const Theme& theme) {
     _currentTheme = theme;
     _lcd.fillScreen(_currentTheme.bgColor);
@@ -38,8 +45,10 @@ void UIManager::setTheme(const Theme& theme) {
     updateStatus(_lastMode, _lastVolume, _lastIsPlaying);
     // Force redraw song info if we have it
     if (_lastSongName.length() > 0) {
-        updateSongInfo(_lastSongName, 0, 0); // Todo: cache index
+        updateSongInfo(_lastSongName, _lastIndex, _lastTotal);
     }
+    _waveSplit = -1;
+    if (_browsing) openBrowser(); // 下一帧按新配色重绘全部行
 }
 
 void UIManager::nextTheme() {
@@ -73,6 +82,8 @@ void UIManager::drawMainArea() {
 }
 
 void UIManager::updateVisualizer() {
+    if (_browsing) return;
+
     // Handle Scrolling Text
     updateScrollingText();
 
@@ -133,7 +144,7 @@ void UIManager::updateVisualizer() {
 }
 
 void UIManager::updateBitrate(int bitrate) {
-    if (bitrate == _lastBitrate) return;
+    if (_browsing || bitrate == _lastBitrate) return;
     _lastBitrate = bitrate;
     
     // Draw Bitrate at Y=130 Left (Moved up)
@@ -149,6 +160,14 @@ void UIManager::updateBitrate(int bitrate) {
 }
 
 void UIManager::updateSongInfo(String filename, int index, int total) {
+    // 浏览中只记录，关闭浏览器时重绘
+    if (_browsing) {
+        _lastSongName = filename;
+        _lastIndex = index;
+        _lastTotal = total;
+        return;
+    }
+
     // Clear the main area (remove Loading text, old spectrum artifacts)
     // Area: Top Status (24) to Song Name (160)
     _lcd.fillRect(0, 24, 240, 136, _currentTheme.bgColor);
@@ -161,6 +180,8 @@ void UIManager::updateSongInfo(String filename, int index, int total) {
     if (slashIdx >= 0) filename = filename.substring(slashIdx + 1);
     
     _lastSongName = filename;
+    _lastIndex = index;
+    _lastTotal = total;
     _lcd.setTextSize(1); // Ensure size 1 (16px)
     _lcd.setTextColor(_currentTheme.textColor, _currentTheme.bgColor);
     
@@ -180,6 +201,7 @@ void UIManager::updateSongInfo(String filename, int index, int total) {
     _lcd.fillRect(0, 160, 240, 24, _currentTheme.bgColor); // Increase clear height
     _lcd.setCursor(_scrollX, 160);
     _lcd.print(filename);
+    drawSleepIndicator(); // 上面清掉了主区域
     
     // Index moved to Top Left (Status Bar)
     if (total > 0) {
@@ -251,7 +273,13 @@ void UIManager::updateStatus(String modeName, int volume, bool isPlaying) {
     _lcd.setCursor(modeX, 4);
     _lcd.print(modeName);
     
-    // Play Icon - Bottom Middle
+    drawSleepIndicator();
+    
+    // Play Icon - Bottom Middle（浏览器覆盖该区域）
+    if (_browsing) {
+        updateVolume(volume);
+        return;
+    }
     int iconX = 114;
     int iconY = 212;
     _lcd.fillRect(iconX, iconY, 12, 12, _currentTheme.bgColor);
@@ -269,6 +297,32 @@ void UIManager::updateStatus(String modeName, int volume, bool isPlaying) {
     updateVolume(volume);
 }
 
+void UIManager::updateSleepTimer(int minutesLeft) {
+    if (minutesLeft == _sleepMinutes) return;
+    _sleepMinutes = minutesLeft;
+    drawSleepIndicator();
+}
+
+void UIManager::drawSleepIndicator() {
+    // 码率行 (Y=130) 中间的空位：左侧码率止于 X=110，右侧格式从 X=180 开始。
+    // 状态栏已被序号 / 模式名 / 音量占满，不能放在那里
+    if (_browsing) return;
+    _lcd.fillRect(112, 130, 66, 16, _currentTheme.bgColor);
+    if (_sleepMinutes < 0) return;
+
+    _lcd.fillCircle(128, 138, 6, _currentTheme.highlightColor);
+    _lcd.fillCircle(131, 135, 5, _currentTheme.bgColor); // 挖出月牙
+
+    _lcd.setTextSize(1);
+    _lcd.setTextColor(_currentTheme.textColor, _currentTheme.bgColor);
+    _lcd.setCursor(137, 130);
+    if (_sleepMinutes == 0) {
+        _lcd.print("E"); // 播完本曲
+    } else {
+        _lcd.print(String(_sleepMinutes));
+    }
+}
+
 void UIManager::updateVolume(int volume) {
     _lcd.setTextSize(1);
     
@@ -301,6 +355,7 @@ void UIManager::updateVolume(int volume) {
 void UIManager::showLoading(String message) {
     // Clear main area
     _lcd.fillRect(0, 24, 240, 216, _currentTheme.bgColor);
+    _waveSplit = -1;
     
     // Draw loading text in center
     _lcd.setTextSize(1);
@@ -311,16 +366,28 @@ void UIManager::showLoading(String message) {
 }
 
 void UIManager::updateProgress(int current, int total) {
-    if (total <= 0) return;
+    if (_browsing || total <= 0) return;
     
     // Progress Bar Y=190
     float pct = (float)current / total;
     if (pct > 1.0) pct = 1.0;
     
     int w = 218 * pct;
-    // Thinner progress bar (6px)
-    _lcd.fillRect(11, 191, w, 6, _currentTheme.progressFillColor);
-    _lcd.fillRect(11 + w, 191, 218 - w, 6, _currentTheme.progressBgColor);
+    if (_waveform) {
+        // 波形 Y=186..206，已播放部分用进度色
+        if (_waveSplit < 0) {
+            for (int i = 0; i < PeakReducer::kColumns; i++) drawWaveColumn(i, i < w);
+        } else {
+            int from = _waveSplit < w ? _waveSplit : w;
+            int to = _waveSplit < w ? w : _waveSplit;
+            for (int i = from; i < to; i++) drawWaveColumn(i, i < w);
+        }
+        _waveSplit = w;
+    } else {
+        // Thinner progress bar (6px)
+        _lcd.fillRect(11, 191, w, 6, _currentTheme.progressFillColor);
+        _lcd.fillRect(11 + w, 191, 218 - w, 6, _currentTheme.progressBgColor);
+    }
     
     // Time text Y=210
     _lcd.setTextSize(1);
@@ -339,4 +406,157 @@ void UIManager::updateProgress(int current, int total) {
     _lcd.print(totalBuf);
 }
 
+void UIManager::updateStreamHealth(const StreamHealth &health) {
+    if (_browsing) return;
+
+    // 缓冲条 Y=191，中点竖线为目标深度；低于目标 3/4（正在放慢补缓冲）时用高亮色
+    uint32_t scale = health.targetMs ? health.targetMs * 2 : 1;
+    int w = health.depthMs >= scale ? 218 : 218 * health.depthMs / scale;
+    uint16_t fill = health.depthMs * 4 < health.targetMs * 3 ? _currentTheme.highlightColor : _currentTheme.progressFillColor;
+    _lcd.fillRect(11, 191, w, 6, fill);
+    _lcd.fillRect(11 + w, 191, 218 - w, 6, _currentTheme.progressBgColor);
+    _lcd.drawFastVLine(11 + 109, 187, 14, _currentTheme.textColor);
+
+    // 文字 Y=210：左侧深度 / 目标（秒），右侧断流次数或连接状态
+    char left[24];
+    char right[16];
+    snprintf(left, sizeof(left), "LIVE %u.%us/%u.%us", (unsigned)(health.depthMs / 1000), (unsigned)(health.depthMs % 1000 / 100),
+             (unsigned)(health.targetMs / 1000), (unsigned)(health.targetMs % 1000 / 100));
+    if (health.link == LINK_BACKOFF || (health.link == LINK_CONNECTING && health.reconnects)) snprintf(right, sizeof(right), "retry %u", health.reconnects);
+    else snprintf(right, sizeof(right), "drop %u", health.underruns);
+
+    _lcd.setTextSize(1);
+    _lcd.setTextColor(_currentTheme.textColor, _currentTheme.bgColor);
+    _lcd.fillRect(10, 210, 220, 16, _currentTheme.bgColor);
+    _lcd.setCursor(10, 210);
+    _lcd.print(left);
+    _lcd.setCursor(240 - 10 - _lcd.textWidth(right), 210);
+    _lcd.print(right);
+}
+
+void UIManager::setWaveform(const WaveColumn *columns) {
+    _waveform = columns;
+    _waveSplit = -1;
+    if (_ready && !_browsing) _lcd.fillRect(11, 186, 218, 21, _currentTheme.bgColor); // 清掉上一首的波形 / 进度条
+}
+
+// 以 Y=196 为中线上下对称：外轮廓为峰值，已播放部分再叠加 RMS 内芯，最安静处也保留 1px 中线
+void UIManager::drawWaveColumn(int column, bool played) {
+    const WaveColumn &c = _waveform[column];
+    int x = 11 + column;
+    int hp = c.peak * 10 / 255;
+    int hr = c.rms * 10 / 255;
+    _lcd.drawFastVLine(x, 186, 21, _currentTheme.bgColor);
+    _lcd.drawFastVLine(x, 196 - hp, hp * 2 + 1, played ? _currentTheme.progressFillColor : _currentTheme.progressBgColor);
+    if (played && hr > 0) _lcd.drawFastVLine(x, 196 - hr, hr * 2 + 1, _currentTheme.textColor);
+}
+
+// 浏览器布局：状态栏下 8 行 × 26px（Y=28..236），右侧 4px 滚动条
+#define BROWSER_TOP 28
+#define BROWSER_ROW_H 26
+#define BROWSER_TEXT_W 232
+
+void UIManager::openBrowser() {
+    _browsing = true;
+    for (int i = 0; i < TrackBrowser::kRows; i++) _browserRowIdx[i] = SIZE_MAX;
+    _browserThumbY = -1;
+    _browserCursor = SIZE_MAX;
+    _lcd.fillRect(0, 24, 240, 216, _currentTheme.bgColor);
+}
+
+void UIManager::drawBrowserRow(int row, const char *path, bool selected) {
+    int y = BROWSER_TOP + row * BROWSER_ROW_H;
+    uint16_t bg = selected ? _currentTheme.highlightColor : _currentTheme.bgColor;
+    if (!path) {
+        _lcd.fillRect(0, y, BROWSER_TEXT_W, BROWSER_ROW_H, _currentTheme.bgColor);
+        return;
+    }
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+
+    // 文字自带背景色，只补齐文字以外的区域，避免整行先清再画的闪烁
+    _lcd.fillRect(0, y, BROWSER_TEXT_W, 5, bg);
+    _lcd.fillRect(0, y + 21, BROWSER_TEXT_W, 5, bg);
+    _lcd.fillRect(0, y + 5, 4, 16, bg);
+    _lcd.setClipRect(0, y, BROWSER_TEXT_W, BROWSER_ROW_H);
+    _lcd.setTextSize(1);
+    _lcd.setTextWrap(false);
+    _lcd.setTextColor(_currentTheme.textColor, bg);
+    _lcd.setCursor(4, y + 5);
+    _lcd.print(name);
+    _lcd.clearClipRect();
+    int x = _lcd.getCursorX();
+    if (x < BROWSER_TEXT_W) _lcd.fillRect(x, y + 5, BROWSER_TEXT_W - x, 16, bg);
+}
+
+void UIManager::drawBrowser(const TrackBrowser &browser, const std::function<const char *(size_t)> &pathAt) {
+    if (!_browsing) openBrowser();
+
+    // 只光栅化可见行，且仅重绘内容或选中状态变化的行；名称按行取，与列表长度无关
+    for (int row = 0; row < TrackBrowser::kRows; row++) {
+        size_t idx = browser.top() + row;
+        bool selected = idx == browser.cursor();
+        if (idx >= browser.count()) idx = SIZE_MAX;
+        if (idx == _browserRowIdx[row] && selected == _browserRowSel[row]) continue;
+        _browserRowIdx[row] = idx;
+        _browserRowSel[row] = selected;
+        drawBrowserRow(row, idx == SIZE_MAX ? nullptr : pathAt(idx), selected);
+    }
+
+    // 滚动条
+    int trackH = TrackBrowser::kRows * BROWSER_ROW_H;
+    int thumbH = trackH;
+    int thumbY = BROWSER_TOP;
+    if (browser.count() > (size_t)TrackBrowser::kRows) {
+        thumbH = (int)((uint64_t)trackH * TrackBrowser::kRows / browser.count());
+        if (thumbH < 8) thumbH = 8;
+        thumbY = BROWSER_TOP + (int)((uint64_t)(trackH - thumbH) * browser.top() / (browser.count() - TrackBrowser::kRows));
+    }
+    if (thumbY != _browserThumbY) {
+        _browserThumbY = thumbY;
+        _lcd.fillRect(236, BROWSER_TOP, 4, trackH, _currentTheme.progressBgColor);
+        _lcd.fillRect(236, thumbY, 4, thumbH, _currentTheme.progressFillColor);
+    }
+
+    // 状态栏左侧显示光标位置
+    if (browser.cursor() != _browserCursor) {
+        _browserCursor = browser.cursor();
+        char pos[24];
+        snprintf(pos, sizeof(pos), "%u/%u", (unsigned)(browser.cursor() + 1), (unsigned)browser.count());
+        _lcd.fillRect(0, 0, 100, 24, _currentTheme.statusBgColor);
+        _lcd.setCursor(5, 5);
+        _lcd.setTextColor(_currentTheme.textColor, _currentTheme.statusBgColor);
+        _lcd.print(pos);
+    }
+}
+
+void UIManager::showBrowserQuery(const char *query, char pending) {
+    if (!query) {
+        updateStatus(_lastMode, _lastVolume, _lastIsPlaying);
+        return;
+    }
+    // 已输入部分（只显示末尾 6 个字母）+ 高亮的候选字母，占用模式名的位置
+    size_t len = strlen(query);
+    const char *tail = len > 6 ? query + len - 6 : query;
+    _lcd.fillRect(80, 0, 80, 24, _currentTheme.statusBgColor);
+    _lcd.setTextSize(1);
+    _lcd.setTextColor(_currentTheme.textColor, _currentTheme.statusBgColor);
+    int w = _lcd.textWidth(tail) + 8;
+    _lcd.setCursor(120 - w / 2, 4);
+    _lcd.print(tail);
+    char letter[2] = { pending, '\0' };
+    _lcd.setTextColor(_currentTheme.statusBgColor, _currentTheme.highlightColor);
+    _lcd.print(letter);
+}
+
+void UIManager::closeBrowser() {
+    if (!_browsing) return;
+    _browsing = false;
+    _lcd.fillRect(0, 24, 240, 216, _currentTheme.bgColor);
+    _lastBitrate = 0; // 下次刷新时重绘码率
+    _waveSplit = -1;
+    updateSongInfo(_lastSongName, _lastIndex, _lastTotal);
+    updateStatus(_lastMode, _lastVolume, _lastIsPlaying);
+}
+
 #endif
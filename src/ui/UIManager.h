@@ -4,6 +4,10 @@
 
 #include "../display/LGFX_Setup.h"
 #include "Theme.h"
+#include "TrackBrowser.h"
+#include "../dsp/PeakReducer.h"
+#include "../stream/StreamSession.h"
+#include <functional>
 
 class UIManager {
 public:
@@ -13,12 +17,24 @@ public:
     // Core updates
     void updateSongInfo(String filename, int index, int total);
     void updateProgress(int current, int total); // Seconds
+    void setWaveform(const WaveColumn *columns); // 进度条改为波形概览（PeakReducer::kColumns 列），nullptr 恢复普通进度条
+    void updateStreamHealth(const StreamHealth &health); // 电台：进度条位置显示缓冲深度（满格为目标的 2 倍）
     void updateVisualizer(); // New method for spectrum animation
     void updateStatus(String modeName, int volume, bool isPlaying);
     void updateVolume(int volume);
     void updateBitrate(int bitrate); // New method
+    void updateSleepTimer(int minutesLeft); // -1 隐藏，0 表示播完本曲
     void showLoading(String message); // New method
+    void setBacklight(uint8_t level); // 0 关闭
+    bool isScreenOn() const { return _backlight > 0; }
     
+    // 曲目浏览：打开期间主界面的绘制暂停（状态仍缓存），关闭时整体重绘
+    void openBrowser();
+    void drawBrowser(const TrackBrowser &browser, const std::function<const char *(size_t)> &pathAt);
+    void closeBrowser();
+    bool isBrowsing() const { return _browsing; }
+    void showBrowserQuery(const char *query, char pending); // 字母选择器：状态栏中部显示，query 为空指针时恢复模式名
+
     // Theme
     void nextTheme();
     void setTheme(const Theme& theme);
@@ -29,6 +45,8 @@ private:
     LGFX_ST7789 _lcd;
     Theme _currentTheme;
     int _themeIndex;
+    uint8_t _backlight = 128;
+    bool _ready = false; // begin() 之前（交接快速启动先开播后初始化屏幕）只缓存状态，不绘制
     
     // Cache to avoid flickering// State cache
     String _lastSongName;
@@ -36,6 +54,20 @@ private:
     int _lastVolume;
     bool _lastIsPlaying;
     int _lastBitrate = 0; // Cache bitrate
+    int _sleepMinutes = -1;
+    int _lastIndex = 0;
+    int _lastTotal = 0;
+
+    // 波形进度条：只重绘已播放分界移动经过的列
+    const WaveColumn *_waveform = nullptr;
+    int _waveSplit = -1; // 已绘制的分界列，-1 表示需要整体重绘
+
+    // 浏览器逐行缓存：行内容和选中状态都未变的行不重绘
+    bool _browsing = false;
+    size_t _browserRowIdx[TrackBrowser::kRows];
+    bool _browserRowSel[TrackBrowser::kRows];
+    int _browserThumbY = -1;
+    size_t _browserCursor = SIZE_MAX;
     
     // Scrolling state
     int _songNameWidth = 0;
@@ -46,8 +78,11 @@ private:
     
     void drawUI();
     void drawStatusBar();
+    void drawSleepIndicator();
     void drawMainArea();
     void drawProgressBar(float percentage);
+    void drawWaveColumn(int column, bool played);
+    void drawBrowserRow(int row, const char *path, bool selected);
 };
 
 extern UIManager ui;
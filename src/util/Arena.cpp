@@ -0,0 +1,108 @@
+#include "Arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+Arena::Arena(size_t chunkSize, MemTag tag)
+    : _chunkSize(chunkSize), _tag(tag), _head(nullptr), _current(nullptr), _offset(0), _used(0), _capacity(0),
+      _limit(0) {}
+
+Arena::~Arena() {
+    release();
+}
+
+Arena::Chunk *Arena::newChunk(size_t minBytes) {
+    size_t size = minBytes > _chunkSize ? minBytes : _chunkSize;
+    if (_limit && _capacity + size > _limit) size = minBytes;
+    if (_limit && _capacity + size > _limit) return nullptr;
+    void *p = nullptr;
+#ifdef ESP_PLATFORM
+    p = heap_caps_malloc(sizeof(Chunk) + size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (!p) p = malloc(sizeof(Chunk) + size); // 无 PSRAM 时退回内部 RAM
+    if (!p && size > minBytes) {
+        // 堆已碎片化、整块申请不到时，只申请本次需要的大小
+        size = minBytes;
+#ifdef ESP_PLATFORM
+        p = heap_caps_malloc(sizeof(Chunk) + size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+        if (!p) p = malloc(sizeof(Chunk) + size);
+    }
+    if (!p) return nullptr;
+
+    Chunk *c = (Chunk *)p;
+    c->next = nullptr;
+    c->size = size;
+    _capacity += size;
+    memCount(_tag, (int32_t)(sizeof(Chunk) + size));
+    return c;
+}
+
+bool Arena::fit(size_t bytes, size_t align) {
+    while (true) {
+        if (_current) {
+            size_t start = (_offset + align - 1) & ~(align - 1);
+            if (start + bytes <= _current->size) return true;
+            if (_current->next) {
+                // 复用 reset() 前留下的块；放不下的大请求会跳过较小的块
+                _current = _current->next;
+                _offset = 0;
+                continue;
+            }
+        }
+
+        Chunk *c = newChunk(bytes + align);
+        if (!c) return false;
+        if (_current) _current->next = c;
+        else _head = c;
+        _current = c;
+        _offset = 0;
+    }
+}
+
+void *Arena::alloc(size_t bytes, size_t align) {
+    if (bytes == 0) bytes = 1;
+    if (!fit(bytes, align)) return nullptr;
+    size_t start = (_offset + align - 1) & ~(align - 1);
+    _used += start + bytes - _offset;
+    _offset = start + bytes;
+    return data(_current) + start;
+}
+
+bool Arena::reserve(size_t bytes) {
+    return fit(bytes ? bytes : 1, sizeof(void *));
+}
+
+const char *Arena::strdup(const char *s, size_t len) {
+    char *p = (char *)alloc(len + 1, 1);
+    if (!p) return nullptr;
+    memcpy(p, s, len);
+    p[len] = '\0';
+    return p;
+}
+
+void Arena::reset() {
+    _current = _head;
+    _offset = 0;
+    _used = 0;
+}
+
+void Arena::release() {
+    Chunk *c = _head;
+    while (c) {
+        Chunk *next = c->next;
+        memCount(_tag, -(int32_t)(sizeof(Chunk) + c->size));
+        free(c); // heap_caps_malloc 的内存同样可用 free 释放
+        c = next;
+    }
+    _head = _current = nullptr;
+    _offset = _used = _capacity = 0;
+}
+
+void arenaOutOfMemory(size_t bytes) {
+    fprintf(stderr, "Arena: out of memory (%u bytes)\n", (unsigned)bytes);
+    abort();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "CountingAllocator.h"
+
+// 块式 bump 分配器：按块向堆申请（ESP32 上优先 PSRAM），块内顺序分配，不支持单独释放。
+// reset() 只把分配指针拨回第一块开头，O(1) 且不归还内存，下一轮分配直接复用原有块，
+// 因此反复整体重建的数据（如每个模式的播放列表）不会在内部 RAM 中留下碎片。
+class Arena {
+public:
+    explicit Arena(size_t chunkSize = 32 * 1024, MemTag tag = MEM_PLAYLIST);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *alloc(size_t bytes, size_t align = sizeof(void *)); // 内存不足返回 nullptr
+    const char *strdup(const char *s, size_t len); // 拷贝 len 字节并补 '\0'；内存不足返回 nullptr
+    // 保证随后合计 bytes 字节（含对齐填充，起点按指针对齐）的分配都能在同一块内完成；
+    // 内存不足返回 false。容器扩容前先预留，失败时由调用方放弃构建，而不是让容器拿到 nullptr
+    bool reserve(size_t bytes);
+
+    void reset();   // O(1)：此前分配的指针全部失效
+    void release(); // 归还所有块
+
+    size_t used() const { return _used; }
+    size_t capacity() const { return _capacity; }
+    // 容量上限（0 = 不限）：超出时按内存不足处理，主机测试据此模拟 PSRAM 耗尽
+    void setLimit(size_t bytes) { _limit = bytes; }
+
+private:
+    struct Chunk {
+        Chunk *next;
+        size_t size;
+    };
+
+    static uint8_t *data(Chunk *c) { return (uint8_t *)(c + 1); }
+    Chunk *newChunk(size_t minBytes);
+    bool fit(size_t bytes, size_t align); // 让 _current 指向放得下该请求的块
+
+    size_t _chunkSize;
+    MemTag _tag;
+    Chunk *_head;
+    Chunk *_current;
+    size_t _offset;   // _current 内已用字节
+    size_t _used;     // 本轮分配总字节（含对齐填充）
+    size_t _capacity; // 所有块的总大小
+    size_t _limit;
+};
+
+// 容器分配失败时的最后防线：打印后 abort()，绝不把 nullptr 交给容器。
+// 正常路径不应走到这里——扩容前应先 Arena::reserve()，失败时放弃整个模式
+[[noreturn]] void arenaOutOfMemory(size_t bytes);
+
+// 供标准容器使用：deallocate 为空操作，内存随 Arena::reset() 一并回收。
+// 注意：reset() 前必须先让容器放弃缓冲区（见 arenaRelease），否则会访问已复用的内存。
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = ArenaAllocator<U>; };
+
+    Arena *arena;
+
+    explicit ArenaAllocator(Arena *a) noexcept : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        void *p = arena->alloc(n * sizeof(T), alignof(T));
+        if (!p) arenaOutOfMemory(n * sizeof(T));
+        return (T *)p;
+    }
+    void deallocate(T *, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const noexcept { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const noexcept { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// 换成空容器，丢弃（而不是逐个释放）原缓冲区
+template <typename V>
+inline void arenaRelease(V &v) {
+    V(v.get_allocator()).swap(v);
+}
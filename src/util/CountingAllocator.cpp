@@ -0,0 +1,33 @@
+#include "CountingAllocator.h"
+
+static int32_t s_current[MEM_TAG_COUNT];
+static int32_t s_peak[MEM_TAG_COUNT];
+
+static const char *const kTagNames[MEM_TAG_COUNT] = { "playlist", "ui", "decoder", "cache" };
+
+const char *memTagName(MemTag tag) {
+    return tag < MEM_TAG_COUNT ? kTagNames[tag] : "?";
+}
+
+void memCount(MemTag tag, int32_t bytes) {
+    if (tag >= MEM_TAG_COUNT) return;
+    int32_t now = __atomic_add_fetch(&s_current[tag], bytes, __ATOMIC_RELAXED);
+    int32_t peak = __atomic_load_n(&s_peak[tag], __ATOMIC_RELAXED);
+    while (now > peak &&
+           !__atomic_compare_exchange_n(&s_peak[tag], &peak, now, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+int32_t memCurrent(MemTag tag) {
+    return tag < MEM_TAG_COUNT ? __atomic_load_n(&s_current[tag], __ATOMIC_RELAXED) : 0;
+}
+
+int32_t memPeak(MemTag tag) {
+    return tag < MEM_TAG_COUNT ? __atomic_load_n(&s_peak[tag], __ATOMIC_RELAXED) : 0;
+}
+
+void memResetPeaks() {
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        __atomic_store_n(&s_peak[i], __atomic_load_n(&s_current[i], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+}
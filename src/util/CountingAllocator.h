@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+// 按子系统统计堆内存：容器使用 CountingAllocator 后，分配/释放的字节数计入对应标签。
+// 纯 C++，主机端编译同样可用（用于测试 PlaylistManager 等模块的内存增长）。
+
+enum MemTag : uint8_t {
+    MEM_PLAYLIST, // 播放列表、路径索引
+    MEM_UI,       // 屏幕驱动缓冲
+    MEM_DECODER,  // 解码器 / 变速处理
+    MEM_CACHE,    // 跳转索引、书签
+    MEM_TAG_COUNT
+};
+
+const char *memTagName(MemTag tag);
+
+// 计数器可被多个任务同时更新（校验任务运行在 core 0）
+void memCount(MemTag tag, int32_t bytes);
+int32_t memCurrent(MemTag tag);
+int32_t memPeak(MemTag tag);
+void memResetPeaks(); // 峰值重置为当前值，开始新的统计窗口
+
+template <typename T, MemTag Tag>
+struct CountingAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = CountingAllocator<U, Tag>; };
+
+    CountingAllocator() noexcept {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U, Tag> &) noexcept {}
+
+    T *allocate(size_t n) {
+        T *p = std::allocator<T>().allocate(n);
+        memCount(Tag, (int32_t)(n * sizeof(T)));
+        return p;
+    }
+
+    void deallocate(T *p, size_t n) {
+        memCount(Tag, -(int32_t)(n * sizeof(T)));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U, Tag> &) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U, Tag> &) const noexcept { return false; }
+};
+
+template <typename T, MemTag Tag>
+using TaggedVector = std::vector<T, CountingAllocator<T, Tag>>;
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 路径的稳定 64 位哈希 (FNV-1a)，用作曲目 ID 和各类 sidecar 缓存的文件名
+inline uint64_t pathHash(const char *path, size_t len = (size_t)-1) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len && path[i]; i++) {
+        h ^= (uint8_t)path[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "Arena.h"
+
+// 开放寻址哈希表：64 位路径哈希 → 32 位曲目 ID
+// 线性探测，容量为 2 的幂且保持负载 ≤ 50%；哈希值 0 保留为空槽标记。
+// 存储来自调用方的 Arena，clear() 之后方可 reset 该 Arena。
+class PathIndex {
+public:
+    static const uint32_t kNotFound = 0xFFFFFFFF;
+
+    explicit PathIndex(Arena &arena)
+        : _keys(ArenaAllocator<uint64_t>(&arena)), _values(ArenaAllocator<uint32_t>(&arena)) {}
+
+    void clear() {
+        arenaRelease(_keys);
+        arenaRelease(_values);
+        _size = 0;
+    }
+
+    static size_t capacityFor(size_t n) {
+        size_t cap = 16;
+        while (cap < n * 2) cap <<= 1;
+        return cap;
+    }
+    // 空表 reserve(n) 从 Arena 申请的字节数（两个数组，不含对齐填充）
+    static size_t bytesFor(size_t n) { return capacityFor(n) * (sizeof(uint64_t) + sizeof(uint32_t)); }
+
+    void reserve(size_t n) {
+        size_t cap = capacityFor(n);
+        if (cap <= _keys.size()) return;
+
+        ArenaVector<uint64_t> oldKeys(_keys.get_allocator());
+        ArenaVector<uint32_t> oldValues(_values.get_allocator());
+        oldKeys.swap(_keys);
+        oldValues.swap(_values);
+        _keys.assign(cap, 0);
+        _values.assign(cap, (uint32_t)kNotFound);
+        _size = 0;
+        for (size_t i = 0; i < oldKeys.size(); i++) {
+            if (oldKeys[i]) insert(oldKeys[i], oldValues[i]);
+        }
+    }
+
+    // 已存在则返回原 ID 且不覆盖（用于重复检测）
+    uint32_t insert(uint64_t key, uint32_t value) {
+        if (key == 0) key = 1;
+        if ((_size + 1) * 2 > _keys.size()) reserve(_size + 1);
+
+        size_t mask = _keys.size() - 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask) {
+            if (_keys[i] == key) return _values[i];
+            if (_keys[i] == 0) {
+                _keys[i] = key;
+                _values[i] = value;
+                _size++;
+                return value;
+            }
+        }
+    }
+
+    uint32_t find(uint64_t key) const {
+        if (_keys.empty()) return kNotFound;
+        if (key == 0) key = 1;
+
+        size_t mask = _keys.size() - 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask) {
+            if (_keys[i] == key) return _values[i];
+            if (_keys[i] == 0) return kNotFound;
+        }
+    }
+
+    size_t size() const { return _size; }
+
+private:
+    ArenaVector<uint64_t> _keys;
+    ArenaVector<uint32_t> _values;
+    size_t _size = 0;
+};
@@ -0,0 +1,190 @@
+// AudioTask 调度约定的主机模拟：真实的 AudioTask.cpp 跑在 FreeRTOS 替身（std::thread）上，
+// 播放器换成记录调用的 Audio 替身。检查修改类调用只发生在音频任务、命令按提交顺序执行、
+// 同步命令带回结果、主循环再慢也不会让音频任务错过截止期、暂停时阻塞在队列上，以及暂停打开不出声。
+#include "TestHarness.h"
+#include "TempDir.h"
+#include "AudioTask.h"
+#include "config.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// 音频任务与固件一样永不退出，测试对象有意不释放
+struct Rig {
+    Audio audio;
+    TimeStretch stretch;
+    AudioTask task;
+    std::atomic<uint32_t> lastBeginUs{ 0 };
+    std::atomic<uint32_t> maxGapUs{ 0 };
+};
+
+static Rig &startRig() {
+    Rig *rig = new Rig;
+    // 经由 loop 钩子测量两次 audio.loop() 的间隔
+    rig->task.onLoopBegin([rig] {
+        uint32_t now = micros();
+        uint32_t last = rig->lastBeginUs.exchange(now);
+        if (last && now - last > rig->maxGapUs) rig->maxGapUs = now - last;
+    });
+    rig->task.onLoopEnd([rig](bool running) {
+        if (!running) rig->lastBeginUs = 0;
+    });
+    rig->task.begin(rig->audio, rig->stretch);
+    return *rig;
+}
+
+static void waitLoops(Rig &rig, uint32_t n) {
+    uint32_t target = rig.audio.loops + n;
+    for (int i = 0; i < 2000 && rig.audio.loops < target; i++) delay(1);
+}
+
+TEST(mutations_run_on_the_audio_task_in_submission_order) {
+    TempDir dir;
+    dir.write("/a.mp3", { 1, 2, 3 });
+    fs::FS fs(dir.path());
+    Rig &rig = startRig();
+
+    CHECK(rig.task.connect(fs, "/a.mp3", 100));
+    rig.task.setVolume(5);
+    rig.task.setVolume(6);
+    rig.task.setVolume(7);
+    rig.task.seekFilePos(4096);
+    rig.task.seekSeconds(30);
+    rig.task.setSpeed(1.5f);
+    CHECK(!rig.task.pauseResume());
+    rig.task.stop();
+
+    std::vector<Audio::Call> calls = rig.audio.calls();
+    std::vector<std::string> expect = { "connect /a.mp3", "volume", "volume", "volume",
+                                        "seekFilePos", "seekSeconds", "pauseResume", "stop" };
+    CHECK_EQ(calls.size(), expect.size());
+    for (size_t i = 0; i < std::min(calls.size(), expect.size()); i++) {
+        CHECK_EQ(calls[i].what, expect[i]);
+        CHECK(calls[i].thread == calls[0].thread);
+    }
+    CHECK(calls[0].thread != std::this_thread::get_id());
+    CHECK_EQ(calls[0].arg, 100u);
+    CHECK_EQ(calls[3].arg, 7u);
+    CHECK_EQ(calls[4].arg, 4096u);
+    CHECK_EQ(calls[5].arg, 30u);
+}
+
+TEST(sync_commands_return_the_task_result) {
+    TempDir dir;
+    dir.write("/a.mp3", { 1 });
+    fs::FS fs(dir.path());
+    Rig &rig = startRig();
+
+    CHECK(!rig.task.connect(fs, "/missing.mp3", 0));
+    CHECK(!rig.audio.isRunning());
+    CHECK(rig.task.connect(fs, "/a.mp3", 0));
+    CHECK(rig.audio.isRunning());
+    CHECK(!rig.task.pauseResume());
+    CHECK(rig.task.pauseResume());
+    rig.task.stop();
+    CHECK(!rig.audio.isRunning());
+}
+
+// 模式切换等慢操作只占主循环：音频任务照常循环，不错过截止期
+TEST(slow_main_loop_does_not_starve_the_decoder) {
+    TempDir dir;
+    dir.write("/a.mp3", { 1 });
+    fs::FS fs(dir.path());
+    Rig &rig = startRig();
+    CHECK(rig.task.connect(fs, "/a.mp3", 0));
+    waitLoops(rig, 5);
+
+    uint32_t loops = rig.audio.loops;
+    uint32_t start = millis();
+    volatile uint64_t sink = 0;
+    while (millis() - start < 300) sink = sink + 1; // 主循环忙于扫描 / 重建播放列表
+    rig.task.setVolume(3);
+    rig.task.seekSeconds(10);
+
+    CHECK(rig.audio.loops - loops >= 50);
+    CHECK_EQ(rig.task.getMissedDeadlines(), 0u);
+    CHECK(rig.maxGapUs < AUDIO_TASK_DEADLINE_MS * 1000u);
+    printf("    300 ms busy main loop: %u audio loops, max gap %u us\n", (unsigned)(rig.audio.loops - loops),
+           (unsigned)rig.maxGapUs);
+    rig.task.stop();
+}
+
+// 音频任务内部的慢命令（SD 跳转）确实会推迟下一次 audio.loop()，计为一次错过
+TEST(slow_command_on_the_audio_task_counts_a_missed_deadline) {
+    TempDir dir;
+    dir.write("/a.mp3", { 1 });
+    fs::FS fs(dir.path());
+    Rig &rig = startRig();
+    CHECK(rig.task.connect(fs, "/a.mp3", 0));
+    waitLoops(rig, 5);
+    CHECK_EQ(rig.task.getMissedDeadlines(), 0u);
+
+    rig.audio.seekStallMs = AUDIO_TASK_DEADLINE_MS + 30;
+    rig.task.seekFilePos(1234);
+    waitLoops(rig, 5);
+    CHECK_EQ(rig.task.getMissedDeadlines(), 1u);
+
+    // 打开文件与暂停 / 继续本身的耗时不计入截止期
+    CHECK(rig.task.connect(fs, "/a.mp3", 0));
+    CHECK(!rig.task.pauseResume());
+    CHECK(rig.task.pauseResume());
+    waitLoops(rig, 5);
+    CHECK_EQ(rig.task.getMissedDeadlines(), 1u);
+    rig.task.stop();
+}
+
+// 暂停时阻塞在命令队列上：只按 AUDIO_TASK_IDLE_MS 超时空转，不错过截止期；继续后恢复每 tick 一轮
+TEST(paused_task_blocks_on_the_queue) {
+    TempDir dir;
+    dir.write("/a.mp3", { 1 });
+    fs::FS fs(dir.path());
+    Rig &rig = startRig();
+    CHECK(rig.task.connect(fs, "/a.mp3", 0));
+    CHECK(!rig.task.pauseResume());
+
+    uint32_t loops = rig.audio.loops;
+    delay(200);
+    uint32_t paused = rig.audio.loops - loops;
+    CHECK(paused <= 200 / AUDIO_TASK_IDLE_MS + 2);
+    CHECK_EQ(rig.task.getMissedDeadlines(), 0u);
+
+    CHECK(rig.task.pauseResume());
+    loops = rig.audio.loops;
+    delay(200);
+    uint32_t running = rig.audio.loops - loops;
+    CHECK(running >= 4 * paused + 20);
+    printf("    200 ms: %u loops paused, %u playing\n", (unsigned)paused, (unsigned)running);
+    rig.task.stop();
+}
+
+// 交接前处于暂停：打开与暂停在同一命令中完成，其间没有任何一轮 audio.loop() 处于播放状态
+TEST(paused_connect_never_plays) {
+    TempDir dir;
+    dir.write("/a.mp3", { 1 });
+    fs::FS fs(dir.path());
+    Rig &rig = startRig();
+    waitLoops(rig, 1);
+
+    CHECK(rig.task.connect(fs, "/a.mp3", 4096, true));
+    CHECK(!rig.audio.isRunning());
+    delay(3 * AUDIO_TASK_IDLE_MS);
+    CHECK_EQ(rig.audio.playingLoops.load(), 0u);
+
+    std::vector<Audio::Call> calls = rig.audio.calls();
+    CHECK_EQ(calls.size(), 2u);
+    if (calls.size() == 2) {
+        CHECK_EQ(calls[0].what, std::string("connect /a.mp3"));
+        CHECK_EQ(calls[0].arg, 4096u);
+        CHECK_EQ(calls[1].what, std::string("pauseResume"));
+        CHECK(calls[1].thread == calls[0].thread && calls[0].thread != std::this_thread::get_id());
+    }
+
+    // 打不开时不暂停；之后按键继续即从原处播放
+    CHECK(!rig.task.connect(fs, "/missing.mp3", 0, true));
+    CHECK_EQ(rig.audio.calls().size(), 3u);
+    CHECK(rig.task.connect(fs, "/a.mp3", 4096, true));
+    CHECK(rig.task.pauseResume());
+    waitLoops(rig, 3);
+    CHECK(rig.audio.playingLoops > 0);
+    rig.task.stop();
+}
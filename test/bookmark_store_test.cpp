@@ -0,0 +1,285 @@
+// BookmarkStore：日志在任意字节处截断、中间记录损坏、追加与压缩过程中断电或卡满后的恢复
+#include "TestHarness.h"
+#include "TempDir.h"
+#include "BookmarkStore.h"
+#include <FS.h>
+#include <map>
+
+static const char *kLog = "/.bookmarks.log";
+static const size_t kRecord = 20;
+
+struct Op {
+    uint64_t key;
+    uint64_t value; // 0 = 删除
+};
+
+// 覆盖新增、改写、删除、重复写同值（不落盘）几种情况
+static std::vector<Op> script(size_t n, uint64_t keys) {
+    std::vector<Op> ops;
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint64_t key = 0x1000 + (seed >> 8) % keys;
+        uint64_t value = (seed >> 4) % 5 == 0 ? 0 : 1 + i;
+        ops.push_back({ key, value });
+    }
+    return ops;
+}
+
+static std::map<uint64_t, uint64_t> model(const std::vector<Op> &ops, size_t count) {
+    std::map<uint64_t, uint64_t> m;
+    for (size_t i = 0; i < count; i++) {
+        if (ops[i].value) {
+            m[ops[i].key] = ops[i].value;
+        } else {
+            m.erase(ops[i].key);
+        }
+    }
+    return m;
+}
+
+static bool matches(const BookmarkStore &store, const std::map<uint64_t, uint64_t> &m, uint64_t keys) {
+    if (store.size() != m.size()) return false;
+    for (uint64_t key = 0x1000; key < 0x1000 + keys; key++) {
+        uint64_t value = 0;
+        bool found = store.get(key, value);
+        auto it = m.find(key);
+        if (found != (it != m.end())) return false;
+        if (found && value != it->second) return false;
+    }
+    return true;
+}
+
+// 日志中实际落盘的记录（跳过与当前值相同的写入与不存在键的删除）
+static std::vector<size_t> loggedOps(const std::vector<Op> &ops) {
+    std::vector<size_t> logged;
+    std::map<uint64_t, uint64_t> m;
+    for (size_t i = 0; i < ops.size(); i++) {
+        auto it = m.find(ops[i].key);
+        bool changes = ops[i].value ? (it == m.end() || it->second != ops[i].value) : it != m.end();
+        if (changes) logged.push_back(i);
+        if (ops[i].value) {
+            m[ops[i].key] = ops[i].value;
+        } else if (it != m.end()) {
+            m.erase(it);
+        }
+    }
+    return logged;
+}
+
+TEST(entries_survive_reopen) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<Op> ops = script(60, 16);
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (const Op &op : ops) store.put(op.key, op.value);
+    }
+    BookmarkStore store;
+    store.begin(fs);
+    CHECK(matches(store, model(ops, ops.size()), 16));
+}
+
+// 日志截断在每一个字节：恢复出完整记录对应的状态，坏尾被丢弃，之后的追加在重开后可见
+TEST(truncation_at_every_offset_recovers_complete_records) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<Op> ops = script(40, 8);
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (const Op &op : ops) store.put(op.key, op.value);
+    }
+    std::vector<uint8_t> full = dir.read(kLog);
+    std::vector<size_t> logged = loggedOps(ops);
+    CHECK_EQ(full.size(), logged.size() * kRecord);
+
+    int bad = 0;
+    for (size_t len = 0; len <= full.size(); len++) {
+        dir.write(kLog, std::vector<uint8_t>(full.begin(), full.begin() + len));
+        size_t complete = len / kRecord;
+        std::map<uint64_t, uint64_t> expect = model(ops, complete ? logged[complete - 1] + 1 : 0);
+
+        BookmarkStore store;
+        store.begin(fs);
+        if (!matches(store, expect, 8)) bad++;
+        if (dir.read(kLog).size() % kRecord != 0) bad++;
+
+        store.put(0x1000, 777);
+        expect[0x1000] = 777;
+        BookmarkStore reopened;
+        reopened.begin(fs);
+        if (!matches(reopened, expect, 8)) bad++;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+// 中间记录校验失败：其后的记录一并丢弃（追加日志不跳过坏记录），之后的新写入可见
+TEST(corrupt_record_stops_replay) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<Op> ops;
+    for (uint64_t i = 0; i < 10; i++) ops.push_back({ 0x1000 + i, 100 + i });
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (const Op &op : ops) store.put(op.key, op.value);
+    }
+    std::vector<uint8_t> bytes = dir.read(kLog);
+    bytes[5 * kRecord + 3] ^= 0x40;
+    dir.write(kLog, bytes);
+
+    BookmarkStore store;
+    store.begin(fs);
+    CHECK(matches(store, model(ops, 5), 10));
+    store.put(0x1009, 5);
+    BookmarkStore reopened;
+    reopened.begin(fs);
+    std::map<uint64_t, uint64_t> expect = model(ops, 5);
+    expect[0x1009] = 5;
+    CHECK(matches(reopened, expect, 10));
+}
+
+// 在一串追加（其中触发一次压缩）的任意字节处断电：重开后的状态必须是某个操作前缀的结果，
+// 且不早于断电前已完整落盘的操作
+TEST(power_cut_during_appends_and_compaction) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    const uint64_t keys = 3;
+    std::vector<Op> ops;
+    for (size_t i = 0; i < 150; i++) ops.push_back({ 0x1000 + i % keys, 1 + i });
+
+    // 前 125 条无故障写入；压缩发生在日志超过 3 + 128 条时
+    const size_t warm = 125;
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (size_t i = 0; i < warm; i++) store.put(ops[i].key, ops[i].value);
+    }
+    std::vector<uint8_t> base = dir.read(kLog);
+
+    int bad = 0, compactedRuns = 0;
+    long budget = 0;
+    for (;; budget++) {
+        dir.write(kLog, base);
+        std::filesystem::remove(dir.file(std::string(kLog) + ".tmp"));
+        BookmarkStore writer;
+        writer.begin(fs);
+        fs.powerCutAfter(budget);
+        size_t done = warm;
+        for (size_t i = warm; i < ops.size() && !fs.powerLost(); i++) {
+            writer.put(ops[i].key, ops[i].value);
+            if (!fs.powerLost()) done = i + 1;
+        }
+        bool finished = !fs.powerLost();
+        fs.powerRestore();
+
+        BookmarkStore reader;
+        reader.begin(fs);
+        bool ok = false;
+        for (size_t n = done; n <= ops.size() && !ok; n++) ok = matches(reader, model(ops, n), keys);
+        if (!ok) bad++;
+        if (dir.read(kLog).size() < base.size()) compactedRuns++;
+        if (finished) break;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(compactedRuns > 0);
+    CHECK(budget > (long)((ops.size() - warm) * kRecord));
+}
+
+// 压缩时卡满：任何短写都保留旧日志且不留 .tmp；空间足够时日志收缩为有效条目
+TEST(compaction_on_a_full_card_keeps_the_old_log) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<Op> ops = script(100, 8);
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (const Op &op : ops) store.put(op.key, op.value);
+    }
+    std::vector<uint8_t> before = dir.read(kLog);
+    std::map<uint64_t, uint64_t> expect = model(ops, ops.size());
+    size_t need = expect.size() * kRecord;
+
+    int bad = 0;
+    for (size_t space = 0; space <= need; space++) {
+        dir.write(kLog, before);
+        BookmarkStore store;
+        store.begin(fs);
+        fs.diskFullAfter((long)space);
+        bool ok = store.compact();
+        fs.diskFree();
+        if (ok != (space == need)) bad++;
+        if (dir.exists(std::string(kLog) + ".tmp") || dir.exists(std::string(kLog) + ".bak")) bad++;
+        if (dir.read(kLog).size() != (ok ? need : before.size())) bad++;
+        BookmarkStore reopened;
+        reopened.begin(fs);
+        if (!matches(reopened, expect, 8)) bad++;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+// 坏尾重写因卡满失败：之后的追加不能接在坏尾后面（否则重开后读不回），
+// 腾出空间后的下一次追加先重写日志，卡满期间的修改随之落盘
+TEST(torn_tail_on_a_full_card_is_rewritten_before_appending) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (uint64_t i = 0; i < 5; i++) store.put(0x1000 + i, 100 + i);
+    }
+    std::vector<uint8_t> bytes = dir.read(kLog);
+    bytes.resize(bytes.size() - 7);
+    dir.write(kLog, bytes);
+
+    BookmarkStore store;
+    fs.diskFullAfter(0);
+    store.begin(fs);
+    store.put(0x1005, 200);
+    fs.diskFree();
+    CHECK_EQ(dir.read(kLog).size(), bytes.size()); // 卡满时什么都没写
+    store.put(0x1006, 300);
+    CHECK_EQ(dir.read(kLog).size(), 6 * kRecord);
+
+    BookmarkStore reopened;
+    reopened.begin(fs);
+    std::map<uint64_t, uint64_t> expect = { { 0x1000, 100 }, { 0x1001, 101 }, { 0x1002, 102 }, { 0x1003, 103 },
+                                            { 0x1005, 200 }, { 0x1006, 300 } };
+    CHECK(matches(reopened, expect, 8));
+}
+
+// 压缩的每一步（含 .bak 挪动与改名）之间断电：重开后状态不变，且不留 .tmp / .bak
+TEST(power_cut_at_every_step_of_compaction) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<Op> ops = script(100, 8);
+    {
+        BookmarkStore store;
+        store.begin(fs);
+        for (const Op &op : ops) store.put(op.key, op.value);
+    }
+    std::vector<uint8_t> before = dir.read(kLog);
+    std::map<uint64_t, uint64_t> expect = model(ops, ops.size());
+
+    int bad = 0;
+    long budget = 0;
+    for (;; budget++) {
+        dir.write(kLog, before);
+        BookmarkStore store;
+        store.begin(fs);
+        fs.powerCutAfter(budget);
+        store.compact();
+        bool finished = !fs.powerLost();
+        fs.powerRestore();
+
+        BookmarkStore reopened;
+        reopened.begin(fs);
+        if (!matches(reopened, expect, 8)) bad++;
+        if (dir.exists(std::string(kLog) + ".tmp") || dir.exists(std::string(kLog) + ".bak")) bad++;
+        if (finished) break;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(budget > (long)(expect.size() * kRecord));
+}
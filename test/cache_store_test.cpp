@@ -0,0 +1,214 @@
+// CacheStore / CacheFile：缓存在任意字节处截断或损坏都被整体拒绝，提交过程中任意一步断电后
+// 加载到的一定是完整的新版或旧版，以及与 tools/generate_playlist.py 写出的文件逐字节一致
+#include "TestHarness.h"
+#include "TempDir.h"
+#include "playlist/CacheStore.h"
+#include <FS.h>
+#include <string>
+#include <vector>
+
+static const uint64_t kManifest = 0x0123456789abcdefull;
+static const char *kTxt = "/.playlist_cache_0.txt";
+static const char *kBak = "/.playlist_cache_0.bak";
+
+static std::vector<std::string> paths(size_t n, const char *tag) {
+    std::vector<std::string> out;
+    char buf[96];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "/音乐/%s/%03u 第%u首.mp3", tag, (unsigned)(i / 10), (unsigned)i);
+        out.push_back(buf);
+    }
+    return out;
+}
+
+static void fill(TrackTable &t, const std::vector<std::string> &list) {
+    for (const std::string &p : list) t.add(p.c_str(), p.size());
+    t.buildIndex();
+}
+
+static std::vector<std::string> contents(const TrackTable &t) {
+    std::vector<std::string> out;
+    for (const char *p : t.playlist) out.push_back(p);
+    return out;
+}
+
+static bool save(fs::FS &fs, const std::vector<std::string> &list) {
+    TrackTable t;
+    fill(t, list);
+    uint32_t crc;
+    return CacheStore(fs, kManifest).save(t, 0, crc);
+}
+
+// 加载结果：成功时为曲目列表，失败时为空且 arena 已回收
+static bool load(fs::FS &fs, std::vector<std::string> &out, uint64_t manifest = kManifest) {
+    TrackTable t;
+    uint32_t crc = 0;
+    bool ok = CacheStore(fs, manifest).load(t, 0, crc);
+    out = contents(t);
+    if (!ok && (!t.playlist.empty() || t.arena.used() != 0)) out.push_back("<not discarded>");
+    return ok;
+}
+
+TEST(round_trip_skips_tombstones) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    TrackTable t;
+    fill(t, { "/a/1.mp3", "/a/1.mp3", "/a/2.mp3", "/a/2_1.mp3", "/b/空格 与 中文.flac" });
+    uint32_t saved = 0, loaded = 0;
+    CHECK(CacheStore(fs, kManifest).save(t, 0, saved));
+
+    TrackTable r;
+    CHECK(CacheStore(fs, kManifest).load(r, 0, loaded));
+    CHECK_EQ(loaded, saved);
+    std::vector<std::string> expect = { "/a/1.mp3", "/a/2.mp3", "/b/空格 与 中文.flac" };
+    CHECK(contents(r) == expect);
+    CHECK(!dir.exists("/.playlist_cache_0.tmp"));
+}
+
+// 在每个字节处截断（不含完整文件）：只有仅缺最后一个换行的文件被接受，其余都被拒绝且已读入的曲目作废
+TEST(truncation_at_every_offset_is_rejected) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<std::string> list = paths(40, "t");
+    CHECK(save(fs, list));
+    std::vector<uint8_t> full = dir.read(kTxt);
+
+    int accepted = 0, notDiscarded = 0;
+    for (size_t len = 0; len < full.size(); len++) {
+        dir.write(kTxt, std::vector<uint8_t>(full.begin(), full.begin() + len));
+        std::vector<std::string> out;
+        if (load(fs, out)) {
+            accepted++;
+            CHECK_EQ(len, full.size() - 1);
+            CHECK(out == list);
+        } else if (!out.empty()) {
+            notDiscarded++;
+        }
+    }
+    CHECK_EQ(accepted, 1);
+    CHECK_EQ(notDiscarded, 0);
+}
+
+TEST(corruption_at_every_offset_is_rejected) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    CHECK(save(fs, paths(20, "c")));
+    std::vector<uint8_t> full = dir.read(kTxt);
+
+    int accepted = 0;
+    for (size_t i = 0; i < full.size(); i++) {
+        for (uint8_t mask : { 0x01, 0x20, 0x80 }) {
+            std::vector<uint8_t> bad = full;
+            bad[i] ^= mask;
+            dir.write(kTxt, bad);
+            std::vector<std::string> out;
+            if (load(fs, out)) accepted++;
+        }
+    }
+    CHECK_EQ(accepted, 0);
+
+    // 尾行之后多出内容（另一次写入的残留）同样拒绝；尾行后的空行允许
+    std::vector<uint8_t> extra = full;
+    for (char c : std::string("/x.mp3\n")) extra.push_back(c);
+    dir.write(kTxt, extra);
+    std::vector<std::string> out;
+    CHECK(!load(fs, out));
+    extra = full;
+    extra.push_back('\n');
+    dir.write(kTxt, extra);
+    CHECK(load(fs, out));
+}
+
+TEST(manifest_change_rejects_both_generations) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    CHECK(save(fs, paths(5, "a")));
+    CHECK(save(fs, paths(6, "b")));
+    CHECK(dir.exists(kBak));
+    std::vector<std::string> out;
+    CHECK(!load(fs, out, kManifest + 1));
+    CHECK(out.empty());
+}
+
+TEST(corrupt_current_generation_falls_back_to_bak) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<std::string> older = paths(8, "old"), newer = paths(9, "new");
+    CHECK(save(fs, older));
+    CHECK(save(fs, newer));
+    std::vector<uint8_t> bytes = dir.read(kTxt);
+    bytes[bytes.size() / 2] ^= 0x04;
+    dir.write(kTxt, bytes);
+
+    std::vector<std::string> out;
+    CHECK(load(fs, out));
+    CHECK(out == older);
+    // 上一代被提升为当前版本
+    CHECK(!dir.exists(kBak));
+    CHECK(load(fs, out));
+    CHECK(out == older);
+}
+
+// 在现有缓存之上保存新版本，断电发生在任意字节 / 删除 / 改名处：
+// 重新上电后加载到的是完整的旧版或新版，绝不是混合或半截；预算足够时一定是新版
+TEST(power_cut_during_save_never_loses_the_cache) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<std::string> gen1 = paths(15, "g1"), gen2 = paths(30, "g2"), gen3 = paths(12, "g3");
+
+    int bad = 0, sawOld = 0, sawNew = 0;
+    long budget = 0;
+    for (;; budget++) {
+        std::filesystem::remove_all(dir.path());
+        std::filesystem::create_directories(dir.path());
+        CHECK(save(fs, gen1));
+        CHECK(save(fs, gen2)); // 已有 .txt 与 .bak，覆盖提交的全部步骤
+
+        fs.powerCutAfter(budget);
+        bool saved = save(fs, gen3);
+        bool finished = !fs.powerLost();
+        fs.powerRestore();
+
+        std::vector<std::string> out;
+        bool ok = load(fs, out);
+        if (!ok) {
+            bad++;
+        } else if (out == gen3) {
+            sawNew++;
+        } else if (out == gen2) {
+            sawOld++;
+            if (saved) bad++; // 报告成功却没生效
+        } else {
+            bad++;
+        }
+        // 恢复后再保存一次，之后仍能正常加载新版
+        CHECK(save(fs, gen1));
+        CHECK(load(fs, out) && out == gen1);
+        if (finished) break;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(sawOld > 0 && sawNew > 0);
+    printf("    %ld power-cut points: %d old generation, %d new\n", budget + 1, sawOld, sawNew);
+}
+
+#ifdef PLAYLIST_TOOL
+// 生成脚本的 write_cache 与固件写出的缓存逐字节一致
+TEST(generate_playlist_writes_identical_files) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    std::vector<std::string> list = paths(25, "py");
+    CHECK(save(fs, list));
+
+    std::string listFile = dir.file("/list.txt"), out = dir.file("/py_cache.txt");
+    std::string text;
+    for (const std::string &p : list) text += p + "\n";
+    dir.write("/list.txt", std::vector<uint8_t>(text.begin(), text.end()));
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd),
+             "%s -c \"import sys; sys.path.insert(0, '%s'); from generate_playlist import write_cache; "
+             "write_cache('%s', open('%s', encoding='utf-8').read().splitlines(), 0x%016llx)\"",
+             PLAYLIST_TOOL_PYTHON, PLAYLIST_TOOL, out.c_str(), listFile.c_str(), (unsigned long long)kManifest);
+    CHECK_EQ(system(cmd), 0);
+    CHECK(dir.read("/py_cache.txt") == dir.read(kTxt));
+}
+#endif
@@ -0,0 +1,60 @@
+// 拍手检测的 CPU 开销：麦克风任务每 10ms 一帧的 processFrame（安静 / 播放中学习回声耦合），
+// 以及音频钩子每块输出（1152 帧立体声，约 26ms）的 outputLevel。
+// 主机上的数字只作相对比较；设备上的实际开销看 MicListener 随音频报告输出的每帧平均 / 最大耗时
+#include "Bench.h"
+#include "input/ClapDetector.h"
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+int main() {
+    const size_t frames = 60 * 100 * bench::scale(); // 60 秒
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0, 1);
+    std::vector<int16_t> quiet(frames * ClapDetector::kFrame), echo(quiet.size());
+    std::vector<int16_t> out(quiet.size());
+    for (size_t i = 0; i < quiet.size(); i++) {
+        quiet[i] = (int16_t)(30 * noise(rng));
+        out[i] = (int16_t)(6000 * sinf(i * 0.07f) * (0.5f + 0.5f * sinf(i * 0.0004f)));
+        echo[i] = (int16_t)(quiet[i] + (i >= 2400 ? out[i - 2400] / 3 : 0)); // 150ms 延迟
+    }
+
+    printf("%-26s %10s %10s %12s\n", "per 10 ms mic frame", "avg ns", "worst ns", "% of frame");
+    for (int playing = 0; playing < 2; playing++) {
+        const std::vector<int16_t> &mic = playing ? echo : quiet;
+        ClapDetector d;
+        uint64_t total = 0, worst = 0;
+        uint32_t events = 0;
+        for (size_t f = 0; f < frames; f++) {
+            const int16_t *p = &mic[f * ClapDetector::kFrame];
+            int16_t level = playing ? ClapDetector::outputLevel(&out[f * ClapDetector::kFrame], ClapDetector::kFrame, 1)
+                                    : ClapDetector::kSilent;
+            uint64_t t0 = bench::nowNs();
+            d.setOutputLevel(level);
+            events += d.processFrame(p);
+            uint64_t ns = bench::nowNs() - t0;
+            total += ns;
+            worst = std::max(worst, ns);
+        }
+        bench::keep(events);
+        printf("%-26s %10.0f %10llu %11.4f%%\n", playing ? "playing (echo learning)" : "quiet", (double)total / frames,
+               (unsigned long long)worst, total / (double)frames / 1e5);
+    }
+
+    // 音频钩子：44.1kHz 立体声，每块 1152 帧
+    const size_t block = 1152, blocks = 2000 * bench::scale();
+    std::vector<int16_t> pcm(block * 2);
+    for (size_t i = 0; i < block; i++) pcm[i * 2] = pcm[i * 2 + 1] = out[i];
+    int32_t sum = 0;
+    uint64_t t0 = bench::nowNs();
+    for (size_t b = 0; b < blocks; b++) {
+        pcm[b % block * 2] ^= 1;
+        sum += ClapDetector::outputLevel(pcm.data(), block * 2, 2);
+    }
+    double ns = (double)(bench::nowNs() - t0) / blocks;
+    bench::keep(sum);
+    printf("%-26s %10.0f %10s %11.4f%%\n", "outputLevel, 1152 frames", ns, "-", ns / (block * 1e9 / 44100) * 100);
+    return 0;
+}
@@ -0,0 +1,242 @@
+// ClapDetector：合成场景（拍手、说话、自己播放的鼓点经扬声器回到麦克风、音量变化、睡眠淡出）上的
+// 识别率与误触发次数。拍手为 1ms 起音、12ms 衰减的宽带噪声加房间余响，说话为 30ms 起音的浊音音节，
+// 鼓点中的军鼓故意与拍手相同
+#include "TestHarness.h"
+#include "input/ClapDetector.h"
+#include <math.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+static const int kRate = 16000;
+typedef std::vector<float> Sig;
+
+static std::mt19937 g_rng(7);
+static float gauss() {
+    static std::normal_distribution<float> d(0, 1);
+    return d(g_rng);
+}
+static float uni(float a, float b) { return std::uniform_real_distribution<float>(a, b)(g_rng); }
+
+static void addNoise(Sig &s, float amp) {
+    for (float &v : s) v += amp * gauss();
+}
+
+static void addClap(Sig &s, size_t at, float amp) {
+    for (size_t i = 0; i < (size_t)(0.25 * kRate) && at + i < s.size(); i++) {
+        float t = (float)i / kRate;
+        float env = (t < 0.001f ? t / 0.001f : expf(-(t - 0.001f) / 0.012f)) + 0.05f * expf(-t / 0.08f);
+        s[at + i] += amp * env * gauss();
+    }
+}
+
+static void addSyllable(Sig &s, size_t at, float amp, float f0, float dur) {
+    for (size_t i = 0; i < (size_t)(dur * kRate) && at + i < s.size(); i++) {
+        float t = (float)i / kRate, env = std::min(1.0f, t / 0.03f) * std::min(1.0f, (dur - t) / 0.04f);
+        float v = 0;
+        for (int h = 1; h <= 12; h++) v += sinf(2 * (float)M_PI * f0 * h * t) / h;
+        s[at + i] += amp * env * v + 0.08f * amp * env * gauss(); // 加少量擦音
+    }
+}
+
+static Sig speech(float secs, float amp) {
+    Sig s((size_t)(secs * kRate), 0);
+    for (size_t p = 0; p < s.size();) {
+        float d = uni(0.08f, 0.3f);
+        addSyllable(s, p, amp * uni(0.4f, 1.0f), uni(180, 320), d);
+        p += (size_t)((d + uni(0.03f, 0.5f)) * kRate);
+    }
+    return s;
+}
+
+// 110 BPM 和弦 + 底鼓 + 军鼓（与拍手同形）+ 八分音符踩镲
+static Sig drums(float secs, float amp) {
+    Sig s((size_t)(secs * kRate), 0);
+    static const float roots[4] = { 220, 174.6f, 261.6f, 196 };
+    float beat = 60.0f / 110;
+    for (size_t i = 0; i < s.size(); i++) {
+        float t = (float)i / kRate, r = roots[(int)(t / (4 * beat)) % 4];
+        s[i] = amp * 0.3f * (sinf(2 * (float)M_PI * r * t) + sinf(2 * (float)M_PI * r * 1.26f * t) + sinf(2 * (float)M_PI * r * 1.5f * t));
+    }
+    for (float t = 0; t < secs; t += beat) {
+        size_t at = (size_t)(t * kRate);
+        int k = (int)lrintf(t / beat) % 4;
+        if (k == 1 || k == 3) {
+            addClap(s, at, amp * 1.2f);
+        } else {
+            for (size_t i = 0; i < (size_t)(0.15 * kRate) && at + i < s.size(); i++) {
+                s[at + i] += amp * 2 * expf(-(float)i / kRate / 0.05f) * sinf(2 * (float)M_PI * 60 * i / kRate);
+            }
+        }
+        addClap(s, at, amp * 0.3f);
+        addClap(s, (size_t)((t + beat / 2) * kRate), amp * 0.3f);
+    }
+    return s;
+}
+
+// 扬声器 → 麦克风：增益与延迟（I2S DMA + 声学路径）
+static void addEcho(Sig &mic, const Sig &out, float gain, float latency) {
+    size_t lag = (size_t)(latency * kRate);
+    for (size_t i = 0; i + lag < mic.size() && i < out.size(); i++) mic[i + lag] += gain * out[i];
+}
+
+// 按拍子插入 count 次一组的拍手，返回组数
+static int addPatterns(Sig &mic, float start, float end, int count, float gap, float pause, float amp) {
+    int patterns = 0;
+    for (float t = start; t < end; t += pause, patterns++) {
+        for (int c = 0; c < count; c++, t += gap) addClap(mic, (size_t)(t * kRate), amp);
+    }
+    return patterns;
+}
+
+static std::vector<int16_t> pcm(const Sig &s) {
+    std::vector<int16_t> out(s.size());
+    for (size_t i = 0; i < s.size(); i++) out[i] = (int16_t)std::max(-32768L, std::min(32767L, lrintf(s[i])));
+    return out;
+}
+
+// 逐帧运行；ref 为扬声器实际播放的内容（固件中即音频钩子看到的输出，已计入音量），为空表示没有播放
+static std::vector<std::pair<float, int>> detect(const Sig &micSig, const Sig *ref) {
+    std::vector<int16_t> mic = pcm(micSig), out = ref ? pcm(*ref) : std::vector<int16_t>();
+    ClapDetector d;
+    std::vector<std::pair<float, int>> events;
+    for (size_t f = 0; f + ClapDetector::kFrame <= mic.size(); f += ClapDetector::kFrame) {
+        d.setOutputLevel(ref && f + ClapDetector::kFrame <= out.size()
+                             ? ClapDetector::outputLevel(&out[f], ClapDetector::kFrame, 1)
+                             : ClapDetector::kSilent);
+        uint8_t c = d.processFrame(&mic[f]);
+        if (c) events.push_back({ (float)f / kRate, c });
+    }
+    return events;
+}
+
+static int count(const std::vector<std::pair<float, int>> &events, int claps) {
+    int n = 0;
+    for (const auto &e : events) n += e.second == claps;
+    return n;
+}
+
+TEST(log2_and_output_level) {
+    CHECK_EQ(ClapDetector::log2Q8(0), 0);
+    CHECK_EQ(ClapDetector::log2Q8(1), 0);
+    CHECK_EQ(ClapDetector::log2Q8(256), 8 * 256);
+    CHECK_EQ(ClapDetector::log2Q8(1ull << 40), 40 * 256);
+    // 线性插值误差 < 0.1（约 0.3dB）
+    int worst = 0;
+    for (uint64_t v = 1; v < (1ull << 40); v = v * 3 / 2 + 1) {
+        int exact = (int)lrint(log2((double)v) * 256);
+        worst = std::max(worst, abs(ClapDetector::log2Q8(v) - exact));
+    }
+    CHECK(worst <= 26);
+
+    // 输出电平与块长、声道间隔无关；增益加倍约高 6dB（2 * kDbQ8 * 3）
+    int16_t stereo[2048];
+    for (int i = 0; i < 1024; i++) stereo[i * 2] = stereo[i * 2 + 1] = (int16_t)(8000 * sinf(i * 0.3f));
+    int16_t mono[1024];
+    for (int i = 0; i < 1024; i++) mono[i] = stereo[i * 2];
+    CHECK(abs(ClapDetector::outputLevel(stereo, 2048, 2) - ClapDetector::outputLevel(mono, 1024, 1)) <= 2);
+    CHECK(abs(ClapDetector::outputLevel(mono, 1024, 1) - ClapDetector::outputLevel(mono, 256, 1)) <= 8);
+    for (int i = 0; i < 1024; i++) mono[i] /= 2;
+    int step = ClapDetector::outputLevel(stereo, 2048, 2) - ClapDetector::outputLevel(mono, 1024, 1);
+    CHECK(abs(step - 6 * ClapDetector::kDbQ8) <= 12);
+    int16_t silent = ClapDetector::kSilent;
+    CHECK_EQ(ClapDetector::outputLevel(mono, 1, 1), silent);
+    CHECK_EQ(ClapDetector::outputLevel(mono, 0, 1), silent);
+}
+
+// 安静房间，不同响度的 2..5 下
+TEST(patterns_in_a_quiet_room) {
+    Sig mic(60 * kRate, 0);
+    addNoise(mic, 30);
+    const int expect[] = { 2, 3, 4, 5, 2, 3, 2, 4 };
+    const float amps[] = { 3000, 8000, 1500, 12000, 600, 5000, 20000, 2500 };
+    float t = 1;
+    for (int k = 0; k < 8; k++) {
+        for (int c = 0; c < expect[k]; c++, t += uni(0.25f, 0.5f)) addClap(mic, (size_t)(t * kRate), amps[k] * uni(0.7f, 1.3f));
+        t += 3;
+    }
+    auto events = detect(mic, nullptr);
+    CHECK_EQ(events.size(), 8u);
+    int exact = 0;
+    for (size_t k = 0; k < events.size() && k < 8; k++) exact += events[k].second == expect[k];
+    CHECK_EQ(exact, 8);
+}
+
+// 单次拍手、间隔过长的两下、超过 maxClaps 的连拍都不输出
+TEST(rhythm_window_rejects_singles_and_runs) {
+    Sig mic(30 * kRate, 0);
+    addNoise(mic, 30);
+    addClap(mic, 1 * kRate, 8000);
+    addClap(mic, 5 * kRate, 8000);
+    addClap(mic, (size_t)(6.5 * kRate), 8000); // 间隔 1.5 秒：两个单拍
+    for (int c = 0; c < 7; c++) addClap(mic, (size_t)((10 + c * 0.3) * kRate), 8000);
+    CHECK(detect(mic, nullptr).empty());
+}
+
+// 没有播放：附近有人说话
+TEST(speech_rarely_triggers) {
+    Sig s = speech(180, 4000);
+    addNoise(s, 30);
+    size_t speechEvents = detect(s, nullptr).size();
+    CHECK(speechEvents <= 1);
+    printf("    no playback, 3 min: speech %zu false triggers\n", speechEvents);
+}
+
+// 自己播放的鼓点经扬声器回到麦克风：有回声参考时不误触发，且拍手比回声响 8dB 时仍能识别
+TEST(own_playback_is_rejected_by_the_echo_reference) {
+    size_t withoutReference = 0;
+    for (float gain : { 0.3f, 1.0f, 3.0f }) {
+        Sig out = drums(180, 3000);
+        Sig mic(out.size(), 0);
+        addNoise(mic, 30);
+        addEcho(mic, out, gain, 0.15f);
+        size_t falseRef = detect(mic, &out).size(), falseNoRef = detect(mic, nullptr).size();
+        int patterns = addPatterns(mic, 5, 175, 3, 0.35f, 9, 3000 * 1.2f * gain * 2.5f);
+        int hits = count(detect(mic, &out), 3);
+        printf("    echo gain %.1f: %zu false triggers (%zu without reference), %d/%d triple claps\n", gain, falseRef,
+               falseNoRef, hits, patterns);
+        CHECK(falseRef <= 1);
+        withoutReference += falseNoRef;
+        CHECK(hits >= patterns * 8 / 10);
+    }
+    // 不给参考时，较轻的回声中军鼓会被当成拍手（较响时一直处于持续状态，反而不触发）
+    CHECK(withoutReference > 0);
+}
+
+// 讲故事，220ms 延迟，中途音量加倍：参考随音量变化，延迟由检测器自行找到
+TEST(volume_step_and_latency_are_tracked) {
+    Sig out = speech(180, 6000);
+    for (size_t i = out.size() / 2; i < out.size(); i++) out[i] *= 2;
+    Sig mic(out.size(), 0);
+    addNoise(mic, 30);
+    addEcho(mic, out, 1.0f, 0.22f);
+    size_t falseRef = detect(mic, &out).size();
+    int patterns = addPatterns(mic, 7, 175, 2, 0.4f, 11, 12000);
+    int hits = count(detect(mic, &out), 2);
+    printf("    story, 220 ms latency, volume step: %zu false triggers, %d/%d double claps\n", falseRef, hits, patterns);
+    CHECK(falseRef <= 1);
+    CHECK(hits >= patterns * 8 / 10);
+}
+
+// 睡眠淡出：扬声器的声音逐渐变小，参考须取淡出之后的输出。若参考仍按淡出前的电平，回声预测偏高、
+// 跟不上耦合的变化，淡出中与淡出后的拍手被当成回声；淡出结束后按键取消、音量恢复，也不误触发
+TEST(sleep_fade_is_part_of_the_reference) {
+    Sig out = drums(150, 3000);
+    Sig faded = out;
+    size_t fadeFrom = 30 * kRate, fadeTo = 60 * kRate, cancel = 100 * kRate;
+    for (size_t i = fadeFrom; i < cancel; i++) {
+        faded[i] *= i >= fadeTo ? 0.05f : 1.0f - 0.95f * (float)(i - fadeFrom) / (fadeTo - fadeFrom);
+    }
+    Sig mic(out.size(), 0);
+    addNoise(mic, 30);
+    addEcho(mic, faded, 0.3f, 0.15f);
+    size_t falseTriggers = detect(mic, &faded).size();
+    int patterns = addPatterns(mic, 40, 100, 3, 0.35f, 5, 1500);
+    int withFade = count(detect(mic, &faded), 3), withoutFade = count(detect(mic, &out), 3);
+    printf("    sleep fade: %zu false triggers; %d/%d triple claps with the faded reference, %d with the unfaded one\n",
+           falseTriggers, withFade, patterns, withoutFade);
+    CHECK(falseTriggers <= 1);
+    CHECK(withFade >= patterns * 9 / 10);
+    CHECK(withoutFade < withFade);
+}
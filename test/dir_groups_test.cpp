@@ -0,0 +1,233 @@
+// 后台校验的目录分组：DirValidation 每个目录恰好列举一次、切换播放列表时放弃；
+// 用计数的假文件系统对比逐首 exists() 的调用次数
+#include "TestHarness.h"
+#include "playlist/DirGroups.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// 目录 → 文件完整路径；统计各类调用次数
+struct FakeFs {
+    std::map<std::string, std::vector<std::string>> dirs;
+    size_t exists = 0;
+    size_t listings = 0;
+    size_t entriesListed = 0;
+
+    void add(const std::string &path) { dirs[path.substr(0, path.rfind('/'))].push_back(path); }
+    void erase(const std::string &path) {
+        std::vector<std::string> &v = dirs[path.substr(0, path.rfind('/'))];
+        v.erase(std::find(v.begin(), v.end(), path));
+    }
+    bool fileExists(const std::string &path) {
+        exists++;
+        auto it = dirs.find(path.substr(0, path.rfind('/')));
+        return it != dirs.end() && std::find(it->second.begin(), it->second.end(), path) != it->second.end();
+    }
+    const std::vector<std::string> &list(const std::string &dir) {
+        listings++;
+        const std::vector<std::string> &v = dirs[dir];
+        entriesListed += v.size();
+        return v;
+    }
+};
+
+// 用 FakeFs 跑 PlaylistManager::validate() 使用的 DirValidation；检查临界区配对，
+// 且列举目录时不持有锁。abandonAfter 次 enter() 之后模拟播放列表被切换
+struct Pass {
+    std::set<uint32_t> missing;
+    bool complete = false;
+    size_t dirs = 0;
+    int depth = 0;
+    int violations = 0;
+    size_t pauses = 0;
+};
+
+static Pass validatePass(const std::vector<const char *> &paths, FakeFs &fs, size_t abandonAfter = SIZE_MAX) {
+    std::vector<uint32_t> ids(paths.size());
+    for (uint32_t i = 0; i < ids.size(); i++) ids[i] = i;
+    sortByDir(ids.data(), ids.size(), paths.data());
+
+    Pass p;
+    size_t enters = 0;
+    DirValidation v;
+    v.enter = [&]() {
+        if (p.depth != 0) p.violations++;
+        if (enters++ >= abandonAfter) return false;
+        p.depth++;
+        return true;
+    };
+    v.leave = [&]() {
+        if (p.depth != 1) p.violations++;
+        p.depth--;
+    };
+    v.list = [&](const char *dir, const std::function<void(const char *)> &entry) {
+        if (p.depth != 0) p.violations++;
+        for (const std::string &name : fs.list(dir)) entry(name.c_str());
+    };
+    v.markMissing = [&](uint32_t id) {
+        if (p.depth != 1) p.violations++;
+        p.missing.insert(id);
+    };
+    v.pause = [&]() { p.pauses++; };
+    p.complete = v.run(ids.data(), ids.size(), paths.data());
+    p.dirs = v.dirs;
+    if (v.missing != p.missing.size()) p.violations++;
+    return p;
+}
+
+static size_t countGroups(const std::vector<uint32_t> &ids, const std::vector<const char *> &paths) {
+    size_t groups = 0;
+    for (size_t i = 0; i < ids.size(); i = dirGroupEnd(ids.data(), ids.size(), i, paths.data())) groups++;
+    return groups;
+}
+
+static size_t countDirs(const std::vector<const char *> &paths) {
+    std::set<std::string> dirs;
+    for (const char *p : paths) dirs.insert(std::string(p, dirLength(p)));
+    return dirs.size();
+}
+
+TEST(dir_length) {
+    CHECK_EQ(dirLength("/a/b.mp3"), 2u);
+    CHECK_EQ(dirLength("/b.mp3"), 0u);
+    CHECK_EQ(dirLength("b.mp3"), 0u);
+    CHECK(sameDir("/a/x.mp3", "/a/y.mp3"));
+    CHECK(!sameDir("/a/x.mp3", "/ab/x.mp3"));
+    CHECK(!sameDir("/a/x.mp3", "/a/b/x.mp3"));
+}
+
+// '.' 与 ' ' 小于 '/'：按完整路径排序会把 /poem 拆成多段
+TEST(nested_and_dotted_folders_form_one_group_each) {
+    std::vector<const char *> paths = {
+        "/poem/c.mp3", "/poem/b/1.mp3", "/poem/a.mp3", "/poem/b.mp3", "/poem/b 2/x.mp3",
+        "/poem/b/2.mp3", "/poem.old/z.mp3", "/poem/d.mp3", "/poem/b-c/y.mp3", "/p/q.mp3",
+    };
+    std::vector<uint32_t> ids(paths.size());
+    for (uint32_t i = 0; i < ids.size(); i++) ids[i] = i;
+
+    std::vector<uint32_t> byPath = ids;
+    std::sort(byPath.begin(), byPath.end(), [&](uint32_t a, uint32_t b) { return strcmp(paths[a], paths[b]) < 0; });
+    CHECK(countGroups(byPath, paths) > countDirs(paths));
+
+    sortByDir(ids.data(), ids.size(), paths.data());
+    CHECK_EQ(countGroups(ids, paths), countDirs(paths));
+    // 组内按文件名排序
+    size_t a = std::find(ids.begin(), ids.end(), 2u) - ids.begin();
+    size_t c = std::find(ids.begin(), ids.end(), 0u) - ids.begin();
+    CHECK(a < c);
+}
+
+// 随机目录树（名字含 ' ' '.' '-' 等小于 '/' 的字符）：分组数恒等于目录数
+TEST(random_trees_group_by_directory) {
+    const char alphabet[] = "ab .-_0";
+    uint32_t seed = 99;
+    auto rnd = [&seed](uint32_t n) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % n;
+    };
+    int bad = 0;
+    for (int round = 0; round < 200; round++) {
+        std::vector<std::string> storage;
+        for (int i = 0; i < 60; i++) {
+            std::string p;
+            int depth = 1 + rnd(3);
+            for (int d = 0; d <= depth; d++) {
+                p += '/';
+                int len = 1 + rnd(3);
+                for (int c = 0; c < len; c++) p += alphabet[rnd(sizeof(alphabet) - 1)];
+            }
+            storage.push_back(p + ".mp3");
+        }
+        std::sort(storage.begin(), storage.end());
+        storage.erase(std::unique(storage.begin(), storage.end()), storage.end());
+        std::vector<const char *> paths;
+        for (const std::string &s : storage) paths.push_back(s.c_str());
+        std::reverse(paths.begin(), paths.end());
+
+        std::vector<uint32_t> ids(paths.size());
+        for (uint32_t i = 0; i < ids.size(); i++) ids[i] = i;
+        sortByDir(ids.data(), ids.size(), paths.data());
+        if (countGroups(ids, paths) != countDirs(paths)) bad++;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+// 2000 首、40 个目录、删掉 5%：旧做法每首一次 exists()，新做法每个目录列举一次
+TEST(validation_lists_each_folder_once) {
+    FakeFs fs;
+    std::vector<std::string> storage;
+    char buf[64];
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof(buf), "/story/%s%d/%04d.mp3", i % 3 ? "album" : "album.", i % 40, i);
+        storage.push_back(buf);
+        fs.add(buf);
+    }
+    std::set<uint32_t> deleted;
+    for (uint32_t i = 7; i < storage.size(); i += 20) {
+        fs.erase(storage[i]);
+        deleted.insert(i);
+    }
+    std::vector<const char *> paths;
+    for (const std::string &s : storage) paths.push_back(s.c_str());
+
+    // 旧：playNext 前逐首 SD.exists()
+    size_t found = 0;
+    for (const std::string &s : storage) found += fs.fileExists(s);
+    CHECK_EQ(found, storage.size() - deleted.size());
+    CHECK_EQ(fs.exists, storage.size());
+
+    Pass p = validatePass(paths, fs);
+    CHECK(p.complete);
+    CHECK_EQ(p.violations, 0);
+    CHECK(p.missing == deleted);
+    CHECK_EQ(p.dirs, countDirs(paths));
+    CHECK_EQ(p.pauses, countDirs(paths));
+    CHECK_EQ(fs.listings, countDirs(paths));
+    CHECK_EQ(fs.entriesListed, storage.size() - deleted.size());
+    printf("exists() per play: %zu calls; validation: %zu listings, %zu entries\n", fs.exists, fs.listings,
+           fs.entriesListed);
+}
+
+// 根目录下的曲目列举 ""；目录整个不存在时其中曲目全部缺失
+TEST(root_and_missing_folders) {
+    FakeFs fs;
+    std::vector<const char *> paths = { "/a.mp3", "/gone/x.mp3", "/b.mp3", "/gone/y.mp3", "/keep/z.mp3" };
+    fs.add("/a.mp3");
+    fs.add("/keep/z.mp3");
+    Pass p = validatePass(paths, fs);
+    CHECK(p.complete);
+    CHECK_EQ(p.violations, 0);
+    CHECK(p.missing == std::set<uint32_t>({ 1, 2, 3 }));
+    CHECK_EQ(fs.listings, 3u);
+}
+
+// 中途切换播放列表（enter() 失败）：立即放弃，之后的目录不再列举，也不再标记
+TEST(switching_playlists_abandons_the_pass) {
+    FakeFs fs;
+    std::vector<std::string> storage;
+    char buf[32];
+    for (int i = 0; i < 40; i++) {
+        snprintf(buf, sizeof(buf), "/d%d/%02d.mp3", i % 8, i);
+        storage.push_back(buf); // 全部缺失
+    }
+    std::vector<const char *> paths;
+    for (const std::string &s : storage) paths.push_back(s.c_str());
+
+    for (size_t abandon = 0; abandon < 16; abandon++) {
+        FakeFs f;
+        Pass p = validatePass(paths, f, abandon);
+        CHECK(!p.complete);
+        CHECK_EQ(p.violations, 0);
+        CHECK_EQ(p.depth, 0);
+        // 每个目录两次 enter()：第 abandon 次失败前完成了 abandon / 2 个目录的标记
+        CHECK_EQ(f.listings, (abandon + 1) / 2);
+        CHECK_EQ(p.missing.size(), abandon / 2 * 5);
+    }
+    Pass full = validatePass(paths, fs);
+    CHECK(full.complete);
+    CHECK_EQ(full.missing.size(), paths.size());
+}
@@ -0,0 +1,129 @@
+// 缓存未命中时的目录扫描：FatScanner 直接读目录扇区 vs 按 FATFS 访问方式估算的 VFS 扫描。
+// 卷为碎片化的 FAT32 镜像（见 FatImage.h）：40 个专辑目录，每个 60 首 + 封面与歌词，另有两层嵌套目录。
+// VFS 一侧是模型而非实测：openNextFile() 对每个条目做 stat + open，两次都从根目录逐级线性查找路径，
+// 再加上 readdir 本身读到的目录扇区；FATFS 只有一个扇区窗口（FF_FS_TINY 之外每个文件另有缓冲，这里不计）。
+// SD 耗时按每扇区 0.25 ms 估算（SPI 单扇区读取的量级），只用来比较两者的量级。
+#include "Bench.h"
+#include "FatImage.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+static const char *const kExtensions[] = { ".mp3", ".m4a", ".aac", ".wav", ".flac" };
+static const double kMsPerSector = 0.25;
+
+// FATFS 的单扇区窗口：目录扇区与 FAT 扇区共用
+struct Window {
+    uint32_t sector = UINT32_MAX;
+    uint64_t reads = 0;
+    void access(uint32_t s) {
+        if (s != sector) {
+            sector = s;
+            reads++;
+        }
+    }
+};
+
+// 按槽位顺序访问目录 d 的 [0, last] 槽位；跨簇时先查 FAT
+static void walkSlots(fat::Image &img, Window &w, const fat::Image::Dir &d, uint32_t from, uint32_t last) {
+    uint32_t perCluster = img.options().sectorsPerCluster * fat::Image::kSector / 32;
+    for (uint32_t slot = from; slot <= last; slot++) {
+        if (slot && slot % perCluster == 0) {
+            uint32_t prev = d.chain[slot / perCluster - 1];
+            w.access(img.fatStart() + prev / (fat::Image::kSector / 4));
+        }
+        w.access(img.slotSector(d, slot));
+    }
+}
+
+// 从根目录逐级查找 dirs[target] 下的第 item 项（f_stat / f_open / f_opendir 的路径解析）
+static void resolve(fat::Image &img, Window &w, const std::vector<std::pair<int, int>> &chain) {
+    for (const auto &step : chain) {
+        const fat::Image::Dir &d = img.dirs[step.first];
+        walkSlots(img, w, d, 0, d.items[step.second].lastSlot);
+    }
+}
+
+// VFS 扫描 dirs[dir]（与 PlaylistManager 的 VFS 路径一致：遇到子目录立即进入）
+static void vfsScan(fat::Image &img, Window &w, std::vector<std::pair<int, int>> &chain, int dir, int levels) {
+    resolve(img, w, chain); // opendir
+    const fat::Image::Dir &d = img.dirs[dir];
+    uint32_t next = 0;
+    for (size_t i = 0; i < d.items.size(); i++) {
+        const fat::Image::Item &item = d.items[i];
+        walkSlots(img, w, d, next, item.lastSlot); // readdir
+        next = item.lastSlot + 1;
+        chain.push_back({ dir, (int)i });
+        resolve(img, w, chain); // stat
+        resolve(img, w, chain); // open
+        if (item.child >= 0 && levels > 0) vfsScan(img, w, chain, item.child, levels - 1);
+        chain.pop_back();
+    }
+}
+
+static void build(fat::Image &img, int albums) {
+    int music = img.mkdir(0, "音乐");
+    char name[96];
+    for (int a = 0; a < albums; a++) {
+        snprintf(name, sizeof(name), "专辑 %02d 经典儿歌合集", a);
+        int album = img.mkdir(music, name);
+        for (int t = 0; t < 60; t++) {
+            snprintf(name, sizeof(name), "%02d 第%d首 小星星 (Live Version).mp3", t, t);
+            img.file(album, name);
+        }
+        img.file(album, "cover.jpg");
+        img.file(album, "歌词.lrc");
+        if (a % 8 == 0) {
+            int disc = img.mkdir(album, "CD2");
+            for (int t = 0; t < 20; t++) {
+                snprintf(name, sizeof(name), "Disc 2 Track %02d.flac", t);
+                img.file(disc, name);
+            }
+        }
+    }
+    img.finish();
+}
+
+int main() {
+    const int albums = 40 * bench::scale();
+    fat::Image::Options o;
+    o.clusters = 70000 + albums * 100;
+    fat::Image img(o);
+    build(img, albums);
+
+    printf("%-24s %10s %10s %10s %12s\n", "scan", "tracks", "sectors", "reads", "est. SD ms");
+
+    FatScanner scanner(img, kExtensions, sizeof(kExtensions) / sizeof(kExtensions[0]));
+    if (!scanner.mount()) {
+        printf("mount failed\n");
+        return 1;
+    }
+    const int rounds = 20;
+    size_t tracks = 0;
+    uint32_t sectors = 0, calls = 0;
+    uint64_t t0 = bench::nowNs();
+    for (int r = 0; r < rounds; r++) {
+        tracks = 0;
+        uint32_t s0 = img.sectorsRead, c0 = img.readCalls;
+        bool ok = scanner.scan("/音乐", 3, [&](const char *, size_t) { tracks++; });
+        sectors = img.sectorsRead - s0;
+        calls = img.readCalls - c0;
+        if (!ok) {
+            printf("scan failed\n");
+            return 1;
+        }
+    }
+    uint64_t ns = (bench::nowNs() - t0) / rounds;
+    printf("%-24s %10zu %10u %10u %12.0f\n", "FatScanner", tracks, (unsigned)sectors, (unsigned)calls,
+           sectors * kMsPerSector);
+
+    Window w;
+    std::vector<std::pair<int, int>> chain = { { 0, 0 } }; // 根目录下的 "音乐"
+    vfsScan(img, w, chain, 1, 3);
+    printf("%-24s %10zu %10llu %10llu %12.0f\n", "VFS model", tracks, (unsigned long long)w.reads,
+           (unsigned long long)w.reads, w.reads * kMsPerSector);
+
+    printf("host CPU per raw scan: %.2f ms (%.0f tracks/s)\n", ns / 1e6, tracks * 1e9 / ns);
+    printf("sector reduction: %.1fx\n", (double)w.reads / sectors);
+    return 0;
+}
@@ -0,0 +1,260 @@
+// FatScanner：在规范构造的 FAT32 镜像上核对扫描结果（长文件名、8.3 大小写标志、碎片化的目录簇链、
+// MBR / 无分区），拒绝自相矛盾的 BPB，以及随机损坏镜像后的扫描必须终止且不越界
+#include "TestHarness.h"
+#include "FatImage.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+static const char *const kExts[] = { ".mp3", ".aac", ".m4a", ".flac", ".ogg", ".wav" };
+
+static std::vector<std::string> scan(fat::Image &img, const char *dir, uint8_t levels, bool *ok = nullptr) {
+    std::vector<std::string> out;
+    FatScanner fs(img, kExts, 6);
+    bool result = fs.mount() && fs.scan(dir, levels, [&](const char *p, size_t n) { out.emplace_back(p, n); });
+    if (ok) *ok = result;
+    return out;
+}
+
+static fat::Image::Options opts(uint32_t spc, bool mbr, bool fragment = true) {
+    fat::Image::Options o;
+    o.sectorsPerCluster = spc;
+    o.mbr = mbr;
+    o.fragment = fragment;
+    return o;
+}
+
+// 儿歌/ 下两层子目录 + 音乐/，各种名字；返回 scan("/儿歌", 1) 应得的路径（按扫描顺序）
+static std::vector<std::string> buildTree(fat::Image &img) {
+    int kids = img.mkdir(0, "儿歌");
+    int music = img.mkdir(0, "音乐");
+    img.file(music, "不在扫描范围.mp3");
+    img.file(kids, "小星星.mp3");
+    img.deleted(kids);
+    img.file(kids, "A very long English title that spans several LFN entries (live).flac");
+    img.file(kids, "😀 emoji.m4a");
+    img.file(kids, "cover.jpg");
+    img.file(kids, ".hidden.mp3");
+    img.shortFile(kids, "LOUD    MP3", 0x00);
+    img.shortFile(kids, "QUIET   WAV", 0x18);
+    img.file(kids, "Ünïcødé.OGG");
+    int sub = img.mkdir(kids, "第二层");
+    img.mkdir(kids, ".Trashes");
+    img.file(sub, "两只老虎.aac");
+    int deep = img.mkdir(sub, "第三层");
+    img.file(deep, "超出层数.mp3");
+    img.finish();
+    return { "/儿歌/小星星.mp3",
+             "/儿歌/A very long English title that spans several LFN entries (live).flac",
+             "/儿歌/😀 emoji.m4a",
+             "/儿歌/LOUD.MP3",
+             "/儿歌/quiet.wav",
+             "/儿歌/Ünïcødé.OGG",
+             "/儿歌/第二层/两只老虎.aac" };
+}
+
+TEST(scans_names_in_directory_order) {
+    for (bool mbr : { false, true }) {
+        for (uint32_t spc : { 1u, 8u, 64u }) {
+            fat::Image img(opts(spc, mbr));
+            std::vector<std::string> expect = buildTree(img);
+            bool ok = false;
+            CHECK(scan(img, "/儿歌", 1, &ok) == expect);
+            CHECK(ok);
+            // 尾部斜杠与 ASCII 大小写不影响；层数 2 时包含第三层
+            std::vector<std::string> deeper = scan(img, "/儿歌/", 2, &ok);
+            CHECK(ok);
+            CHECK_EQ(deeper.size(), expect.size() + 1);
+            CHECK_EQ(scan(img, "/音乐", 0).size(), 1u);
+        }
+    }
+}
+
+TEST(missing_directory_fails) {
+    fat::Image img(opts(8, false));
+    buildTree(img);
+    bool ok = true;
+    CHECK(scan(img, "/故事", 2, &ok).empty());
+    CHECK(!ok);
+    CHECK(scan(img, "/儿歌/小星星.mp3", 2, &ok).empty()); // 文件不是目录
+    CHECK(!ok);
+}
+
+TEST(ascii_names_resolve_case_insensitively) {
+    fat::Image img(opts(8, false));
+    int dir = img.mkdir(0, "Album One");
+    img.file(dir, "Track.MP3");
+    img.finish();
+    bool ok = false;
+    std::vector<std::string> out = scan(img, "/album ONE", 0, &ok);
+    CHECK(ok);
+    CHECK_EQ(out.size(), 1u);
+    if (!out.empty()) CHECK_EQ(out[0], std::string("/album ONE/Track.MP3")); // 前缀沿用调用方给的写法
+}
+
+// 一个目录横跨几十个分散的簇：全部找到，文件自身的簇一次也不读
+TEST(large_fragmented_directory_reads_only_directory_sectors) {
+    fat::Image img(opts(1, true));
+    int dir = img.mkdir(0, "故事");
+    std::vector<std::string> expect;
+    for (int i = 0; i < 800; i++) {
+        std::string name = "第" + std::to_string(i) + "集 小猪佩奇的一天.mp3";
+        img.file(dir, name);
+        expect.push_back("/故事/" + name);
+        if (i % 3 == 0) img.file(dir, "lyrics " + std::to_string(i) + ".lrc");
+    }
+    img.finish();
+    CHECK(img.dirs[dir].chain.size() > 100);
+
+    img.trackReads = true;
+    bool ok = false;
+    CHECK(scan(img, "/故事", 0, &ok) == expect);
+    CHECK(ok);
+    std::set<uint32_t> fileSectors;
+    for (uint32_t c : img.fileClusters) fileSectors.insert(img.clusterSector(c));
+    int touched = 0;
+    for (uint32_t s : img.readLog) touched += fileSectors.count(s);
+    CHECK_EQ(touched, 0);
+}
+
+// ---- BPB 校验：每种畸形都在 mount() 中拒绝 ----
+
+static bool mountPatched(void (*patch)(fat::Image &, uint8_t *)) {
+    fat::Image img(opts(8, false));
+    buildTree(img);
+    patch(img, img.sector(img.bootSector()));
+    FatScanner fs(img, kExts, 6);
+    return fs.mount();
+}
+
+TEST(rejects_malformed_bpb) {
+    using fat::Image;
+    CHECK(mountPatched([](Image &, uint8_t *) {})); // 对照：未修改时可挂载
+
+    // 保留区 + FAT 超出卷大小：数据区扇区数会下溢成巨大的簇数
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put16(b + 14, 0xFFFF); }));
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put32(b + 36, 0x80000000u); }));
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put32(b + 32, 1000); }));
+    // 簇数落在 FAT16 范围
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put32(b + 32, 32 + 2 * 547 + 60000 * 8); }));
+    // 簇数超出 FAT32 簇号范围（扇区数放大，簇大小改为 1）
+    CHECK(!mountPatched([](Image &, uint8_t *b) {
+        b[13] = 1;
+        Image::put32(b + 32, 0xFFFFFFF0u);
+        Image::put32(b + 36, 0x00400000u);
+    }));
+    // FAT 表装不下全部簇
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put32(b + 36, 100); }));
+    // 卷超出 32 位扇区号
+    CHECK(!mountPatched([](Image &, uint8_t *b) {
+        b[13] = 128;
+        Image::put32(b + 32, 0xFFFFFFFFu);
+    }));
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put16(b + 14, 0); }));                 // 无保留区
+    CHECK(!mountPatched([](Image &, uint8_t *b) { b[13] = 6; }));                                // 每簇扇区数非 2 的幂
+    CHECK(!mountPatched([](Image &, uint8_t *b) { b[16] = 0; }));                                // 没有 FAT
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put16(b + 11, 4096); }));              // 扇区大小
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put16(b + 17, 512); }));               // FAT16 根目录区
+    CHECK(!mountPatched([](Image &, uint8_t *b) { Image::put32(b + 44, 0x0FFFFFF0u); }));       // 根目录簇越界
+    CHECK(!mountPatched([](Image &, uint8_t *b) { b[510] = 0; }));                               // 签名
+}
+
+// 目录簇链指回自身：扫描失败返回，读取量受目录最大尺寸（2MB）限制
+TEST(cluster_chain_loop_terminates) {
+    fat::Image img(opts(1, false));
+    int dir = img.mkdir(0, "环");
+    for (int i = 0; i < 100; i++) img.file(dir, "歌曲" + std::to_string(i) + ".mp3");
+    img.finish();
+    const fat::Image::Dir &d = img.dirs[dir];
+    uint32_t last = d.chain.back();
+    fat::Image::put32(img.sector(img.fatStart() + last / 128) + (last % 128) * 4, d.chain[0]);
+    // 目录结束标记也抹掉，否则读到空条目就停了
+    memset(img.sector(img.slotSector(d, d.slots())), 0xE5, 512);
+
+    bool ok = true;
+    img.sectorsRead = 0;
+    scan(img, "/环", 0, &ok);
+    CHECK(!ok);
+    // 目录扇区最多 2MB，另加每个簇一次 FAT 扇区读取（簇链分散在不同 FAT 扇区）
+    CHECK(img.sectorsRead <= 2 * (65536 * 32 / 512) + 64);
+    printf("    looped chain: %u sectors read before giving up\n", (unsigned)img.sectorsRead);
+}
+
+// 子目录项指回祖先：每个目录只遍历一次，不重复报告曲目，也不会按层数指数展开
+TEST(directory_cycles_are_visited_once) {
+    fat::Image img(opts(8, false));
+    int top = img.mkdir(0, "top");
+    img.file(top, "a.mp3");
+    std::vector<int> loops;
+    for (int i = 0; i < 12; i++) loops.push_back(img.mkdir(top, "loop" + std::to_string(i)));
+    img.finish();
+    // 把 12 个子目录项都改成指向 top 自己
+    uint32_t topCluster = img.dirs[top].chain[0];
+    fat::Image::Dir &t = img.dirs[top];
+    for (const fat::Image::Item &item : t.items) {
+        if (item.child < 0) continue;
+        uint8_t *e = img.sector(img.slotSector(t, item.lastSlot)) + (item.lastSlot % 16) * 32;
+        fat::Image::put16(e + 20, topCluster >> 16);
+        fat::Image::put16(e + 26, topCluster & 0xFFFF);
+    }
+    bool ok = false;
+    img.sectorsRead = 0;
+    std::vector<std::string> out = scan(img, "/top", 8, &ok);
+    CHECK(ok);
+    CHECK_EQ(out.size(), 1u);
+    CHECK(img.sectorsRead < 100);
+}
+
+// 随机损坏：每轮在引导扇区、FAT 或目录扇区里改写若干字节后挂载并扫描 8 层。
+// 要求扫描终止、读取量有界、回调的路径以扫描目录开头且长度合理
+TEST(fuzzed_images_terminate_without_overreading) {
+    fat::Image base(opts(1, true));
+    int root = base.mkdir(0, "儿歌");
+    uint32_t seed = 99;
+    std::vector<int> dirs = { root };
+    for (int i = 0; i < 300; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int dir = dirs[(seed >> 8) % dirs.size()];
+        if (i % 25 == 0 && dirs.size() < 10) {
+            dirs.push_back(base.mkdir(dir, "子目录" + std::to_string(i)));
+        } else {
+            base.file(dir, "曲目 " + std::to_string(i) + (i % 4 ? ".mp3" : ".txt"));
+        }
+    }
+    base.finish();
+    std::vector<uint32_t> targets = base.writtenSectors();
+    std::sort(targets.begin(), targets.end());
+
+    const int rounds = 3000;
+    int mounted = 0, scanned = 0, bad = 0;
+    uint32_t maxRead = 0;
+    for (int r = 0; r < rounds; r++) {
+        fat::Image img = base;
+        int edits = 1 + r % 8;
+        for (int k = 0; k < edits; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            // 一半落在引导扇区 / MBR，其余落在写过的扇区（FAT 与目录）
+            uint32_t sector = (seed >> 7) % 2 ? (k % 2 ? 0 : img.bootSector()) : targets[(seed >> 9) % targets.size()];
+            seed = seed * 1664525u + 1013904223u;
+            uint8_t *p = img.sector(sector) + (seed >> 8) % 512;
+            seed = seed * 1664525u + 1013904223u;
+            *p = (seed >> 5) % 3 == 0 ? 0xFF : (uint8_t)(seed >> 13);
+        }
+        FatScanner fs(img, kExts, 6);
+        if (!fs.mount()) continue;
+        mounted++;
+        std::vector<std::string> out;
+        bool ok = fs.scan("/儿歌", 8, [&](const char *p, size_t n) { out.emplace_back(p, n); });
+        if (ok) scanned++;
+        for (const std::string &p : out) {
+            if (p.compare(0, 7, "/儿歌") != 0 || p.size() > 8 * 4 * 256) bad++;
+        }
+        maxRead = std::max(maxRead, img.sectorsRead);
+    }
+    printf("    %d rounds: %d mounted, %d scanned ok, max %u sectors read\n", rounds, mounted, scanned, (unsigned)maxRead);
+    CHECK_EQ(bad, 0);
+    CHECK(mounted > rounds / 4);
+    // 目录数有限（每个目录簇链最多 2MB），读取量不随损坏爆炸
+    CHECK(maxRead < 200000);
+}
@@ -0,0 +1,224 @@
+// GestureRecognizer / EdgeRing：回放带抖动的边沿序列，检查单击、连击、长按、快速轻点与队列溢出
+#include "TestHarness.h"
+#include "input/EdgeRing.h"
+#include "input/GestureRecognizer.h"
+#include <vector>
+
+struct Replay {
+    GestureRecognizer g;
+    std::vector<Gesture> out;
+
+    void edge(uint8_t button, bool pressed, uint32_t t) {
+        g.onEdge(button, pressed, t);
+        drain();
+    }
+    void tick(uint32_t t, const bool *levels = nullptr) {
+        g.tick(t, levels);
+        drain();
+    }
+    // 一次机械按键动作：先抖动 bounces 次（间隔 1~3 ms），最后落在 pressed
+    void bouncy(uint8_t button, bool pressed, uint32_t t, int bounces = 3) {
+        for (int i = 0; i < bounces; i++) {
+            edge(button, pressed, t);
+            edge(button, !pressed, t + 1);
+            t += 3;
+        }
+        edge(button, pressed, t);
+    }
+    void drain() {
+        Gesture e;
+        while (g.poll(e)) out.push_back(e);
+    }
+    size_t count(GestureType type) const {
+        size_t n = 0;
+        for (const Gesture &e : out) n += e.type == type;
+        return n;
+    }
+};
+
+TEST(clean_single_click) {
+    Replay r;
+    r.edge(0, true, 1000);
+    r.edge(0, false, 1120);
+    r.tick(1400);
+    CHECK(r.out.empty());
+    r.tick(1600);
+    CHECK_EQ(r.out.size(), 1u);
+    CHECK_EQ(r.out[0].type, GESTURE_CLICK);
+    CHECK_EQ(r.out[0].clicks, 1);
+}
+
+TEST(bouncing_contacts_give_one_click) {
+    Replay r;
+    r.bouncy(1, true, 1000);
+    r.bouncy(1, false, 1150);
+    r.tick(2000);
+    CHECK_EQ(r.out.size(), 1u);
+    CHECK_EQ(r.out[0].clicks, 1);
+    CHECK_EQ(r.out[0].button, 1);
+}
+
+TEST(bouncing_double_click) {
+    Replay r;
+    r.bouncy(0, true, 1000);
+    r.bouncy(0, false, 1100);
+    r.bouncy(0, true, 1250);
+    r.bouncy(0, false, 1350, 5);
+    r.tick(3000); // 主循环很晚才推进：判定仍按边沿时间
+    CHECK_EQ(r.out.size(), 1u);
+    CHECK_EQ(r.out[0].type, GESTURE_CLICK);
+    CHECK_EQ(r.out[0].clicks, 2);
+}
+
+// 短于去抖窗口的轻点被当作干扰忽略，按键不会卡在按下，之后的单击照常识别
+TEST(quick_tap_never_sticks_pressed) {
+    Replay r;
+    r.edge(0, true, 1000);
+    r.edge(0, false, 1030);
+    r.tick(2500);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 0u);
+    CHECK(!r.g.isPressed(0));
+
+    r.edge(0, true, 3000);
+    r.edge(0, false, 3100);
+    r.tick(3600);
+    CHECK_EQ(r.out.size(), 1u);
+    CHECK_EQ(r.out[0].type, GESTURE_CLICK);
+    CHECK_EQ(r.out[0].clicks, 1);
+}
+
+// 反复快速轻点（每次都短于窗口）同样不能累积成按下状态
+TEST(burst_of_quick_taps_is_ignored) {
+    Replay r;
+    for (uint32_t t = 1000; t < 1400; t += 40) {
+        r.edge(2, true, t);
+        r.edge(2, false, t + 20);
+    }
+    r.tick(4000);
+    CHECK(r.out.empty());
+    CHECK(!r.g.isPressed(2));
+}
+
+TEST(long_press_with_bouncy_release) {
+    Replay r;
+    r.bouncy(0, true, 1000);
+    r.tick(1500);
+    CHECK(r.out.empty());
+    r.tick(1810);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 1u);
+    r.bouncy(0, false, 2500, 6);
+    r.tick(4000);
+    CHECK_EQ(r.out.size(), 1u);
+}
+
+// 松开发生在长按阈值之前、但去抖尚未确认时推进时钟：不能误报长按
+TEST(release_pending_at_long_press_deadline) {
+    Replay r;
+    r.edge(0, true, 1000);
+    r.tick(1100);
+    r.edge(0, false, 1790);
+    r.tick(1805);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 0u);
+    r.tick(2500);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 0u);
+    CHECK_EQ(r.count(GESTURE_CLICK), 1u);
+}
+
+// 按住时的一次短暂抖动不打断长按
+TEST(glitch_while_held_keeps_long_press) {
+    Replay r;
+    r.edge(0, true, 1000);
+    r.edge(0, false, 1400);
+    r.edge(0, true, 1403);
+    r.tick(1850);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 1u);
+    CHECK_EQ(r.count(GESTURE_CLICK), 0u);
+}
+
+TEST(bouncy_chord) {
+    Replay r;
+    r.bouncy(0, true, 1000);
+    r.bouncy(2, true, 1060);
+    r.tick(3000);
+    r.bouncy(0, false, 3100);
+    r.bouncy(2, false, 3120);
+    r.tick(5000);
+    CHECK_EQ(r.out.size(), 1u);
+    CHECK_EQ(r.out[0].type, GESTURE_CHORD);
+    CHECK_EQ(r.out[0].buttons, (1 << 0) | (1 << 2));
+}
+
+TEST(ring_overflow_drops_oldest) {
+    EdgeRing<32> ring;
+    for (uint32_t i = 0; i < 40; i++) ring.push(0, i & 1, i);
+    ButtonEdge e;
+    std::vector<uint32_t> times;
+    while (ring.pop(e)) times.push_back(e.timeMs);
+    CHECK_EQ(times.size(), 32u);
+    CHECK_EQ(times.front(), 8u);
+    CHECK_EQ(times.back(), 39u);
+    CHECK_EQ(ring.dropped(), 8u);
+
+    ring.push(1, true, 100);
+    CHECK(ring.pop(e));
+    CHECK_EQ(e.timeMs, 100u);
+    CHECK(!ring.pop(e));
+}
+
+// 主循环阻塞期间一串带抖动的点击溢出队列：保留下来的最新边沿以松开结束，不会误报长按
+TEST(overflowed_ring_replays_to_released) {
+    EdgeRing<32> ring;
+    uint32_t t = 1000;
+    for (int click = 0; click < 5; click++) {
+        for (int i = 0; i < 4; i++) {
+            ring.push(0, true, t);
+            ring.push(0, false, t + 1);
+            t += 2;
+        }
+        ring.push(0, true, t);
+        for (int i = 0; i < 4; i++) {
+            ring.push(0, false, t + 80);
+            ring.push(0, true, t + 81);
+            t += 2;
+        }
+        ring.push(0, false, t + 80);
+        t += 200;
+    }
+    CHECK(ring.dropped() == 0); // 尚未读取时不计
+
+    Replay r;
+    ButtonEdge e;
+    while (ring.pop(e)) r.edge(e.button, e.pressed, e.timeMs);
+    CHECK(ring.dropped() > 0);
+    bool released[GestureRecognizer::kMaxButtons] = {};
+    r.tick(t + 3000, released);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 0u);
+    CHECK(!r.g.isPressed(0));
+}
+
+// 松开的边沿整个丢失：到期复核实际电平后补上松开
+TEST(lost_release_is_recovered_from_level) {
+    Replay r;
+    bool pressed[GestureRecognizer::kMaxButtons] = { true };
+    bool released[GestureRecognizer::kMaxButtons] = {};
+    r.edge(0, true, 1000);
+    r.tick(1060, pressed);
+    CHECK(r.g.isPressed(0));
+    r.tick(1100, released);
+    r.tick(1160, released);
+    CHECK(!r.g.isPressed(0));
+    r.tick(2500, released);
+    CHECK_EQ(r.count(GESTURE_LONG_PRESS), 0u);
+    CHECK_EQ(r.count(GESTURE_CLICK), 1u);
+}
+
+// 按下后的边沿丢失、到期时实际已松开：复核不符，放弃这次按下
+TEST(level_check_cancels_unconfirmed_press) {
+    Replay r;
+    bool released[GestureRecognizer::kMaxButtons] = {};
+    r.edge(0, true, 1000);
+    r.tick(1060, released);
+    CHECK(!r.g.isPressed(0));
+    r.tick(3000, released);
+    CHECK(r.out.empty());
+}
@@ -0,0 +1,163 @@
+// HandoffState：编解码往返、损坏 / 截断 / 清零的识别、版本规则（更高版本在负载末尾追加的字段被忽略），
+// 以及字节级格式快照
+#include "TestHarness.h"
+#include "power/HandoffState.h"
+#include "util/Crc32.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+static HandoffState sample() {
+    HandoffState s;
+    s.mode = 3;
+    s.volume = 17;
+    s.flags = HandoffState::FLAG_PAUSED;
+    s.manifestHash = 0x1122334455667788ull;
+    s.trackId = 0xdeadbeefcafef00dull;
+    s.filePos = 1234567;
+    s.seconds = 321;
+    s.shuffleSeed = 0x9abcdef0;
+    s.historySkip = 7;
+    s.setPath("/故事/西游记/第01回.mp3");
+    return s;
+}
+
+static bool same(const HandoffState &a, const HandoffState &b) {
+    return a.mode == b.mode && a.volume == b.volume && a.flags == b.flags && a.manifestHash == b.manifestHash &&
+           a.trackId == b.trackId && a.filePos == b.filePos && a.seconds == b.seconds && a.shuffleSeed == b.shuffleSeed &&
+           a.historySkip == b.historySkip && strcmp(a.path, b.path) == 0;
+}
+
+// 改动头部或负载后重算 CRC：模拟另一版本固件合法写入的数据
+static void refreshCrc(uint8_t *buf) {
+    uint16_t len = buf[6] | buf[7] << 8;
+    uint32_t c = crc32(buf + 12, len, crc32(buf + 4, 4));
+    for (int i = 0; i < 4; i++) buf[8 + i] = (uint8_t)(c >> (8 * i));
+}
+
+struct Encoded {
+    uint8_t buf[HandoffState::kMaxSize + 64];
+    size_t size;
+
+    explicit Encoded(const HandoffState &s) { size = s.encode(buf, sizeof(buf)); }
+};
+
+TEST(round_trip) {
+    HandoffState s = sample(), d;
+    Encoded e(s);
+    CHECK_EQ(e.size, HandoffState::kHeaderSize + HandoffState::kFixedSize + strlen(s.path));
+    CHECK_EQ(d.decode(e.buf, e.size), HandoffState::OK);
+    CHECK(same(s, d));
+    // 存放区比数据大（RTC 缓冲固定长度）
+    CHECK_EQ(d.decode(e.buf, sizeof(e.buf)), HandoffState::OK);
+    CHECK(same(s, d));
+    // 空间不足
+    CHECK_EQ(s.encode(e.buf, e.size - 1), 0u);
+
+    HandoffState m = sample();
+    m.mode = -1;
+    Encoded em(m);
+    CHECK_EQ(d.decode(em.buf, em.size), HandoffState::OK);
+    CHECK_EQ(d.mode, -1);
+}
+
+TEST(cleared_truncated_and_flipped_data_is_rejected) {
+    HandoffState d;
+    std::vector<uint8_t> zero(HandoffState::kMaxSize, 0);
+    CHECK_EQ(d.decode(zero.data(), zero.size()), HandoffState::EMPTY);
+    CHECK_EQ(d.mode, -1);
+
+    Encoded e(sample());
+    CHECK_EQ(d.decode(e.buf, 8), HandoffState::EMPTY);
+    int accepted = 0;
+    for (size_t k = 0; k < e.size; k++) accepted += d.decode(e.buf, k) == HandoffState::OK;
+    CHECK_EQ(accepted, 0);
+
+    // 每一位翻转都被拒绝（魔数位为 EMPTY，其余为 CORRUPT / UNSUPPORTED）
+    for (size_t i = 0; i < e.size * 8; i++) {
+        Encoded t = e;
+        t.buf[i / 8] ^= 1 << (i % 8);
+        accepted += d.decode(t.buf, t.size) == HandoffState::OK;
+    }
+    CHECK_EQ(accepted, 0);
+}
+
+// 版本规则：0 无效；更高版本在负载末尾追加字段，本固件按自己认识的部分解码
+TEST(versioning) {
+    HandoffState s = sample(), d;
+    Encoded e(s);
+
+    Encoded v0 = e;
+    v0.buf[4] = 0;
+    refreshCrc(v0.buf);
+    CHECK_EQ(d.decode(v0.buf, v0.size), HandoffState::UNSUPPORTED);
+
+    Encoded v2 = e;
+    v2.buf[4] = 2;
+    uint16_t len = (v2.buf[6] | v2.buf[7] << 8) + 16;
+    memset(v2.buf + v2.size, 0xA5, 16);
+    v2.buf[6] = (uint8_t)len;
+    v2.buf[7] = (uint8_t)(len >> 8);
+    refreshCrc(v2.buf);
+    CHECK_EQ(d.decode(v2.buf, v2.size + 16), HandoffState::OK);
+    CHECK(same(s, d));
+    CHECK_EQ(d.decode(v2.buf, v2.size + 15), HandoffState::CORRUPT); // 声明的长度超出数据
+}
+
+TEST(inconsistent_lengths_are_corrupt) {
+    HandoffState d;
+    Encoded e(sample());
+
+    Encoded path = e;
+    path.buf[HandoffState::kHeaderSize + 3] = 255; // 路径长度超出负载
+    refreshCrc(path.buf);
+    CHECK_EQ(d.decode(path.buf, path.size), HandoffState::CORRUPT);
+
+    Encoded shortPayload = e;
+    shortPayload.buf[6] = HandoffState::kFixedSize - 1; // 负载短于固定字段
+    shortPayload.buf[7] = 0;
+    refreshCrc(shortPayload.buf);
+    CHECK_EQ(d.decode(shortPayload.buf, shortPayload.size), HandoffState::CORRUPT);
+}
+
+// 最长路径可存；过长的路径存为空，回来后按 trackId 选曲
+TEST(path_limits) {
+    HandoffState s = sample(), d;
+    std::string p(HandoffState::kMaxPath, 'a');
+    s.setPath(p.c_str());
+    Encoded full(s);
+    CHECK_EQ(full.size, (size_t)HandoffState::kMaxSize);
+    CHECK_EQ(d.decode(full.buf, full.size), HandoffState::OK);
+    CHECK(same(s, d));
+
+    s.setPath((p + "b").c_str());
+    CHECK_EQ(s.path[0], '\0');
+    Encoded empty(s);
+    CHECK_EQ(d.decode(empty.buf, empty.size), HandoffState::OK);
+    CHECK_EQ(d.path[0], '\0');
+    CHECK_EQ(d.trackId, s.trackId);
+    s.setPath(nullptr);
+    CHECK_EQ(s.path[0], '\0');
+}
+
+// 字节级快照：字段顺序或宽度被无意改动时失败（改格式须提升版本号或更换魔数）
+TEST(format_snapshot) {
+    HandoffState f;
+    f.mode = 1;
+    f.volume = 2;
+    f.flags = 3;
+    f.manifestHash = 4;
+    f.trackId = 5;
+    f.filePos = 6;
+    f.seconds = 7;
+    f.shuffleSeed = 8;
+    f.historySkip = 9;
+    f.setPath("/a");
+    Encoded e(f);
+    CHECK_EQ(e.size, 50u);
+    const uint8_t header[] = { 'H', 'O', 'F', 'F', 1, 0, 38, 0 };
+    CHECK(memcmp(e.buf, header, sizeof(header)) == 0);
+    const uint8_t payload[] = { 1, 2, 3, 2, 4, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 0,
+                                7, 0, 0, 0, 8, 0, 0, 0, 9, 0, 0, 0, '/', 'a' };
+    CHECK(memcmp(e.buf + HandoffState::kHeaderSize, payload, sizeof(payload)) == 0);
+}
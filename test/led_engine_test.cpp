@@ -0,0 +1,124 @@
+// LedEngine：用虚拟时钟逐帧推进，检查关键帧插值、缓动、图层叠加与循环次数
+#include "TestHarness.h"
+#include "LedEngine.h"
+#include <stdlib.h>
+
+static const LedColor kBlack = { 0, 0, 0 };
+static const LedColor kRed = { 255, 0, 0 };
+static const LedColor kGreen = { 0, 255, 0 };
+static const LedColor kBlue = { 0, 0, 255 };
+
+// 与 main.cpp 中的彩虹底色相同：12.75 s 一圈
+static const LedKeyframe kRainbow[] = {
+    { 0, kRed, 255, LED_EASE_LINEAR },
+    { 4250, kGreen, 255, LED_EASE_LINEAR },
+    { 8500, kBlue, 255, LED_EASE_LINEAR },
+    { 12750, kRed, 255, LED_EASE_LINEAR },
+};
+
+static bool near(LedColor c, int r, int g, int b, int tol = 2) {
+    return abs(c.r - r) <= tol && abs(c.g - g) <= tol && abs(c.b - b) <= tol;
+}
+
+TEST(idle_engine_is_black) {
+    LedEngine led;
+    CHECK(led.render(0) == kBlack);
+    CHECK(led.render(123456) == kBlack);
+}
+
+TEST(rainbow_interpolates_linearly_and_loops) {
+    LedEngine led;
+    led.play(LED_LAYER_BASE, kRainbow, 4, 0, 1000);
+    CHECK(led.render(1000) == kRed);
+    CHECK(near(led.render(1000 + 2125), 127, 127, 0));
+    CHECK(near(led.render(1000 + 4250), 0, 255, 0));
+    CHECK(near(led.render(1000 + 8500 + 1062), 63, 0, 191));
+    // 第 100 圈的同一相位颜色相同
+    CHECK(led.render(1000 + 2125) == led.render(1000 + 2125 + 100 * 12750));
+    CHECK(led.isActive(LED_LAYER_BASE));
+}
+
+// 每 30 ms 一帧（LED 任务的帧率）走完一圈：相邻帧颜色变化平滑，不跳变
+TEST(rainbow_is_smooth_at_task_frame_rate) {
+    LedEngine led;
+    led.play(LED_LAYER_BASE, kRainbow, 4, 0, 0);
+    LedColor prev = led.render(0);
+    int maxStep = 0;
+    for (uint32_t t = 30; t <= 2 * 12750; t += 30) {
+        LedColor c = led.render(t);
+        int step = abs(c.r - prev.r) + abs(c.g - prev.g) + abs(c.b - prev.b);
+        if (step > maxStep) maxStep = step;
+        prev = c;
+    }
+    CHECK(maxStep <= 6);
+}
+
+TEST(blink_sits_on_top_of_base_and_expires) {
+    LedEngine led;
+    led.play(LED_LAYER_BASE, kRainbow, 4, 0, 0);
+    led.blink(LED_LAYER_NOTIFY, 2, kBlue, 5000);
+
+    CHECK(led.render(5000) == kBlue);
+    CHECK(led.render(5099) == kBlue);
+    CHECK(led.render(5100) == kBlack); // 灭灯阶段遮住底色
+    CHECK(led.render(5199) == kBlack);
+    CHECK(led.render(5200) == kBlue);  // 第二次
+    CHECK(led.render(5350) == kBlack);
+    CHECK(led.isActive(LED_LAYER_NOTIFY));
+    // 两次结束后露出底色
+    CHECK(led.render(5400) == led.render(5400 + 12750));
+    CHECK(!led.isActive(LED_LAYER_NOTIFY));
+    CHECK(led.render(5400) != kBlack);
+}
+
+TEST(step_holds_until_keyframe) {
+    LedEngine led;
+    const LedKeyframe frames[] = {
+        { 0, kRed, 255, LED_EASE_STEP },
+        { 100, kGreen, 255, LED_EASE_STEP },
+        { 200, kGreen, 255, LED_EASE_STEP },
+    };
+    led.play(LED_LAYER_BASE, frames, 3, 1, 0);
+    CHECK(led.render(99) == kRed);
+    CHECK(led.render(100) == kGreen);
+    CHECK(led.render(199) == kGreen);
+    led.render(200);
+    CHECK(!led.isActive(LED_LAYER_BASE));
+}
+
+TEST(smoothstep_eases_in_and_out) {
+    LedEngine linear, eased;
+    const LedKeyframe a[] = { { 0, kBlack, 255, LED_EASE_LINEAR }, { 1000, { 255, 255, 255 }, 255, LED_EASE_LINEAR } };
+    const LedKeyframe b[] = { { 0, kBlack, 255, LED_EASE_IN_OUT }, { 1000, { 255, 255, 255 }, 255, LED_EASE_IN_OUT } };
+    linear.play(LED_LAYER_BASE, a, 2, 0, 0);
+    eased.play(LED_LAYER_BASE, b, 2, 0, 0);
+    CHECK(eased.render(100).r < linear.render(100).r);
+    CHECK(near(eased.render(500), 127, 127, 127));
+    CHECK(eased.render(900).r > linear.render(900).r);
+}
+
+TEST(partial_alpha_blends_layers) {
+    LedEngine led;
+    const LedKeyframe base[] = { { 0, kRed, 255, LED_EASE_STEP } };
+    const LedKeyframe half[] = { { 0, kBlue, 128, LED_EASE_STEP } };
+    led.play(LED_LAYER_BASE, base, 1, 0, 0);
+    led.play(LED_LAYER_NOTIFY, half, 1, 0, 0);
+    CHECK(near(led.render(10), 127, 0, 128));
+    led.stop(LED_LAYER_NOTIFY);
+    CHECK(led.render(10) == kRed);
+}
+
+// millis() 回绕与尚未开始的时间轴
+TEST(clock_wraparound_and_future_start) {
+    LedEngine led;
+    uint32_t start = 0xFFFFFF00u;
+    led.blink(LED_LAYER_NOTIFY, 1, kGreen, start);
+    CHECK(led.render(start + 50) == kGreen);
+    CHECK(led.render(start + 150) == kBlack); // 已跨过 0
+    CHECK(led.isActive(LED_LAYER_NOTIFY));
+    led.render(start + 200);
+    CHECK(!led.isActive(LED_LAYER_NOTIFY));
+
+    led.play(LED_LAYER_BASE, kRainbow, 4, 0, 5000);
+    CHECK(led.render(4000) == kRed);
+}
@@ -0,0 +1,121 @@
+// ModeManifest：段与键的解析、路径校验、注释与引号、电台模式、全局键
+#include "TestHarness.h"
+#include "ModeManifest.h"
+#include <string.h>
+#include <string>
+
+static bool parse(ModeManifest &m, const std::string &text) {
+    return m.parse(text.data(), text.size());
+}
+
+static bool hasError(const ModeManifest &m, const char *needle) {
+    for (const std::string &e : m.errors()) {
+        if (e.find(needle) != std::string::npos) return true;
+    }
+    return false;
+}
+
+TEST(sections_keys_and_defaults) {
+    ModeManifest m;
+    CHECK(parse(m, "# 注释\n[故事]\npath = /故事/\nshuffle = sequential\ndsp = slow\ndepth = 3\n\n[英语]\n"
+                   "shuffle = album ; 行尾注释\ndsp = 0.9\n"));
+    CHECK_EQ(m.modes().size(), 2u);
+    const ModeConfig &a = m.modes()[0];
+    CHECK(a.name == "故事");
+    CHECK(a.path == "/故事"); // 去掉末尾斜杠
+    CHECK_EQ(a.shuffle, SHUFFLE_SEQUENTIAL);
+    CHECK(a.speed == 0.8f);
+    CHECK_EQ(a.depth, 3);
+    const ModeConfig &b = m.modes()[1];
+    CHECK(b.path == "/英语"); // 缺省为 "/" + 名称
+    CHECK_EQ(b.shuffle, SHUFFLE_ALBUM);
+    CHECK(b.speed == 0.9f);
+    CHECK_EQ(b.depth, 2);
+    CHECK(m.errors().empty());
+}
+
+// 空段名的缺省路径是 "/"，会扫描整张卡：整段忽略，其下的键也不会落到别的模式上
+TEST(empty_section_name_is_rejected) {
+    ModeManifest m;
+    CHECK(parse(m, "[ ]\npath = /x\n[]\n[音乐]\n"));
+    CHECK_EQ(m.modes().size(), 1u);
+    CHECK(m.modes()[0].path == "/音乐");
+    CHECK(hasError(m, "line 1: empty mode name"));
+    CHECK(hasError(m, "line 3: bad section header"));
+
+    ModeManifest only;
+    CHECK(!parse(only, "[\t]\n"));
+    CHECK(only.modes().empty());
+}
+
+TEST(bad_paths_and_values_are_reported) {
+    ModeManifest m;
+    CHECK(parse(m, "[a]\npath = relative\n[b]\npath = /b\n[c]\npath = /b/\n[d]\ndepth = 9\nshuffle = loud\ndsp = 3\n"
+                   "colour = red\n"));
+    CHECK_EQ(m.modes().size(), 2u);
+    CHECK(m.modes()[0].path == "/b");
+    CHECK(m.modes()[1].path == "/d");
+    CHECK_EQ(m.modes()[1].depth, 2);
+    CHECK(hasError(m, "path must start with '/'"));
+    CHECK(hasError(m, "duplicate path: /b"));
+    CHECK(hasError(m, "invalid depth"));
+    CHECK(hasError(m, "invalid shuffle"));
+    CHECK(hasError(m, "invalid dsp"));
+    CHECK(hasError(m, "invalid colour"));
+}
+
+// # 与 ; 在引号外开始注释：不加引号的路径在此截断，加引号则原样保留
+TEST(comment_characters_need_quotes_in_paths) {
+    ModeManifest m;
+    CHECK(parse(m, "[a]\npath = /C# 入门\n[b]\npath = \"/C# 入门\"\n[c]\npath = \"/x;y\" ; 注释\n"));
+    CHECK_EQ(m.modes().size(), 3u);
+    CHECK(m.modes()[0].path == "/C");
+    CHECK(m.modes()[1].path == "/C# 入门");
+    CHECK(m.modes()[2].path == "/x;y");
+}
+
+TEST(stream_modes_and_globals) {
+    const char *text = "\xEF\xBB\xBFwifi_ssid = \"my#wifi\" ; c\nwifi_password = \"a;b\"\n[故事]\n[电台]\n"
+                       "stream = http://x:8000/a.mp3 # c\nstream = HTTP://y/b\nstream = https://z/c\n"
+                       "[坏]\npath = /a\nstream = http://q/\nwifi_ssid = late\n";
+    ModeManifest m;
+    CHECK(m.parse(text, strlen(text)));
+    CHECK(m.wifiSsid() == "my#wifi");
+    CHECK(m.wifiPassword() == "a;b");
+    CHECK(m.hasStreams());
+    CHECK_EQ(m.modes().size(), 2u);
+    const ModeConfig &radio = m.modes()[1];
+    CHECK(radio.isStream());
+    CHECK(radio.path.empty());
+    CHECK_EQ(radio.streams.size(), 2u);
+    CHECK(radio.streams[0] == "http://x:8000/a.mp3");
+    CHECK(hasError(m, "invalid stream: https://z/c"));
+    CHECK(hasError(m, "stream mode cannot have a path"));
+    CHECK(hasError(m, "invalid wifi_ssid: late")); // 全局键只能写在第一个段之前
+}
+
+TEST(mode_count_is_capped) {
+    std::string text;
+    for (int i = 0; i < 20; i++) text += "[m" + std::to_string(i) + "]\n";
+    ModeManifest m;
+    CHECK(parse(m, text));
+    CHECK_EQ(m.modes().size(), ModeManifest::kMaxModes + 0);
+    CHECK(hasError(m, "too many modes"));
+}
+
+// 哈希只取决于原始字节：任何改动（包括注释）都让旧缓存失效
+TEST(hash_tracks_the_raw_bytes) {
+    ModeManifest a, b, c;
+    parse(a, "[a]\n");
+    parse(b, "[a]\n");
+    parse(c, "[a]\n# x\n");
+    CHECK_EQ(a.hash(), b.hash());
+    CHECK(a.hash() != c.hash());
+    CHECK(a.hash() != 0);
+
+    ModeManifest d;
+    d.loadDefaults({ "/故事", "/音乐" });
+    CHECK_EQ(d.hash(), 0u);
+    CHECK_EQ(d.modes().size(), 2u);
+    CHECK(d.modes()[1].name == "音乐");
+}
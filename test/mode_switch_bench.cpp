@@ -0,0 +1,118 @@
+// 连续 100 次模式切换：旧实现（每条路径一个堆字符串，clear() 逐个释放后 reserve(1000)）
+// 与 arena（discard() 一步回收，块留给下一个模式复用）的耗时与堆碎片。
+// 碎片以每次切换的堆分配 + 释放次数衡量：ESP32 内部 RAM 的碎片来自大量小块与其他子系统
+// 长期存活的分配交错释放（这里每 256 条路径插入一个不释放的小块模拟）。主机 glibc 的空闲字节统计
+// 受子进程继承的堆状态影响太大，不作为指标。每种实现在单独的子进程中运行，堆互不影响。
+#include "Bench.h"
+#include "playlist/TrackTable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static size_t g_heapOps = 0;
+
+void *operator new(size_t n) {
+    g_heapOps++;
+    void *p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void *p) noexcept {
+    if (p) g_heapOps++;
+    free(p);
+}
+void operator delete(void *p, size_t) noexcept {
+    if (p) g_heapOps++;
+    free(p);
+}
+
+static std::vector<std::vector<std::string>> makeModes() {
+    std::vector<std::vector<std::string>> modes;
+    char buf[128];
+    for (size_t m = 0; m < 5; m++) {
+        std::vector<std::string> paths;
+        size_t n = 1000 * (1 + m % 3) + m * 137;
+        for (size_t i = 0; i < n; i++) {
+            snprintf(buf, sizeof(buf), "/mode%zu/album_%03zu/%05zu %s.mp3", m, i / 120, i,
+                     i % 3 ? "chapter title" : "a somewhat longer chapter title");
+            paths.push_back(buf);
+        }
+        modes.push_back(paths);
+    }
+    return modes;
+}
+
+static void report(const char *name, uint64_t ns, int switches, size_t ops, const char *extra) {
+    printf("%-18s %10.2f %12.1f %12.1f %s\n", name, ns / 1e6, ns / 1e3 / switches, (double)ops / switches, extra);
+}
+
+// 旧实现：std::vector<String>，路径各自在堆上
+static void runStrings(const std::vector<std::vector<std::string>> &modes, int switches, bool) {
+    std::vector<void *> pinned;
+    std::vector<std::string> playlist;
+    size_t ops = g_heapOps;
+    uint64_t t0 = bench::nowNs();
+    for (int k = 0; k < switches; k++) {
+        const std::vector<std::string> &mode = modes[k % modes.size()];
+        playlist.clear();
+        playlist.reserve(1000);
+        for (const std::string &p : mode) {
+            playlist.push_back(std::string(p.data(), p.size()));
+            if (playlist.size() % 256 == 0) pinned.push_back(malloc(48));
+        }
+    }
+    uint64_t ns = bench::nowNs() - t0;
+    bench::keep(playlist);
+    report("vector<String>", ns, switches, g_heapOps - ops, "");
+}
+
+// arena：同一个 TrackTable 反复 discard() 后重建；withIndex 时另含路径索引与重复检测。
+// arena 的块直接 malloc，按容量增长折算成次数
+static void runArena(const std::vector<std::vector<std::string>> &modes, int switches, bool withIndex) {
+    std::vector<void *> pinned;
+    TrackTable t;
+    size_t ops = g_heapOps;
+    uint64_t t0 = bench::nowNs();
+    for (int k = 0; k < switches; k++) {
+        const std::vector<std::string> &mode = modes[k % modes.size()];
+        t.discard();
+        for (const std::string &p : mode) {
+            t.add(p.data(), p.size());
+            if (t.playlist.size() % 256 == 0) pinned.push_back(malloc(48));
+        }
+        if (withIndex) t.buildIndex();
+    }
+    uint64_t ns = bench::nowNs() - t0;
+    size_t chunks = (t.arena.capacity() + 32 * 1024 - 1) / (32 * 1024);
+    char extra[48];
+    snprintf(extra, sizeof(extra), "(arena %zu KB)", t.arena.capacity() / 1024);
+    report(withIndex ? "arena + index" : "arena", ns, switches, g_heapOps - ops + chunks, extra);
+}
+
+int main() {
+    const int switches = 100 * bench::scale();
+    std::vector<std::vector<std::string>> modes = makeModes();
+
+    printf("%-18s %10s %12s %12s\n", "implementation", "ms total", "us/switch", "heap ops/sw");
+    fflush(stdout);
+    struct Run {
+        void (*fn)(const std::vector<std::vector<std::string>> &, int, bool);
+        bool withIndex;
+    } runs[] = { { runStrings, false }, { runArena, false }, { runArena, true } };
+    for (const Run &r : runs) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            r.fn(modes, switches, r.withIndex);
+            fflush(stdout);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// 模式切换延迟：真实的 PlaylistManager::setMode() 跑在 SD 替身上，四个模式 500 ~ 4000 首。
+// "重建"：memoryCap 只够当前模式，每次切换都淘汰其余模式并从缓存重建（读缓存 + 校验 + 建索引 + 加载检索索引 + 打乱）；
+// "常驻"：全部常驻，setMode() 只交换指针并恢复该模式的播放位置，不读卡。
+// 两栏都不含设备上切换模式时写 NVS 的耗时（主机替身只存内存）。
+// 主机上文件在页缓存里，"重建"一栏不含 SD 读取；按表中每次读取的字节数与卡的读速可估算设备耗时。
+#include "Bench.h"
+#include "TempDir.h"
+#include "PlaylistManager.h"
+#include <SD.h>
+#include <stdio.h>
+#include <string>
+
+static void settle(PlaylistManager &pm) {
+    for (int i = 0; i < 10000 && !pm.isValidated(); i++) delay(1);
+}
+
+int main() {
+    const size_t sizes[4] = { 500, 1500, 4000, 2500 };
+    TempDir dir;
+    char buf[96];
+    for (int m = 0; m < 4; m++) {
+        for (size_t i = 0; i < sizes[m]; i++) {
+            snprintf(buf, sizeof(buf), "/mode%d/album_%03zu/%05zu chapter title.mp3", m, i / 100, i);
+            dir.write(buf, {});
+        }
+    }
+    SD.setRoot(dir.path());
+
+    // 校验任务持有管理器指针，有意不释放
+    PlaylistManager &pm = *new PlaylistManager;
+    for (int m = 0; m < 4; m++) {
+        ModeConfig c;
+        c.name = "mode" + std::to_string(m);
+        c.path = "/mode" + std::to_string(m);
+        pm.addMode(c);
+    }
+    // 首次构建：扫描并写出缓存与检索索引
+    pm.memoryCap = SIZE_MAX;
+    for (int m = 0; m < 4; m++) {
+        pm.setMode(m);
+        settle(pm);
+    }
+
+    printf("%-26s %12s %14s %10s\n", "mode switch", "us/switch", "KB read/switch", "resident");
+
+    // 只容得下当前模式：每次切换都从缓存重建；校验在计时之外跑完，避免与下一次切换争锁
+    {
+        const int switches = 40 * bench::scale();
+        pm.memoryCap = 1;
+        uint64_t ns = 0;
+        size_t reads = SD.stats.bytesRead;
+        for (int k = 0; k < switches; k++) {
+            uint64_t t0 = bench::nowNs();
+            pm.setMode(k % 4);
+            ns += bench::nowNs() - t0;
+            settle(pm);
+        }
+        size_t read = SD.stats.bytesRead - reads;
+        printf("%-26s %12.1f %14.1f %10zu\n", "rebuild from cache", ns / 1e3 / switches, read / 1024.0 / switches,
+               pm.residentBytes());
+    }
+
+    // 全部常驻：切换只换指针，并恢复各自的位置（每次切回播放一首）
+    {
+        const int switches = 2000 * bench::scale();
+        pm.memoryCap = SIZE_MAX;
+        for (int m = 0; m < 4; m++) {
+            pm.setMode(m);
+            settle(pm);
+        }
+        uint64_t ns = 0;
+        size_t reads = SD.stats.bytesRead;
+        size_t played = 0;
+        for (int k = 0; k < switches; k++) {
+            uint64_t t0 = bench::nowNs();
+            pm.setMode(k % 4);
+            ns += bench::nowNs() - t0;
+            played += pm.getCurrentIndex();
+        }
+        bench::keep(played);
+        size_t read = SD.stats.bytesRead - reads;
+        printf("%-26s %12.1f %14.1f %10zu\n", "resident setMode", ns / 1e3 / switches, read / 1024.0 / switches,
+               pm.residentBytes());
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+// 播放顺序策略在 1 万首列表上的生成耗时（每种策略取多次平均），以及播放统计表的记录与查询
+#include "Bench.h"
+#include "playlist/OrderPolicy.h"
+#include "playlist/PlayCountTable.h"
+#include "util/PathHash.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+int main() {
+    const size_t tracks = 10000 * bench::scale();
+    std::vector<std::string> storage;
+    char buf[96];
+    for (size_t i = 0; i < tracks; i++) {
+        snprintf(buf, sizeof(buf), "/古诗/第%zu册/%zu 静夜思 %zu.mp3", i / 40, i % 40, i);
+        storage.push_back(buf);
+    }
+    std::vector<const char *> paths;
+    for (const std::string &s : storage) paths.push_back(s.c_str());
+
+    PlayCountTable stats;
+    uint64_t t0 = bench::nowNs();
+    for (size_t i = 0; i < tracks; i++) stats.notePlayed(pathHash(paths[(i * 7919) % tracks]));
+    uint64_t noteNs = bench::nowNs() - t0;
+
+    printf("%-12s %10s\n", "policy", "ms/build");
+    struct Case {
+        const char *name;
+        ShufflePolicy type;
+    } cases[] = { { "random", SHUFFLE_RANDOM }, { "sequential", SHUFFLE_SEQUENTIAL }, { "album", SHUFFLE_ALBUM },
+                  { "weighted", SHUFFLE_WEIGHTED } };
+    const int rounds = 10;
+    for (const Case &c : cases) {
+        std::vector<uint32_t> ids(tracks);
+        uint64_t total = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (uint32_t i = 0; i < tracks; i++) ids[i] = i;
+            OrderContext ctx = { paths.data(), &stats, (uint32_t)r };
+            t0 = bench::nowNs();
+            OrderPolicy::forType(c.type).build(ids.data(), ids.size(), ctx);
+            total += bench::nowNs() - t0;
+        }
+        bench::keep(ids);
+        printf("%-12s %10.2f\n", c.name, total / 1e6 / rounds);
+    }
+    printf("play table: %zu entries, %.0f ns/notePlayed, %zu bytes serialized\n", stats.size(),
+           (double)noteNs / tracks, stats.serializedSize());
+    return 0;
+}
@@ -0,0 +1,197 @@
+// 播放顺序策略：自然排序、专辑分组（含嵌套目录）、避开最近播放、加权随机与播放统计表
+#include "TestHarness.h"
+#include "playlist/DirGroups.h"
+#include "playlist/OrderPolicy.h"
+#include "playlist/PlayCountTable.h"
+#include "util/PathHash.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+static const uint32_t kNeverPlayed = PlayCountTable::kNeverPlayed; // CHECK_EQ 按引用取值
+
+struct List {
+    std::vector<std::string> storage;
+    std::vector<const char *> paths;
+    std::vector<uint32_t> ids;
+
+    explicit List(const std::vector<std::string> &p) : storage(p) {
+        for (const std::string &s : storage) paths.push_back(s.c_str());
+        for (uint32_t i = 0; i < storage.size(); i++) ids.push_back(i);
+    }
+    OrderContext ctx(uint32_t seed, const PlayCountTable *stats = nullptr) const {
+        return OrderContext{ paths.data(), stats, seed };
+    }
+    std::vector<std::string> order() const {
+        std::vector<std::string> out;
+        for (uint32_t id : ids) out.push_back(storage[id]);
+        return out;
+    }
+};
+
+static std::string dirOf(const std::string &p) {
+    return p.substr(0, p.rfind('/'));
+}
+
+// 每个目录恰好连续一段，段内文件名按自然顺序
+static bool albumsIntact(const std::vector<std::string> &order) {
+    std::set<std::string> seen;
+    for (size_t i = 0; i < order.size(); i++) {
+        std::string dir = dirOf(order[i]);
+        if (i > 0 && dir == dirOf(order[i - 1])) {
+            if (naturalCompare(order[i - 1].c_str(), order[i].c_str()) >= 0) return false;
+            continue;
+        }
+        if (!seen.insert(dir).second) return false;
+    }
+    return true;
+}
+
+TEST(natural_compare_orders_numbers_by_value) {
+    CHECK(naturalCompare("第2集.mp3", "第10集.mp3") < 0);
+    CHECK(naturalCompare("a9", "a010") < 0);
+    CHECK(naturalCompare("a10", "a9") > 0);
+    CHECK(naturalCompare("a", "a1") < 0);
+    CHECK_EQ(naturalCompare("x01", "x1"), 0);
+}
+
+TEST(sequential_is_natural_and_deterministic) {
+    List l({ "/s/第10集.mp3", "/s/第2集.mp3", "/s/第1集.mp3" });
+    OrderPolicy::forType(SHUFFLE_SEQUENTIAL).build(l.ids.data(), l.ids.size(), l.ctx(1));
+    CHECK(l.order() == std::vector<std::string>({ "/s/第1集.mp3", "/s/第2集.mp3", "/s/第10集.mp3" }));
+}
+
+// 主机复现：/poem/b/* 排在 /poem 的文件之间时，/poem 被拆成两张专辑
+TEST(album_shuffle_keeps_nested_folders_apart) {
+    List base({ "/poem/c.mp3", "/poem/b/1.mp3", "/poem/b/2.mp3", "/poem/a.mp3", "/poem/b.mp3", "/poem/b 2/x.mp3",
+                "/poem/b/10.mp3", "/poem/b.c/y.mp3", "/poem/a/1.mp3" });
+    const OrderPolicy &album = OrderPolicy::forType(SHUFFLE_ALBUM);
+    int bad = 0;
+    for (uint32_t seed = 0; seed < 200; seed++) {
+        List l = base;
+        album.build(l.ids.data(), l.ids.size(), l.ctx(seed));
+        if (!albumsIntact(l.order())) bad++;
+    }
+    CHECK_EQ(bad, 0);
+
+    List l = base;
+    album.build(l.ids.data(), l.ids.size(), l.ctx(3));
+    std::vector<std::string> order = l.order();
+    size_t a = 0;
+    while (order[a] != "/poem/a.mp3") a++;
+    CHECK(order[a + 1] == "/poem/b.mp3");
+    CHECK(order[a + 2] == "/poem/c.mp3");
+}
+
+// 自然排序认为相等的两个目录（"01" 与 "1"）仍是两张专辑
+TEST(album_shuffle_separates_naturally_equal_dirs) {
+    List base({ "/x/01/a.mp3", "/x/1/a.mp3", "/x/01/b.mp3", "/x/1/b.mp3" });
+    for (uint32_t seed = 0; seed < 50; seed++) {
+        List l = base;
+        OrderPolicy::forType(SHUFFLE_ALBUM).build(l.ids.data(), l.ids.size(), l.ctx(seed));
+        CHECK(albumsIntact(l.order()));
+    }
+}
+
+TEST(album_shuffle_is_deterministic_and_shuffles_albums) {
+    std::vector<std::string> paths;
+    for (int d = 0; d < 20; d++) {
+        for (int t = 0; t < 5; t++) paths.push_back("/古诗/" + std::to_string(d) + "/" + std::to_string(t) + ".mp3");
+    }
+    List a(paths), b(paths), c(paths);
+    const OrderPolicy &album = OrderPolicy::forType(SHUFFLE_ALBUM);
+    album.build(a.ids.data(), a.ids.size(), a.ctx(7));
+    album.build(b.ids.data(), b.ids.size(), b.ctx(7));
+    album.build(c.ids.data(), c.ids.size(), c.ctx(8));
+    CHECK(a.ids == b.ids);
+    CHECK(a.ids != c.ids);
+    CHECK(albumsIntact(a.order()));
+}
+
+// 开头专辑含最近播放的曲目时整组移到末尾，嵌套目录不受影响
+TEST(album_avoid_recent_rotates_whole_albums) {
+    List l({ "/p/a.mp3", "/p/b/1.mp3", "/p/c.mp3", "/p/b/2.mp3", "/q/1.mp3" });
+    const OrderPolicy &album = OrderPolicy::forType(SHUFFLE_ALBUM);
+    for (uint32_t seed = 0; seed < 30; seed++) {
+        List t = l;
+        album.build(t.ids.data(), t.ids.size(), t.ctx(seed));
+        uint32_t recent[1] = { t.ids[0] };
+        album.avoidRecent(t.ids.data(), t.ids.size(), recent, 1, t.ctx(seed));
+        CHECK(t.ids[0] != recent[0]);
+        CHECK(albumsIntact(t.order()));
+    }
+}
+
+TEST(random_avoid_recent_keeps_recent_out_of_the_head) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 40; i++) paths.push_back("/r/" + std::to_string(i) + ".mp3");
+    List l(paths);
+    const OrderPolicy &random = OrderPolicy::forType(SHUFFLE_RANDOM);
+    random.build(l.ids.data(), l.ids.size(), l.ctx(5));
+    uint32_t recent[8];
+    for (int i = 0; i < 8; i++) recent[i] = l.ids[i * 2];
+    random.avoidRecent(l.ids.data(), l.ids.size(), recent, 8, l.ctx(5));
+    for (int i = 0; i < 8; i++) {
+        for (uint32_t r : recent) CHECK(l.ids[i] != r);
+    }
+    std::vector<uint32_t> sorted = l.ids;
+    std::sort(sorted.begin(), sorted.end());
+    for (uint32_t i = 0; i < sorted.size(); i++) CHECK_EQ(sorted[i], i);
+}
+
+// 序号回绕前后 age 都正确（旧的 16 位序号在 65536 次播放后算错）
+TEST(play_count_clock_survives_65536_plays) {
+    PlayCountTable t;
+    uint64_t a = pathHash("/a.mp3"), b = pathHash("/b.mp3");
+    t.notePlayed(a);
+    for (int i = 0; i < 70000; i++) t.notePlayed(b);
+    CHECK_EQ(t.age(a), 70000u);
+    CHECK_EQ(t.age(b), 0u);
+    CHECK_EQ(t.plays(b), 0xFFFF); // 次数饱和
+    CHECK_EQ(t.age(pathHash("/never.mp3")), kNeverPlayed);
+}
+
+TEST(play_count_serialization_round_trip) {
+    PlayCountTable t;
+    for (int i = 0; i < 100; i++) t.notePlayed(pathHash(("/" + std::to_string(i % 30)).c_str()));
+    std::vector<uint8_t> buf(t.serializedSize());
+    t.serialize(buf.data());
+    PlayCountTable u;
+    CHECK(u.deserialize(buf.data(), buf.size()));
+    for (int i = 0; i < 30; i++) {
+        uint64_t h = pathHash(("/" + std::to_string(i)).c_str());
+        CHECK_EQ(u.age(h), t.age(h));
+        CHECK_EQ(u.plays(h), t.plays(h));
+    }
+    // 截断、条目数与长度不符
+    CHECK(!u.deserialize(buf.data(), buf.size() - 1));
+    buf[4] = 0xFF;
+    CHECK(!u.deserialize(buf.data(), buf.size()));
+}
+
+// 从未播放的曲目权重封顶：20 首最近播过的 + 1 首从未播放，后者排第一的概率约为 21 / (1+...+20 + 21)
+TEST(weighted_caps_the_weight_of_unplayed_tracks) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 21; i++) paths.push_back("/w/" + std::to_string(i) + ".mp3");
+    PlayCountTable stats;
+    for (int i = 0; i < 20; i++) stats.notePlayed(pathHash(paths[i].c_str())); // age 19 .. 0
+    const OrderPolicy &weighted = OrderPolicy::forType(SHUFFLE_WEIGHTED);
+
+    int unplayedFirst = 0, oldestFirst = 0, newestFirst = 0;
+    const int runs = 20000;
+    for (int seed = 0; seed < runs; seed++) {
+        List l(paths);
+        weighted.build(l.ids.data(), l.ids.size(), l.ctx(seed, &stats));
+        if (l.ids[0] == 20) unplayedFirst++;
+        if (l.ids[0] == 0) oldestFirst++;
+        if (l.ids[0] == 19) newestFirst++;
+    }
+    // 权重：从未播放 21，最久的 20，刚播过的 1，总和 231
+    double total = 21 + 210;
+    CHECK(fabs(unplayedFirst / (double)runs - 21 / total) < 0.015);
+    CHECK(fabs(oldestFirst / (double)runs - 20 / total) < 0.015);
+    CHECK(fabs(newestFirst / (double)runs - 1 / total) < 0.005);
+}
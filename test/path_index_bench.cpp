@@ -0,0 +1,69 @@
+// 删除密集负载：10k 曲目中按随机顺序删除一半
+// 旧实现：按完整路径线性比较 + vector::erase 搬移；新实现：PathIndex 查哈希 + 墓碑位
+#include "Bench.h"
+#include "util/PathHash.h"
+#include "util/PathIndex.h"
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> makePaths(size_t n) {
+    std::vector<std::string> paths;
+    char buf[96];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "/story/album_%03zu/chapter_%05zu_long_title.mp3", i / 100, i);
+        paths.push_back(buf);
+    }
+    return paths;
+}
+
+int main() {
+    const size_t tracks = 10000 * bench::scale();
+    std::vector<std::string> paths = makePaths(tracks);
+    std::vector<std::string> victims(paths.begin(), paths.begin() + tracks / 2);
+    std::shuffle(victims.begin(), victims.end(), std::mt19937(7));
+
+    printf("%-28s %10s %12s\n", "workload", "ms", "ns/remove");
+
+    // 旧实现
+    {
+        std::vector<std::string> playlist = paths;
+        uint64_t t0 = bench::nowNs();
+        for (const std::string &v : victims) {
+            for (size_t i = 0; i < playlist.size(); i++) {
+                if (playlist[i] == v) {
+                    playlist.erase(playlist.begin() + i);
+                    break;
+                }
+            }
+        }
+        uint64_t ns = bench::nowNs() - t0;
+        bench::keep(playlist);
+        printf("%-28s %10.2f %12.0f\n", "linear String + erase", ns / 1e6, (double)ns / victims.size());
+    }
+
+    // 新实现：建索引 + 墓碑删除
+    {
+        Arena arena;
+        PathIndex index(arena);
+        std::vector<bool> removed(tracks, false);
+        uint64_t t0 = bench::nowNs();
+        index.reserve(tracks);
+        for (uint32_t id = 0; id < tracks; id++) index.insert(pathHash(paths[id].c_str()), id);
+        uint64_t buildNs = bench::nowNs() - t0;
+
+        t0 = bench::nowNs();
+        for (const std::string &v : victims) {
+            uint32_t id = index.find(pathHash(v.c_str()));
+            if (id != PathIndex::kNotFound && paths[id] == v) removed[id] = true;
+        }
+        uint64_t ns = bench::nowNs() - t0;
+        bench::keep(removed);
+        printf("%-28s %10.2f %12.0f\n", "PathIndex build", buildNs / 1e6, (double)buildNs / tracks);
+        printf("%-28s %10.2f %12.0f\n", "PathIndex + tombstone", ns / 1e6, (double)ns / victims.size());
+        printf("arena bytes for index: %zu\n", arena.used());
+    }
+    return 0;
+}
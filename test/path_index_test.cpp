@@ -0,0 +1,70 @@
+// PathIndex：查找、重复插入返回原 ID、扩容重哈希、哈希值 0 的保留处理
+#include "TestHarness.h"
+#include "util/PathHash.h"
+#include "util/PathIndex.h"
+#include <string>
+
+static const uint32_t kNotFound = PathIndex::kNotFound; // CHECK_EQ 按引用取值
+
+TEST(insert_and_find) {
+    Arena arena;
+    PathIndex index(arena);
+    CHECK_EQ(index.find(pathHash("/a.mp3")), kNotFound);
+    CHECK_EQ(index.insert(pathHash("/a.mp3"), 0), 0u);
+    CHECK_EQ(index.insert(pathHash("/b.mp3"), 1), 1u);
+    CHECK_EQ(index.find(pathHash("/a.mp3")), 0u);
+    CHECK_EQ(index.find(pathHash("/b.mp3")), 1u);
+    CHECK_EQ(index.find(pathHash("/c.mp3")), kNotFound);
+    CHECK_EQ(index.size(), 2u);
+}
+
+// 同一路径第二次插入返回第一次的 ID，且不覆盖（PlaylistManager 据此标记重复）
+TEST(duplicate_insert_keeps_first_id) {
+    Arena arena;
+    PathIndex index(arena);
+    index.insert(pathHash("/x/song.mp3"), 3);
+    CHECK_EQ(index.insert(pathHash("/x/song.mp3"), 9), 3u);
+    CHECK_EQ(index.find(pathHash("/x/song.mp3")), 3u);
+    CHECK_EQ(index.size(), 1u);
+}
+
+TEST(key_zero_is_remapped) {
+    Arena arena;
+    PathIndex index(arena);
+    CHECK_EQ(index.insert(0, 5), 5u);
+    CHECK_EQ(index.find(0), 5u);
+    CHECK_EQ(index.find(1), 5u); // 0 与 1 共用槽位：哈希碰撞由调用方比较路径兜底
+}
+
+// 不预留容量逐个插入 10k 条，期间多次扩容；全部可查且无误报
+TEST(growth_keeps_every_entry) {
+    Arena arena;
+    PathIndex index(arena);
+    char path[64];
+    for (uint32_t id = 0; id < 10000; id++) {
+        snprintf(path, sizeof(path), "/poem/%u/%u.mp3", id / 37, id);
+        CHECK_EQ(index.insert(pathHash(path), id), id);
+    }
+    int bad = 0;
+    for (uint32_t id = 0; id < 10000; id++) {
+        snprintf(path, sizeof(path), "/poem/%u/%u.mp3", id / 37, id);
+        if (index.find(pathHash(path)) != id) bad++;
+        snprintf(path, sizeof(path), "/poem/%u/%u.flac", id / 37, id);
+        if (index.find(pathHash(path)) != kNotFound) bad++;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(index.size(), 10000u);
+}
+
+// clear() 后重建复用同一 Arena
+TEST(clear_then_rebuild_after_arena_reset) {
+    Arena arena;
+    PathIndex index(arena);
+    for (uint32_t id = 0; id < 500; id++) index.insert(pathHash(std::to_string(id).c_str()), id);
+    index.clear();
+    arena.reset();
+    CHECK_EQ(index.size(), 0u);
+    CHECK_EQ(index.find(pathHash("7")), kNotFound);
+    for (uint32_t id = 0; id < 500; id++) index.insert(pathHash(std::to_string(id).c_str()), id + 1);
+    CHECK_EQ(index.find(pathHash("7")), 8u);
+}
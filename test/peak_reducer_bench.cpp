@@ -0,0 +1,37 @@
+// PeakReducer 内层循环：3 分钟 44.1kHz 立体声，按解码器的 1152 帧分块输入。
+// reset 时给出两倍长度，列永远不会完成，测到的是完整的累加开销
+#include "Bench.h"
+#include "dsp/PeakReducer.h"
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+static PeakReducer g_reducer;
+
+int main() {
+    const uint32_t rate = 44100;
+    const uint64_t total = 180ull * rate;
+    std::vector<int16_t> pcm(total * 2);
+    for (uint64_t f = 0; f < total; f++) {
+        double s = 8000 * sin(f * 0.05) * (0.6 + 0.4 * sin(f * 0.0003));
+        pcm[f * 2] = (int16_t)s;
+        pcm[f * 2 + 1] = (int16_t)(-s * 0.5);
+    }
+
+    printf("%-14s %10s %12s %14s\n", "chunk frames", "ns/frame", "x realtime", "ms per track");
+    const int reps = 5 * bench::scale();
+    for (size_t chunk : { (size_t)64, (size_t)1152, (size_t)4096 }) {
+        int completed = 0;
+        uint64_t t0 = bench::nowNs();
+        for (int k = 0; k < reps; k++) {
+            g_reducer.reset(total * 2);
+            for (uint64_t f = 0; f < total; f += chunk) g_reducer.put(&pcm[f * 2], std::min<uint64_t>(chunk, total - f), 2);
+            completed += g_reducer.completedColumns();
+        }
+        double ns = (double)(bench::nowNs() - t0) / reps / total;
+        bench::keep(completed);
+        printf("%-14zu %10.2f %12.0f %14.1f\n", chunk, ns, 1e9 / (ns * rate), ns * total / 1e6);
+    }
+    return 0;
+}
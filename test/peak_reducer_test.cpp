@@ -0,0 +1,187 @@
+// PeakReducer：任意分块与暴力参考一致、跳转后仍能补齐全部列、停顿检测落在段首，
+// 以及量化公式与 tools/gen_waveforms.py 一致
+#include "TestHarness.h"
+#include "dsp/PeakReducer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+static const uint32_t kRate = 44100;
+static const uint32_t kSeconds = 180;
+static const uint64_t kTotal = (uint64_t)kSeconds * kRate;
+
+// 合成曲目：25 秒朗诵与 4 秒停顿交替（停顿底噪约 -70dB），立体声
+struct Track {
+    std::vector<int16_t> pcm;
+    std::vector<int> segmentStarts; // 秒
+
+    Track() : pcm(kTotal * 2) {
+        std::mt19937 rng(1);
+        uint64_t f = 0;
+        for (int p = 0; f < kTotal; p++) {
+            bool loud = p % 2 == 0;
+            uint64_t len = (loud ? 25 : 4) * (uint64_t)kRate;
+            if (loud) segmentStarts.push_back((int)(f / kRate));
+            for (uint64_t i = 0; i < len && f < kTotal; i++, f++) {
+                double a = loud ? 8000 * (0.6 + 0.4 * sin(i * 0.0003)) : 10;
+                double s = a * sin(f * 0.05) + (int)(rng() % 21) - 10;
+                pcm[f * 2] = (int16_t)s;
+                pcm[f * 2 + 1] = (int16_t)(-s * 0.5);
+            }
+        }
+        pcm[12345 * 2] = -32768; // 满幅负值不溢出
+    }
+
+    void feed(PeakReducer &r, uint64_t from, uint64_t to, size_t chunk = 1152) const {
+        r.seek(from);
+        for (uint64_t f = from; f < to; f += chunk) r.put(&pcm[f * 2], std::min<uint64_t>(chunk, to - f), 2);
+    }
+};
+
+static const Track &track() {
+    static Track t;
+    return t;
+}
+
+// 静态对象：PeakReducer 约 4KB，不放在栈上
+static PeakReducer g_reducer;
+
+TEST(random_chunks_match_brute_force) {
+    const Track &t = track();
+    PeakReducer &r = g_reducer;
+    r.reset(kTotal);
+    std::mt19937 rng(2);
+    std::vector<uint64_t> chunkEnds;
+    for (uint64_t pos = 0; pos < kTotal;) {
+        size_t n = std::min<uint64_t>(1 + rng() % 2304, kTotal - pos);
+        r.put(&t.pcm[pos * 2], n, 2);
+        pos += n;
+        chunkEnds.push_back(pos);
+    }
+    CHECK(r.complete());
+
+    int bad = 0;
+    for (int c = 0; c < PeakReducer::kColumns; c++) {
+        uint64_t s = (uint64_t)c * kTotal / PeakReducer::kColumns, e = (uint64_t)(c + 1) * kTotal / PeakReducer::kColumns;
+        // 每列累计够 kCoverage 即完成：参考值取到达到 90% 的那一块末尾为止（不超过列尾）
+        uint64_t need = std::max<uint64_t>(1, (e - s) * PeakReducer::kCoverage / 100);
+        uint64_t stop = std::min(e, *std::lower_bound(chunkEnds.begin(), chunkEnds.end(), s + need));
+        int peak = 0;
+        double sq = 0;
+        for (uint64_t i = s; i < stop; i++) {
+            for (int ch = 0; ch < 2; ch++) {
+                int v = t.pcm[i * 2 + ch];
+                peak = std::max(peak, abs(v));
+                sq += (double)v * v;
+            }
+        }
+        uint8_t qp = PeakReducer::quantize((float)peak), qr = PeakReducer::quantize((float)sqrt(sq / ((stop - s) * 2)));
+        const WaveColumn &w = r.columns()[c];
+        if (abs(w.peak - qp) > 1 || abs(w.rms - qr) > 1) bad++;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(r.columns()[PeakReducer::kColumns * 12345 / kTotal].peak, 255);
+}
+
+// 从 100 秒处开始播放，再跳回开头、重播一段重叠区间：最终全部列完成
+TEST(seeks_fill_every_column) {
+    const Track &t = track();
+    PeakReducer &r = g_reducer;
+    r.reset(kTotal);
+    t.feed(r, 100 * kRate, kTotal);
+    int afterFirst = r.completedColumns();
+    CHECK(afterFirst > 0 && !r.complete());
+    CHECK(!r.columnReady(0));
+    t.feed(r, 0, 50 * kRate);
+    CHECK(!r.complete());
+    t.feed(r, 40 * kRate, 110 * kRate);
+    CHECK(r.complete());
+}
+
+// 没有 reset 的曲目、空输入、越界的位置都被忽略
+TEST(inputs_outside_the_track_are_ignored) {
+    const Track &t = track();
+    PeakReducer &r = g_reducer;
+    r.reset(0);
+    CHECK(!r.started());
+    r.put(t.pcm.data(), 1000, 2);
+    CHECK_EQ(r.completedColumns(), 0);
+
+    r.reset(kTotal);
+    r.seek(kTotal + 10);
+    r.put(t.pcm.data(), 1000, 2);
+    CHECK_EQ(r.completedColumns(), 0);
+    r.put(t.pcm.data(), 0, 2);
+    CHECK_EQ(r.completedColumns(), 0);
+}
+
+TEST(gap_jumps_land_on_segment_starts) {
+    const Track &t = track();
+    PeakReducer &r = g_reducer;
+    r.reset(kTotal);
+    t.feed(r, 0, kTotal);
+    CHECK(r.complete());
+
+    std::vector<int> forward;
+    for (int col = 0; (col = PeakReducer::findGap(r.columns(), PeakReducer::kColumns, col, 1)) >= 0;) {
+        forward.push_back((int)((uint64_t)col * kSeconds / PeakReducer::kColumns));
+    }
+    CHECK_EQ(forward.size(), t.segmentStarts.size() - 1);
+    for (size_t i = 0; i < forward.size() && i + 1 < t.segmentStarts.size(); i++) {
+        int expect = t.segmentStarts[i + 1];
+        CHECK(forward[i] >= expect - 1 && forward[i] <= expect);
+    }
+
+    // 往回跳：从末尾逐段回到更早的段首
+    std::vector<int> backward;
+    for (int col = PeakReducer::kColumns - 1; (col = PeakReducer::findGap(r.columns(), PeakReducer::kColumns, col, -1)) >= 0;) {
+        backward.push_back((int)((uint64_t)col * kSeconds / PeakReducer::kColumns));
+    }
+    CHECK(!backward.empty());
+    for (size_t i = 1; i < backward.size(); i++) CHECK(backward[i] < backward[i - 1]);
+
+    // 平坦或全静音的波形没有停顿
+    WaveColumn flat[PeakReducer::kColumns] = {};
+    CHECK_EQ(PeakReducer::findGap(flat, PeakReducer::kColumns, 0, 1), -1);
+    CHECK_EQ(PeakReducer::findGap(nullptr, PeakReducer::kColumns, 0, 1), -1);
+}
+
+TEST(quantize_is_log_scaled) {
+    CHECK_EQ(PeakReducer::quantize(0.0f), 0);
+    CHECK_EQ(PeakReducer::quantize(32.0f), 0);      // -60dBFS
+    CHECK_EQ(PeakReducer::quantize(32768.0f), 255); // 0dBFS
+    CHECK_EQ(PeakReducer::quantize(40000.0f), 255);
+    // 单调：每 6dB 约 25.5 级
+    int steps = 0;
+    for (float a = 32.0f; a < 32768.0f; a *= 2.0f) {
+        int d = PeakReducer::quantize(a * 2.0f) - PeakReducer::quantize(a);
+        if (d < 25 || d > 26) steps++;
+    }
+    CHECK_EQ(steps, 0);
+}
+
+#ifdef WAVEFORM_TOOL
+// 离线工具与固件使用同一量化公式：1..32768 每个整数幅度的结果一致
+TEST(gen_waveforms_quantize_matches) {
+    std::string cmd = std::string(WAVEFORM_TOOL_PYTHON) + " -c \"import sys; sys.path.insert(0, '" + WAVEFORM_TOOL +
+                      "'); from gen_waveforms import quantize; sys.stdout.write(bytes(quantize(a) for a in range(32769)).hex())\"";
+    FILE *p = popen(cmd.c_str(), "r");
+    CHECK(p != nullptr);
+    if (!p) return;
+    std::string hex;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), p)) > 0) hex.append(buf, n);
+    CHECK_EQ(pclose(p), 0);
+    CHECK_EQ(hex.size(), 32769u * 2);
+    int mismatches = 0;
+    for (uint32_t a = 0; a <= 32768 && a * 2 + 1 < hex.size(); a++) {
+        uint8_t expect = (uint8_t)strtoul(hex.substr(a * 2, 2).c_str(), nullptr, 16);
+        if (PeakReducer::quantize((float)a) != expect) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+}
+#endif
@@ -0,0 +1,97 @@
+// PlayHistory：环形缓冲回绕、回退到最早一条为止、前进重放、持久化恢复
+#include "TestHarness.h"
+#include "playlist/PlayHistory.h"
+
+static const size_t kCapacity = PlayHistory::kCapacity; // CHECK_EQ 按引用取值
+
+TEST(push_ignores_repeat_of_newest) {
+    PlayHistory h;
+    CHECK(h.push(1));
+    CHECK(!h.push(1));
+    CHECK(h.push(2));
+    CHECK(h.push(1));
+    CHECK_EQ(h.size(), 3u);
+    CHECK_EQ(h.at(0), 1u);
+    CHECK_EQ(h.at(1), 2u);
+    CHECK_EQ(h.at(2), 1u);
+    CHECK_EQ(h.at(3), 0u);
+}
+
+// 回退停在最早一条：不会越过它，也不会回绕到最新
+TEST(back_stops_at_the_oldest_entry) {
+    PlayHistory h;
+    for (uint64_t i = 1; i <= 5; i++) h.push(i);
+    uint64_t hash = 0;
+    for (uint64_t expect = 4; expect >= 1; expect--) {
+        CHECK(h.back(hash));
+        CHECK_EQ(hash, expect);
+    }
+    CHECK(!h.back(hash));
+    CHECK(!h.back(hash));
+    CHECK_EQ(h.cursor(), 4u);
+    CHECK_EQ(h.at(h.cursor()), 1u); // prev() 停在这里重播最早一首
+}
+
+TEST(forward_replays_what_back_visited) {
+    PlayHistory h;
+    for (uint64_t i = 1; i <= 5; i++) h.push(i);
+    uint64_t hash = 0;
+    h.back(hash);
+    h.back(hash);
+    CHECK(h.forward(hash));
+    CHECK_EQ(hash, 4u);
+    CHECK(h.forward(hash));
+    CHECK_EQ(hash, 5u);
+    CHECK(!h.forward(hash));
+    CHECK(h.atHead());
+
+    // 回看途中直接选曲：待重放的曲目放弃，新曲目成为最新
+    h.back(hash);
+    h.push(9);
+    CHECK(h.atHead());
+    CHECK_EQ(h.at(0), 9u);
+    CHECK_EQ(h.at(1), 5u);
+}
+
+TEST(single_entry_cannot_go_back) {
+    PlayHistory h;
+    uint64_t hash = 0;
+    CHECK(!h.back(hash));
+    h.push(7);
+    CHECK(!h.back(hash));
+    CHECK_EQ(h.at(h.cursor()), 7u);
+}
+
+// 超过容量后只保留最近 kCapacity 首，回退最多 kCapacity - 1 步
+TEST(ring_keeps_the_most_recent_entries) {
+    PlayHistory h;
+    for (uint64_t i = 1; i <= 3 * kCapacity + 5; i++) h.push(i);
+    CHECK_EQ(h.size(), kCapacity);
+    uint64_t newest = 3 * kCapacity + 5;
+    for (size_t b = 0; b < kCapacity; b++) CHECK_EQ(h.at(b), newest - b);
+
+    uint64_t hash = 0;
+    size_t steps = 0;
+    while (h.back(hash)) steps++;
+    CHECK_EQ(steps, kCapacity - 1);
+    CHECK_EQ(hash, newest - (kCapacity - 1));
+}
+
+TEST(restore_round_trips_slots_and_head) {
+    PlayHistory h;
+    for (uint64_t i = 1; i <= kCapacity + 10; i++) h.push(i * 0x9E3779B97F4A7C15ull);
+    uint64_t slots[PlayHistory::kCapacity];
+    for (uint16_t i = 0; i < kCapacity; i++) slots[i] = h.slot(i);
+
+    PlayHistory r;
+    r.restore(slots, h.head(), h.count());
+    CHECK_EQ(r.size(), h.size());
+    for (size_t b = 0; b < kCapacity; b++) CHECK_EQ(r.at(b), h.at(b));
+    CHECK(r.atHead());
+
+    // 头部越界或计数超出容量的文件按空历史处理
+    r.restore(slots, kCapacity, 3);
+    CHECK_EQ(r.size(), 0u);
+    r.restore(slots, 0, kCapacity + 1);
+    CHECK_EQ(r.size(), 0u);
+}
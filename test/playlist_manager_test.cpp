@@ -0,0 +1,259 @@
+// PlaylistManager 的常驻模式：真实的 setMode() / evict() 跑在 SD 替身上。
+// 检查总占用超过 memoryCap 时淘汰最久未用的非当前模式、被淘汰模式的脏播放统计先落盘，
+// 以及当前模式即使单独超限也保留；选曲不落盘，只有 commitPlayed() 确认的曲目进入历史与统计；
+// 检索索引在卡满与断电时不留半截文件。
+#include "TestHarness.h"
+#include "TempDir.h"
+#include "PlaylistManager.h"
+#include "playlist/PlayCountTable.h"
+#include "util/Crc32.h"
+#include "util/PathHash.h"
+#include <SD.h>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+static const size_t kSizes[4] = { 300, 600, 900, 1200 };
+static const int kWeighted = 2; // 加权随机模式，播放统计参与排序
+
+static void makeModes(TempDir &dir) {
+    char buf[64];
+    for (int m = 0; m < 4; m++) {
+        for (size_t i = 0; i < kSizes[m]; i++) {
+            snprintf(buf, sizeof(buf), "/m%d/album%02zu/%04zu.mp3", m, i / 50, i);
+            dir.write(buf, {});
+        }
+    }
+}
+
+// 校验任务与固件一样永不退出并持有管理器指针，测试对象有意不释放
+static PlaylistManager &startManager(TempDir &dir) {
+    SD.setRoot(dir.path());
+    PlaylistManager *pm = new PlaylistManager;
+    for (int m = 0; m < 4; m++) {
+        ModeConfig c;
+        c.name = "m" + std::to_string(m);
+        c.path = "/m" + std::to_string(m);
+        c.shuffle = m == kWeighted ? SHUFFLE_WEIGHTED : SHUFFLE_RANDOM;
+        pm->addMode(c);
+    }
+    pm->memoryCap = SIZE_MAX;
+    return *pm;
+}
+
+// 等当前模式的后台校验跑完，之后切换不再与校验任务争锁
+static void settle(PlaylistManager &pm) {
+    for (int i = 0; i < 5000 && !pm.isValidated(); i++) delay(1);
+}
+
+static std::string resident(PlaylistManager &pm) {
+    std::string s;
+    for (int m = 0; m < 4; m++) s += pm.isModeResident(m) ? '0' + m : '-';
+    return s;
+}
+
+// 与 PlaylistManager::modeFilePath("plays", ...) 相同的命名
+static std::string statsFile(int mode) {
+    uint64_t h = pathHash(("/m" + std::to_string(mode)).c_str());
+    char name[40];
+    snprintf(name, sizeof(name), "/.plays_%08x.bin", (unsigned)(h ^ (h >> 32)));
+    return name;
+}
+
+static bool readStats(TempDir &dir, int mode, PlayCountTable &stats) {
+    std::vector<uint8_t> buf = dir.read(statsFile(mode));
+    if (buf.size() < 8 || memcmp(buf.data(), "PLY2", 4) != 0) return false;
+    uint32_t crc;
+    memcpy(&crc, buf.data() + buf.size() - 4, 4);
+    return crc == crc32(buf.data() + 4, buf.size() - 8) && stats.deserialize(buf.data() + 4, buf.size() - 8);
+}
+
+TEST(lru_eviction_keeps_the_current_mode_and_saves_dirty_stats) {
+    TempDir dir;
+    makeModes(dir);
+    PlaylistManager &pm = startManager(dir);
+
+    // 全部常驻，使用顺序 0 1 2 3，再切回 1：最久未用的是 0
+    size_t bytes[4], total = 0;
+    for (int m = 0; m < 4; m++) {
+        pm.setMode(m);
+        settle(pm);
+        CHECK_EQ(pm.count(), kSizes[m]);
+        bytes[m] = pm.residentBytes() - total;
+        total = pm.residentBytes();
+    }
+    CHECK_EQ(resident(pm), std::string("0123"));
+    pm.setMode(1);
+    CHECK_EQ(resident(pm), std::string("0123"));
+
+    // 超出 1 字节：只淘汰 0
+    pm.memoryCap = total - 1;
+    pm.setMode(3);
+    CHECK_EQ(resident(pm), std::string("-123"));
+    CHECK_EQ(pm.residentBytes(), total - bytes[0]);
+
+    // 在加权模式播放几首；离开时统计写入失败（卡满），统计仍是脏的
+    pm.setMode(kWeighted);
+    std::set<std::string> played;
+    for (int i = 0; i < 5; i++) {
+        std::string path = pm.next().c_str();
+        CHECK(pm.commitPlayed(pathHash(path.c_str())));
+        played.insert(path);
+    }
+    CHECK_EQ(played.size(), 5u);
+    SD.diskFullAfter(0);
+    pm.setMode(3);
+    SD.diskFree();
+    CHECK(!dir.exists(statsFile(kWeighted)));
+
+    // 容量只够 1 和 3：切到 1 时淘汰最久未用的 2（3 刚用过），删除前补写它的统计
+    pm.memoryCap = bytes[1] + bytes[3];
+    pm.setMode(1);
+    CHECK_EQ(resident(pm), std::string("-1-3"));
+    PlayCountTable stats;
+    CHECK(readStats(dir, kWeighted, stats));
+    CHECK_EQ(stats.size(), played.size());
+    int counted = 0;
+    for (const std::string &p : played) counted += stats.plays(pathHash(p.c_str())) == 1;
+    CHECK_EQ(counted, 5);
+
+    // 上限低于当前模式本身：其余全部淘汰，当前模式保留并可继续播放
+    pm.memoryCap = 1;
+    pm.setMode(3);
+    CHECK_EQ(resident(pm), std::string("---3"));
+    CHECK_EQ(pm.residentBytes(), bytes[3]);
+    CHECK(pm.next().length() > 0);
+
+    // 切回被淘汰的模式：从缓存重建，替换掉 3
+    pm.setMode(0);
+    CHECK_EQ(resident(pm), std::string("0---"));
+    CHECK_EQ(pm.count(), kSizes[0]);
+    settle(pm);
+}
+
+// 常驻切换只交换指针：切回的模式保留自己的播放顺序与位置，不重新打乱
+TEST(resident_switch_keeps_each_modes_position) {
+    TempDir dir;
+    makeModes(dir);
+    PlaylistManager &pm = startManager(dir);
+    pm.setMode(0);
+    settle(pm);
+    std::vector<std::string> first;
+    for (int i = 0; i < 3; i++) first.push_back(pm.next().c_str());
+    pm.setMode(1);
+    settle(pm);
+    pm.next();
+
+    size_t reads = SD.stats.bytesRead;
+    pm.setMode(0);
+    CHECK_EQ(SD.stats.bytesRead, reads); // 不读卡
+    CHECK_EQ(pm.getCurrentIndex(), 2u);
+    std::string fourth = pm.next().c_str();
+    CHECK(std::find(first.begin(), first.end(), fourth) == first.end());
+    CHECK_EQ(pm.getCurrentIndex(), 3u);
+}
+
+// next() 不读写卡；打开失败（未 commitPlayed）的曲目不进历史与统计；落盘在 savePlayed() 中批量进行
+TEST(only_committed_tracks_enter_history_and_stats) {
+    TempDir dir;
+    makeModes(dir);
+    PlaylistManager &pm = startManager(dir);
+    pm.setMode(kWeighted);
+    settle(pm);
+
+    fs::FS::Stats before = SD.stats;
+    std::vector<std::string> committed;
+    std::string failed;
+    for (int i = 0; i < 6; i++) {
+        std::string path = pm.next().c_str();
+        if (i == 2) {
+            failed = path; // 打开失败：不确认
+            continue;
+        }
+        CHECK(pm.commitPlayed(pathHash(path.c_str())));
+        committed.push_back(path);
+    }
+    CHECK_EQ(SD.stats.opens, before.opens);
+    CHECK_EQ(SD.stats.bytesWritten, before.bytesWritten);
+    CHECK_EQ(pm.getOrderAge(), 5u);
+
+    // 重复确认、确认不是 next() 选出的曲目都被忽略
+    CHECK(!pm.commitPlayed(pathHash(committed.back().c_str())));
+    pm.next();
+    CHECK(!pm.commitPlayed(pathHash(failed.c_str())));
+    CHECK_EQ(pm.getOrderAge(), 5u);
+
+    // prev() 沿历史回退，不产生待确认的曲目
+    std::string back = pm.prev().c_str();
+    CHECK_EQ(back, committed[committed.size() - 2]);
+    CHECK(!pm.commitPlayed(pathHash(back.c_str())));
+
+    pm.savePlayed(true);
+    PlayCountTable stats;
+    CHECK(readStats(dir, kWeighted, stats));
+    CHECK_EQ(stats.size(), committed.size());
+    CHECK_EQ(stats.plays(pathHash(failed.c_str())), 0);
+
+    // 另一个管理器从卡上加载同一历史：回退得到倒数第二首
+    PlaylistManager &reloaded = startManager(dir);
+    reloaded.setMode(kWeighted);
+    settle(reloaded);
+    CHECK_EQ(std::string(reloaded.prev().c_str()), committed[committed.size() - 2]);
+}
+
+// 统计按每 16 首的节奏落盘：不到 16 首时 savePlayed() 只写历史
+TEST(stats_are_saved_every_16_plays) {
+    TempDir dir;
+    makeModes(dir);
+    PlaylistManager &pm = startManager(dir);
+    pm.setMode(kWeighted);
+    settle(pm);
+    for (int i = 0; i < 15; i++) CHECK(pm.commitPlayed(pathHash(pm.next().c_str())));
+    pm.savePlayed();
+    CHECK(!dir.exists(statsFile(kWeighted)));
+    CHECK(pm.commitPlayed(pathHash(pm.next().c_str())));
+    pm.savePlayed();
+    PlayCountTable stats;
+    CHECK(readStats(dir, kWeighted, stats));
+    CHECK_EQ(stats.size(), 16u);
+}
+
+// 检索索引经 .tmp 改名提交：卡满时不留半截的 .idx，断电在任一步正式文件要么完整、要么缺失
+TEST(search_index_is_never_left_half_written) {
+    TempDir dir;
+    makeModes(dir);
+    const std::string idx = "/.playlist_cache_0.idx";
+    PlaylistManager &pm = startManager(dir);
+    pm.setMode(0);
+    settle(pm);
+    std::vector<uint8_t> full = dir.read(idx);
+    CHECK(full.size() > 8);
+
+    // 卡满：写一半失败，正式文件与临时文件都不留下
+    SD.remove(idx.c_str());
+    SD.diskFullAfter(full.size() / 2);
+    PlaylistManager &fullCard = startManager(dir);
+    fullCard.setMode(0);
+    settle(fullCard);
+    SD.diskFree();
+    CHECK(!dir.exists(idx));
+    CHECK(!dir.exists(idx + ".tmp"));
+
+    // 断电点扫过写入、删除与改名；恢复供电后下次加载重建出同样的索引
+    const long steps[] = { 0, 1, (long)full.size() / 2, (long)full.size(), (long)full.size() + 1, (long)full.size() + 2 };
+    for (long n : steps) {
+        SD.powerCutAfter(n);
+        PlaylistManager &cut = startManager(dir);
+        cut.setMode(0);
+        settle(cut);
+        SD.powerRestore();
+        CHECK(!dir.exists(idx) || dir.read(idx) == full);
+
+        PlaylistManager &next = startManager(dir);
+        next.setMode(0);
+        settle(next);
+        CHECK(dir.read(idx) == full);
+        SD.remove(idx.c_str());
+    }
+}
@@ -0,0 +1,66 @@
+// 检索索引的建立、查询与持久化耗时。曲目名由常用字、多音字与 ASCII 片段随机拼成，
+// 查询为 1~4 个首字母；多音字使查询在每层分出多个区间，最坏情况即来自这些查询
+#include "Bench.h"
+#include "playlist/SearchIndex.h"
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+
+int main() {
+    const char *pieces[] = { "静", "夜", "思", "春", "晓", "明", "月", "光", "白", "日", "依", "山", "尽", "黄", "河",
+                             "鹳", "雀", "重", "长", "乐", "行", "朝", "调", "A",  "b",  "Z",  "7",  " ",  "-" };
+    const size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+    const char letters[] = "jysxmgbrshlhaczt7";
+
+    printf("%-10s %10s %10s %12s %12s %12s %12s\n", "tracks", "build ms", "B/track", "query avg us", "query max us",
+           "save+load ms", "hits/query");
+    for (size_t n : { (size_t)2000, (size_t)50000, (size_t)200000 * bench::scale() }) {
+        std::mt19937 rng(7);
+        std::vector<std::string> paths;
+        paths.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            std::string p = "/古诗/album" + std::to_string(i % 50) + "/";
+            int len = 2 + rng() % 8;
+            for (int k = 0; k < len; k++) p += pieces[rng() % pieceCount];
+            paths.push_back(p + ".mp3");
+        }
+
+        uint64_t t0 = bench::nowNs();
+        SearchIndex index;
+        for (uint32_t i = 0; i < n; i++) index.add(i, paths[i].c_str(), strlen("/古诗"));
+        index.finalize();
+        uint64_t buildNs = bench::nowNs() - t0;
+
+        uint64_t total = 0, worst = 0;
+        size_t hits = 0;
+        const int queries = 1000;
+        for (int q = 0; q < queries; q++) {
+            char query[8];
+            int len = 1 + rng() % 4;
+            for (int k = 0; k < len; k++) query[k] = letters[rng() % (sizeof(letters) - 1)];
+            query[len] = '\0';
+            uint32_t ids[32];
+            t0 = bench::nowNs();
+            hits += index.query(query, ids, 32);
+            uint64_t ns = bench::nowNs() - t0;
+            total += ns;
+            if (ns > worst) worst = ns;
+        }
+
+        std::vector<uint8_t> buf(index.serializedSize());
+        t0 = bench::nowNs();
+        index.serialize(buf.data(), 1);
+        SearchIndex loaded;
+        bool ok = loaded.deserialize(buf.data(), buf.size(), 1);
+        uint64_t ioNs = bench::nowNs() - t0;
+        if (!ok) {
+            printf("deserialize failed\n");
+            return 1;
+        }
+        printf("%-10zu %10.1f %10.1f %12.2f %12.2f %12.1f %12.1f\n", n, buildNs / 1e6, (double)index.bytes() / n,
+               total / 1e3 / queries, worst / 1e3, ioNs / 1e6, (double)hits / queries);
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+// SearchIndex / 拼音首字母表：归一化、词首前缀匹配、多音字的各个读音、排序、持久化，
+// 以及随机曲目上与逐条暴力匹配的对照
+#include "TestHarness.h"
+#include "playlist/PinyinInitials.h"
+#include "playlist/SearchIndex.h"
+#include <string.h>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+static uint32_t mask(const char *utf8) {
+    uint32_t cp = 0;
+    const uint8_t *s = (const uint8_t *)utf8;
+    if (s[0] >= 0xE0) cp = ((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+    return pinyinKeyMask(pinyinKey(cp));
+}
+
+static uint32_t bit(char c) { return 1u << (c - 'a'); }
+
+struct Library {
+    std::vector<std::string> paths;
+    SearchIndex index;
+
+    Library(const std::vector<std::string> &p, size_t rootLen) : paths(p) {
+        for (uint32_t i = 0; i < paths.size(); i++) index.add(i, paths[i].c_str(), rootLen);
+        index.finalize();
+    }
+    std::vector<std::string> find(const char *q, size_t max = 16) const {
+        uint32_t ids[64];
+        size_t n = index.query(q, ids, max);
+        std::vector<std::string> out;
+        for (size_t i = 0; i < n; i++) out.push_back(paths[ids[i]]);
+        return out;
+    }
+    bool finds(const char *q, const std::string &path) const {
+        for (const std::string &p : find(q, 64)) {
+            if (p == path) return true;
+        }
+        return false;
+    }
+};
+
+TEST(pinyin_table_covers_level2_and_polyphones) {
+    CHECK_EQ(mask("静"), bit('j'));
+    CHECK_EQ(mask("鹳"), bit('g')); // GB2312 二级字
+    CHECK_EQ(mask("犇"), bit('b')); // GBK，不在 GB2312
+    CHECK_EQ(mask("略"), bit('l'));
+    CHECK_EQ(mask("重"), bit('z') | bit('c'));
+    CHECK_EQ(mask("长"), bit('c') | bit('z'));
+    CHECK_EQ(mask("乐"), bit('l') | bit('y'));
+    CHECK_EQ(mask("行"), bit('x') | bit('h'));
+    // 扩展 A 区、假名、标点不收录
+    CHECK_EQ(pinyinKey(0x3400), 0);
+    CHECK_EQ(pinyinKey(0x3042), 0);
+    CHECK_EQ(pinyinKey(0xFF0C), 0);
+
+    // 多音字的键字节在字母之后，不会与 '|' 或字母冲突
+    uint8_t key = pinyinKey(0x91CD); // 重
+    CHECK(key >= kPinyinSetBase);
+    CHECK_EQ(pinyinKeyMask('|'), 0u);
+    CHECK_EQ(pinyinKeyMask('7'), 0u);
+}
+
+TEST(normalize_marks_word_starts) {
+    char out[64];
+    uint64_t starts;
+    size_t n = SearchIndex::normalize("静夜思", strlen("静夜思"), out, sizeof(out), &starts);
+    CHECK_EQ(n, 3u);
+    CHECK_STR(out, "jys");
+    CHECK_EQ(starts, 0x7ull);
+
+    const char *mixed = "001 - Twinkle Ｌittle star";
+    n = SearchIndex::normalize(mixed, strlen(mixed), out, sizeof(out), &starts);
+    CHECK_STR(out, "001twinklelittlestar");
+    CHECK_EQ(starts, (1ull << 0) | (1ull << 3) | (1ull << 10) | (1ull << 16));
+}
+
+static const std::vector<std::string> kPoems = {
+    "/古诗/静夜思.mp3",       "/古诗/春晓.mp3",          "/古诗/唐诗/登鹳雀楼.mp3", "/古诗/Twinkle Little Star.mp3",
+    "/古诗/唐诗/咏鹅.flac",   "/古诗/001 静夜思(朗诵).mp3", "/古诗/九月九日忆山东兄弟 重阳.mp3",
+    "/古诗/长歌行.mp3",       "/古诗/音乐/快乐的节日.mp3",
+};
+
+TEST(prefix_and_initial_queries) {
+    Library lib(kPoems, strlen("/古诗"));
+    CHECK(lib.finds("jys", "/古诗/静夜思.mp3"));
+    CHECK(lib.finds("ys", "/古诗/静夜思.mp3"));
+    CHECK(lib.finds("cx", "/古诗/春晓.mp3"));
+    CHECK(lib.finds("star", "/古诗/Twinkle Little Star.mp3"));
+    CHECK(lib.finds("LITTLE", "/古诗/Twinkle Little Star.mp3"));
+    CHECK(lib.finds("001j", "/古诗/001 静夜思(朗诵).mp3"));
+    CHECK(lib.finds("静夜", "/古诗/静夜思.mp3"));
+    CHECK(lib.find("xyz").empty());
+
+    // 二级字
+    CHECK(lib.finds("dgql", "/古诗/唐诗/登鹳雀楼.mp3"));
+    CHECK(lib.finds("gql", "/古诗/唐诗/登鹳雀楼.mp3"));
+
+    // 目录标签：唐诗/ 下的两首
+    std::vector<std::string> ts = lib.find("ts");
+    CHECK_EQ(ts.size(), 2u);
+    CHECK(lib.finds("tsye", "/古诗/唐诗/咏鹅.flac") == false); // 标签与文件名不连成一个词
+    CHECK(lib.finds("ye", "/古诗/唐诗/咏鹅.flac"));
+}
+
+TEST(polyphones_match_every_reading) {
+    Library lib(kPoems, strlen("/古诗"));
+    const std::string chongyang = "/古诗/九月九日忆山东兄弟 重阳.mp3";
+    CHECK(lib.finds("zy", chongyang));
+    CHECK(lib.finds("cy", chongyang));
+    CHECK(lib.finds("重阳", chongyang));
+    CHECK(lib.finds("jyjr", chongyang));
+    CHECK(!lib.finds("sy", chongyang));
+
+    CHECK(lib.finds("cgx", "/古诗/长歌行.mp3"));
+    CHECK(lib.finds("zgh", "/古诗/长歌行.mp3"));
+    CHECK(lib.finds("gx", "/古诗/长歌行.mp3"));
+
+    // 目录 "音乐" 与文件名 "快乐" 中的 "乐"：yy / yl 都命中目录标签
+    CHECK(lib.finds("yy", "/古诗/音乐/快乐的节日.mp3"));
+    CHECK(lib.finds("yl", "/古诗/音乐/快乐的节日.mp3"));
+    CHECK(lib.finds("kl", "/古诗/音乐/快乐的节日.mp3"));
+    CHECK(lib.finds("ky", "/古诗/音乐/快乐的节日.mp3"));
+}
+
+// 结果按键的字典序且去重：同一曲目多个词首命中只返回一次
+TEST(results_are_deduplicated_and_capped) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 40; i++) paths.push_back("/m/重重重 " + std::to_string(i) + ".mp3");
+    Library lib(paths, 2);
+    std::vector<std::string> hits = lib.find("c", 64);
+    CHECK_EQ(hits.size(), 40u);
+    CHECK_EQ(std::set<std::string>(hits.begin(), hits.end()).size(), 40u);
+    CHECK_EQ(lib.find("zc", 8).size(), 8u);
+    CHECK_EQ(lib.find("czz", 64).size(), 40u);
+}
+
+TEST(serialization_round_trip_and_rejects) {
+    Library lib(kPoems, strlen("/古诗"));
+    std::vector<uint8_t> buf(lib.index.serializedSize());
+    lib.index.serialize(buf.data(), 0x1234);
+
+    SearchIndex loaded;
+    CHECK(loaded.deserialize(buf.data(), buf.size(), 0x1234));
+    uint32_t ids[8];
+    CHECK_EQ(loaded.query("cy", ids, 8), 1u);
+    CHECK_EQ(loaded.entryCount(), lib.index.entryCount());
+
+    CHECK(!loaded.deserialize(buf.data(), buf.size(), 0x1235));
+    CHECK_EQ(loaded.entryCount(), 0u);
+    CHECK(!loaded.deserialize(buf.data(), buf.size() - 1, 0x1234));
+
+    // 按别的拼音表建立的索引
+    std::vector<uint8_t> other = buf;
+    other[4] ^= 1;
+    CHECK(!loaded.deserialize(other.data(), other.size(), 0x1234));
+
+    // 键偏移越界
+    other = buf;
+    memset(other.data() + 20, 0xFF, 3);
+    CHECK(!loaded.deserialize(other.data(), other.size(), 0x1234));
+}
+
+// 暴力匹配：在每个词首逐字节比较，键字节与查询字节可匹配的首字母有交集（或同为数字 / 分隔符）即相等
+static bool byteMatches(uint8_t key, uint8_t q) {
+    uint32_t a = pinyinKeyMask(key), b = pinyinKeyMask(q);
+    return a || b ? (a & b) != 0 : key == q;
+}
+
+static std::string keyOf(const std::string &path, size_t rootLen, uint64_t &starts) {
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    std::string name = path.substr(slash + 1, dot - slash - 1);
+    char key[SearchIndex::kMaxKey + 1];
+    size_t n = SearchIndex::normalize(name.c_str(), name.size(), key, SearchIndex::kMaxName + 1, &starts);
+    if (slash > rootLen && n + 2 < sizeof(key)) {
+        size_t from = path.rfind('/', slash - 1) + 1;
+        uint64_t dirStarts;
+        size_t d = SearchIndex::normalize(path.c_str() + from, slash - from, key + n + 1, sizeof(key) - n - 1, &dirStarts);
+        if (d) {
+            key[n] = SearchIndex::kTagSeparator;
+            starts |= dirStarts << (n + 1);
+            n += 1 + d;
+        }
+    }
+    return std::string(key, n);
+}
+
+TEST(random_queries_match_brute_force) {
+    std::mt19937 rng(7);
+    const char *pieces[] = { "静", "夜", "思", "重", "长", "乐", "行", "鹳", "雀", "楼", "阳", "春",
+                             "晓", "A",  "b",  "Z",  "7",  " ",  "-",  "会", "朝", "调", "弹" };
+    const size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+    std::vector<std::string> paths;
+    for (int i = 0; i < 3000; i++) {
+        std::string p = "/古诗/专辑" + std::string(pieces[rng() % 13]) + std::to_string(i % 30) + "/";
+        int len = 2 + rng() % 8;
+        for (int k = 0; k < len; k++) p += pieces[rng() % pieceCount];
+        paths.push_back(p + ".mp3");
+    }
+    Library lib(paths, strlen("/古诗"));
+
+    std::vector<std::string> keys;
+    std::vector<uint64_t> starts;
+    for (const std::string &p : paths) {
+        uint64_t s;
+        keys.push_back(keyOf(p, strlen("/古诗"), s));
+        starts.push_back(s);
+    }
+
+    const char letters[] = "jysczlxhkdtgqb7";
+    int mismatches = 0;
+    size_t hits = 0;
+    for (int t = 0; t < 400; t++) {
+        std::string q;
+        int len = 1 + rng() % 4;
+        for (int k = 0; k < len; k++) q += letters[rng() % (sizeof(letters) - 1)];
+
+        std::set<uint32_t> expect;
+        for (uint32_t id = 0; id < keys.size(); id++) {
+            const std::string &key = keys[id];
+            for (size_t j = 0; j + q.size() <= key.size() && j < 64; j++) {
+                if (!(starts[id] & (1ull << j))) continue;
+                size_t k = 0;
+                while (k < q.size() && byteMatches((uint8_t)key[j + k], (uint8_t)q[k])) k++;
+                if (k == q.size()) {
+                    expect.insert(id);
+                    break;
+                }
+            }
+        }
+        uint32_t ids[64];
+        size_t n = lib.index.query(q.c_str(), ids, 64);
+        std::set<uint32_t> got(ids, ids + n);
+        hits += n;
+        if (expect.size() <= 64 ? got != expect : n != 64) mismatches++;
+        for (uint32_t id : got) {
+            if (!expect.count(id)) mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+    printf("    400 queries over %zu tracks: %zu hits, %d mismatches\n", paths.size(), hits, mismatches);
+}
@@ -0,0 +1,48 @@
+// SeekIndex 构建耗时：60 分钟的 MP3（逐帧扫描）与 FLAC（只读 SEEKTABLE），以及查表开销
+#include "Bench.h"
+#include "MediaGen.h"
+#include "TempDir.h"
+#include "SeekIndex.h"
+#include <SD.h>
+#include <stdio.h>
+
+int main() {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    double minutes = 60.0 * bench::scale();
+
+    printf("%-16s %10s %10s %10s %12s\n", "stream", "MB", "seconds", "build ms", "lookup ns");
+    struct Case {
+        const char *name;
+        const char *path;
+        media::Stream stream;
+    };
+    Case cases[] = {
+        { "mp3 cbr 32k", "/cbr.mp3", media::mp3(minutes * 60, false, false, 1, 4096, 1) },
+        { "mp3 vbr", "/vbr.mp3", media::mp3(minutes * 60 / 4, false, true, 0, 0, 2) },
+        { "flac 10s points", "/a.flac", media::flac(minutes * 60 / 4, 44100, 10, 3) },
+    };
+    for (Case &c : cases) {
+        dir.write(c.path, c.stream.bytes);
+        std::filesystem::remove_all(dir.file("/.seek"));
+
+        uint64_t t0 = bench::nowNs();
+        SeekIndex index;
+        index.open(c.path);
+        while (index.buildStep(8192)) {}
+        uint64_t buildNs = bench::nowNs() - t0;
+
+        uint32_t seconds = index.getIndexedSeconds();
+        uint64_t sum = 0;
+        t0 = bench::nowNs();
+        for (uint32_t i = 0; i < 1000000; i++) {
+            uint32_t offset;
+            if (index.lookup((i * 7919u) % seconds, offset)) sum += offset;
+        }
+        uint64_t lookupNs = bench::nowNs() - t0;
+        bench::keep(sum);
+        printf("%-16s %10.1f %10u %10.1f %12.1f\n", c.name, c.stream.bytes.size() / 1e6, seconds, buildNs / 1e6,
+               lookupNs / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+// SeekIndex：合成 MP3 / FLAC 的跳转精度、索引缓存的失效与损坏处理、写入中断电
+#include "TestHarness.h"
+#include "MediaGen.h"
+#include "TempDir.h"
+#include "SeekIndex.h"
+#include "util/PathHash.h"
+#include <SD.h>
+
+static std::string sidecar(const char *path) {
+    char name[40];
+    snprintf(name, sizeof(name), "/.seek/%016llx.idx", (unsigned long long)pathHash(path));
+    return name;
+}
+
+static void buildAll(SeekIndex &index) {
+    while (index.buildStep(8192)) {}
+}
+
+// 第 s 秒的偏移必须是某一帧的起点，且该帧起始于 [s, s + 一帧) 内（MP3 逐帧扫描）
+static void checkMp3(const media::Stream &s, SeekIndex &index) {
+    double frameSec = (double)s.samplesPerFrame / s.sampleRate;
+    uint32_t seconds = (uint32_t)(s.frames.back().sample / s.sampleRate);
+    CHECK(index.getIndexedSeconds() >= seconds);
+    size_t k = 0;
+    int bad = 0;
+    for (uint32_t sec = 0; sec < index.getIndexedSeconds(); sec++) {
+        uint32_t offset;
+        CHECK(index.lookup(sec, offset));
+        while (k < s.frames.size() && s.frames[k].offset < offset) k++;
+        if (k == s.frames.size() || s.frames[k].offset != offset) {
+            bad++;
+            continue;
+        }
+        double t = (double)s.frames[k].sample / s.sampleRate;
+        if (t < sec || t >= sec + frameSec) bad++;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+TEST(mp3_cbr_offsets_land_on_frames) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    media::Stream s = media::mp3(300, false, false, 9, 2000, 1);
+    dir.write("/a.mp3", s.bytes);
+
+    SeekIndex index;
+    index.open("/a.mp3");
+    CHECK(!index.isComplete());
+    buildAll(index);
+    CHECK(index.isComplete());
+    checkMp3(s, index);
+    CHECK(dir.exists(sidecar("/a.mp3")));
+}
+
+TEST(mp3_vbr_and_mpeg2_offsets_land_on_frames) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    media::Stream vbr = media::mp3(200, false, true, 0, 0, 7);
+    dir.write("/vbr.mp3", vbr.bytes);
+    SeekIndex a;
+    a.open("/vbr.mp3");
+    buildAll(a);
+    checkMp3(vbr, a);
+
+    media::Stream v2 = media::mp3(120, true, false, 8, 300, 3);
+    dir.write("/v2.MP3", v2.bytes);
+    SeekIndex b;
+    b.open("/v2.MP3");
+    buildAll(b);
+    checkMp3(v2, b);
+}
+
+// FLAC 取不晚于目标时刻的最近 seek point
+TEST(flac_uses_nearest_earlier_seek_point) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    media::Stream s = media::flac(95, 44100, 10, 5);
+    dir.write("/a.flac", s.bytes);
+
+    SeekIndex index;
+    index.open("/a.flac");
+    CHECK(index.isComplete()); // SEEKTABLE 一次读完，无需增量构建
+    int bad = 0;
+    for (uint32_t sec = 0; sec < index.getIndexedSeconds(); sec++) {
+        uint32_t offset;
+        CHECK(index.lookup(sec, offset));
+        const media::Frame *f = nullptr;
+        for (const media::Frame &fr : s.frames) {
+            if (fr.offset == offset) f = &fr;
+        }
+        if (!f || f->sample > (uint64_t)sec * s.sampleRate || (uint64_t)sec * s.sampleRate - f->sample > 10ull * s.sampleRate) bad++;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(index.getIndexedSeconds() >= 90);
+}
+
+TEST(cached_index_is_reused) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    media::Stream s = media::mp3(60, false, false, 9, 0, 2);
+    dir.write("/a.mp3", s.bytes);
+    SeekIndex first;
+    first.open("/a.mp3");
+    buildAll(first);
+
+    SeekIndex second;
+    second.open("/a.mp3");
+    CHECK(second.isComplete());
+    CHECK_EQ(second.getIndexedSeconds(), first.getIndexedSeconds());
+    checkMp3(s, second);
+}
+
+TEST(index_is_invalidated_when_file_size_changes) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    dir.write("/a.mp3", media::mp3(60, false, false, 9, 0, 2).bytes);
+    SeekIndex first;
+    first.open("/a.mp3");
+    buildAll(first);
+
+    dir.write("/a.mp3", media::mp3(61, false, false, 9, 0, 2).bytes);
+    SeekIndex second;
+    second.open("/a.mp3");
+    CHECK(!second.isComplete());
+}
+
+static void patchCount(TempDir &dir, const std::string &path, uint32_t count) {
+    std::vector<uint8_t> bytes = dir.read(path);
+    memcpy(&bytes[9], &count, 4);
+    dir.write(path, bytes);
+}
+
+// 损坏的条目数不能导致按其分配内存：只接受索引文件实际容纳得下的数量
+TEST(corrupt_sidecar_count_is_rejected) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    dir.write("/a.mp3", media::mp3(30, false, false, 9, 0, 2).bytes);
+    SeekIndex first;
+    first.open("/a.mp3");
+    buildAll(first);
+    uint32_t count = first.getIndexedSeconds();
+    std::string path = sidecar("/a.mp3");
+
+    for (uint32_t bad : { 0xFFFFFFFFu, 0x40000004u, count + 1, 0u }) {
+        patchCount(dir, path, bad);
+        SeekIndex index;
+        index.open("/a.mp3");
+        CHECK(!index.isComplete());
+        CHECK_EQ(index.getIndexedSeconds(), 0u);
+    }
+
+    // 截断的索引文件
+    patchCount(dir, path, count);
+    std::vector<uint8_t> bytes = dir.read(path);
+    bytes.resize(bytes.size() - 3);
+    dir.write(path, bytes);
+    SeekIndex truncated;
+    truncated.open("/a.mp3");
+    CHECK(!truncated.isComplete());
+}
+
+// 保存过程中任意位置断电：之后要么加载到完整正确的索引，要么重新构建，绝不接受半截文件
+TEST(power_cut_while_saving_never_leaves_a_bad_index) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    media::Stream s = media::mp3(20, false, false, 9, 0, 4);
+    dir.write("/a.mp3", s.bytes);
+    SD.mkdir("/.seek");
+
+    size_t expectedSize = 13 + 21 * 4;
+    int loaded = 0;
+    for (long budget = 0; budget < (long)expectedSize + 8; budget++) {
+        std::filesystem::remove_all(dir.file("/.seek"));
+        SD.mkdir("/.seek");
+        SeekIndex writer;
+        writer.open("/a.mp3");
+        SD.powerCutAfter(budget);
+        buildAll(writer);
+        SD.powerRestore();
+
+        SeekIndex reader;
+        reader.open("/a.mp3");
+        if (reader.isComplete()) {
+            loaded++;
+            CHECK_EQ(reader.getIndexedSeconds(), writer.getIndexedSeconds());
+            checkMp3(s, reader);
+        }
+    }
+    CHECK(loaded > 0);
+    SD.powerRestore();
+}
+
+TEST(leftover_tmp_file_is_ignored_and_replaced) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    media::Stream s = media::mp3(30, false, false, 9, 0, 6);
+    dir.write("/a.mp3", s.bytes);
+    std::string path = sidecar("/a.mp3");
+    dir.write(path + ".tmp", std::vector<uint8_t>(7, 0xAA));
+
+    SeekIndex writer;
+    writer.open("/a.mp3");
+    buildAll(writer);
+    CHECK(!dir.exists(path + ".tmp"));
+
+    SeekIndex reader;
+    reader.open("/a.mp3");
+    CHECK(reader.isComplete());
+    checkMp3(s, reader);
+}
@@ -0,0 +1,99 @@
+// SidecarDir：旁路缓存目录的文件数上限、按目录顺序淘汰最早的文件、替换不计数
+#include "TestHarness.h"
+#include "TempDir.h"
+#include "SidecarDir.h"
+#include <filesystem>
+#include <string>
+
+static size_t countFiles(TempDir &dir, const char *sub) {
+    size_t n = 0;
+    for (const auto &e : std::filesystem::directory_iterator(dir.file(sub))) n += e.is_regular_file();
+    return n;
+}
+
+static std::string name(int i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "/.wave/%04d.pk", i);
+    return buf;
+}
+
+// 写 .tmp 再提交，与 SeekIndex / WaveformIndex 的用法相同
+static bool save(TempDir &dir, SidecarDir &side, int i) {
+    std::string path = name(i);
+    dir.write(path + ".tmp", { (uint8_t)i });
+    return side.commit((path + ".tmp").c_str(), path.c_str());
+}
+
+TEST(count_stays_under_the_cap_and_newest_files_survive) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    SidecarDir side(fs, "/.wave", 16);
+    CHECK(side.prepare());
+    CHECK(dir.exists("/.wave"));
+
+    for (int i = 0; i < 100; i++) {
+        CHECK(save(dir, side, i));
+        CHECK(countFiles(dir, "/.wave") <= 16);
+        CHECK(dir.exists(name(i)));
+        CHECK(!dir.exists(name(i) + ".tmp"));
+    }
+    // 每次超限删到 14 个：最后留下的是最近提交的一段
+    size_t left = countFiles(dir, "/.wave");
+    CHECK(left >= 14);
+    for (int i = 100 - (int)left; i < 100; i++) CHECK(dir.exists(name(i)));
+}
+
+// 每批淘汰只列一次目录，而不是每次提交都列
+TEST(directory_is_listed_once_per_batch) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    SidecarDir side(fs, "/.wave", 64);
+    side.prepare();
+    size_t listed = 0;
+    for (int i = 0; i < 200; i++) {
+        size_t before = fs.stats.listed;
+        save(dir, side, i);
+        if (fs.stats.listed != before) listed++;
+    }
+    // 第一次提交时统计一次；之后数量每到 65 就删到 56，即第 65、74、83 ... 个提交各列一次
+    CHECK_EQ(listed, (size_t)(1 + (200 - 65) / 9 + 1));
+}
+
+// 卡上已有超过上限的旧文件：第一次新增时统计并一次删到 7/8
+TEST(existing_files_are_counted_on_first_commit) {
+    TempDir dir;
+    for (int i = 0; i < 40; i++) dir.write(name(i), { 1 });
+    fs::FS fs(dir.path());
+    SidecarDir side(fs, "/.wave", 16);
+    CHECK(save(dir, side, 40));
+    CHECK_EQ(countFiles(dir, "/.wave"), 14u);
+    CHECK(dir.exists(name(40)));
+    CHECK(!dir.exists(name(0)));
+}
+
+// 替换已有文件不增加计数，也不触发淘汰
+TEST(replacing_a_file_does_not_grow_the_count) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    SidecarDir side(fs, "/.wave", 4);
+    side.prepare();
+    for (int i = 0; i < 4; i++) save(dir, side, i);
+    size_t removes = fs.stats.removes;
+    for (int k = 0; k < 10; k++) CHECK(save(dir, side, 2));
+    CHECK_EQ(fs.stats.removes - removes, 10u); // 只有替换前删旧文件
+    CHECK_EQ(countFiles(dir, "/.wave"), 4u);
+    CHECK(dir.read(name(2)) == std::vector<uint8_t>{ 2 });
+}
+
+// 改名失败（断电）返回 false，由调用方删除 .tmp
+TEST(failed_commit_reports_false) {
+    TempDir dir;
+    fs::FS fs(dir.path());
+    SidecarDir side(fs, "/.wave", 4);
+    side.prepare();
+    dir.write(name(0) + ".tmp", { 0 });
+    fs.powerCutAfter(0);
+    CHECK(!side.commit((name(0) + ".tmp").c_str(), name(0).c_str()));
+    fs.powerRestore();
+    CHECK(!dir.exists(name(0)));
+}
@@ -0,0 +1,137 @@
+// SleepScheduler 主机模型：背光 / 调频 / 深度睡眠的时间线，以及用主循环时间线验证休眠不拖慢界面帧与按键分发
+#include "TestHarness.h"
+#include "power/SleepScheduler.h"
+
+static PowerInputs inputs(uint32_t now, uint32_t lastActivity, bool playing, uint32_t pausedSince = 0) {
+    PowerInputs in;
+    in.nowMs = now;
+    in.lastActivityMs = lastActivity;
+    in.pausedSinceMs = pausedSince;
+    in.loopWorkUs = 100;
+    in.playing = playing;
+    in.heavyDecode = false;
+    return in;
+}
+
+TEST(backlight_dims_then_turns_off) {
+    SleepScheduler s;
+    CHECK_EQ(s.plan(inputs(1000, 0, true)).backlight, BACKLIGHT_FULL);
+    CHECK_EQ(s.plan(inputs(29999, 0, true)).backlight, BACKLIGHT_FULL);
+    CHECK_EQ(s.plan(inputs(30000, 0, true)).backlight, BACKLIGHT_DIM);
+    CHECK_EQ(s.plan(inputs(120000, 0, true)).backlight, BACKLIGHT_OFF);
+    // 按键后恢复
+    CHECK_EQ(s.plan(inputs(130000, 129000, true)).backlight, BACKLIGHT_FULL);
+}
+
+TEST(cpu_profile_follows_decode_load) {
+    SleepScheduler s;
+    PowerInputs in = inputs(0, 0, true);
+    CHECK_EQ(s.plan(in).cpu, CPU_BALANCED);
+    in.heavyDecode = true;
+    CHECK_EQ(s.plan(in).cpu, CPU_PERFORMANCE);
+    PowerPlan paused = s.plan(inputs(0, 0, false));
+    CHECK_EQ(paused.cpu, CPU_ECO);
+    CHECK(paused.lightSleep);
+    CHECK(!s.plan(in).lightSleep); // 播放中 I2S 持有 PM 锁
+}
+
+// 暂停满 10 分钟且期间无按键才深度睡眠；播放中从不
+TEST(deep_sleep_needs_pause_and_idle) {
+    SleepScheduler s;
+    const uint32_t t = 1000000;
+    CHECK(!s.plan(inputs(t, 0, true, 0)).deepSleep);
+    CHECK(!s.plan(inputs(t, 0, false, t - 599999)).deepSleep);
+    CHECK(s.plan(inputs(t, 0, false, t - 600000)).deepSleep);
+    CHECK(!s.plan(inputs(t, t - 1000, false, 0)).deepSleep);
+    // millis() 回绕
+    CHECK(s.plan(inputs(5000, 5000 - 700000u, false, 5000 - 650000u)).deepSleep);
+}
+
+// 主循环时间线：每轮先分发按键（input.loop()），再做本轮工作（耗时随机，偶有 SD 读写 / 整屏重绘的尖峰），
+// 最后按计划休眠。按键边沿在任意时刻到达，延迟 = 到下一轮开始的时间；屏幕亮着时每轮画一帧。
+struct LoopStats {
+    double maxInputMs = 0;    // 边沿到分发的最长延迟（不含超出预算的尖峰轮）
+    double maxFrameMs = 0;    // 亮屏时相邻两帧的最长间隔（同上）
+    double minFrameMs = 1e9;  // 亮屏时相邻两帧的最短间隔：过短说明在空转
+    double sleptMs = 0;
+    double totalMs = 0;
+};
+
+// 最近一次按键在 0 时刻，从 startMs 开始跑 seconds 秒
+static LoopStats simulate(const SleepScheduler &s, uint32_t startMs, bool playing, double seconds) {
+    LoopStats st;
+    double now = startMs;
+    uint32_t seed = 7;
+    auto rnd = [&seed](uint32_t n) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % n;
+    };
+    double start = now;
+    while (now - start < seconds * 1000) {
+        double roundStart = now;
+        double work = 0.5 + rnd(4000) / 1000.0;
+        if (rnd(100) == 0) work += 45; // 尖峰：超出预算，本轮不休眠
+        now += work;
+
+        PowerInputs in = inputs((uint32_t)now, 0, playing);
+        in.loopWorkUs = (uint32_t)(work * 1000);
+        PowerPlan p = s.plan(in);
+        now += p.loopSleepMs;
+        st.sleptMs += p.loopSleepMs;
+
+        double round = now - roundStart;
+        uint16_t budget = p.backlight == BACKLIGHT_OFF ? s.inputLatencyMs : s.uiFrameMs;
+        if (work < budget) {
+            // 本轮内任意时刻到达的边沿，最晚在下一轮开始时分发
+            if (round > st.maxInputMs) st.maxInputMs = round;
+            if (p.backlight != BACKLIGHT_OFF) {
+                if (round > st.maxFrameMs) st.maxFrameMs = round;
+                if (round < st.minFrameMs) st.minFrameMs = round;
+            }
+        }
+    }
+    st.totalMs = now - start;
+    return st;
+}
+
+// 亮屏：每轮补足到一帧，帧间隔落在 (uiFrameMs - 1, uiFrameMs]，按键分发同样不超过一帧
+TEST(screen_on_loop_keeps_frame_rate) {
+    SleepScheduler s;
+    for (bool playing : { true, false }) {
+        LoopStats st = simulate(s, 0, playing, 20);
+        CHECK(st.maxFrameMs <= s.uiFrameMs);
+        CHECK(st.minFrameMs > s.uiFrameMs - 1);
+        CHECK(st.maxInputMs <= s.uiFrameMs);
+        CHECK(st.sleptMs > st.totalMs * 0.8); // 大部分时间在休眠
+    }
+}
+
+// 熄屏：没有帧要画，按按键延迟预算休眠，休眠更长但分发不超过 inputLatencyMs
+TEST(screen_off_loop_stays_within_input_latency) {
+    SleepScheduler s;
+    for (bool playing : { true, false }) {
+        LoopStats st = simulate(s, s.backlightOffAfterMs, playing, 60);
+        CHECK(st.maxInputMs <= s.inputLatencyMs);
+        CHECK(st.maxInputMs > s.inputLatencyMs - 1);
+        CHECK_EQ(st.maxFrameMs, 0.0);
+        CHECK(st.sleptMs > st.totalMs * 0.9);
+    }
+}
+
+// 休眠只补足预算的剩余部分：本轮工作已超出预算时不休眠
+TEST(busy_loop_does_not_sleep) {
+    SleepScheduler s;
+    PowerInputs in = inputs(1000, 0, true);
+    in.loopWorkUs = 0;
+    CHECK_EQ(s.plan(in).loopSleepMs, s.uiFrameMs);
+    in.loopWorkUs = 12500;
+    CHECK_EQ(s.plan(in).loopSleepMs, 17);
+    in.loopWorkUs = s.uiFrameMs * 1000;
+    CHECK_EQ(s.plan(in).loopSleepMs, 0);
+    in.loopWorkUs = 80000;
+    CHECK_EQ(s.plan(in).loopSleepMs, 0);
+
+    in = inputs(s.backlightOffAfterMs, 0, true);
+    in.loopWorkUs = 12500;
+    CHECK_EQ(s.plan(in).loopSleepMs, s.inputLatencyMs - 13);
+}
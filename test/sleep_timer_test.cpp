@@ -0,0 +1,121 @@
+// SleepTimer：虚拟时钟推进档位、淡出与到期；GainRamp：逐样本增益的淡出平滑度
+#include "TestHarness.h"
+#include "dsp/GainRamp.h"
+#include "power/SleepTimer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <vector>
+
+TEST(cycle_through_presets) {
+    SleepTimer t;
+    CHECK_EQ(t.update(0, 0).minutesLeft, -1);
+    CHECK_EQ(t.cycle(0), SLEEP_15_MIN);
+    CHECK_EQ(t.cycle(0), SLEEP_30_MIN);
+    CHECK_EQ(t.cycle(0), SLEEP_60_MIN);
+    CHECK_EQ(t.cycle(0), SLEEP_END_OF_TRACK);
+    CHECK_EQ(t.cycle(0), SLEEP_OFF);
+    CHECK_EQ(t.update(0, 0).gain, 256);
+}
+
+// 15 分钟档：每秒推进一次，剩余分钟单调递减，最后 30 秒线性淡出，到点到期
+TEST(fifteen_minutes_fade_and_expire) {
+    SleepTimer t;
+    const uint32_t start = 1000;
+    t.cycle(start);
+    int lastMinutes = 16;
+    uint16_t lastGain = 256;
+    uint32_t expiredAt = 0;
+    for (uint32_t now = start; now <= start + 16 * 60000; now += 1000) {
+        SleepTimerState st = t.update(now, 0);
+        CHECK(st.minutesLeft <= lastMinutes);
+        lastMinutes = st.minutesLeft;
+        CHECK(st.gain <= lastGain);
+        lastGain = st.gain;
+        if (now < start + 15 * 60000 - 30000) {
+            CHECK(!st.fading);
+            CHECK_EQ(st.gain, 256);
+        }
+        if (st.expired) {
+            expiredAt = now;
+            break;
+        }
+    }
+    CHECK_EQ(expiredAt, start + 15 * 60000);
+    CHECK_EQ(t.update(start + 15 * 60000 - 15000, 0).gain, 128);
+    CHECK(t.update(start + 15 * 60000 - 15000, 0).fading);
+    CHECK_EQ(t.update(start + 60000, 0).minutesLeft, 14);
+}
+
+TEST(deadline_survives_millis_wraparound) {
+    SleepTimer t;
+    uint32_t start = 0xFFFFFFFFu - 5 * 60000;
+    t.cycle(start); // 15 分钟，跨过回绕
+    CHECK(!t.update(start + 10 * 60000, 0).expired);
+    CHECK_EQ(t.update(start + 10 * 60000, 0).minutesLeft, 5);
+    CHECK(t.update(start + 15 * 60000, 0).expired);
+}
+
+TEST(end_of_track_fades_with_track_and_stops_on_eof) {
+    SleepTimer t;
+    for (int i = 0; i < 4; i++) t.cycle(0);
+    CHECK_EQ(t.getMode(), SLEEP_END_OF_TRACK);
+    SleepTimerState st = t.update(0, 120000);
+    CHECK_EQ(st.minutesLeft, 0);
+    CHECK_EQ(st.gain, 256);
+    CHECK_EQ(t.update(0, 15000).gain, 128);
+    CHECK(!t.update(0, 0).expired); // 时长未知：不淡出，等曲目结束
+    CHECK(t.onTrackEnd());
+    CHECK(t.update(0, 0).expired);
+}
+
+TEST(cancel_restores_gain) {
+    SleepTimer t;
+    t.cycle(0);
+    CHECK(t.update(15 * 60000 - 1000, 0).fading);
+    t.cancel();
+    SleepTimerState st = t.update(15 * 60000 - 1000, 0);
+    CHECK_EQ(st.gain, 256);
+    CHECK(!st.expired);
+    CHECK(!t.onTrackEnd());
+}
+
+// 淡出 30 秒、主循环每 20ms 更新一次增益、每块 512 帧：
+// 逐样本增益在音量 5 时仍有上百级，而旧做法（改音量档位）只剩 5 级；相邻样本的增益跳变不超过 1/256
+TEST(per_sample_fade_is_smooth_at_low_volume) {
+    SleepTimer t;
+    t.cycle(0);
+    const uint32_t fadeStart = 15 * 60000 - 30000;
+    std::set<int> volumeSteps, gainSteps;
+    uint16_t applied = 256;
+    int maxJump = 0;
+    std::vector<int16_t> block(512 * 2);
+    for (uint32_t now = fadeStart; now <= 15 * 60000; now += 20) {
+        uint16_t gain = t.update(now, 0).gain;
+        volumeSteps.insert((5 * gain + 255) >> 8);
+
+        for (size_t i = 0; i < block.size(); i++) block[i] = 16384;
+        applyGainRamp(block.data(), 512, applied, gain);
+        applied = gain;
+        for (size_t i = 0; i < 512; i++) {
+            gainSteps.insert(block[i * 2]);
+            if (i) {
+                int jump = abs(block[i * 2] - block[(i - 1) * 2]);
+                if (jump > maxJump) maxJump = jump;
+            }
+        }
+    }
+    CHECK(volumeSteps.size() <= 6u);
+    CHECK(gainSteps.size() >= 200u);
+    CHECK(maxJump <= 16384 / 256 + 1);
+}
+
+TEST(gain_ramp_identity_and_silence) {
+    int16_t buf[8] = { 1000, -1000, 32767, -32768, 5, -5, 0, 77 };
+    int16_t copy[8];
+    memcpy(copy, buf, sizeof(buf));
+    applyGainRamp(buf, 4, 256, 256);
+    CHECK(memcmp(buf, copy, sizeof(buf)) == 0);
+    applyGainRamp(buf, 4, 0, 0);
+    for (int16_t v : buf) CHECK_EQ(v, 0);
+}
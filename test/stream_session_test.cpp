@@ -0,0 +1,411 @@
+// StreamSession + JitterBuffer：在虚拟时钟上对着脚本化的 Icecast 替身（StreamTransport）运行，
+// 消费端按解码器模型读取（输入缓冲最多 16KB，按实测字节率消耗）。每帧负载带序号，
+// 检查快速起播、抖动下的目标深度、短暂停顿被吸收、长断流后恢复、重连时突发重发的旧帧被拼接掉，
+// 以及重定向、4xx / 5xx、不支持的格式；另有 FrameSync 与 StreamUrl 的单元检查
+#include "TestHarness.h"
+#include "stream/StreamSession.h"
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// 128kbps / 44.1kHz MPEG-1 Layer III，无填充：每帧 417 字节、1152 个采样（约 26.1ms）
+static const uint8_t kMp3Header[4] = { 0xFF, 0xFB, 0x90, 0x00 };
+static const size_t kFrameLen = 417;
+static const int64_t kFrameUs = 1152LL * 1000000 / 44100;
+static const int64_t kHistoryUs = 10000000; // 服务器在测试开始前已运行 10 秒，连接时有内容可突发
+
+static uint8_t frameByte(uint32_t seq, size_t i) {
+    if (i < 4) return kMp3Header[i];
+    if (i < 8) return (uint8_t)(seq >> (8 * (i - 4)));
+    return (uint8_t)((seq + i) % 200); // 不含 0xFF，负载中不会出现假帧头
+}
+
+// Icecast 替身：直播源按实时产生帧，新连接先突发最近 burstBytes 的内容；
+// 可注入到达抖动、停顿（期间不发送任何数据，之后补发）、断开连接，以及固定的 HTTP 响应
+class FakeIcecast : public StreamTransport {
+public:
+    explicit FakeIcecast(const uint32_t &clock) : _clock(clock) {}
+
+    // ---- 脚本 ----
+    std::map<std::string, std::string> responses; // 路径 → 完整的响应头（非 /stream）
+    std::string contentType = "audio/mpeg";
+    size_t burstBytes = 65536;
+    uint32_t jitterMs = 0;     // 与 tools/stream_server.py 的 jitter 相同：每 0.5 秒随机停顿 0..jitterMs
+    uint32_t stallFrom = 0, stallTo = 0;
+    std::vector<uint32_t> dropAt;
+
+    // ---- 观察 ----
+    int connects = 0;
+    std::string lastHost, lastRequest;
+    uint16_t lastPort = 0;
+
+    bool connect(const char *host, uint16_t port, uint32_t) override {
+        connects++;
+        lastHost = host;
+        lastPort = port;
+        _open = true;
+        _request.clear();
+        _reply.clear();
+        _replyPos = 0;
+        _streaming = false;
+        return true;
+    }
+
+    bool write(const uint8_t *buf, size_t len) override {
+        if (!_open) return false;
+        _request.append((const char *)buf, len);
+        if (_request.find("\r\n\r\n") == std::string::npos) return true;
+        lastRequest = _request;
+        std::string path = _request.substr(4, _request.find(' ', 4) - 4);
+        if (path == "/stream") {
+            _reply = "HTTP/1.0 200 OK\r\nContent-Type: " + contentType + "\r\nicy-br: 128\r\n\r\n";
+            _streaming = true;
+            uint32_t live = producedBy(_clock);
+            uint32_t burst = (uint32_t)(burstBytes / kFrameLen);
+            _nextFrame = live > burst ? live - burst : 0;
+            _burstEnd = live;
+            _frameOffset = 0;
+        } else {
+            auto it = responses.find(path);
+            _reply = it != responses.end() ? it->second : "HTTP/1.0 404 Not Found\r\n\r\n";
+        }
+        return true;
+    }
+
+    int read(uint8_t *buf, size_t len) override {
+        if (!_open) return -1;
+        uint32_t now = _clock;
+        for (size_t i = 0; i < dropAt.size(); i++) {
+            if (now >= dropAt[i] && _streaming) {
+                dropAt.erase(dropAt.begin() + i);
+                _open = false;
+                return -1;
+            }
+        }
+        if (now >= stallFrom && now < stallTo) return 0;
+        if (_request.find("\r\n\r\n") == std::string::npos) return 0;
+
+        size_t n = 0;
+        while (n < len && _replyPos < _reply.size()) buf[n++] = _reply[_replyPos++];
+        if (!_streaming) {
+            if (n) return (int)n;
+            _open = false; // 非流响应发完即关闭
+            return -1;
+        }
+        while (n < len && deliverAt(_nextFrame) <= now) {
+            size_t take = kFrameLen - _frameOffset < len - n ? kFrameLen - _frameOffset : len - n;
+            for (size_t i = 0; i < take; i++) buf[n + i] = frameByte(_nextFrame, _frameOffset + i);
+            n += take;
+            _frameOffset += take;
+            if (_frameOffset == kFrameLen) {
+                _frameOffset = 0;
+                _nextFrame++;
+            }
+        }
+        return (int)n;
+    }
+
+    void close() override { _open = false; }
+
+private:
+    static int64_t producedUs(uint32_t seq) { return (int64_t)seq * kFrameUs - kHistoryUs; }
+    static uint32_t producedBy(uint32_t nowMs) { return (uint32_t)(((int64_t)nowMs * 1000 + kHistoryUs) / kFrameUs); }
+
+    // 突发部分立即可读，直播部分按产生时刻；抖动停顿或停顿期间产生的帧，停顿结束后才到
+    uint32_t deliverAt(uint32_t seq) const {
+        if (seq < _burstEnd) return 0;
+        int64_t at = producedUs(seq) / 1000;
+        if (jitterMs && at >= 0) {
+            uint64_t x = (uint64_t)(at / 500 + 1) * 0x9E3779B97F4A7C15ull; // 每个 0.5 秒窗口一个随机停顿
+            x = (x ^ (x >> 31)) * 0xBF58476D1CE4E5B9ull;
+            int64_t pauseEnd = at / 500 * 500 + (int64_t)((x >> 32) % (jitterMs + 1));
+            if (at < pauseEnd) at = pauseEnd;
+        }
+        if (at >= stallFrom && at < stallTo) at = stallTo;
+        return at < 0 ? 0 : (uint32_t)at;
+    }
+
+    const uint32_t &_clock;
+    bool _open = false;
+    bool _streaming = false;
+    std::string _request, _reply;
+    size_t _replyPos = 0;
+    uint32_t _nextFrame = 0, _burstEnd = 0;
+    size_t _frameOffset = 0;
+};
+
+// 一次收听：会话按返回的等待时间推进，消费端每 10ms 按解码器模型读取并核对帧序号
+struct Listener {
+    uint32_t now = 0;
+    FakeIcecast server{ now };
+    std::vector<uint8_t> mem = std::vector<uint8_t>(512 * 1024);
+    JitterBuffer buffer;
+    StreamSession session{ server, buffer };
+
+    uint32_t startedMs = UINT32_MAX;
+    double lead = 0;
+    std::vector<uint8_t> partial;
+    int64_t lastSeq = -1;
+    uint32_t frames = 0, duplicates = 0, gaps = 0;
+    uint32_t slowedMs = 0;
+    uint32_t maxTargetMs = 0;
+
+    Listener() { buffer.begin(mem.data(), mem.size()); }
+
+    bool open(const char *url) {
+        buffer.reset(now);
+        return session.open(url, now);
+    }
+
+    void run(uint32_t untilMs) {
+        uint32_t wake = now;
+        uint32_t lastTick = now;
+        for (; now < untilMs; now++) {
+            if (now >= wake) {
+                uint32_t wait = session.step(now);
+                wake = now + (wait ? wait : 1);
+            }
+            if (now - lastTick >= 10) {
+                consume(now - lastTick);
+                lastTick = now;
+            }
+        }
+    }
+
+    void consume(uint32_t dt) {
+        if (startedMs == UINT32_MAX) {
+            if (!buffer.canStart()) return;
+            startedMs = now;
+        }
+        int adjust = buffer.rateAdjust((uint32_t)lead);
+        if (adjust < 0) slowedMs += dt;
+        double need = buffer.byteRate() * dt / 1000.0 * (adjust < 0 ? 0.96 : 1.0);
+        lead = lead > need ? lead - need : 0;
+        uint8_t tmp[16384];
+        size_t n = buffer.read(tmp, sizeof(tmp) - (size_t)lead, (uint32_t)lead, now);
+        lead += n;
+        partial.insert(partial.end(), tmp, tmp + n);
+        size_t off = 0;
+        for (; off + kFrameLen <= partial.size(); off += kFrameLen) {
+            const uint8_t *f = &partial[off];
+            uint32_t seq = f[4] | f[5] << 8 | f[6] << 16 | (uint32_t)f[7] << 24;
+            if (memcmp(f, kMp3Header, 4) != 0 || (int64_t)seq <= lastSeq) duplicates++;
+            else if (lastSeq >= 0 && seq != lastSeq + 1) gaps++;
+            if ((int64_t)seq > lastSeq) lastSeq = seq;
+            frames++;
+        }
+        partial.erase(partial.begin(), partial.begin() + off);
+        if (buffer.targetMs() > maxTargetMs) maxTargetMs = buffer.targetMs();
+    }
+
+    StreamHealth health() {
+        StreamHealth h;
+        buffer.fillHealth(h, (uint32_t)lead);
+        return h;
+    }
+
+    void print(const char *name) {
+        StreamHealth h = health();
+        printf("    %-12s start %u ms, %u frames, jitter peak %u ms, target %u ms (max %u), underruns %u, stall %u ms, "
+               "reconnects %u, spliced %u, slowed %u ms\n",
+               name, startedMs, frames, h.peakMs, h.targetMs, maxTargetMs, h.underruns, h.stallMs, session.reconnects(),
+               session.splicedFrames(), slowedMs);
+    }
+};
+
+static const char *kStream = "http://radio.local:8000/stream";
+
+TEST(clean_stream_fast_starts_without_underruns) {
+    Listener l;
+    CHECK(l.open(kStream));
+    l.run(30000);
+    l.print("clean");
+    StreamHealth h = l.health();
+    CHECK(l.startedMs <= 100); // 突发的内容足够起播
+    CHECK_EQ(l.session.link(), LINK_STREAMING);
+    CHECK_EQ(l.session.codec(), CODEC_MP3);
+    CHECK_EQ(h.underruns, 0);
+    CHECK_EQ(l.duplicates, 0u);
+    CHECK_EQ(l.gaps, 0u);
+    CHECK(l.frames > 1000);
+    CHECK(h.byteRate >= 15900 && h.byteRate <= 16000);
+    CHECK_EQ(l.server.lastHost, std::string("radio.local"));
+    CHECK_EQ(l.server.lastPort, 8000);
+    CHECK(l.server.lastRequest.find("GET /stream HTTP/1.0\r\nHost: radio.local:8000\r\n") == 0);
+    CHECK(l.server.lastRequest.find("Icy-MetaData: 0") != std::string::npos);
+}
+
+// 没有突发的服务器：等到 startMs（400ms）的内容才起播
+TEST(without_burst_start_waits_for_start_depth) {
+    Listener l;
+    l.server.burstBytes = 0;
+    CHECK(l.open(kStream));
+    l.run(10000);
+    l.print("no burst");
+    CHECK(l.startedMs >= 350 && l.startedMs <= 500);
+    CHECK(l.slowedMs > 0); // 起播时深度不足目标，略微放慢补足
+    CHECK_EQ(l.health().underruns, 0);
+    CHECK_EQ(l.gaps + l.duplicates, 0u);
+}
+
+TEST(jitter_raises_the_target_depth) {
+    Listener l;
+    l.server.jitterMs = 800;
+    CHECK(l.open(kStream));
+    l.run(40000);
+    l.print("jitter 800");
+    StreamHealth h = l.health();
+    CHECK(h.peakMs >= 600);
+    CHECK(h.targetMs >= 1000 + 200 && h.targetMs <= 800 * 5 / 4 + 300 + 50);
+    CHECK_EQ(h.underruns, 0);
+    CHECK_EQ(l.gaps + l.duplicates, 0u);
+}
+
+TEST(short_stall_is_absorbed) {
+    Listener l;
+    l.server.stallFrom = 6000;
+    l.server.stallTo = 7200;
+    CHECK(l.open(kStream));
+    l.run(20000);
+    l.print("stall 1.2 s");
+    CHECK_EQ(l.health().underruns, 0);
+    CHECK_EQ(l.session.reconnects(), 0);
+    CHECK_EQ(l.gaps + l.duplicates, 0u);
+}
+
+// 8 秒停顿：超过断流判定后重连（连接期间服务器也不响应，先等响应头超时再退避），缓冲耗尽断流一次，
+// 服务器恢复后重新缓冲继续播放；已播出的内容不会重播
+TEST(long_stall_reconnects_and_recovers) {
+    Listener l;
+    l.server.stallFrom = 6000;
+    l.server.stallTo = 14000;
+    CHECK(l.open(kStream));
+    l.run(25000);
+    l.print("stall 8 s");
+    StreamHealth h = l.health();
+    CHECK(l.session.reconnects() >= 1);
+    CHECK(h.underruns >= 1);
+    CHECK(h.stallMs > 0);
+    CHECK_EQ(h.playout, PLAYOUT_PLAYING);
+    CHECK_EQ(l.session.link(), LINK_STREAMING);
+    CHECK_EQ(l.duplicates, 0u);
+}
+
+// 服务器两次断开：立即重连，新连接开头突发的旧帧按 CRC 丢弃，从第一帧新内容接上
+TEST(reconnect_splices_out_the_burst) {
+    Listener l;
+    l.server.dropAt = { 5000, 9000 };
+    CHECK(l.open(kStream));
+    l.run(15000);
+    l.print("two drops");
+    StreamHealth h = l.health();
+    CHECK_EQ(l.session.reconnects(), 2);
+    CHECK(l.session.splicedFrames() >= 2 * (65536 / kFrameLen) - 4);
+    CHECK_EQ(h.underruns, 0);
+    CHECK_EQ(l.duplicates, 0u);
+    CHECK_EQ(l.gaps, 0u);
+}
+
+TEST(redirects_are_followed_and_bounded) {
+    Listener l;
+    l.server.responses["/live"] = "HTTP/1.0 302 Found\r\nLocation: http://edge.local:8080/hop\r\n\r\n";
+    l.server.responses["/hop"] = "HTTP/1.1 301 Moved\r\nlocation: /stream\r\n\r\n";
+    CHECK(l.open("http://radio.local/live"));
+    l.run(3000);
+    CHECK_EQ(l.session.link(), LINK_STREAMING);
+    CHECK_EQ(l.server.connects, 3);
+    CHECK_EQ(l.server.lastHost, std::string("edge.local"));
+    CHECK_EQ(l.server.lastPort, 8080);
+    CHECK(l.startedMs != UINT32_MAX);
+
+    Listener loop;
+    loop.server.responses["/a"] = "HTTP/1.0 302 Found\r\nLocation: /a\r\n\r\n";
+    CHECK(loop.open("http://radio.local/a"));
+    loop.run(2000);
+    CHECK_EQ(loop.session.link(), LINK_FAILED);
+    CHECK_STR(loop.session.error(), "too many redirects");
+    CHECK_EQ(loop.server.connects, StreamSession::kMaxRedirects + 1);
+}
+
+// 4xx 与不支持的格式不再重试；5xx 按 250ms 起指数退避
+TEST(errors_fail_or_back_off) {
+    Listener notFound;
+    CHECK(notFound.open("http://radio.local/missing"));
+    notFound.run(5000);
+    CHECK_EQ(notFound.session.link(), LINK_FAILED);
+    CHECK_STR(notFound.session.error(), "http 404");
+    CHECK_EQ(notFound.server.connects, 1);
+
+    Listener busy;
+    busy.server.responses["/busy"] = "HTTP/1.0 503 Service Unavailable\r\n\r\n";
+    CHECK(busy.open("http://radio.local/busy"));
+    busy.run(4000);
+    CHECK_EQ(busy.session.link(), LINK_BACKOFF);
+    CHECK_STR(busy.session.error(), "http 503");
+    CHECK_EQ(busy.server.connects, 5); // 0、0.25、0.75、1.75、3.75 秒
+
+    Listener html;
+    html.server.contentType = "text/html; charset=utf-8";
+    CHECK(html.open(kStream));
+    html.run(2000);
+    CHECK_EQ(html.session.link(), LINK_FAILED);
+    CHECK_STR(html.session.error(), "type text/html");
+
+    Listener chunked;
+    chunked.server.responses["/c"] = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+    CHECK(chunked.open("http://radio.local/c"));
+    chunked.run(1000);
+    CHECK_STR(chunked.session.error(), "chunked not supported");
+
+    Listener bad;
+    CHECK(!bad.open("https://radio.local/stream"));
+    CHECK_EQ(bad.session.link(), LINK_FAILED);
+    CHECK_EQ(bad.server.connects, 0);
+}
+
+TEST(url_parsing) {
+    StreamUrl u;
+    CHECK(u.parse("http://radio.local"));
+    CHECK_EQ(u.host, std::string("radio.local"));
+    CHECK_EQ(u.port, 80);
+    CHECK_EQ(u.path, std::string("/"));
+    CHECK(u.parse("HTTP://10.0.0.2:8000/live.mp3?x=1#frag"));
+    CHECK_EQ(u.host, std::string("10.0.0.2"));
+    CHECK_EQ(u.port, 8000);
+    CHECK_EQ(u.path, std::string("/live.mp3?x=1"));
+    CHECK(!u.parse("https://radio.local/"));
+    CHECK(!u.parse("http://user:pw@radio.local/"));
+    CHECK(!u.parse("http://radio.local:0/"));
+    CHECK(!u.parse("http://radio.local:99999/"));
+    CHECK(!u.parse("http://:8000/"));
+}
+
+TEST(frame_sync) {
+    uint8_t mp3[2000] = {};
+    for (int i = 0; i < 4; i++) memcpy(mp3 + 100 + i * kFrameLen, kMp3Header, 4);
+    FrameInfo info;
+    size_t keep = 99;
+    CHECK_EQ(FrameSync::find(mp3, sizeof(mp3), CODEC_UNKNOWN, info, keep), 100);
+    CHECK_EQ(info.codec, CODEC_MP3);
+    CHECK_EQ(info.length, kFrameLen);
+    CHECK_EQ(info.samples, 1152);
+    CHECK_EQ(info.sampleRate, 44100u);
+    // 下一帧头还没到：保留候选帧头，之前的字节可丢弃
+    CHECK_EQ(FrameSync::find(mp3, 100 + kFrameLen + 3, CODEC_UNKNOWN, info, keep), -1);
+    CHECK_EQ(keep, 100u);
+    CHECK_EQ(FrameSync::find(mp3, sizeof(mp3), CODEC_AAC, info, keep), -1);
+
+    // ADTS：AAC-LC 44.1kHz，帧长 371，无 CRC
+    uint8_t adts[7] = { 0xFF, 0xF1, 0x50, 0x80, 0, 0, 0xFC };
+    adts[3] |= (371 >> 11) & 3;
+    adts[4] = (371 >> 3) & 0xFF;
+    adts[5] = (uint8_t)((371 & 7) << 5) | 0x1F;
+    CHECK(FrameSync::parseHeader(adts, sizeof(adts), CODEC_UNKNOWN, info));
+    CHECK_EQ(info.codec, CODEC_AAC);
+    CHECK_EQ(info.length, 371);
+    CHECK_EQ(info.samples, 1024);
+    CHECK_EQ(info.sampleRate, 44100u);
+    CHECK(!FrameSync::parseHeader(adts, sizeof(adts), CODEC_MP3, info));
+    CHECK(!FrameSync::parseHeader(adts, 6, CODEC_UNKNOWN, info));
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+
+// 基准测试用计时。BENCH_SCALE 环境变量放大工作量（默认 1，ctest 中保持快速）。
+namespace bench {
+
+inline uint64_t nowNs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline int scale() {
+    const char *s = getenv("BENCH_SCALE");
+    int n = s ? atoi(s) : 1;
+    return n > 0 ? n : 1;
+}
+
+// 阻止编译器优化掉被测结果
+template <typename T>
+inline void keep(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace bench
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "playlist/FatScanner.h"
+
+// 测试用的 FAT32 镜像：按 Microsoft FAT 规范写出引导扇区、FAT 表与目录簇（长文件名 + 8.3 条目），
+// 稀疏存放，未写入的扇区读出为 0，几十万扇区的卷也只占几百 KB。构建环境里不一定有 mkfs.fat，
+// 这里直接构造，同时记录每个目录项的槽位，供基准按 FATFS 的访问方式估算 VFS 扫描的读扇区数。
+namespace fat {
+
+class Image : public BlockDevice {
+public:
+    static const uint32_t kSector = 512;
+    static const uint32_t kReserved = 32;
+    static const uint32_t kFats = 2;
+
+    struct Options {
+        uint32_t sectorsPerCluster = 8;
+        uint32_t clusters = 70000; // FAT32 至少 65525 簇
+        bool mbr = false;          // 分区从 2048 扇区开始，扇区 0 为 MBR
+        bool fragment = true;      // 目录簇链随机分散，而不是连续分配
+        uint32_t seed = 1;
+    };
+
+    struct Item {
+        std::string name;  // UTF-8
+        uint32_t firstSlot; // 第一个目录项（LFN 或短名）的槽位
+        uint32_t lastSlot;  // 短名条目的槽位
+        int child;          // 子目录下标，文件为 -1
+    };
+
+    struct Dir {
+        std::string path; // 根目录为 ""
+        std::vector<uint8_t> entries;
+        std::vector<uint32_t> chain;
+        std::vector<Item> items;
+        uint32_t slots() const { return (uint32_t)(entries.size() / 32); }
+    };
+
+    explicit Image(const Options &o) : _o(o), _seed(o.seed), _used(o.clusters + 2, false) {
+        _base = o.mbr ? 2048 : 0;
+        _fatSize = ((o.clusters + 2) * 4 + kSector - 1) / kSector;
+        _total = kReserved + kFats * _fatSize + o.clusters * o.sectorsPerCluster;
+        _used[0] = _used[1] = true;
+        _next = 2;
+        dirs.push_back(Dir());
+        dirs[0].chain.push_back(alloc());
+        appendEntry(dirs[0], shortEntry("TESTVOL    ", 0x08, 0, 0));
+    }
+
+    // 在 parent 下建子目录（总是带长文件名），返回目录下标
+    int mkdir(int parent, const std::string &name) {
+        int index = (int)dirs.size();
+        dirs.push_back(Dir());
+        Dir &d = dirs.back();
+        d.path = dirs[parent].path + "/" + name;
+        d.chain.push_back(alloc());
+        appendEntry(d, shortEntry(".          ", 0x10, d.chain[0], 0));
+        appendEntry(d, shortEntry("..         ", 0x10, parent == 0 ? 0 : dirs[parent].chain[0], 0));
+        addLong(parent, name, 0x10, d.chain[0], index);
+        return index;
+    }
+
+    // 文件：占一个簇（内容不写，扫描不应读它）
+    void file(int dir, const std::string &name) {
+        uint32_t c = alloc();
+        fileClusters.push_back(c);
+        addLong(dir, name, 0x20, c, -1);
+    }
+
+    // 只有 8.3 条目的文件；nt 为 NT 保留字节（0x08 主名小写，0x10 扩展名小写）
+    void shortFile(int dir, const char name83[11], uint8_t nt) {
+        uint32_t c = alloc();
+        fileClusters.push_back(c);
+        Dir &d = dirs[dir];
+        std::vector<uint8_t> e = shortEntry(name83, 0x20, c, nt);
+        d.items.push_back({ std::string(name83, 11), d.slots(), d.slots(), -1 });
+        appendEntry(d, e);
+    }
+
+    // 已删除的条目（首字节 0xE5）
+    void deleted(int dir) {
+        std::vector<uint8_t> e = shortEntry("DELETED TXT", 0x20, 0, 0);
+        e[0] = 0xE5;
+        appendEntry(dirs[dir], e);
+    }
+
+    // 写出目录簇、两份 FAT、引导扇区（与 MBR）；之后才能扫描
+    void finish() {
+        uint32_t clusterBytes = _o.sectorsPerCluster * kSector;
+        for (Dir &d : dirs) {
+            while (d.chain.size() * clusterBytes < d.entries.size()) d.chain.push_back(alloc());
+            for (size_t i = 0; i < d.chain.size(); i++) {
+                size_t from = i * clusterBytes;
+                for (uint32_t s = 0; s < _o.sectorsPerCluster && from + s * kSector < d.entries.size(); s++) {
+                    size_t off = from + s * kSector;
+                    size_t n = std::min<size_t>(kSector, d.entries.size() - off);
+                    memcpy(sector(clusterSector(d.chain[i]) + s), d.entries.data() + off, n);
+                }
+                setFat(d.chain[i], i + 1 < d.chain.size() ? d.chain[i + 1] : 0x0FFFFFFF);
+            }
+        }
+        for (uint32_t c : fileClusters) setFat(c, 0x0FFFFFFF);
+        setFat(0, 0x0FFFFFF8);
+        setFat(1, 0x0FFFFFFF);
+
+        uint8_t *b = sector(_base);
+        b[0] = 0xEB, b[1] = 0x58, b[2] = 0x90;
+        memcpy(b + 3, "MKIMG   ", 8);
+        put16(b + 11, kSector);
+        b[13] = (uint8_t)_o.sectorsPerCluster;
+        put16(b + 14, kReserved);
+        b[16] = kFats;
+        b[21] = 0xF8;
+        put32(b + 28, _base);
+        put32(b + 32, _total);
+        put32(b + 36, _fatSize);
+        put32(b + 44, dirs[0].chain[0]);
+        put16(b + 48, 1);
+        put16(b + 50, 6);
+        b[66] = 0x29;
+        memcpy(b + 82, "FAT32   ", 8);
+        b[510] = 0x55, b[511] = 0xAA;
+        if (_o.mbr) {
+            uint8_t *m = sector(0);
+            m[0x1BE + 4] = 0x0C;
+            put32(m + 0x1BE + 8, _base);
+            put32(m + 0x1BE + 12, _total);
+            m[510] = 0x55, m[511] = 0xAA;
+        }
+    }
+
+    bool read(uint32_t n, uint8_t *buf, uint32_t count) override {
+        readCalls++;
+        for (uint32_t i = 0; i < count; i++) {
+            if ((uint64_t)n + i >= deviceSectors()) return false;
+            auto it = _sectors.find(n + i);
+            if (it == _sectors.end()) {
+                memset(buf + i * kSector, 0, kSector);
+            } else {
+                memcpy(buf + i * kSector, it->second.data(), kSector);
+            }
+            sectorsRead++;
+            if (trackReads) readLog.push_back(n + i);
+        }
+        return true;
+    }
+
+    uint8_t *sector(uint32_t n) { return _sectors[n].data(); }
+    std::vector<uint32_t> writtenSectors() const {
+        std::vector<uint32_t> out;
+        for (const auto &kv : _sectors) out.push_back(kv.first);
+        return out;
+    }
+
+    uint32_t bootSector() const { return _base; }
+    uint32_t fatStart() const { return _base + kReserved; }
+    uint32_t clusterSector(uint32_t c) const {
+        return _base + kReserved + kFats * _fatSize + (c - 2) * _o.sectorsPerCluster;
+    }
+    uint32_t slotSector(const Dir &d, uint32_t slot) const {
+        uint32_t perCluster = _o.sectorsPerCluster * kSector / 32;
+        return clusterSector(d.chain[slot / perCluster]) + (slot % perCluster) * 32 / kSector;
+    }
+    uint64_t deviceSectors() const { return (uint64_t)_base + _total; }
+    const Options &options() const { return _o; }
+
+    static void put16(uint8_t *p, uint16_t v) { p[0] = v, p[1] = v >> 8; }
+    static void put32(uint8_t *p, uint32_t v) { p[0] = v, p[1] = v >> 8, p[2] = v >> 16, p[3] = v >> 24; }
+
+    std::vector<Dir> dirs;
+    std::vector<uint32_t> fileClusters;
+    uint32_t readCalls = 0;
+    uint32_t sectorsRead = 0;
+    bool trackReads = false;
+    std::vector<uint32_t> readLog;
+
+private:
+    uint32_t alloc() {
+        uint32_t c;
+        if (_o.fragment) {
+            do {
+                _seed = _seed * 1664525u + 1013904223u;
+                c = 2 + (_seed >> 4) % _o.clusters;
+            } while (_used[c]);
+        } else {
+            while (_used[_next]) _next++;
+            c = _next;
+        }
+        _used[c] = true;
+        return c;
+    }
+
+    void setFat(uint32_t c, uint32_t value) {
+        for (uint32_t k = 0; k < kFats; k++) {
+            put32(sector(fatStart() + k * _fatSize + c / (kSector / 4)) + (c % (kSector / 4)) * 4, value);
+        }
+    }
+
+    static std::vector<uint8_t> shortEntry(const char name83[11], uint8_t attr, uint32_t cluster, uint8_t nt) {
+        std::vector<uint8_t> e(32, 0);
+        memcpy(e.data(), name83, 11);
+        e[11] = attr;
+        e[12] = nt;
+        put16(e.data() + 20, cluster >> 16);
+        put16(e.data() + 26, cluster & 0xFFFF);
+        return e;
+    }
+
+    static void appendEntry(Dir &d, const std::vector<uint8_t> &e) { d.entries.insert(d.entries.end(), e.begin(), e.end()); }
+
+    static std::vector<uint16_t> utf16(const std::string &s) {
+        std::vector<uint16_t> out;
+        for (size_t i = 0; i < s.size();) {
+            uint8_t c = s[i];
+            uint32_t cp;
+            int n;
+            if (c < 0x80) cp = c, n = 1;
+            else if (c < 0xE0) cp = c & 0x1F, n = 2;
+            else if (c < 0xF0) cp = c & 0x0F, n = 3;
+            else cp = c & 0x07, n = 4;
+            for (int k = 1; k < n; k++) cp = (cp << 6) | (s[i + k] & 0x3F);
+            i += n;
+            if (cp >= 0x10000) {
+                out.push_back(0xD800 + ((cp - 0x10000) >> 10));
+                out.push_back(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            } else {
+                out.push_back(cp);
+            }
+        }
+        return out;
+    }
+
+    // LFN 条目（序号倒序）+ 唯一的 8.3 别名
+    void addLong(int dir, const std::string &name, uint8_t attr, uint32_t cluster, int child) {
+        char alias[12];
+        snprintf(alias, sizeof(alias), "F%07u   ", (unsigned)++_aliases);
+        uint8_t sum = 0;
+        for (int i = 0; i < 11; i++) sum = ((sum & 1) << 7) + (sum >> 1) + (uint8_t)alias[i];
+
+        std::vector<uint16_t> u = utf16(name);
+        if (u.size() % 13) {
+            u.push_back(0x0000);
+            while (u.size() % 13) u.push_back(0xFFFF);
+        }
+        static const uint8_t kOffsets[13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+        Dir &d = dirs[dir];
+        uint32_t first = d.slots();
+        int count = (int)(u.size() / 13);
+        for (int ord = count; ord >= 1; ord--) {
+            std::vector<uint8_t> e(32, 0);
+            e[0] = ord | (ord == count ? 0x40 : 0);
+            e[11] = 0x0F;
+            e[13] = sum;
+            for (int k = 0; k < 13; k++) put16(e.data() + kOffsets[k], u[(ord - 1) * 13 + k]);
+            appendEntry(d, e);
+        }
+        d.items.push_back({ name, first, d.slots(), child });
+        appendEntry(d, shortEntry(alias, attr, cluster, 0));
+    }
+
+    Options _o;
+    uint32_t _seed;
+    std::vector<bool> _used;
+    uint32_t _next;
+    uint32_t _base;
+    uint32_t _fatSize;
+    uint32_t _total;
+    uint32_t _aliases = 0;
+    std::unordered_map<uint32_t, std::array<uint8_t, kSector>> _sectors;
+};
+
+} // namespace fat
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// 测试用的合成媒体流：帧头合法、负载为伪随机字节，附带每帧的起始样本与偏移，作为跳转的参考答案
+namespace media {
+
+struct Frame {
+    uint32_t offset;
+    uint64_t sample; // 帧起始样本
+};
+
+struct Stream {
+    std::vector<uint8_t> bytes;
+    std::vector<Frame> frames;
+    uint32_t sampleRate = 0;
+    uint32_t samplesPerFrame = 0;
+};
+
+inline uint32_t lcg(uint32_t &seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+// ID3v2 标签：10 字节头 + size 字节负载（syncsafe 长度）
+inline void appendId3(std::vector<uint8_t> &out, uint32_t size) {
+    const uint8_t h[10] = { 'I', 'D', '3', 4, 0, 0, (uint8_t)((size >> 21) & 0x7F), (uint8_t)((size >> 14) & 0x7F),
+                            (uint8_t)((size >> 7) & 0x7F), (uint8_t)(size & 0x7F) };
+    out.insert(out.end(), h, h + 10);
+    out.insert(out.end(), size, 0);
+}
+
+// MPEG-1 Layer III（mpeg2 = true 时为 MPEG-2，22.05kHz / 576 样本每帧）。
+// vbr 时每帧随机选码率，否则固定 bitrateIndex
+inline Stream mp3(double seconds, bool mpeg2, bool vbr, uint8_t bitrateIndex, uint32_t id3Size, uint32_t seed) {
+    static const uint16_t kV1[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+    static const uint16_t kV2[16] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+    Stream s;
+    s.sampleRate = mpeg2 ? 22050 : 44100;
+    s.samplesPerFrame = mpeg2 ? 576 : 1152;
+    if (id3Size) appendId3(s.bytes, id3Size);
+
+    uint64_t total = (uint64_t)(seconds * s.sampleRate);
+    uint32_t pad = 0;
+    for (uint64_t sample = 0; sample < total; sample += s.samplesPerFrame) {
+        uint8_t br = vbr ? (uint8_t)(1 + lcg(seed) % 14) : bitrateIndex;
+        uint32_t kbps = mpeg2 ? kV2[br] : kV1[br];
+        pad = (pad + 1) % 3 == 0 ? 1 : 0; // 周期性填充位，帧长随之 ±1
+        uint32_t len = (s.samplesPerFrame / 8) * kbps * 1000 / s.sampleRate + pad;
+        s.frames.push_back({ (uint32_t)s.bytes.size(), sample });
+        uint8_t h[4] = { 0xFF, (uint8_t)(mpeg2 ? 0xF3 : 0xFB), (uint8_t)((br << 4) | (pad << 1)), 0x44 };
+        s.bytes.insert(s.bytes.end(), h, h + 4);
+        for (uint32_t i = 4; i < len; i++) s.bytes.push_back((uint8_t)lcg(seed));
+    }
+    return s;
+}
+
+// FLAC：fLaC + STREAMINFO + SEEKTABLE（每 pointSeconds 秒一个点）+ 固定 4096 样本的“帧”
+inline Stream flac(double seconds, uint32_t sampleRate, double pointSeconds, uint32_t seed) {
+    Stream s;
+    s.sampleRate = sampleRate;
+    s.samplesPerFrame = 4096;
+    uint64_t total = (uint64_t)(seconds * sampleRate);
+
+    // 先生成音频帧（偏移相对第一帧）
+    std::vector<uint8_t> audio;
+    std::vector<Frame> frames;
+    for (uint64_t sample = 0; sample < total; sample += s.samplesPerFrame) {
+        frames.push_back({ (uint32_t)audio.size(), sample });
+        uint32_t len = 1500 + lcg(seed) % 3000;
+        audio.push_back(0xFF);
+        audio.push_back(0xF8);
+        for (uint32_t i = 2; i < len; i++) audio.push_back((uint8_t)lcg(seed));
+    }
+
+    // 每个 seek point 指向不晚于该时刻的最近一帧
+    std::vector<Frame> points;
+    size_t k = 0;
+    for (double t = 0; t * sampleRate < total; t += pointSeconds) {
+        uint64_t target = (uint64_t)(t * sampleRate);
+        while (k + 1 < frames.size() && frames[k + 1].sample <= target) k++;
+        points.push_back(frames[k]);
+    }
+
+    const uint8_t magic[4] = { 'f', 'L', 'a', 'C' };
+    s.bytes.insert(s.bytes.end(), magic, magic + 4);
+    uint8_t si[4 + 34] = { 0x00, 0, 0, 34 };
+    si[4 + 10] = (uint8_t)(sampleRate >> 12);
+    si[4 + 11] = (uint8_t)(sampleRate >> 4);
+    si[4 + 12] = (uint8_t)((sampleRate & 0x0F) << 4) | 0x02; // 采样率低 4 位 + 声道数 - 1
+    s.bytes.insert(s.bytes.end(), si, si + sizeof(si));
+
+    uint32_t len = (points.size() + 1) * 18; // 末尾附一个占位点
+    uint8_t bh[4] = { 0x83, (uint8_t)(len >> 16), (uint8_t)(len >> 8), (uint8_t)len };
+    s.bytes.insert(s.bytes.end(), bh, bh + 4);
+    auto be = [&s](uint64_t v, int bytes) {
+        for (int b = bytes - 1; b >= 0; b--) s.bytes.push_back((uint8_t)(v >> (8 * b)));
+    };
+    for (const Frame &p : points) {
+        be(p.sample, 8);
+        be(p.offset, 8);
+        be(s.samplesPerFrame, 2);
+    }
+    be(0xFFFFFFFFFFFFFFFFULL, 8);
+    be(0, 8);
+    be(0, 2);
+
+    uint32_t first = s.bytes.size();
+    for (Frame f : frames) s.frames.push_back({ first + f.offset, f.sample });
+    s.bytes.insert(s.bytes.end(), audio.begin(), audio.end());
+    return s;
+}
+
+} // namespace media
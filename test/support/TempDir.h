@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdlib.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 每个测试用例一个临时目录，析构时整体删除
+class TempDir {
+public:
+    TempDir() {
+        std::string tmpl = (std::filesystem::temp_directory_path() / "player-test-XXXXXX").string();
+        std::vector<char> buf(tmpl.begin(), tmpl.end());
+        buf.push_back('\0');
+        _path = mkdtemp(buf.data());
+    }
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(_path, ec);
+    }
+
+    const std::string &path() const { return _path; }
+    std::string file(const std::string &rel) const { return _path + (rel[0] == '/' ? "" : "/") + rel; }
+
+    void write(const std::string &rel, const std::vector<uint8_t> &data) const {
+        std::filesystem::create_directories(std::filesystem::path(file(rel)).parent_path());
+        std::ofstream(file(rel), std::ios::binary).write((const char *)data.data(), data.size());
+    }
+    std::vector<uint8_t> read(const std::string &rel) const {
+        std::ifstream in(file(rel), std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    bool exists(const std::string &rel) const { return std::filesystem::exists(file(rel)); }
+
+private:
+    std::string _path;
+};
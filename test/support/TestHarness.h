@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 主机测试的最小断言框架：TEST() 注册用例，CHECK 失败只记录不中断，
+// 由 TestMain.cpp 的 main() 依次运行并以失败数作为退出码（ctest 据此判定）。
+// 命令行参数为用例名时只运行匹配的用例。
+namespace test {
+
+struct Case {
+    const char *name;
+    void (*fn)();
+};
+
+std::vector<Case> &cases();
+void fail(const char *file, int line, const std::string &message);
+
+struct Register {
+    Register(const char *name, void (*fn)()) { cases().push_back({ name, fn }); }
+};
+
+// 字符类型按数值打印
+template <typename T>
+const T &show(const T &v) { return v; }
+inline int show(char v) { return v; }
+inline int show(signed char v) { return v; }
+inline unsigned show(unsigned char v) { return v; }
+
+template <typename A, typename B>
+void checkEq(const A &a, const B &b, const char *exprA, const char *exprB, const char *file, int line) {
+    if (a == b) return;
+    std::ostringstream s;
+    s << exprA << " == " << exprB << " (" << show(a) << " vs " << show(b) << ")";
+    fail(file, line, s.str());
+}
+
+inline void checkStr(const char *a, const char *b, const char *exprA, const char *exprB, const char *file, int line) {
+    std::string sa = a ? a : "(null)";
+    std::string sb = b ? b : "(null)";
+    if (a && b && sa == sb) return;
+    fail(file, line, std::string(exprA) + " == " + exprB + " (\"" + sa + "\" vs \"" + sb + "\")");
+}
+
+} // namespace test
+
+#define TEST(name)                                             \
+    static void name();                                        \
+    static test::Register name##_registration(#name, name);    \
+    static void name()
+
+#define CHECK(cond)                                            \
+    do {                                                       \
+        if (!(cond)) test::fail(__FILE__, __LINE__, #cond);    \
+    } while (0)
+
+#define CHECK_EQ(a, b) test::checkEq((a), (b), #a, #b, __FILE__, __LINE__)
+#define CHECK_STR(a, b) test::checkStr((a), (b), #a, #b, __FILE__, __LINE__)
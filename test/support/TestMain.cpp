@@ -0,0 +1,32 @@
+#include "TestHarness.h"
+#include <string.h>
+
+namespace test {
+
+static int g_failures = 0;
+
+std::vector<Case> &cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+void fail(const char *file, int line, const std::string &message) {
+    g_failures++;
+    printf("  FAIL %s:%d: %s\n", file, line, message.c_str());
+}
+
+} // namespace test
+
+int main(int argc, char **argv) {
+    int run = 0;
+    for (const test::Case &c : test::cases()) {
+        if (argc > 1 && strcmp(argv[1], c.name) != 0) continue;
+        int before = test::g_failures;
+        printf("[ RUN  ] %s\n", c.name);
+        c.fn();
+        printf("[ %s ] %s\n", test::g_failures == before ? " OK " : "FAIL", c.name);
+        run++;
+    }
+    printf("%d cases, %d failures\n", run, test::g_failures);
+    return test::g_failures == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// 主机测试用的 Arduino 最小替身：只提供被测设备侧代码（BookmarkStore、SeekIndex 等）
+// 用到的 String / Serial / 计时接口。Serial 默认静默，HOST_SERIAL=1 时输出到 stdout。
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+// 与 ESP32 的 Arduino.h 一样带入 FreeRTOS 任务接口
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef bool boolean;
+
+class String {
+public:
+    String() {}
+    String(const char *s) : _s(s ? s : "") {}
+    String(const std::string &s) : _s(s) {}
+    explicit String(int v) : _s(std::to_string(v)) {}
+    explicit String(unsigned v) : _s(std::to_string(v)) {}
+    explicit String(long v) : _s(std::to_string(v)) {}
+    explicit String(unsigned long v) : _s(std::to_string(v)) {}
+
+    const char *c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.size(); }
+    char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    char &operator[](unsigned int i) { return _s[i]; }
+
+    bool startsWith(const String &p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+    bool endsWith(const String &p) const {
+        return _s.size() >= p._s.size() && _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+    }
+    int indexOf(char c) const { return find(_s.find(c)); }
+    int indexOf(const String &s) const { return find(_s.find(s._s)); }
+    int lastIndexOf(char c) const { return find(_s.rfind(c)); }
+    String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        return from < to && from < _s.size() ? String(_s.substr(from, to - from)) : String();
+    }
+    void toLowerCase() {
+        for (char &c : _s) {
+            if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        }
+    }
+    void trim() {
+        size_t a = _s.find_first_not_of(" \t\r\n");
+        size_t b = _s.find_last_not_of(" \t\r\n");
+        _s = a == std::string::npos ? "" : _s.substr(a, b - a + 1);
+    }
+
+    String &operator+=(const String &o) { _s += o._s; return *this; }
+    String &operator+=(const char *o) { _s += o; return *this; }
+    String &operator+=(char c) { _s += c; return *this; }
+    friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+    friend String operator+(const String &a, const char *b) { return String(a._s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b._s); }
+    bool operator==(const String &o) const { return _s == o._s; }
+    bool operator==(const char *o) const { return _s == (o ? o : ""); }
+    bool operator!=(const String &o) const { return _s != o._s; }
+    bool operator!=(const char *o) const { return !(*this == o); }
+
+private:
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    std::string _s;
+};
+
+class HostSerial {
+public:
+    void printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    void print(const char *s);
+    void print(const String &s) { print(s.c_str()); }
+    void println(const char *s = "");
+    void println(const String &s) { println(s.c_str()); }
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+uint32_t esp_random();
@@ -0,0 +1,71 @@
+#pragma once
+
+// 主机测试用的 ESP32-audioI2S 替身：不解码，只记录调用。
+// 每个修改类接口记下调用线程，测试据此检查"只有音频任务修改播放器"的约定；
+// 播放状态下的 loop() 单独计数，检查暂停打开时没有解码；
+// setFilePos() 可注入一次耗时，模拟慢 SD 跳转。
+#include "Arduino.h"
+#include "FS.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Audio {
+public:
+    struct Call {
+        std::string what;
+        uint32_t arg;
+        std::thread::id thread;
+    };
+
+    bool connecttoFS(fs::FS &fs, const char *path, uint32_t resumeFilePos = 0) {
+        record(std::string("connect ") + path, resumeFilePos);
+        bool ok = path[0] != '\0' && fs.exists(path);
+        running = ok;
+        return ok;
+    }
+    bool pauseResume() {
+        record("pauseResume", 0);
+        running = !running;
+        return true;
+    }
+    void stopSong() {
+        record("stop", 0);
+        running = false;
+    }
+    void setVolume(uint8_t volume) { record("volume", volume); }
+    bool setFilePos(uint32_t pos) {
+        record("seekFilePos", pos);
+        uint32_t ms = seekStallMs.exchange(0);
+        if (ms) delay(ms);
+        return true;
+    }
+    bool setAudioPlayPosition(uint16_t second) { record("seekSeconds", second); return true; }
+
+    void loop() {
+        loops++;
+        if (running) playingLoops++;
+    }
+    bool isRunning() { return running; }
+
+    std::vector<Call> calls() {
+        std::lock_guard<std::mutex> guard(_lock);
+        return _calls;
+    }
+
+    std::atomic<bool> running{ false };
+    std::atomic<uint32_t> loops{ 0 };
+    std::atomic<uint32_t> playingLoops{ 0 }; // 处于播放状态时的 loop() 次数：真实库在这些轮次中解码出声
+    std::atomic<uint32_t> seekStallMs{ 0 }; // 下一次 setFilePos() 额外耗时
+
+private:
+    void record(const std::string &what, uint32_t arg) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _calls.push_back({ what, arg, std::this_thread::get_id() });
+    }
+
+    std::mutex _lock;
+    std::vector<Call> _calls;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+// 主机测试用的 fs::FS 替身：路径映射到主机上的一个根目录。
+// 与 FAT 上的 VFS 一致，rename 不覆盖已存在的目标。
+// 故障注入：powerCutAfter(n) 之后只允许再写 n 字节（remove / rename 各计 1），
+// 预算耗尽即视为断电，此后所有写入、删除、重命名都不生效。
+// diskFullAfter(n)：文件数据只能再写 n 字节（短写），删除与重命名照常，模拟卡满。
+#include "Arduino.h"
+#include <memory>
+#include <vector>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FS;
+
+class File {
+public:
+    File() {}
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size);
+    int available();
+    int read();
+    size_t read(uint8_t *buf, size_t size);
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush() {}
+    void close();
+    operator bool() const;
+
+    const char *path() const;
+    const char *name() const;
+    bool isDirectory() const;
+    File openNextFile(const char *mode = FILE_READ);
+    String getNextFileName();
+    String readStringUntil(char terminator);
+
+private:
+    friend class FS;
+    struct Impl;
+    std::shared_ptr<Impl> _impl;
+};
+
+class FS {
+public:
+    struct Stats {
+        size_t opens = 0;
+        size_t exists = 0;
+        size_t removes = 0;
+        size_t renames = 0;
+        size_t listed = 0;       // openNextFile / getNextFileName 返回的条目数
+        size_t bytesWritten = 0;
+        size_t bytesRead = 0;
+    };
+
+    explicit FS(const std::string &root = "");
+    void setRoot(const std::string &root) { _root = root; }
+    const std::string &root() const { return _root; }
+
+    File open(const char *path, const char *mode = FILE_READ, const bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, const bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to);
+    bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char *path);
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool rmdir(const char *path);
+
+    void powerCutAfter(long budget) { _budget = budget; }
+    bool powerLost() const { return _budget == 0; }
+    void powerRestore() { _budget = -1; }
+    void diskFullAfter(long bytes) { _space = bytes; }
+    void diskFree() { _space = -1; }
+
+    Stats stats;
+
+private:
+    friend class File;
+    size_t spend(size_t bytes); // 返回允许写入的字节数
+    std::string full(const char *path) const;
+
+    std::string _root;
+    long _budget; // -1 表示不限
+    long _space;  // -1 表示不限
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
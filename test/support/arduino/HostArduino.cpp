@@ -0,0 +1,278 @@
+#include "Arduino.h"
+#include "FS.h"
+#include "SD.h"
+#include "Preferences.h"
+#include <stdarg.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace stdfs = std::filesystem;
+
+HostSerial Serial;
+SDFS SD;
+
+static bool serialEnabled() {
+    static const bool enabled = getenv("HOST_SERIAL") != nullptr;
+    return enabled;
+}
+
+void HostSerial::printf(const char *fmt, ...) {
+    if (!serialEnabled()) return;
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+void HostSerial::print(const char *s) {
+    if (serialEnabled()) fputs(s, stdout);
+}
+
+void HostSerial::println(const char *s) {
+    if (serialEnabled()) puts(s);
+}
+
+static std::chrono::steady_clock::time_point bootTime() {
+    static const auto t0 = std::chrono::steady_clock::now();
+    return t0;
+}
+
+unsigned long millis() {
+    using namespace std::chrono;
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - bootTime()).count();
+}
+
+unsigned long micros() {
+    using namespace std::chrono;
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now() - bootTime()).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {}
+
+uint32_t esp_random() {
+    static std::mt19937 rng(12345);
+    return rng();
+}
+
+static std::mutex g_prefsLock;
+static std::map<std::string, int32_t> g_prefs; // "命名空间/键" → 值
+
+bool Preferences::begin(const char *name, bool readOnly) {
+    _ns = name;
+    return true;
+}
+
+int32_t Preferences::getInt(const char *key, int32_t defaultValue) {
+    std::lock_guard<std::mutex> guard(g_prefsLock);
+    auto it = g_prefs.find(_ns + "/" + key);
+    return it == g_prefs.end() ? defaultValue : it->second;
+}
+
+size_t Preferences::putInt(const char *key, int32_t value) {
+    std::lock_guard<std::mutex> guard(g_prefsLock);
+    g_prefs[_ns + "/" + key] = value;
+    return sizeof(value);
+}
+
+bool Preferences::clear() {
+    std::lock_guard<std::mutex> guard(g_prefsLock);
+    std::string prefix = _ns + "/";
+    for (auto it = g_prefs.begin(); it != g_prefs.end();) {
+        it = it->first.compare(0, prefix.size(), prefix) == 0 ? g_prefs.erase(it) : std::next(it);
+    }
+    return true;
+}
+
+namespace fs {
+
+struct File::Impl {
+    FS *fs = nullptr;
+    FILE *fp = nullptr;
+    std::string path; // 设备侧路径（以 / 开头）
+    bool dir = false;
+    std::vector<std::string> entries; // 目录条目（排序，保证可重复）
+    size_t next = 0;
+
+    ~Impl() {
+        if (fp) fclose(fp);
+    }
+};
+
+FS::FS(const std::string &root) : _root(root), _budget(-1), _space(-1) {}
+
+std::string FS::full(const char *path) const {
+    return _root + (path && path[0] == '/' ? "" : "/") + (path ? path : "");
+}
+
+size_t FS::spend(size_t bytes) {
+    if (_budget < 0) return bytes;
+    size_t allowed = bytes < (size_t)_budget ? bytes : (size_t)_budget;
+    _budget -= allowed;
+    return allowed;
+}
+
+File FS::open(const char *path, const char *mode, const bool create) {
+    stats.opens++;
+    File f;
+    std::string p = full(path);
+    std::error_code ec;
+    bool writing = mode[0] != 'r' || strchr(mode, '+');
+    if (writing && powerLost()) return f;
+
+    auto impl = std::make_shared<File::Impl>();
+    impl->fs = this;
+    impl->path = path[0] == '/' ? path : std::string("/") + path;
+    if (stdfs::is_directory(p, ec)) {
+        if (writing) return f;
+        impl->dir = true;
+        for (const auto &e : stdfs::directory_iterator(p, ec)) impl->entries.push_back(e.path().filename().string());
+        std::sort(impl->entries.begin(), impl->entries.end());
+    } else {
+        if (mode[0] == 'r' && !stdfs::exists(p, ec)) return f;
+        // "w" 截断本身也算一次写入
+        if (mode[0] == 'w' && spend(1) == 0) return f;
+        impl->fp = fopen(p.c_str(), (std::string(mode) + "b").c_str());
+        if (!impl->fp) return f;
+    }
+    f._impl = impl;
+    return f;
+}
+
+bool FS::exists(const char *path) {
+    stats.exists++;
+    std::error_code ec;
+    return stdfs::exists(full(path), ec);
+}
+
+bool FS::remove(const char *path) {
+    stats.removes++;
+    if (spend(1) == 0) return false;
+    std::error_code ec;
+    return stdfs::remove(full(path), ec);
+}
+
+bool FS::rename(const char *from, const char *to) {
+    stats.renames++;
+    std::error_code ec;
+    if (!stdfs::exists(full(from), ec) || stdfs::exists(full(to), ec)) return false;
+    if (spend(1) == 0) return false;
+    stdfs::rename(full(from), full(to), ec);
+    return !ec;
+}
+
+bool FS::mkdir(const char *path) {
+    if (spend(1) == 0) return false;
+    std::error_code ec;
+    return stdfs::create_directory(full(path), ec);
+}
+
+bool FS::rmdir(const char *path) {
+    if (spend(1) == 0) return false;
+    std::error_code ec;
+    return stdfs::remove(full(path), ec);
+}
+
+size_t File::write(const uint8_t *buf, size_t size) {
+    if (!_impl || !_impl->fp) return 0;
+    FS *fs = _impl->fs;
+    if (fs->_space >= 0 && size > (size_t)fs->_space) size = (size_t)fs->_space;
+    size_t allowed = fs->spend(size);
+    size_t n = allowed ? fwrite(buf, 1, allowed, _impl->fp) : 0;
+    fflush(_impl->fp);
+    if (fs->_space >= 0) fs->_space -= (long)n;
+    fs->stats.bytesWritten += n;
+    return n;
+}
+
+int File::available() {
+    if (!_impl || !_impl->fp) return 0;
+    long pos = ftell(_impl->fp);
+    return (int)(size() - pos);
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t *buf, size_t size) {
+    if (!_impl || !_impl->fp) return 0;
+    size_t n = fread(buf, 1, size, _impl->fp);
+    _impl->fs->stats.bytesRead += n;
+    return n;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!_impl || !_impl->fp) return false;
+    return fseek(_impl->fp, (long)pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+}
+
+size_t File::position() const {
+    return _impl && _impl->fp ? (size_t)ftell(_impl->fp) : 0;
+}
+
+size_t File::size() const {
+    if (!_impl || !_impl->fp) return 0;
+    long pos = ftell(_impl->fp);
+    fseek(_impl->fp, 0, SEEK_END);
+    long end = ftell(_impl->fp);
+    fseek(_impl->fp, pos, SEEK_SET);
+    return (size_t)end;
+}
+
+void File::close() {
+    _impl.reset();
+}
+
+File::operator bool() const {
+    return _impl != nullptr;
+}
+
+const char *File::path() const {
+    return _impl ? _impl->path.c_str() : nullptr;
+}
+
+const char *File::name() const {
+    if (!_impl) return nullptr;
+    const char *slash = strrchr(_impl->path.c_str(), '/');
+    return slash ? slash + 1 : _impl->path.c_str();
+}
+
+bool File::isDirectory() const {
+    return _impl && _impl->dir;
+}
+
+static std::string childPath(const std::string &dir, const std::string &name) {
+    return dir == "/" ? "/" + name : dir + "/" + name;
+}
+
+File File::openNextFile(const char *mode) {
+    if (!_impl || !_impl->dir || _impl->next >= _impl->entries.size()) return File();
+    _impl->fs->stats.listed++;
+    std::string child = childPath(_impl->path, _impl->entries[_impl->next++]);
+    return _impl->fs->open(child.c_str(), mode);
+}
+
+String File::getNextFileName() {
+    if (!_impl || !_impl->dir || _impl->next >= _impl->entries.size()) return String();
+    _impl->fs->stats.listed++;
+    return String(childPath(_impl->path, _impl->entries[_impl->next++]));
+}
+
+String File::readStringUntil(char terminator) {
+    std::string s;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) s += (char)c;
+    return String(s);
+}
+
+} // namespace fs
@@ -0,0 +1,130 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+// 任务与固件一致永不退出：线程分离，进程结束时随之结束
+struct HostTask {
+    uint32_t stack;
+    uint32_t notified = 0;
+    std::mutex lock;
+    std::condition_variable changed;
+};
+
+static thread_local HostTask *t_current = nullptr;
+
+struct HostQueue {
+    size_t length;
+    size_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    std::mutex lock;
+    std::condition_variable changed;
+};
+
+static std::chrono::steady_clock::time_point deadline(TickType_t wait) {
+    auto now = std::chrono::steady_clock::now();
+    return wait == portMAX_DELAY ? now + std::chrono::hours(24 * 365) : now + std::chrono::milliseconds(wait);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+    HostTask *task = new HostTask;
+    task->stack = stack;
+    std::thread([fn, arg, task] {
+        t_current = task;
+        fn(arg);
+    }).detach();
+    if (handle) *handle = task;
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+    using namespace std::chrono;
+    static const auto t0 = steady_clock::now();
+    return (TickType_t)duration_cast<milliseconds>(steady_clock::now() - t0).count();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return task ? task->stack : 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notified++;
+    task->changed.notify_all();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait) {
+    HostTask *task = t_current;
+    if (!task) return 0; // 不是 xTaskCreatePinnedToCore 创建的线程
+    std::unique_lock<std::mutex> guard(task->lock);
+    if (!task->changed.wait_until(guard, deadline(wait), [task] { return task->notified > 0; })) return 0;
+    uint32_t value = task->notified;
+    task->notified = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue *q = new HostQueue;
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait) {
+    std::unique_lock<std::mutex> guard(q->lock);
+    if (!q->changed.wait_until(guard, deadline(wait), [q] { return q->items.size() < q->length; })) return pdFALSE;
+    const uint8_t *p = (const uint8_t *)item;
+    q->items.emplace_back(p, p + q->itemSize);
+    q->changed.notify_all();
+    return pdTRUE;
+}
+
+static BaseType_t take(QueueHandle_t q, void *item, TickType_t wait, bool remove) {
+    std::unique_lock<std::mutex> guard(q->lock);
+    if (!q->changed.wait_until(guard, deadline(wait), [q] { return !q->items.empty(); })) return pdFALSE;
+    if (q->itemSize) memcpy(item, q->items.front().data(), q->itemSize);
+    if (remove) {
+        q->items.pop_front();
+        q->changed.notify_all();
+    }
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait) {
+    return take(q, item, wait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t q, void *item, TickType_t wait) {
+    return take(q, item, wait, false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    SemaphoreHandle_t m = xSemaphoreCreateBinary();
+    xSemaphoreGive(m);
+    return m;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    return xQueueSend(sem, nullptr, 0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) {
+    return xQueueReceive(sem, nullptr, wait);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// NVS 替身：按命名空间保存在进程内存中，不落盘；同一进程内的各个 Preferences 对象共享
+#include "Arduino.h"
+#include <map>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char *name, bool readOnly = false);
+    void end() { _ns.clear(); }
+    int32_t getInt(const char *key, int32_t defaultValue = 0);
+    size_t putInt(const char *key, int32_t value);
+    bool clear();
+
+private:
+    std::string _ns;
+};
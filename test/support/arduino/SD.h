@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FS.h"
+
+// SD 卡替身：测试用 SD.setRoot() 指向临时目录
+class SDFS : public fs::FS {
+public:
+    bool begin() { return true; }
+    bool readRAW(uint8_t *buf, uint32_t sector) { return false; } // 主机上不是卡：原始扫描退回 VFS
+};
+
+extern SDFS SD;
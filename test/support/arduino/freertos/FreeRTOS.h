@@ -0,0 +1,38 @@
+#pragma once
+
+// 主机测试用的 FreeRTOS 最小替身：任务是 std::thread，队列 / 信号量用互斥量 + 条件变量实现，
+// 1 tick = 1 ms。优先级与核心号只记录不生效（主机线程并行运行），
+// 所以主机上验证的是调度约定（谁调用什么、命令顺序、阻塞与截止期统计），不是抢占本身。
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct HostTask *TaskHandle_t;
+typedef struct HostQueue *QueueHandle_t;
+typedef struct HostQueue *SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// 临界区：主机上是自旋锁
+typedef struct {
+    int locked;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+inline void portENTER_CRITICAL(portMUX_TYPE *mux) {
+    while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) {}
+}
+inline void portEXIT_CRITICAL(portMUX_TYPE *mux) { __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE); }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task); // 主机上返回申请的栈大小
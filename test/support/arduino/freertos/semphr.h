@@ -0,0 +1,9 @@
+#pragma once
+
+#include "queue.h"
+
+// 二值信号量即长度为 1、元素为空的队列（与 FreeRTOS 的实现方式相同）
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex(); // 不做优先级继承，也不检查持有者
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "FreeRTOS.h"
+// 任务通知：每个任务一个计数值
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait);
@@ -0,0 +1,44 @@
+// TimeStretch 周期开销基准：每个输出帧的耗时与实时倍率（44.1kHz 立体声）
+#include "Bench.h"
+#include "dsp/TimeStretch.h"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+int main() {
+    const size_t seconds = 30 * bench::scale();
+    const size_t frames = 44100 * seconds;
+    std::vector<int16_t> pcm(frames * 2);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < frames; i++) {
+        // 语音/音乐的粗略替身：两个音加噪声
+        seed = seed * 1664525u + 1013904223u;
+        double v = sin(i * 0.0627) * 6000 + sin(i * 0.0113) * 4000 + (int16_t)(seed >> 16) / 16;
+        pcm[i * 2] = pcm[i * 2 + 1] = (int16_t)v;
+    }
+
+    printf("%-6s %12s %12s %10s\n", "speed", "out frames", "ns/frame", "x realtime");
+    for (float speed : { 0.8f, 0.96f, 1.25f }) {
+        TimeStretch ts;
+        ts.begin(2);
+        ts.setSpeed(speed);
+        int16_t out[TimeStretch::kSegment * 2];
+        size_t produced = 0;
+        uint64_t t0 = bench::nowNs();
+        for (size_t pos = 0; pos < frames; pos += 256) {
+            size_t n = frames - pos < 256 ? frames - pos : 256;
+            ts.put(&pcm[pos * 2], n);
+            size_t got;
+            while ((got = ts.receive(out, TimeStretch::kSegment)) > 0) produced += got;
+        }
+        uint64_t ns = bench::nowNs() - t0;
+        bench::keep(out);
+        double perFrame = (double)ns / produced;
+        printf("%-6.2f %12zu %12.1f %10.0f\n", speed, produced, perFrame, 1e9 / 44100.0 / perFrame);
+    }
+    // 相关搜索的乘加数：(2·kTolerance/kDecimate + 2·kDecimate) 个候选 × kSegment/kDecimate 次，每 kSegment 帧一次
+    size_t candidates = 2 * TimeStretch::kTolerance / TimeStretch::kDecimate + 1 + 2 * (TimeStretch::kDecimate - 1);
+    double macs = (double)candidates * (TimeStretch::kSegment / TimeStretch::kDecimate) / TimeStretch::kSegment;
+    printf("correlation: %.1f MACs per output frame\n", macs);
+    return 0;
+}
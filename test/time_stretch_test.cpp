@@ -0,0 +1,133 @@
+// TimeStretch 质量测试：变速后时长按 1/speed 缩放，音高（基频）保持不变
+#include "TestHarness.h"
+#include "dsp/TimeStretch.h"
+#include <math.h>
+#include <vector>
+
+static const double kRate = 44100.0;
+
+// 立体声测试信号：基频 f0 及其谐波（类似元音），左右声道相同
+static std::vector<int16_t> harmonicTone(double f0, size_t frames, int harmonics) {
+    std::vector<int16_t> pcm(frames * 2);
+    for (size_t i = 0; i < frames; i++) {
+        double t = i / kRate;
+        double v = 0;
+        for (int h = 1; h <= harmonics; h++) v += sin(2 * M_PI * f0 * h * t) / h;
+        int16_t s = (int16_t)(v * 9000);
+        pcm[i * 2] = s;
+        pcm[i * 2 + 1] = s;
+    }
+    return pcm;
+}
+
+// 按解码器的节奏（每次 256 帧）送入并取空输出
+static std::vector<int16_t> stretch(const std::vector<int16_t> &in, float speed) {
+    TimeStretch ts;
+    ts.begin(2);
+    ts.setSpeed(speed);
+    std::vector<int16_t> out;
+    int16_t buf[TimeStretch::kSegment * 2];
+    size_t frames = in.size() / 2;
+    for (size_t pos = 0; pos < frames; pos += 256) {
+        size_t n = frames - pos < 256 ? frames - pos : 256;
+        ts.put(&in[pos * 2], n);
+        size_t got;
+        while ((got = ts.receive(buf, TimeStretch::kSegment)) > 0) out.insert(out.end(), buf, buf + got * 2);
+    }
+    return out;
+}
+
+// 归一化自相关估计基频（左声道，窗口取信号中段），抛物线插值到亚采样精度
+static double estimatePitch(const std::vector<int16_t> &pcm, double minHz, double maxHz) {
+    size_t frames = pcm.size() / 2;
+    const size_t window = 4096;
+    size_t start = frames / 2 - window / 2;
+    size_t minLag = (size_t)(kRate / maxHz);
+    size_t maxLag = (size_t)(kRate / minHz) + 1;
+
+    std::vector<double> r(maxLag + 2, 0);
+    for (size_t lag = minLag - 1; lag <= maxLag + 1; lag++) {
+        double acc = 0, e0 = 0, e1 = 0;
+        for (size_t i = 0; i < window; i++) {
+            double a = pcm[(start + i) * 2];
+            double b = pcm[(start + i + lag) * 2];
+            acc += a * b;
+            e0 += a * a;
+            e1 += b * b;
+        }
+        r[lag] = acc / sqrt(e0 * e1 + 1e-9);
+    }
+    size_t best = minLag;
+    for (size_t lag = minLag; lag <= maxLag; lag++) {
+        if (r[lag] > r[best]) best = lag;
+    }
+    double a = r[best - 1], b = r[best], c = r[best + 1];
+    double denom = a - 2 * b + c;
+    double offset = denom != 0 ? 0.5 * (a - c) / denom : 0;
+    return kRate / (best + offset);
+}
+
+static void checkSpeed(float speed, double f0) {
+    std::vector<int16_t> in = harmonicTone(f0, (size_t)(kRate * 3), 4);
+    std::vector<int16_t> out = stretch(in, speed);
+
+    // 时长：输出帧数 ≈ 输入帧数 / speed（内部缓冲最多滞留约 3 段）
+    double expected = in.size() / 2 / speed;
+    double frames = out.size() / 2;
+    printf("  speed %.2f f0 %.0f Hz: %zu -> %.0f frames (expected %.0f)\n", speed, f0, in.size() / 2, frames, expected);
+    CHECK(fabs(frames - expected) < TimeStretch::kSegment * 4);
+
+    // 搜索范围 f0/1.5 ~ f0×1.5：重采样式变速（音高随之 ×speed）也落在范围内，会被检出
+    double pitchIn = estimatePitch(in, f0 / 1.5, f0 * 1.5);
+    double pitchOut = estimatePitch(out, f0 / 1.5, f0 * 1.5);
+    printf("  pitch in %.2f Hz, out %.2f Hz (%.2f%%)\n", pitchIn, pitchOut, 100.0 * (pitchOut - pitchIn) / pitchIn);
+    CHECK(fabs(pitchIn - f0) / f0 < 0.005);
+    CHECK(fabs(pitchOut - pitchIn) / pitchIn < 0.01);
+}
+
+TEST(slow_down_keeps_pitch) {
+    checkSpeed(0.8f, 220);
+    checkSpeed(0.8f, 440);
+}
+
+TEST(speed_up_keeps_pitch) {
+    checkSpeed(1.25f, 220);
+    checkSpeed(1.25f, 440);
+}
+
+TEST(stream_rate_nudge_keeps_pitch) {
+    checkSpeed(0.96f, 330);
+}
+
+// 交叉淡化处没有明显的相位跳变：输出的逐帧差分不超过输入的两倍
+TEST(no_clicks_at_segment_joins) {
+    std::vector<int16_t> in = harmonicTone(440, (size_t)kRate, 1);
+    std::vector<int16_t> out = stretch(in, 0.8f);
+    int maxIn = 0, maxOut = 0;
+    for (size_t i = 2; i < in.size(); i += 2) maxIn = std::max(maxIn, abs(in[i] - in[i - 2]));
+    for (size_t i = 2; i < out.size(); i += 2) maxOut = std::max(maxOut, abs(out[i] - out[i - 2]));
+    printf("  max step in %d, out %d\n", maxIn, maxOut);
+    CHECK(maxOut <= maxIn * 2);
+}
+
+TEST(reset_drops_buffered_audio) {
+    TimeStretch ts;
+    ts.begin(2);
+    ts.setSpeed(1.25f);
+    std::vector<int16_t> in = harmonicTone(440, 4096, 1);
+    ts.put(in.data(), 4096);
+    ts.reset();
+    int16_t buf[TimeStretch::kSegment * 2];
+    CHECK_EQ(ts.receive(buf, TimeStretch::kSegment), (size_t)0);
+}
+
+TEST(speed_is_clamped) {
+    TimeStretch ts;
+    ts.begin(2);
+    ts.setSpeed(0.1f);
+    CHECK_EQ(ts.getSpeed(), 0.5f);
+    ts.setSpeed(3.0f);
+    CHECK_EQ(ts.getSpeed(), 2.0f);
+    ts.setSpeed(1.0f);
+    CHECK(!ts.isActive());
+}
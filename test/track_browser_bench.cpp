@@ -0,0 +1,116 @@
+// 曲目浏览器的单帧开销随列表长度的变化：TrackBrowser 推进光标 + 按 UIManager::drawBrowser 的方式
+// 只重绘变化的可见行。屏幕换成 240x240 的 RGB565 内存帧缓冲，字形按每字符一个 8x16（汉字 16x16）色块填充，
+// 行内的填充区域与 drawBrowserRow 相同；SPI 传输不计（满 8 行重绘约 232x208 像素，80 MHz 下约 10 ms）。
+// 每种长度跑 10 秒长按下滚、10 秒长按上滚、10 秒单步，每帧 33 ms。
+#include "Bench.h"
+#include "playlist/TrackTable.h"
+#include "ui/TrackBrowser.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static const int kTop = 28, kRowH = 26, kTextW = 232, kWidth = 240;
+static uint16_t g_fb[kWidth * kWidth];
+
+static void fillRect(int x, int y, int w, int h, uint16_t c) {
+    for (int j = y; j < y + h; j++) {
+        for (int i = x; i < x + w; i++) g_fb[j * kWidth + i] = c;
+    }
+}
+
+struct Screen {
+    size_t rowIdx[TrackBrowser::kRows];
+    bool rowSel[TrackBrowser::kRows];
+    size_t rowsDrawn = 0;
+
+    Screen() {
+        for (int r = 0; r < TrackBrowser::kRows; r++) rowIdx[r] = SIZE_MAX, rowSel[r] = false;
+    }
+
+    void drawRow(int row, const char *path, bool selected) {
+        int y = kTop + row * kRowH;
+        uint16_t bg = selected ? 0xF800 : 0x0000;
+        rowsDrawn++;
+        if (!path) {
+            fillRect(0, y, kTextW, kRowH, 0);
+            return;
+        }
+        const char *name = strrchr(path, '/');
+        name = name ? name + 1 : path;
+        fillRect(0, y, kTextW, 5, bg);
+        fillRect(0, y + 21, kTextW, 5, bg);
+        fillRect(0, y + 5, 4, 16, bg);
+        int x = 4;
+        for (const char *p = name; *p && x < kTextW;) {
+            int w = (*p & 0x80) ? 16 : 8;
+            if (x + w > kTextW) w = kTextW - x;
+            fillRect(x, y + 5, w, 16, (uint16_t)(*p * 31));
+            x += w;
+            p += (*p & 0x80) ? 3 : 1;
+        }
+        if (x < kTextW) fillRect(x, y + 5, kTextW - x, 16, bg);
+    }
+
+    template <typename PathAt>
+    void draw(const TrackBrowser &b, const PathAt &pathAt) {
+        for (int r = 0; r < TrackBrowser::kRows; r++) {
+            size_t idx = b.top() + r;
+            bool selected = idx == b.cursor();
+            if (idx >= b.count()) idx = SIZE_MAX;
+            if (idx == rowIdx[r] && selected == rowSel[r]) continue;
+            rowIdx[r] = idx;
+            rowSel[r] = selected;
+            drawRow(r, idx == SIZE_MAX ? nullptr : pathAt(idx), selected);
+        }
+    }
+};
+
+int main() {
+    printf("%-10s %10s %10s %10s %12s %10s\n", "tracks", "open us", "avg us", "worst us", "rows/frame", "cursor");
+    for (size_t n : { (size_t)1000, (size_t)50000 * bench::scale(), (size_t)1000000 }) {
+        TrackTable table;
+        char buf[128];
+        for (size_t i = 0; i < n; i++) {
+            int len = snprintf(buf, sizeof(buf), "/音乐/album_%05zu/%06zu - 一首很长的歌曲名称 track.mp3", i / 20, i);
+            table.add(buf, len);
+        }
+        table.buildIndex();
+
+        // 与 PlaylistManager::buildBrowseList 相同：打开时做一次 O(N) 的可播放 ID 快照
+        uint64_t t0 = bench::nowNs();
+        std::vector<uint32_t> ids;
+        ids.reserve(table.count());
+        for (uint32_t id = 0; id < table.playlist.size(); id++) {
+            if (table.isPlayable(id)) ids.push_back(id);
+        }
+        uint64_t openNs = bench::nowNs() - t0;
+        auto pathAt = [&](size_t i) { return table.playlist[ids[i]]; };
+
+        TrackBrowser browser;
+        browser.open(ids.size(), ids.size() / 2);
+        Screen screen;
+        uint32_t now = 0;
+        uint64_t total = 0, worst = 0;
+        int frames = 0;
+        for (int phase = 0; phase < 3; phase++) {
+            if (phase < 2) browser.startHold(phase == 0 ? 1 : -1, now);
+            for (int f = 0; f < 300; f++) {
+                now += 33;
+                t0 = bench::nowNs();
+                if (phase < 2) browser.tick(now);
+                else browser.step(f % 2 ? 1 : -1);
+                screen.draw(browser, pathAt);
+                uint64_t ns = bench::nowNs() - t0;
+                total += ns;
+                if (ns > worst) worst = ns;
+                frames++;
+            }
+            browser.stopHold();
+        }
+        bench::keep(g_fb);
+        printf("%-10zu %10.0f %10.2f %10.2f %12.2f %10zu\n", n, openNs / 1e3, total / 1e3 / frames, worst / 1e3,
+               (double)screen.rowsDrawn / frames, browser.cursor());
+    }
+    return 0;
+}
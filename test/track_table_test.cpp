@@ -0,0 +1,176 @@
+// TrackTable：重复检测，以及模式反复重建 / 淘汰时 MEM_PLAYLIST 的内存增长
+#include "TestHarness.h"
+#include "playlist/TrackTable.h"
+#include "util/PathHash.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const uint32_t kNotFound = PathIndex::kNotFound; // CHECK_EQ 按引用取值
+
+static std::vector<std::string> paths(size_t n, uint32_t seed) {
+    std::vector<std::string> out;
+    char buf[96];
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        snprintf(buf, sizeof(buf), "/music/dir%02u/track %05u %s.mp3", (unsigned)(i / 200), (unsigned)i,
+                 (seed >> 28) & 1 ? "live" : "studio");
+        out.push_back(buf);
+    }
+    return out;
+}
+
+static void fill(TrackTable &t, const std::vector<std::string> &list) {
+    for (const std::string &p : list) t.add(p.c_str(), p.size());
+    t.buildIndex();
+}
+
+static size_t textBytes(const std::vector<std::string> &list) {
+    size_t n = 0;
+    for (const std::string &p : list) n += p.size() + 1;
+    return n;
+}
+
+TEST(exact_and_numbered_copies_are_tombstoned) {
+    TrackTable t;
+    fill(t, { "/a/song.mp3", "/a/song_1.mp3", "/a/song.mp3", "/a/other_2.mp3", "/a/x_y.mp3", "/b/song_1.mp3",
+              "/a/song_12.flac", "/a/song.flac" });
+    CHECK_EQ(t.playlist.size(), 8u);
+    CHECK(t.isPlayable(0));
+    CHECK(t.isRemoved(1));  // song_1.mp3，同目录有 song.mp3
+    CHECK(t.isRemoved(2));  // 同一路径第二次出现
+    CHECK(t.isPlayable(3)); // 没有 other.mp3
+    CHECK(t.isPlayable(4)); // "_y" 不是数字
+    CHECK(t.isPlayable(5)); // 不同目录
+    CHECK(t.isRemoved(6));  // song_12.flac 对应 song.flac（出现在其后也算）
+    CHECK(t.isPlayable(7));
+    CHECK_EQ(t.duplicateCount, 3u);
+    CHECK_EQ(t.count(), 5u);
+    CHECK_EQ(t.index.find(pathHash("/a/song.mp3")), 0u);
+    CHECK_EQ(t.index.find(pathHash("/c.mp3")), kNotFound);
+}
+
+TEST(rebuild_clears_tombstones) {
+    TrackTable t;
+    fill(t, { "/a.mp3", "/a.mp3" });
+    t.markRemoved(0);
+    CHECK_EQ(t.count(), 0u);
+    t.buildIndex();
+    CHECK_EQ(t.count(), 1u);
+    CHECK(t.isPlayable(0));
+}
+
+// 一个模式的全部分配都走 arena：计数器增量只比 arena 容量多出块头，析构后回到原值
+TEST(all_memory_is_charged_to_the_arena) {
+    int32_t before = memCurrent(MEM_PLAYLIST);
+    std::vector<std::string> list = paths(5000, 1);
+    {
+        TrackTable t;
+        fill(t, list);
+        CHECK_EQ(t.count(), 5000u);
+        size_t charged = memCurrent(MEM_PLAYLIST) - before;
+        CHECK(charged >= t.arena.capacity() && charged - t.arena.capacity() < t.arena.capacity() / 1000);
+        // 每首：路径文本 + 指针（含扩容时留在 arena 中的旧缓冲）+ 索引槽 + 墓碑 / 位图
+        size_t perTrack = (t.arena.capacity() - textBytes(list)) / list.size();
+        printf("    %u tracks: arena %u bytes, %u bytes/track beyond path text\n", (unsigned)list.size(),
+               (unsigned)t.arena.capacity(), (unsigned)perTrack);
+        CHECK(perTrack <= 96);
+    }
+    CHECK_EQ(memCurrent(MEM_PLAYLIST), before);
+}
+
+// 缓存损坏 / 扫描失败后 discard() 再重建：arena 块被复用，多轮之后容量与计数器都不再增长
+TEST(discard_and_rebuild_does_not_grow) {
+    int32_t before = memCurrent(MEM_PLAYLIST);
+    std::vector<std::string> list = paths(3000, 2);
+    TrackTable t;
+    fill(t, list);
+    t.discard();
+    fill(t, list);
+    size_t steady = t.arena.capacity();
+    int32_t charged = memCurrent(MEM_PLAYLIST) - before;
+    for (int round = 0; round < 50; round++) {
+        t.discard();
+        CHECK(t.playlist.empty());
+        CHECK_EQ(t.count(), 0u);
+        fill(t, list);
+    }
+    CHECK_EQ(t.arena.capacity(), steady);
+    CHECK_EQ(memCurrent(MEM_PLAYLIST) - before, charged);
+    CHECK_EQ(t.count(), 3000u);
+}
+
+// 模式切换与 LRU 淘汰：反复构建、释放不同大小的模式，结束后不残留，峰值只取决于同时常驻的模式
+TEST(mode_churn_returns_to_baseline) {
+    int32_t before = memCurrent(MEM_PLAYLIST);
+    memResetPeaks();
+    std::vector<std::vector<std::string>> modes;
+    for (uint32_t i = 0; i < 4; i++) modes.push_back(paths(500 + i * 1500, 10 + i));
+
+    size_t largest = 0;
+    for (int round = 0; round < 100; round++) {
+        TrackTable *resident[2] = { new TrackTable, new TrackTable };
+        fill(*resident[0], modes[round % 4]);
+        fill(*resident[1], modes[(round + 1) % 4]);
+        size_t both = memCurrent(MEM_PLAYLIST) - before;
+        if (both > largest) largest = both;
+        delete resident[0];
+        delete resident[1];
+    }
+    CHECK_EQ(memCurrent(MEM_PLAYLIST), before);
+    CHECK_EQ((size_t)(memPeak(MEM_PLAYLIST) - before), largest);
+}
+
+// PSRAM 耗尽：add() 在装不下时返回 false，已加入的条目都是完整路径，绝不出现空串
+TEST(add_fails_cleanly_when_the_arena_is_exhausted) {
+    std::vector<std::string> list = paths(4000, 3);
+    TrackTable t;
+    t.arena.setLimit(96 * 1024);
+    size_t added = 0;
+    while (added < list.size() && t.add(list[added].c_str(), list[added].size())) added++;
+    CHECK(added > 100 && added < list.size());
+    CHECK(t.exhausted);
+    CHECK_EQ(t.playlist.size(), added);
+    int bad = 0;
+    for (size_t i = 0; i < added; i++) {
+        if (!t.playlist[i] || list[i] != t.playlist[i]) bad++;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(t.arena.capacity() <= 96 * 1024);
+
+    // 此后一律失败，即使有一条短路径本来放得下
+    CHECK(!t.add("/a.mp3", 6));
+    CHECK_EQ(t.playlist.size(), added);
+
+    // 模式放弃：buildIndex 失败并清空，不留下没有墓碑位的半成品
+    CHECK(!t.buildIndex());
+    CHECK(t.playlist.empty());
+    CHECK_EQ(t.count(), 0u);
+}
+
+// 路径放得下、索引放不下：同样整体放弃
+TEST(build_index_fails_cleanly_when_the_index_does_not_fit) {
+    std::vector<std::string> list = paths(2000, 4);
+    TrackTable probe;
+    for (const std::string &p : list) probe.add(p.c_str(), p.size());
+
+    TrackTable t;
+    t.arena.setLimit(probe.arena.capacity());
+    for (const std::string &p : list) CHECK(t.add(p.c_str(), p.size()));
+    CHECK(!t.exhausted);
+    CHECK(!t.buildIndex());
+    CHECK(t.exhausted);
+    CHECK(t.playlist.empty());
+    CHECK_EQ(t.index.find(pathHash(list[0].c_str())), kNotFound);
+}
+
+TEST(arena_strdup_reports_out_of_memory) {
+    Arena arena(1024);
+    arena.setLimit(1024);
+    char big[900];
+    memset(big, 'x', sizeof(big));
+    CHECK(arena.strdup(big, sizeof(big)) != nullptr);
+    CHECK(arena.strdup(big, sizeof(big)) == nullptr);
+    CHECK(!arena.reserve(200));
+    CHECK(arena.reserve(100));
+}
@@ -0,0 +1,103 @@
+// WaveformIndex：播放中归约的波形经 .tmp 改名落盘，卡满或断电不留下截断的 .pk，之后能照常加载
+#include "TestHarness.h"
+#include "TempDir.h"
+#include "WaveformIndex.h"
+#include "util/PathHash.h"
+#include <SD.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+static const uint32_t kRate = 8000;
+static const uint32_t kSeconds = 2;
+static const size_t kFileBytes = 4 + 1 + 4 + sizeof(WaveColumn) * PeakReducer::kColumns + 4;
+
+static std::string sidecar(const char *path) {
+    char name[40];
+    snprintf(name, sizeof(name), "/.wave/%016llx.pk", (unsigned long long)pathHash(path));
+    return name;
+}
+
+// 按 20ms 一块送入单声道 PCM（幅度随时间变化），直到主循环侧拿到完整波形
+static bool reduce(WaveformIndex &w) {
+    std::vector<int16_t> pcm(kRate / 50);
+    for (uint32_t frame = 0; frame < kRate * kSeconds; frame += pcm.size()) {
+        for (size_t i = 0; i < pcm.size(); i++) {
+            double t = (double)(frame + i) / kRate;
+            pcm[i] = (int16_t)(12000 * (0.2 + t / kSeconds) * sin(2 * M_PI * 440 * t));
+        }
+        w.feed(pcm.data(), pcm.size(), 1, kRate, kSeconds, frame / kRate);
+        if (w.update()) return true;
+    }
+    return false;
+}
+
+static std::vector<uint8_t> columnsOf(const WaveformIndex &w) {
+    const uint8_t *p = (const uint8_t *)w.columns();
+    return p ? std::vector<uint8_t>(p, p + sizeof(WaveColumn) * PeakReducer::kColumns) : std::vector<uint8_t>();
+}
+
+TEST(reduced_waveform_is_saved_and_reloaded) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    dir.write("/a.mp3", std::vector<uint8_t>(1000, 0));
+    WaveformIndex writer;
+    writer.open("/a.mp3");
+    CHECK(!writer.isReady());
+    CHECK(reduce(writer));
+    CHECK_EQ(dir.read(sidecar("/a.mp3")).size(), kFileBytes);
+    CHECK(!dir.exists(sidecar("/a.mp3") + ".tmp"));
+
+    WaveformIndex reader;
+    reader.open("/a.mp3");
+    CHECK(reader.isReady());
+    CHECK(columnsOf(reader) == columnsOf(writer));
+}
+
+// 卡满：短写失败，不留下 .pk 与 .tmp，下次播放重新归约
+TEST(full_card_leaves_no_truncated_waveform) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    dir.write("/a.mp3", std::vector<uint8_t>(1000, 0));
+    WaveformIndex writer;
+    writer.open("/a.mp3");
+    SD.mkdir("/.wave");
+    SD.diskFullAfter(kFileBytes / 2);
+    CHECK(reduce(writer));
+    SD.diskFree();
+    CHECK(writer.isReady()); // 本次播放照常显示
+    CHECK(!dir.exists(sidecar("/a.mp3")));
+    CHECK(!dir.exists(sidecar("/a.mp3") + ".tmp"));
+
+    WaveformIndex reader;
+    reader.open("/a.mp3");
+    CHECK(!reader.isReady());
+}
+
+// 保存过程中任意位置断电：正式文件要么完整、要么不存在；此后能加载或重新归约
+TEST(power_cut_while_saving_never_leaves_a_partial_file) {
+    TempDir dir;
+    SD.setRoot(dir.path());
+    dir.write("/a.mp3", std::vector<uint8_t>(1000, 0));
+    std::string path = sidecar("/a.mp3");
+    SD.mkdir("/.wave");
+    int loaded = 0;
+    for (long budget = 0; budget < (long)kFileBytes + 8; budget++) {
+        SD.remove(path.c_str());
+        WaveformIndex writer;
+        writer.open("/a.mp3");
+        SD.powerCutAfter(budget);
+        reduce(writer);
+        SD.powerRestore();
+        CHECK(!dir.exists(path) || dir.read(path).size() == kFileBytes);
+
+        WaveformIndex reader;
+        reader.open("/a.mp3");
+        if (reader.isReady()) {
+            loaded++;
+            CHECK(columnsOf(reader) == columnsOf(writer));
+        }
+        SD.remove((path + ".tmp").c_str());
+    }
+    CHECK(loaded > 0);
+}
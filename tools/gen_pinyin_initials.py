@@ -0,0 +1,168 @@
+"""
+生成 src/playlist/PinyinInitials.cpp：CJK 基本区 U+4E00..U+9FA5 每个汉字的拼音首字母表，以及多音字的全部首字母。
+
+读音来源依次为：
+  1. GB2312 一级汉字（3755 个常用字）按拼音排序，按区位码落在哪个声母区间即可得到首字母；
+  2. 其余汉字（GB2312 二级字及 GBK / Unicode 基本区的字）取 CLDR 拼音排序数据中的读音，
+     即 Perl 自带的 Unicode::Collate::CJK::Pinyin（每字一个最常用读音，共 20892 字）；
+  3. POLYPHONES 中列出的常用多音字，把各读音的首字母都加上（"重" → z / c，"长" → c / z）。
+不覆盖：扩展 A 区及以后的字（U+3400.. / U+20000..），以及 POLYPHONES 以外的多音字的次要读音。
+
+用法：python3 tools/gen_pinyin_initials.py [Pinyin.pm 路径] > src/playlist/PinyinInitials.cpp
+"""
+import glob
+import sys
+import zlib
+
+FIRST = 0x4E00
+LAST = 0x9FA5
+
+# GB2312 一级汉字各声母的起始区位码（没有 i / u / v 开头的拼音）
+BOUNDARIES = [
+    (0xB0A1, 'a'), (0xB0C5, 'b'), (0xB2C1, 'c'), (0xB4EE, 'd'), (0xB6EA, 'e'), (0xB7A2, 'f'),
+    (0xB8C1, 'g'), (0xB9FE, 'h'), (0xBBF7, 'j'), (0xBFA6, 'k'), (0xC0AC, 'l'), (0xC2E8, 'm'),
+    (0xC4C3, 'n'), (0xC5B6, 'o'), (0xC5BE, 'p'), (0xC6DA, 'q'), (0xC8BB, 'r'), (0xC8F6, 's'),
+    (0xCBFA, 't'), (0xCDDA, 'w'), (0xCEF4, 'x'), (0xD1B9, 'y'), (0xD4D1, 'z'),
+]
+LEVEL1_END = 0xD7F9
+
+# CLDR 数据把 lüè 音节排在 E 下
+CLDR_FIXES = {'略': 'l', '掠': 'l', '锊': 'l'}
+
+# 常用多音字：只列首字母不同的读音（"都" du / dou 之类首字母相同的不必列）
+POLYPHONES = {
+    '重': 'zhong chong', '长': 'chang zhang', '行': 'xing hang', '乐': 'le yue', '朝': 'chao zhao',
+    '传': 'chuan zhuan', '调': 'diao tiao', '弹': 'dan tan', '藏': 'cang zang', '曾': 'zeng ceng',
+    '参': 'can shen cen', '单': 'dan shan chan', '降': 'jiang xiang', '会': 'hui kuai', '校': 'xiao jiao',
+    '卡': 'ka qia', '给': 'gei ji', '解': 'jie xie', '识': 'shi zhi', '属': 'shu zhu', '省': 'sheng xing',
+    '宿': 'su xiu', '种': 'zhong chong', '沈': 'shen chen', '盛': 'sheng cheng', '叶': 'ye xie',
+    '车': 'che ju', '率': 'lv shuai', '仇': 'chou qiu', '区': 'qu ou', '系': 'xi ji',
+    '折': 'zhe she', '奇': 'qi ji', '辟': 'bi pi', '便': 'bian pian', '秘': 'mi bi', '否': 'fou pi',
+    '拗': 'ao niu', '阿': 'a e', '暴': 'bao pu', '泌': 'mi bi', '曝': 'pu bao', '乘': 'cheng sheng',
+    '澄': 'cheng deng', '匙': 'chi shi', '臭': 'chou xiu', '畜': 'chu xu', '幢': 'zhuang chuang',
+    '伺': 'si ci', '攒': 'zan cuan', '撮': 'cuo zuo', '囤': 'tun dun', '番': 'fan pan', '脯': 'fu pu',
+    '蛤': 'ha ge', '合': 'he ge', '颈': 'jing geng', '红': 'hong gong', '吓': 'xia he', '茄': 'qie jia',
+    '句': 'ju gou', '龟': 'gui jun qiu', '壳': 'ke qiao', '咯': 'ka ge lo', '弄': 'nong long',
+    '疟': 'nve yao', '刨': 'pao bao', '炮': 'pao bao', '栖': 'qi xi',
+    '强': 'qiang jiang', '圈': 'quan juan', '厦': 'sha xia', '提': 'ti di', '尾': 'wei yi',
+    '纤': 'xian qian', '巷': 'xiang hang', '艾': 'ai yi', '贾': 'jia gu', '尉': 'wei yu', '蔓': 'man wan',
+    '石': 'shi dan', '汤': 'tang shang', '蕃': 'fan bo', '栅': 'zha shan', '铅': 'qian yan', '茜': 'qian xi',
+    '期': 'qi ji', '虹': 'hong jiang', '腌': 'yan a', '术': 'shu zhu', '芥': 'jie gai', '刹': 'sha cha',
+    '侧': 'ce zhai', '夹': 'jia ga', '骑': 'qi ji', '且': 'qie ju', '扁': 'bian pian', '万': 'wan mo',
+    '乾': 'qian gan', '亟': 'ji qi', '翟': 'zhai di', '吁': 'xu yu', '呵': 'he a', '咳': 'ke hai',
+    '埔': 'pu bu', '椎': 'zhui chui', '槛': 'jian kan', '泊': 'bo po', '炔': 'que gui', '轧': 'zha ya',
+    '辗': 'zhan nian', '傀': 'kui gui', '恶': 'e wu', '粘': 'nian zhan', '繁': 'fan po', '鸟': 'niao diao',
+    '荨': 'qian xun', '瀑': 'pu bao', '厂': 'chang an', '蹊': 'xi qi', '堡': 'bao bu pu', '蔚': 'wei yu',
+    '咖': 'ka ga', '喔': 'o wo', '哦': 'o e', '嘿': 'hei mo', '苣': 'ju qu', '枸': 'gou ju', '鹄': 'hu gu',
+    '纶': 'lun guan', '缉': 'ji qi', '峙': 'zhi shi', '稽': 'ji qi', '扛': 'kang gang',
+    '厕': 'ce si', '浒': 'hu xu', '祭': 'ji zhai', '镐': 'gao hao', '拽': 'zhuai ye', '殖': 'zhi shi',
+    '氏': 'shi zhi', '吭': 'keng hang', '陂': 'bei pi po', '泷': 'long shuang', '粥': 'zhou yu',
+    '窨': 'yin xun', '歙': 'she xi', '嗯': 'en n',
+}
+
+
+def gb2312_initial(cp):
+    try:
+        gb = chr(cp).encode('gb2312')
+    except UnicodeEncodeError:
+        return None
+    code = gb[0] << 8 | gb[1]
+    if code < BOUNDARIES[0][0] or code > LEVEL1_END:
+        return None
+    letter = None
+    for start, l in BOUNDARIES:
+        if code >= start:
+            letter = l
+    return letter
+
+
+def load_cldr(path):
+    data = open(path, encoding='ascii').read().split('__DATA__')[1].split('__END__')[0]
+    letters = {}
+    letter = None
+    for token in data.split():
+        if '-' in token:  # FDD0-0041 等：下一个字母区间开始
+            letter = chr(int(token.split('-')[1], 16)).lower()
+        elif letter:
+            letters[int(token, 16)] = letter
+    for ch, l in CLDR_FIXES.items():
+        letters[ord(ch)] = l
+    return letters
+
+
+def main():
+    paths = sys.argv[1:] or sorted(glob.glob('/usr/share/perl/5.*/Unicode/Collate/CJK/Pinyin.pm'))
+    if not paths:
+        sys.exit('Unicode/Collate/CJK/Pinyin.pm not found; pass its path')
+    cldr = load_cldr(paths[-1])
+
+    table = []
+    for cp in range(FIRST, LAST + 1):
+        table.append(gb2312_initial(cp) or cldr.get(cp) or '.')
+
+    # 多音字：首字母集合（含主读音）→ 集合编号
+    poly = {}
+    for ch, readings in POLYPHONES.items():
+        cp = ord(ch)
+        letters = set(r[0] for r in readings.split())
+        if table[cp - FIRST] != '.':
+            letters.add(table[cp - FIRST])
+        if len(letters) < 2:
+            sys.exit('%s: readings share one initial' % ch)
+        poly[cp] = ''.join(sorted(letters))
+    sets = sorted(set(poly.values()))
+    if len(sets) > 128:
+        sys.exit('too many initial sets')
+    table_id = zlib.crc32((''.join(table) + ''.join('%x%s' % kv for kv in sorted(poly.items()))).encode())
+
+    out = sys.stdout
+    out.write('// 由 tools/gen_pinyin_initials.py 生成，请勿手工修改\n')
+    out.write('#include "PinyinInitials.h"\n\n')
+    out.write('// U+%04X 起每个汉字一个字符：主读音的拼音首字母，\'.\' 表示未收录\n' % FIRST)
+    out.write('static const char kInitials[] =\n')
+    for i in range(0, len(table), 96):
+        out.write('    "%s"\n' % ''.join(table[i:i + 96]))
+    out.write(';\n\n')
+    out.write('// 多音字的首字母集合，按位（bit 0 = \'a\'）\n')
+    out.write('static const uint32_t kSets[] = {\n')
+    for i in range(0, len(sets), 8):
+        masks = ['0x%07X' % sum(1 << (ord(c) - 97) for c in s) for s in sets[i:i + 8]]
+        out.write('    %s,\n' % ', '.join(masks))
+    out.write('};\n\n')
+    out.write('// 按码位排序：{ 码位, kSets 下标 }\n')
+    out.write('static const struct {\n    uint16_t cp;\n    uint8_t set;\n} kPolyphones[] = {\n')
+    items = sorted(poly.items())
+    for i in range(0, len(items), 6):
+        row = ['{ 0x%04X, %2d }' % (cp, sets.index(s)) for cp, s in items[i:i + 6]]
+        out.write('    %s,\n' % ', '.join(row))
+    out.write('};\n\n')
+    out.write('''uint8_t pinyinKey(uint32_t cp) {
+    if (cp < 0x%04X || cp > 0x%04X) return 0;
+    size_t lo = 0, hi = sizeof(kPolyphones) / sizeof(kPolyphones[0]);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (kPolyphones[mid].cp < cp) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < sizeof(kPolyphones) / sizeof(kPolyphones[0]) && kPolyphones[lo].cp == cp) {
+        return kPinyinSetBase + kPolyphones[lo].set;
+    }
+    char c = kInitials[cp - 0x%04X];
+    return c == '.' ? 0 : (uint8_t)c;
+}
+
+uint32_t pinyinKeyMask(uint8_t key) {
+    if (key >= 'a' && key <= 'z') return 1u << (key - 'a');
+    size_t set = key - kPinyinSetBase;
+    return key >= kPinyinSetBase && set < sizeof(kSets) / sizeof(kSets[0]) ? kSets[set] : 0;
+}
+
+uint32_t pinyinTableId() { return 0x%08X; }
+''' % (FIRST, LAST, FIRST, table_id))
+    known = sum(1 for c in table if c != '.')
+    print('%d / %d characters mapped, %d polyphones in %d initial sets' % (known, len(table), len(poly), len(sets)),
+          file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
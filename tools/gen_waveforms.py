@@ -0,0 +1,76 @@
+import os
+import sys
+import math
+import struct
+import zlib
+import subprocess
+
+# 离线生成波形概览 sidecar（/.wave/<路径哈希>.pk），格式与固件 src/WaveformIndex.cpp 一致。
+# 固件在首次播放时也会自行生成；预先生成后第一次播放就能看到波形、按停顿跳转。
+# 解码依赖 ffmpeg（需在 PATH 中）。用法：python3 tools/gen_waveforms.py <SD 卡根目录> [模式目录 ...]
+
+COLUMNS = 218           # PeakReducer::kColumns
+MAGIC = 0x4B504657      # "WFPK"
+VERSION = 1
+AUDIO_EXTS = {'.mp3', '.aac', '.m4a', '.flac', '.ogg', '.wav'}
+
+def fnv1a64(data):
+    """与固件 pathHash() 相同的 FNV-1a 64 位哈希"""
+    h = 0xcbf29ce484222325
+    for b in data:
+        h ^= b
+        h = (h * 0x100000001b3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+def quantize(amplitude):
+    """与 PeakReducer::quantize 相同：线性幅度 0..32768 → 0..255（-60dBFS..0dBFS）"""
+    if amplitude < 1.0:
+        return 0
+    q = 255.0 + 255.0 * 20.0 * math.log10(amplitude / 32768.0) / 60.0
+    return 0 if q <= 0 else 255 if q >= 255 else int(q + 0.5)
+
+def reduce_file(path):
+    pcm = subprocess.run(['ffmpeg', '-v', 'error', '-i', path, '-f', 's16le', '-ac', '2', '-'],
+                         stdout=subprocess.PIPE, check=True).stdout
+    samples = struct.unpack('<%dh' % (len(pcm) // 2), pcm[:len(pcm) // 4 * 4])
+    total = len(samples) // 2
+    if total < COLUMNS:
+        return None
+    out = bytearray()
+    for c in range(COLUMNS):
+        seg = samples[c * total // COLUMNS * 2:(c + 1) * total // COLUMNS * 2]
+        peak = max(abs(v) for v in seg)
+        rms = math.sqrt(sum(v * v for v in seg) / len(seg))
+        out += bytes((quantize(peak), quantize(rms)))
+    return bytes(out)
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: gen_waveforms.py <sd_root> [mode_dir ...]")
+        sys.exit(1)
+    root = sys.argv[1]
+    dirs = sys.argv[2:] or ['/']
+    os.makedirs(os.path.join(root, '.wave'), exist_ok=True)
+
+    for d in dirs:
+        for cur, subdirs, files in os.walk(os.path.join(root, d.lstrip('/'))):
+            subdirs[:] = [s for s in subdirs if not s.startswith('.')]
+            for name in sorted(files):
+                if name.startswith('.') or os.path.splitext(name)[1].lower() not in AUDIO_EXTS:
+                    continue
+                full = os.path.join(cur, name)
+                sd_path = '/' + os.path.relpath(full, root).replace(os.sep, '/')
+                sidecar = os.path.join(root, '.wave', '%016x.pk' % fnv1a64(sd_path.encode('utf-8')))
+                if os.path.exists(sidecar):
+                    continue
+                columns = reduce_file(full)
+                if columns is None:
+                    continue
+                with open(sidecar, 'wb') as f:
+                    f.write(struct.pack('<IBI', MAGIC, VERSION, os.path.getsize(full) & 0xFFFFFFFF))
+                    f.write(columns)
+                    f.write(struct.pack('<I', zlib.crc32(columns)))
+                print(sd_path)
+
+if __name__ == '__main__':
+    main()
@@ -1,23 +1,151 @@
 import os
 import sys
 import re
+import zlib
 
 # ---------------- 配置区域 ----------------
-# 你的播放器中定义的模式列表（顺序必须与代码中一致！）
-MODES = [
+# 模式列表优先读取 SD 卡根目录的 modes.ini（与固件共用，格式见 src/ModeManifest.h）。
+# 没有清单时使用与固件 config.h 相同的默认模式（顺序即模式 ID）
+MANIFEST_NAME = "modes.ini"
+DEFAULT_MODES = [
     "/儿歌",  # 对应 ID 0
-    "/古诗",  # 对应 ID 1
-    "/故事",  # 对应 ID 2
-    "/音乐"   # 对应 ID 3
+    "/音乐",  # 对应 ID 1
+    "/古诗",  # 对应 ID 2
+    "/故事"   # 对应 ID 3
 ]
+DEFAULT_DEPTH = 2
+MAX_DEPTH = 8
+MAX_MODES = 16
 
-# 支持的音频格式
-AUDIO_EXTS = {'.mp3', '.aac', '.flac', '.ogg', '.wav'}
+# 支持的音频格式（与固件 PlaylistManager::isAudioFile 一致）
+AUDIO_EXTS = {'.mp3', '.aac', '.m4a', '.flac', '.ogg', '.wav'}
 
 # 要忽略的文件/文件夹（以 . 开头的隐藏文件默认忽略）
 IGNORE_NAMES = {'System Volume Information', '$RECYCLE.BIN', '.Trashes', '.fseventsd'}
 # ----------------------------------------
 
+def fnv1a64(data):
+    """与固件 pathHash() 相同的 FNV-1a 64 位哈希"""
+    h = 0xcbf29ce484222325
+    for b in data:
+        if b == 0:
+            break
+        h ^= b
+        h = (h * 0x100000001b3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+def write_cache(cache_path, files, manifest_hash):
+    """
+    写出与固件 CacheFile 相同的格式：首行清单哈希，每行一首，尾行为曲目数与 CRC32（覆盖此前全部字节）。
+    先写 .tmp 再重命名提交，原缓存保留为 .bak，与固件 CacheStore::save 一致。
+    """
+    lines = [f"#manifest {manifest_hash:016x}"] + list(files)
+    data = ''.join(line + '\n' for line in lines).encode('utf-8')
+    data += f"#end {len(files)} {zlib.crc32(data):08x}\n".encode('ascii')
+
+    base, _ = os.path.splitext(cache_path)
+    tmp_path = base + '.tmp'
+    with open(tmp_path, 'wb') as f:
+        f.write(data)
+        f.flush()
+        os.fsync(f.fileno())
+    if os.path.exists(cache_path):
+        os.replace(cache_path, base + '.bak')
+    os.replace(tmp_path, cache_path)
+
+def load_manifest(sd_root):
+    """
+    读取 modes.ini，返回 (模式列表, 清单哈希)。
+    解析规则与 ModeManifest::parse 保持一致；无清单或没有有效模式时返回默认模式和哈希 0。
+    """
+    path = os.path.join(sd_root, MANIFEST_NAME)
+    defaults = [{'name': m.lstrip('/'), 'path': m, 'depth': DEFAULT_DEPTH} for m in DEFAULT_MODES]
+    if not os.path.isfile(path):
+        return defaults, 0
+
+    with open(path, 'rb') as f:
+        raw = f.read()
+    text = raw.decode('utf-8', errors='replace')
+    if text.startswith('\ufeff'):
+        text = text[1:]
+
+    modes = []
+    current = None
+    seen_section = False
+
+    def finish(mode):
+        if mode is None:
+            return
+        if mode['streams']:
+            # 电台模式：固件直接用地址建列表，没有目录也不写缓存
+            if mode['path']:
+                print(f"⚠️ {MANIFEST_NAME}: 电台模式不能有 path: {mode['name']}")
+            elif len(modes) >= MAX_MODES:
+                print(f"⚠️ {MANIFEST_NAME}: 模式过多")
+            else:
+                modes.append(mode)
+            return
+        p = mode['path'] or '/' + mode['name']
+        if not p.startswith('/'):
+            print(f"⚠️ {MANIFEST_NAME}: path 必须以 / 开头: {p}")
+            return
+        p = p.rstrip('/') or '/'
+        if any(m['path'] == p for m in modes):
+            print(f"⚠️ {MANIFEST_NAME}: 重复的 path: {p}")
+            return
+        if len(modes) >= MAX_MODES:
+            print(f"⚠️ {MANIFEST_NAME}: 模式过多")
+            return
+        mode['path'] = p
+        modes.append(mode)
+
+    for line_no, line in enumerate(text.split('\n'), 1):
+        # 注释（# 或 ;）不含双引号内的部分
+        line = re.match(r'(?:[^#;"]|"[^"]*"?)*', line).group(0).strip()
+        if not line:
+            continue
+        if line.startswith('['):
+            finish(current)
+            current = None
+            seen_section = True
+            if not line.endswith(']') or len(line) < 3:
+                print(f"⚠️ {MANIFEST_NAME} 第 {line_no} 行: 段名格式错误")
+                continue
+            current = {'name': line[1:-1].strip(), 'path': '', 'depth': DEFAULT_DEPTH, 'streams': []}
+            if not current['name']:
+                # 空名称的缺省路径是 /，会扫描整张卡
+                print(f"⚠️ {MANIFEST_NAME} 第 {line_no} 行: 模式名称不能为空")
+                current = None
+            continue
+        if '=' in line and not seen_section:
+            key = line.split('=', 1)[0].strip()
+            if key not in ('wifi_ssid', 'wifi_password'):
+                print(f"⚠️ {MANIFEST_NAME} 第 {line_no} 行: 未知全局键 {key}")
+            continue
+        if current is None or '=' not in line:
+            print(f"⚠️ {MANIFEST_NAME} 第 {line_no} 行: 应为 [模式] 或 key = value")
+            continue
+        key, value = (x.strip() for x in line.split('=', 1))
+        if len(value) >= 2 and value[0] == value[-1] == '"':
+            value = value[1:-1]
+        if key == 'stream':
+            if value.lower().startswith('http://') and len(value) > 7:
+                current['streams'].append(value)
+            else:
+                print(f"⚠️ {MANIFEST_NAME} 第 {line_no} 行: 只支持 http:// 电台地址: {value}")
+        elif key == 'path':
+            current['path'] = value
+        elif key == 'depth' and value.isdigit() and int(value) <= MAX_DEPTH:
+            current['depth'] = int(value)
+        elif key not in ('shuffle', 'dsp', 'depth'):
+            print(f"⚠️ {MANIFEST_NAME} 第 {line_no} 行: 未知键 {key}")
+    finish(current)
+
+    if not modes:
+        print(f"⚠️ {MANIFEST_NAME} 中没有有效模式，使用默认模式")
+        return defaults, 0
+    return modes, fnv1a64(raw)
+
 def is_audio_file(filename):
     _, ext = os.path.splitext(filename)
     return ext.lower() in AUDIO_EXTS
@@ -92,11 +220,12 @@ def remove_duplicates(root_path):
     if deleted_count > 0:
         print(f"🧹 共清理 {deleted_count} 个重复副本文件")
 
-def scan_directory(root_dir, mode_path):
+def scan_directory(root_dir, mode_path, depth=DEFAULT_DEPTH):
     """
     扫描指定模式目录下的所有音频文件
     root_dir: SD卡根目录在电脑上的路径
     mode_path: 模式相对路径（如 "/儿歌"）
+    depth: 子目录扫描深度（与固件 scan 的 levels 含义相同）
     """
     file_list = []
     
@@ -117,6 +246,11 @@ def scan_directory(root_dir, mode_path):
     for root, dirs, files in os.walk(full_scan_path):
         # 过滤隐藏目录
         dirs[:] = [d for d in dirs if not d.startswith('.') and d not in IGNORE_NAMES]
+        # 超过扫描深度的子目录不再进入
+        rel = os.path.relpath(root, full_scan_path)
+        level = 0 if rel == '.' else rel.count(os.sep) + 1
+        if level >= depth:
+            dirs[:] = []
         
         for file in files:
             # 过滤隐藏文件
@@ -150,11 +284,17 @@ def main():
     print(f"SD卡根目录: {sd_root}")
     print("-" * 40)
     
+    modes, manifest_hash = load_manifest(sd_root)
+    print(f"模式清单: {len(modes)} 个模式, 哈希 {manifest_hash:016x}")
+    
     total_files = 0
     
-    for idx, mode in enumerate(MODES):
+    for idx, mode in enumerate(modes):
+        if mode.get('streams'):
+            print(f"📻 模式 {mode['name']} 为网络电台（{len(mode['streams'])} 个地址），跳过")
+            continue
         # 扫描该模式下的文件
-        files = scan_directory(sd_root, mode)
+        files = scan_directory(sd_root, mode['path'], mode['depth'])
         
         if files:
             # 生成缓存文件名: .playlist_cache_0.txt
@@ -162,15 +302,13 @@ def main():
             cache_path = os.path.join(sd_root, cache_filename)
             
             try:
-                with open(cache_path, 'w', encoding='utf-8') as f:
-                    for line in files:
-                        f.write(line + '\n')
+                write_cache(cache_path, files, manifest_hash)
                 print(f"✅ 生成索引: {cache_filename} (包含 {len(files)} 首歌)")
                 total_files += len(files)
             except Exception as e:
                 print(f"❌ 写入失败 {cache_filename}: {e}")
         else:
-            print(f"⚪ 模式 {mode} 为空，跳过生成")
+            print(f"⚪ 模式 {mode['name']} 为空，跳过生成")
             
     print("-" * 40)
     print(f"完成！共索引 {total_files} 首歌。")
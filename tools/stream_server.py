@@ -0,0 +1,286 @@
+"""
+本地网络电台模拟：把一个 MP3 / ADTS AAC 文件当作直播流循环播出，用于测试固件的网络电台模式
+（src/stream/）。可以按需限速、停顿、断开，观察抖动缓冲的目标深度、断流与重连。
+
+    python3 tools/stream_server.py music.mp3 [--port 8000] [--burst 2] [--throttle 0.8] [--jitter 300]
+                                              [--stall-every 60 --stall-for 4] [--drop-every 120] [--icy]
+
+直播时钟从服务器启动开始走，所有连接共享：重连后从当前直播位置继续（与真实电台一样，断开期间的内容错过了）。
+新连接先突发发送 --burst 秒的历史内容（Icecast 的 burst-on-connect），之后按实时速率发送。
+
+地址：
+    /stream          音频流（Content-Type 按文件格式，--no-type 时省略由固件嗅探）
+    /redirect        302 跳转到 /stream
+    /status/<code>   返回指定状态码（测试 4xx 不重试、5xx 退避）
+    /control?...     运行时调整，参数同下方的标准输入命令，例如 /control?throttle=0.5&stall=3
+
+标准输入命令（回车执行）：
+    throttle <x>   发送速率上限为实时的 x 倍（0 不限；低于 1 时客户端逐渐落后直播）
+    jitter <ms>    随机停顿 0..ms 毫秒（约每 0.5 秒一次）
+    stall <s>      所有连接停止发送 s 秒（连接保持），之后补发积压的数据
+    drop           立即断开所有连接
+    status         打印当前设置与连接数
+"""
+import argparse
+import os
+import random
+import socketserver
+import sys
+import threading
+import time
+import urllib.parse
+from http.server import BaseHTTPRequestHandler, HTTPServer
+
+# ---------------- 帧解析（与 src/stream/FrameSync.cpp 一致） ----------------
+MPEG_BITRATES = [
+    [[0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0],
+     [0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0],
+     [0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0]],
+    [[0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0],
+     [0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0],
+     [0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0]],
+]
+MPEG_RATES = [44100, 48000, 32000]
+ADTS_RATES = [96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350]
+
+
+def parse_frame(data, i):
+    """返回 (格式, 帧长, 时长秒) 或 None"""
+    if i + 7 > len(data) or data[i] != 0xFF:
+        return None
+    b1, b2 = data[i + 1], data[i + 2]
+    if (b1 & 0xF6) == 0xF0:  # ADTS
+        rate_index = (b2 >> 2) & 0xF
+        length = ((data[i + 3] & 3) << 11) | (data[i + 4] << 3) | (data[i + 5] >> 5)
+        if rate_index >= 13 or length <= 7:
+            return None
+        return "aac", length, 1024 * ((data[i + 6] & 3) + 1) / ADTS_RATES[rate_index]
+    if (b1 & 0xE0) != 0xE0:
+        return None
+    version = (b1 >> 3) & 3
+    layer = 4 - ((b1 >> 1) & 3)
+    bitrate_index, rate_index, padding = b2 >> 4, (b2 >> 2) & 3, (b2 >> 1) & 1
+    if version == 1 or layer == 4 or rate_index == 3:
+        return None
+    kbps = MPEG_BITRATES[0 if version == 3 else 1][layer - 1][bitrate_index]
+    if kbps == 0:
+        return None
+    rate = MPEG_RATES[rate_index] >> (0 if version == 3 else 1 if version == 2 else 2)
+    if layer == 1:
+        return "mp3", (12 * kbps * 1000 // rate + padding) * 4, 384 / rate
+    if layer == 2 or version == 3:
+        return "mp3", 144 * kbps * 1000 // rate + padding, 1152 / rate
+    return "mp3", 72 * kbps * 1000 // rate + padding, 576 / rate
+
+
+def load_frames(path):
+    """切分为帧列表 [(bytes, 时长)]，跳过 ID3v2 标签与无法解析的字节"""
+    with open(path, "rb") as f:
+        data = f.read()
+    i = 0
+    if data[:3] == b"ID3" and len(data) > 10:
+        i = 10 + ((data[6] & 0x7F) << 21 | (data[7] & 0x7F) << 14 | (data[8] & 0x7F) << 7 | (data[9] & 0x7F))
+    frames, codec = [], None
+    while i < len(data):
+        info = parse_frame(data, i)
+        if info is None or (codec and info[0] != codec) or i + info[1] > len(data):
+            i += 1
+            continue
+        codec = info[0]
+        frames.append((data[i:i + info[1]], info[2]))
+        i += info[1]
+    if not frames:
+        sys.exit(f"{path}: 没有找到 MP3 / ADTS 帧")
+    return codec, frames
+
+
+# ---------------- 直播状态 ----------------
+class Station:
+    def __init__(self, codec, frames, burst):
+        self.codec = codec
+        self.frames = frames
+        self.duration = sum(d for _, d in frames)
+        self.frame_time = self.duration / len(frames)
+        self.burst = burst
+        self.start = time.monotonic()
+        self.lock = threading.Lock()
+        self.throttle = 0.0      # 发送速率上限（实时的倍数），0 不限
+        self.jitter_ms = 0
+        self.stall_until = 0.0
+        self.generation = 0      # drop 递增，连接发现后断开
+        self.clients = 0
+        self.bytes_sent = 0
+
+    def live_index(self):
+        """当前直播位置（帧序号，不取模）"""
+        return int((time.monotonic() - self.start) / self.frame_time)
+
+    def frame(self, n):
+        return self.frames[n % len(self.frames)][0]
+
+    def command(self, name, value=None):
+        with self.lock:
+            if name == "throttle":
+                self.throttle = float(value)
+            elif name == "jitter":
+                self.jitter_ms = int(float(value))
+            elif name == "stall":
+                self.stall_until = time.monotonic() + float(value)
+            elif name == "drop":
+                self.generation += 1
+            elif name != "status":
+                return f"unknown command: {name}"
+        return self.status()
+
+    def status(self):
+        stalled = max(0.0, self.stall_until - time.monotonic())
+        return (f"clients {self.clients}, throttle {self.throttle or 'off'}, jitter {self.jitter_ms} ms, "
+                f"stall {stalled:.1f} s left, sent {self.bytes_sent // 1024} KB")
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.0"
+    station = None
+    options = None
+
+    def log_message(self, fmt, *args):
+        sys.stderr.write(f"[{time.strftime('%H:%M:%S')}] {self.address_string()} {fmt % args}\n")
+
+    def do_GET(self):
+        url = urllib.parse.urlparse(self.path)
+        if url.path == "/stream":
+            self.stream()
+        elif url.path == "/redirect":
+            self.send_response(302)
+            self.send_header("Location", "/stream")
+            self.end_headers()
+        elif url.path.startswith("/status/"):
+            self.send_response(int(url.path[8:] or 500))
+            self.end_headers()
+        elif url.path == "/control":
+            reply = self.station.status()
+            for key, values in urllib.parse.parse_qs(url.query, keep_blank_values=True).items():
+                reply = self.station.command(key, values[0] or None)
+            self.send_response(200)
+            self.send_header("Content-Type", "text/plain")
+            self.end_headers()
+            self.wfile.write((reply + "\n").encode())
+        else:
+            self.send_response(404)
+            self.end_headers()
+
+    def stream(self):
+        st, opt = self.station, self.options
+        head = "ICY 200 OK\r\n" if opt.icy else "HTTP/1.0 200 OK\r\n"
+        if not opt.no_type:
+            head += f"Content-Type: {'audio/mpeg' if st.codec == 'mp3' else 'audio/aac'}\r\n"
+        bitrate = int(sum(len(f) for f, _ in st.frames) * 8 / st.duration / 1000)
+        head += f"icy-br: {bitrate}\r\nicy-name: stream_server\r\nCache-Control: no-cache\r\n\r\n"
+        self.wfile.write(head.encode())
+
+        with st.lock:
+            st.clients += 1
+            generation = st.generation
+        # 从直播位置往前 burst 秒开始，先突发发送这部分
+        n = max(0, st.live_index() - int(st.burst / st.frame_time))
+        credit = 0.0  # 限速时允许发送的媒体时长（秒）
+        last = time.monotonic()
+        hold_until = 0.0
+        try:
+            while True:
+                now = time.monotonic()
+                dt, last = now - last, now
+                with st.lock:
+                    if st.generation != generation:
+                        self.log_message("dropped")
+                        return
+                    stalled = now < st.stall_until
+                    throttle, jitter = st.throttle, st.jitter_ms
+                if throttle:
+                    credit = min(credit + dt * throttle, 1.0)
+                if jitter and now >= hold_until and random.random() < dt * 2:
+                    hold_until = now + random.uniform(0, jitter / 1000)
+                if stalled or now < hold_until:
+                    time.sleep(0.01)
+                    continue
+
+                live = st.live_index()
+                chunk = bytearray()
+                while n <= live and len(chunk) < 16384:
+                    if throttle:
+                        if credit < st.frame_time:
+                            break
+                        credit -= st.frame_time
+                    chunk += st.frame(n)
+                    n += 1
+                if chunk:
+                    self.wfile.write(chunk)
+                    with st.lock:
+                        st.bytes_sent += len(chunk)
+                else:
+                    time.sleep(0.01)
+        except (BrokenPipeError, ConnectionResetError):
+            self.log_message("client closed")
+        finally:
+            with st.lock:
+                st.clients -= 1
+
+
+class Server(socketserver.ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def schedule(station, opt):
+    """--stall-every / --drop-every 的定时故障"""
+    next_stall = time.monotonic() + opt.stall_every if opt.stall_every else None
+    next_drop = time.monotonic() + opt.drop_every if opt.drop_every else None
+    while next_stall or next_drop:
+        time.sleep(0.1)
+        now = time.monotonic()
+        if next_stall and now >= next_stall:
+            print(f"stall {opt.stall_for} s: {station.command('stall', opt.stall_for)}", flush=True)
+            next_stall += opt.stall_every
+        if next_drop and now >= next_drop:
+            print(f"drop: {station.command('drop')}", flush=True)
+            next_drop += opt.drop_every
+
+
+def main():
+    parser = argparse.ArgumentParser(description="本地网络电台模拟（限速 / 停顿 / 断开）")
+    parser.add_argument("file", help="MP3 或 ADTS AAC 文件，循环播出")
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--burst", type=float, default=2.0, help="新连接突发发送的秒数")
+    parser.add_argument("--throttle", type=float, default=0.0, help="发送速率上限（实时的倍数）")
+    parser.add_argument("--jitter", type=int, default=0, help="随机停顿上限 (ms)")
+    parser.add_argument("--stall-every", type=float, default=0, help="每隔多少秒停顿一次")
+    parser.add_argument("--stall-for", type=float, default=3.0, help="每次停顿的秒数")
+    parser.add_argument("--drop-every", type=float, default=0, help="每隔多少秒断开所有连接")
+    parser.add_argument("--icy", action="store_true", help="状态行使用 SHOUTcast 的 ICY 200 OK")
+    parser.add_argument("--no-type", action="store_true", help="不发送 Content-Type")
+    opt = parser.parse_args()
+
+    codec, frames = load_frames(opt.file)
+    station = Station(codec, frames, opt.burst)
+    station.command("throttle", opt.throttle)
+    station.command("jitter", opt.jitter)
+    Handler.station, Handler.options = station, opt
+
+    server = Server((opt.host, opt.port), Handler)
+    print(f"{os.path.basename(opt.file)}: {codec}, {len(frames)} frames, {station.duration:.1f} s loop; "
+          f"http://{opt.host}:{opt.port}/stream", flush=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    threading.Thread(target=schedule, args=(station, opt), daemon=True).start()
+
+    for line in sys.stdin:
+        parts = line.split()
+        if parts:
+            print(station.command(parts[0], parts[1] if len(parts) > 1 else None), flush=True)
+    # 标准输入关闭（后台运行）时保持服务
+    while True:
+        time.sleep(3600)
+
+
+if __name__ == "__main__":
+    main()
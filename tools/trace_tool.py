@@ -0,0 +1,176 @@
+import struct
+import sys
+import time
+import zlib
+
+# ---------------- 格式定义 ----------------
+# 与 src/diag/TraceRecorder.h 保持一致（枚举只追加，不重排）
+MAGIC = b"TRC1"
+HEADER = struct.Struct("<4sHHII")   # magic, 版本, 记录长度, 记录数, 被覆盖的记录数
+RECORD = struct.Struct("<QBBHI")    # timeUs, type, code, a, b
+
+TYPES = ["mark", "button", "command", "track_open", "cache", "underrun", "deadline", "section", "stream"]
+COMMANDS = ["play_pause", "next_song", "prev_song", "next_mode", "prev_mode", "speed",
+            "seek_forward", "seek_backward", "ab_repeat", "sleep_timer", "volume_up",
+            "volume_down", "mute", "led_toggle", "track_end"]
+CACHE = ["hit", "miss", "resident"]
+SECTIONS = ["mode_switch", "mode_build", "scan", "track_open", "ui_frame", "trace_flush", "boot"]
+BOOT_PHASES = ["runtime", "display", "storage", "modes", "playlist", "audio", "input", "track"]  # src/diag/BootProfile.h
+STREAM = ["connect", "start", "stall", "closed", "backoff", "failed", "underrun", "splice"]
+MARKS = ["boot", "flush"]
+FLUSH_REASONS = ["serial", "underrun", "sleep"]
+GESTURES = ["click", "long_press", "chord"]
+BUTTONS = ["mode", "vol_up", "vol_down", "mic"]  # mic：拍手口令，x 后为拍手次数
+# ----------------------------------------
+
+
+def name(table, i):
+    return table[i] if i < len(table) else f"#{i}"
+
+
+def load(path):
+    """读取追踪文件，返回 (记录列表, 被覆盖数)。CRC 不符时抛出 ValueError"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size + 4:
+        raise ValueError("文件过短")
+    magic, version, rec_size, count, dropped = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("不是追踪文件")
+    if version != 1 or rec_size != RECORD.size:
+        raise ValueError(f"不支持的版本 {version} / 记录长度 {rec_size}")
+    end = HEADER.size + count * rec_size
+    if len(data) != end + 4:
+        raise ValueError("文件长度与记录数不符")
+    (crc,) = struct.unpack_from("<I", data, end)
+    if zlib.crc32(data[:end]) != crc:
+        raise ValueError("CRC 校验失败")
+    records = [RECORD.unpack_from(data, HEADER.size + i * rec_size) for i in range(count)]
+    return records, dropped
+
+
+def describe(rec):
+    _, type_, code, a, b = rec
+    t = name(TYPES, type_)
+    if t == "mark":
+        m = name(MARKS, code)
+        if m == "boot":
+            return "boot (handoff)" if a else m
+        return f"{m} ({name(FLUSH_REASONS, a)})" if m == "flush" else m
+    if t == "button":
+        g = name(GESTURES, code)
+        if g == "chord":
+            keys = "+".join(BUTTONS[i] for i in range(len(BUTTONS)) if (a >> 8) & (1 << i))
+            return f"chord {keys}"
+        return f"{g} {name(BUTTONS, a & 0xFF)} x{b}"
+    if t == "command":
+        return name(COMMANDS, code)
+    if t == "track_open":
+        return f"{'ok' if code else 'FAILED'} mode {a} hash {b:08x}"
+    if t == "cache":
+        return f"{name(CACHE, code)} mode {a}, {b} tracks"
+    if t == "underrun":
+        return f"gap {b} ms"
+    if t == "deadline":
+        return f"gap {b / 1000:.1f} ms"
+    if t == "section" and name(SECTIONS, code) == "boot":
+        return f"boot {name(BOOT_PHASES, a)} {b / 1000:.2f} ms"
+    if t == "section":
+        return f"{name(SECTIONS, code)}({a}) {b / 1000:.2f} ms"
+    if t == "stream":
+        s = name(STREAM, code)
+        detail = {"connect": f"failures {b}", "start": f"http {b}", "stall": f"silent {b} ms",
+                  "closed": f"silent {b} ms", "backoff": f"wait {b} ms", "failed": f"http {b}",
+                  "underrun": f"target {b} ms", "splice": f"skipped {b} frames"}.get(s, f"b {b}")
+        return f"{s} (reconnects {a}) {detail}"
+    return f"code {code} a {a} b {b}"
+
+
+def cmd_decode(records):
+    if not records:
+        return
+    t0 = records[0][0]
+    for rec in records:
+        print(f"{(rec[0] - t0) / 1e6:10.3f}s  {name(TYPES, rec[1]):<10} {describe(rec)}")
+
+
+def cmd_stats(records):
+    """按分段统计耗时分布，并列出每次断流前 2 秒内发生的事件"""
+    sections = {}
+    for _, type_, code, a, b in records:
+        if name(TYPES, type_) == "section":
+            sections.setdefault(name(SECTIONS, code), []).append(b)
+    print(f"{'section':<14}{'count':>7}{'min ms':>10}{'avg ms':>10}{'p95 ms':>10}{'max ms':>10}")
+    for sec, values in sorted(sections.items()):
+        values.sort()
+        p95 = values[min(len(values) - 1, int(len(values) * 0.95))]
+        print(f"{sec:<14}{len(values):>7}{values[0] / 1000:>10.2f}{sum(values) / len(values) / 1000:>10.2f}"
+              f"{p95 / 1000:>10.2f}{values[-1] / 1000:>10.2f}")
+
+    for i, rec in enumerate(records):
+        stream_underrun = name(TYPES, rec[1]) == "stream" and name(STREAM, rec[2]) == "underrun"
+        if name(TYPES, rec[1]) not in ("underrun", "deadline") and not stream_underrun:
+            continue
+        print(f"\n{name(TYPES, rec[1])} at {(rec[0] - records[0][0]) / 1e6:.3f}s ({describe(rec)}), preceded by:")
+        j = i - 1
+        while j >= 0 and rec[0] - records[j][0] <= 2_000_000:
+            j -= 1
+        for prev in records[j + 1:i]:
+            print(f"  -{(rec[0] - prev[0]) / 1000:8.1f} ms  {name(TYPES, prev[1]):<10} {describe(prev)}")
+
+
+def cmd_replay(records, port=None, speed=1.0):
+    """
+    按原始时间间隔重放命令流。给定串口时发送到设备（固件串口命令 "cmd <n>"，见 main.cpp handleSerial），
+    否则只打印重放脚本。曲目结束 (track_end) 由设备自然产生，不重放。
+    """
+    commands = [r for r in records if name(TYPES, r[1]) == "command" and name(COMMANDS, r[2]) != "track_end"]
+    if not commands:
+        print("没有可重放的命令")
+        return
+    ser = None
+    if port:
+        import serial  # pip install pyserial
+        ser = serial.Serial(port, 115200, timeout=0)
+
+    start = time.monotonic()
+    t0 = commands[0][0]
+    for rec in commands:
+        offset = (rec[0] - t0) / 1e6 / speed
+        if ser:
+            delay = start + offset - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            ser.write(f"cmd {rec[2]}\n".encode())
+        print(f"{offset:10.3f}s  cmd {rec[2]:<3} {name(COMMANDS, rec[2])}")
+    if ser:
+        ser.close()
+
+
+def main():
+    if len(sys.argv) < 3 or sys.argv[1] not in ("decode", "stats", "replay"):
+        print("使用方法: python trace_tool.py decode|stats <trace.bin>")
+        print("          python trace_tool.py replay <trace.bin> [串口] [倍速]")
+        print("示例: python trace_tool.py stats /Volumes/SDCARD/.trace.bin")
+        print("示例: python trace_tool.py replay .trace.bin /dev/ttyUSB0 2")
+        sys.exit(1)
+
+    try:
+        records, dropped = load(sys.argv[2])
+    except (OSError, ValueError) as e:
+        print(f"错误: {e}")
+        sys.exit(1)
+    print(f"{len(records)} 条记录（缓冲已覆盖更早的 {dropped} 条）\n")
+
+    if sys.argv[1] == "decode":
+        cmd_decode(records)
+    elif sys.argv[1] == "stats":
+        cmd_stats(records)
+    else:
+        port = sys.argv[3] if len(sys.argv) > 3 else None
+        speed = float(sys.argv[4]) if len(sys.argv) > 4 else 1.0
+        cmd_replay(records, port, speed)
+
+
+if __name__ == "__main__":
+    main()